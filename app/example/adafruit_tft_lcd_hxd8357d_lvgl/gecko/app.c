@@ -110,6 +110,7 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
+  lv_port_indev_process();
   lv_timer_handler_run_in_period(5);
 
   if (btn0_pressed) {
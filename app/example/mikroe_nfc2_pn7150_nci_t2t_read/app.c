@@ -45,21 +45,18 @@
 
 #include "mikroe_pn7150_config.h"
 #include "mikroe_pn7150.h"
+#include "nci_tml.h"
 
 #if (defined(SLI_SI917))
-#include "sl_driver_gpio.h"
 #include "sl_i2c_instances.h"
 #include "rsi_debug.h"
 
 #define app_printf(...)           DEBUGOUT(__VA_ARGS__)
 #define I2C_INSTANCE_USED         SL_I2C2
-#define GPIO_M4_INTR              0 // M4 Pin interrupt number
-#define AVL_INTR_NO               0 // available interrupt number
 
 static sl_i2c_instance_t i2c_instance = I2C_INSTANCE_USED;
 #else
 #include "sl_i2cspm_instances.h"
-#include "gpiointerrupt.h"
 #include "app_log.h"
 
 #define app_printf(...)          app_log(__VA_ARGS__)
@@ -70,8 +67,6 @@ static uint16_t t2t_area_size = 0;
 static uint8_t data_buff[16];
 static mikroe_i2c_handle_t app_i2c_instance = NULL;
 
-static void app_int_callback(uint8_t intNo);
-
 /*
  * T2T Read Process
  * -----------------------------------------------------------------------------
@@ -116,25 +111,8 @@ void app_init(void)
     app_printf("> PN7150 - NFC 2 Click board driver init failed.\n");
   }
 
-#if (defined(SLI_SI917))
-  sl_gpio_t gpio_port_pin = {
-    MIKROE_PN7150_INT_PIN / 16,
-    MIKROE_PN7150_INT_PIN % 16
-  };
-  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
-                                     GPIO_M4_INTR,
-                                     SL_GPIO_INTERRUPT_RISING_EDGE,
-                                     (void *)&app_int_callback,
-                                     AVL_INTR_NO);
-#else
-  GPIO_ExtIntConfig(MIKROE_PN7150_INT_PORT,
-                    MIKROE_PN7150_INT_PIN,
-                    MIKROE_PN7150_INT_PIN,
-                    true,
-                    false,
-                    true);
-  GPIOINT_CallbackRegister(MIKROE_PN7150_INT_PIN, app_int_callback);
-#endif
+  // Packets are read on the PN7150 IRQ edge and handed to NCI.
+  nci_tml_init(nci_notify_incoming_packet);
 
   app_printf("        HW Reset       \r\n");
   mikroe_pn7150_hw_reset();
@@ -371,9 +349,3 @@ void app_process_action(void)
       break;
   }
 }
-
-static void app_int_callback(uint8_t intNo)
-{
-  (void) intNo;
-  nci_notify_incoming_packet();
-}
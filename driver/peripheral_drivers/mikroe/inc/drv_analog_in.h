@@ -90,6 +90,45 @@ typedef struct
   analog_in_config_t config;
 } analog_in_t;
 
+typedef enum
+{
+  ANALOG_IN_AVERAGE_1 = 0,
+  ANALOG_IN_AVERAGE_2,
+  ANALOG_IN_AVERAGE_4,
+  ANALOG_IN_AVERAGE_8,
+  ANALOG_IN_AVERAGE_16,
+
+  ///< Default hardware averaging
+  ANALOG_IN_AVERAGE_DEFAULT = ANALOG_IN_AVERAGE_1
+} analog_in_average_t;
+
+typedef enum
+{
+  ANALOG_IN_STREAM_HALF_COMPLETE = 0, ///< buffer[0] has been filled
+  ANALOG_IN_STREAM_FULL_COMPLETE      ///< buffer[1] has been filled
+} analog_in_stream_event_t;
+
+/**
+ * @brief Stream callback, called from the DMA interrupt each time one of the
+ * two buffers has been filled. The buffer is owned by the application until
+ * the DMA wraps around to it again, i.e. for buffer_length sample periods.
+ */
+typedef void (*analog_in_stream_callback_t)(analog_in_t *obj,
+                                            analog_in_stream_event_t event,
+                                            uint16_t *buffer,
+                                            uint32_t length,
+                                            void *user_data);
+
+typedef struct
+{
+  uint32_t sample_rate;          ///< Sampling rate in Hz
+  analog_in_average_t average;   ///< Hardware averaging per sample
+  uint16_t *buffer[2];           ///< Double buffer for the raw samples
+  uint32_t buffer_length;        ///< Number of samples per buffer
+  analog_in_stream_callback_t callback;
+  void *user_data;
+} analog_in_stream_config_t;
+
 void analog_in_configure_default(analog_in_config_t *config);
 err_t analog_in_open(analog_in_t *obj, analog_in_config_t *config);
 err_t analog_in_set_resolution(analog_in_t *obj,
@@ -100,6 +139,26 @@ err_t analog_in_read(analog_in_t *obj, uint16_t *readDatabuf);
 err_t analog_in_read_voltage(analog_in_t *obj, float *readDatabuf);
 void analog_in_close(analog_in_t *obj);
 
+/**
+ * @brief Fill the stream configuration with default values (1 kHz, no
+ * averaging, no buffers).
+ */
+void analog_in_stream_configure_default(analog_in_stream_config_t *config);
+
+/**
+ * @brief Start continuous, timer triggered sampling of the opened input.
+ * Samples are moved by the DMA alternately into buffer[0] and buffer[1] and
+ * the callback is invoked after each buffer is filled. analog_in_read() and
+ * analog_in_read_voltage() return ADC_ERROR while streaming is active.
+ */
+err_t analog_in_stream_start(analog_in_t *obj,
+                             analog_in_stream_config_t *config);
+
+/**
+ * @brief Stop continuous sampling and restore single conversion mode.
+ */
+err_t analog_in_stream_stop(analog_in_t *obj);
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,10 +41,13 @@
 #include <string.h>
 #include <math.h>
 #include "em_cmu.h"
+#include "dmadrv.h"
 #include "drv_analog_in.h"
 
 #if defined(_SILICON_LABS_32B_SERIES_1)
 #include "em_adc.h"
+#include "em_prs.h"
+#include "em_timer.h"
 #elif defined(_SILICON_LABS_32B_SERIES_2)
 #include "em_iadc.h"
 #endif
@@ -63,6 +66,20 @@
 #define MIKROE_CONFIG_ADC_AVDD   3300
 #endif
 
+#if defined(_SILICON_LABS_32B_SERIES_1)
+// TIMER and PRS channel used to trigger conversions in streaming mode
+#ifndef MIKROE_CONFIG_ADC_STREAM_TIMER
+#define MIKROE_CONFIG_ADC_STREAM_TIMER           TIMER1
+#define MIKROE_CONFIG_ADC_STREAM_TIMER_CLOCK     cmuClock_TIMER1
+#define MIKROE_CONFIG_ADC_STREAM_PRS_SOURCE      PRS_CH_CTRL_SOURCESEL_TIMER1
+#define MIKROE_CONFIG_ADC_STREAM_PRS_SIGNAL      PRS_CH_CTRL_SIGSEL_TIMER1OF
+#endif
+
+#ifndef MIKROE_CONFIG_ADC_STREAM_PRS_CHANNEL
+#define MIKROE_CONFIG_ADC_STREAM_PRS_CHANNEL     0
+#endif
+#endif
+
 #if defined(_SILICON_LABS_32B_SERIES_2)
 #define calc_adc_pos(port, pin) \
   ((((port) * 16) + pin) + (unsigned int)iadcNegInputPortAPin0)
@@ -82,9 +99,21 @@ static err_t allocate_analog_bus_even0(analog_in_t *obj);
 static err_t hal_adc_init(analog_in_t *obj);
 static void hal_adc_deinit(analog_in_t *obj);
 uint16_t hal_adc_read(analog_in_t *obj);
+static err_t hal_adc_stream_trigger_start(analog_in_t *obj);
+static void hal_adc_stream_trigger_stop(analog_in_t *obj);
+static bool hal_adc_stream_dma_callback(unsigned int channel,
+                                        unsigned int sequenceNo,
+                                        void *userParam);
+static err_t hal_adc_stream_abort(analog_in_t *obj);
 
 static analog_in_t *_owner = NULL;
 
+// Streaming state, _stream is NULL while in single conversion mode
+static analog_in_stream_config_t stream_config;
+static analog_in_stream_config_t *_stream = NULL;
+static LDMA_Descriptor_t stream_desc[2];
+static unsigned int stream_dma_channel;
+
 static err_t _acquire(analog_in_t *obj, bool obj_open_state)
 {
   err_t status = ACQUIRE_SUCCESS;
@@ -121,7 +150,7 @@ err_t analog_in_open(analog_in_t *obj, analog_in_config_t *config)
 err_t analog_in_set_resolution(analog_in_t *obj,
                                analog_in_resolution_t resolution)
 {
-  if (_acquire(obj, false) != ACQUIRE_FAIL) {
+  if ((_stream == NULL) && (_acquire(obj, false) != ACQUIRE_FAIL)) {
     obj->config.resolution = resolution;
     return ADC_SUCCESS;
   } else {
@@ -131,7 +160,7 @@ err_t analog_in_set_resolution(analog_in_t *obj,
 
 err_t analog_in_set_vref_input(analog_in_t *obj, analog_in_vref_t vref)
 {
-  if (_acquire(obj, false) != ACQUIRE_FAIL) {
+  if ((_stream == NULL) && (_acquire(obj, false) != ACQUIRE_FAIL)) {
     obj->config.vref_input = vref;
     hal_adc_deinit(obj);
     return hal_adc_init(obj);
@@ -142,7 +171,7 @@ err_t analog_in_set_vref_input(analog_in_t *obj, analog_in_vref_t vref)
 
 err_t analog_in_set_vref_value(analog_in_t *obj, float vref_value)
 {
-  if (_acquire(obj, false) != ACQUIRE_FAIL) {
+  if ((_stream == NULL) && (_acquire(obj, false) != ACQUIRE_FAIL)) {
     obj->config.vref_value = vref_value;
     hal_adc_deinit(obj);
     return hal_adc_init(obj);
@@ -153,7 +182,7 @@ err_t analog_in_set_vref_value(analog_in_t *obj, float vref_value)
 
 err_t analog_in_read(analog_in_t *obj, uint16_t *readDatabuf)
 {
-  if (_acquire(obj, false) != ACQUIRE_FAIL) {
+  if ((_stream == NULL) && (_acquire(obj, false) != ACQUIRE_FAIL)) {
     *readDatabuf = hal_adc_read(obj);
     switch (obj->config.resolution) {
       case ANALOG_IN_RESOLUTION_6_BIT:
@@ -178,7 +207,7 @@ err_t analog_in_read(analog_in_t *obj, uint16_t *readDatabuf)
 
 err_t analog_in_read_voltage(analog_in_t *obj, float *readDatabuf)
 {
-  if (_acquire(obj, false) != ACQUIRE_FAIL) {
+  if ((_stream == NULL) && (_acquire(obj, false) != ACQUIRE_FAIL)) {
     *readDatabuf = (float)hal_adc_read(obj) * obj->config.vref_value / 4096;
     return ADC_SUCCESS;
   } else {
@@ -188,11 +217,158 @@ err_t analog_in_read_voltage(analog_in_t *obj, float *readDatabuf)
 
 void analog_in_close(analog_in_t *obj)
 {
+  if (_stream != NULL) {
+    analog_in_stream_stop(obj);
+  }
   hal_adc_deinit(obj);
   obj->handle = NULL;
   _owner = NULL;
 }
 
+void analog_in_stream_configure_default(analog_in_stream_config_t *config)
+{
+  config->sample_rate = 1000;
+  config->average = ANALOG_IN_AVERAGE_DEFAULT;
+  config->buffer[0] = NULL;
+  config->buffer[1] = NULL;
+  config->buffer_length = 0;
+  config->callback = NULL;
+  config->user_data = NULL;
+}
+
+err_t analog_in_stream_start(analog_in_t *obj,
+                             analog_in_stream_config_t *config)
+{
+  LDMA_TransferCfg_t xfer;
+  volatile uint32_t *src;
+  Ecode_t ecode;
+
+  if ((_stream != NULL) || (_acquire(obj, false) == ACQUIRE_FAIL)) {
+    return ADC_ERROR;
+  }
+  if ((config->buffer[0] == NULL) || (config->buffer[1] == NULL)
+      || (config->buffer_length == 0)
+      || (config->buffer_length > DMADRV_MAX_XFER_COUNT)
+      || (config->sample_rate == 0)
+      || (config->average > ANALOG_IN_AVERAGE_16)) {
+    return ADC_ERROR;
+  }
+
+#if defined(_SILICON_LABS_32B_SERIES_1)
+  if (obj->handle != ADC0) {
+    return ADC_ERROR;
+  }
+  src = &((ADC_TypeDef *)obj->handle)->SINGLEDATA;
+  xfer = (LDMA_TransferCfg_t)
+         LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_ADC0_SINGLE);
+#elif defined(_SILICON_LABS_32B_SERIES_2)
+  if (obj->handle != IADC0) {
+    return ADC_ERROR;
+  }
+  src = &((IADC_TypeDef *)obj->handle)->SINGLEFIFODATA;
+  xfer = (LDMA_TransferCfg_t)
+         LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
+#endif
+
+  memcpy(&stream_config, config, sizeof(analog_in_stream_config_t));
+  _stream = &stream_config;
+
+  // Reconfigure the ADC for triggered conversions
+  hal_adc_deinit(obj);
+  if (hal_adc_init(obj) != ADC_SUCCESS) {
+    return hal_adc_stream_abort(obj);
+  }
+
+  // Two descriptors linked into a ping-pong loop
+  stream_desc[0] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(src,
+                                                    config->buffer[0],
+                                                    config->buffer_length,
+                                                    1);
+  stream_desc[1] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(src,
+                                                    config->buffer[1],
+                                                    config->buffer_length,
+                                                    -1);
+  stream_desc[0].xfer.size = ldmaCtrlSizeHalf;
+  stream_desc[1].xfer.size = ldmaCtrlSizeHalf;
+
+  ecode = DMADRV_Init();
+  if ((ecode != ECODE_EMDRV_DMADRV_OK)
+      && (ecode != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED)) {
+    return hal_adc_stream_abort(obj);
+  }
+  if (DMADRV_AllocateChannel(&stream_dma_channel, NULL)
+      != ECODE_EMDRV_DMADRV_OK) {
+    return hal_adc_stream_abort(obj);
+  }
+  if (DMADRV_LdmaStartTransfer((int)stream_dma_channel,
+                               &xfer,
+                               stream_desc,
+                               hal_adc_stream_dma_callback,
+                               obj) != ECODE_EMDRV_DMADRV_OK) {
+    DMADRV_FreeChannel(stream_dma_channel);
+    return hal_adc_stream_abort(obj);
+  }
+
+  if (hal_adc_stream_trigger_start(obj) != ADC_SUCCESS) {
+    DMADRV_StopTransfer(stream_dma_channel);
+    DMADRV_FreeChannel(stream_dma_channel);
+    return hal_adc_stream_abort(obj);
+  }
+  return ADC_SUCCESS;
+}
+
+err_t analog_in_stream_stop(analog_in_t *obj)
+{
+  if ((_stream == NULL) || (_acquire(obj, false) == ACQUIRE_FAIL)) {
+    return ADC_ERROR;
+  }
+
+  hal_adc_stream_trigger_stop(obj);
+  DMADRV_StopTransfer(stream_dma_channel);
+  DMADRV_FreeChannel(stream_dma_channel);
+  _stream = NULL;
+
+  // Back to software started single conversions
+  hal_adc_deinit(obj);
+  return hal_adc_init(obj);
+}
+
+static err_t hal_adc_stream_abort(analog_in_t *obj)
+{
+  _stream = NULL;
+  hal_adc_deinit(obj);
+  hal_adc_init(obj);
+  return ADC_ERROR;
+}
+
+static bool hal_adc_stream_dma_callback(unsigned int channel,
+                                        unsigned int sequenceNo,
+                                        void *userParam)
+{
+  (void)channel;
+  analog_in_stream_config_t *stream = _stream;
+
+  if ((stream != NULL) && (stream->callback != NULL)) {
+    // sequenceNo starts at 1 for the first completed descriptor
+    if (sequenceNo & 1) {
+      stream->callback((analog_in_t *)userParam,
+                       ANALOG_IN_STREAM_HALF_COMPLETE,
+                       stream->buffer[0],
+                       stream->buffer_length,
+                       stream->user_data);
+    } else {
+      stream->callback((analog_in_t *)userParam,
+                       ANALOG_IN_STREAM_FULL_COMPLETE,
+                       stream->buffer[1],
+                       stream->buffer_length,
+                       stream->user_data);
+    }
+  }
+  return true;
+}
+
 #if defined(_SILICON_LABS_32B_SERIES_1)
 static const ADC_PosSel_TypeDef aportx_possel_table_A[] = {
   adcPosSelAPORT3XCH8,
@@ -380,6 +556,18 @@ static err_t hal_adc_init(analog_in_t *obj)
     return ADC_ERROR;
   }
 
+  if (_stream != NULL) {
+    // Conversions are started by the stream TIMER through PRS
+    initSingle.prsEnable = true;
+    initSingle.prsSel =
+      (ADC_PRSSEL_TypeDef)MIKROE_CONFIG_ADC_STREAM_PRS_CHANNEL;
+    if (_stream->average != ANALOG_IN_AVERAGE_1) {
+      // Oversampled results are 16 bit wide
+      initSingle.resolution = adcResOVS;
+      init.ovsRateSel = (ADC_OvsRateSel_TypeDef)(_stream->average - 1);
+    }
+  }
+
   uint32_t reference_voltage = (uint32_t)floor(obj->config.vref_value * 100)
                                * 10;
   if (obj->config.vref_input == ANALOG_IN_VREF_EXTERNAL) {
@@ -442,6 +630,51 @@ uint16_t hal_adc_read(analog_in_t *obj)
   return (uint16_t)ADC_DataSingleGet((ADC_TypeDef *)obj->handle);
 }
 
+static err_t hal_adc_stream_trigger_start(analog_in_t *obj)
+{
+  (void)obj;
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  uint32_t timer_freq;
+  uint32_t top;
+  uint32_t prescale = 0;
+
+  CMU_ClockEnable(cmuClock_HFPER, true);
+  CMU_ClockEnable(cmuClock_PRS, true);
+  CMU_ClockEnable(MIKROE_CONFIG_ADC_STREAM_TIMER_CLOCK, true);
+
+  // Find the smallest prescaler for which TOP fits in 16 bits
+  timer_freq = CMU_ClockFreqGet(MIKROE_CONFIG_ADC_STREAM_TIMER_CLOCK);
+  top = timer_freq / _stream->sample_rate;
+  while ((top > 0x10000) && (prescale < 10)) {
+    prescale++;
+    top = (timer_freq >> prescale) / _stream->sample_rate;
+  }
+  if ((top < 2) || (top > 0x10000)) {
+    return ADC_ERROR;
+  }
+
+  PRS_SourceSignalSet(MIKROE_CONFIG_ADC_STREAM_PRS_CHANNEL,
+                      MIKROE_CONFIG_ADC_STREAM_PRS_SOURCE,
+                      MIKROE_CONFIG_ADC_STREAM_PRS_SIGNAL,
+                      prsEdgeOff);
+
+  timer_init.enable = false;
+  timer_init.prescale = (TIMER_Prescale_TypeDef)prescale;
+  TIMER_Init(MIKROE_CONFIG_ADC_STREAM_TIMER, &timer_init);
+  TIMER_TopSet(MIKROE_CONFIG_ADC_STREAM_TIMER, top - 1);
+  TIMER_Enable(MIKROE_CONFIG_ADC_STREAM_TIMER, true);
+
+  return ADC_SUCCESS;
+}
+
+static void hal_adc_stream_trigger_stop(analog_in_t *obj)
+{
+  (void)obj;
+  TIMER_Enable(MIKROE_CONFIG_ADC_STREAM_TIMER, false);
+  TIMER_Reset(MIKROE_CONFIG_ADC_STREAM_TIMER);
+  PRS_SourceSignalSet(MIKROE_CONFIG_ADC_STREAM_PRS_CHANNEL, 0, 0, prsEdgeOff);
+}
+
 #elif defined(_SILICON_LABS_32B_SERIES_2)
 static err_t allocate_analog_bus_even0(analog_in_t *obj)
 {
@@ -630,6 +863,31 @@ static err_t hal_adc_init(analog_in_t *obj)
   initAllConfigs.configs[0].osrHighSpeed = iadcCfgOsrHighSpeed2x;
   initAllConfigs.configs[0].analogGain = iadcCfgAnalogGain1x;
 
+  if (_stream != NULL) {
+    /**
+     * The IADC local timer counts CLK_SRC_ADC cycles and triggers one
+     * single conversion per period, results are moved out by the LDMA.
+     */
+    uint32_t timer_cycles = CLK_SRC_ADC_FREQ / _stream->sample_rate;
+    if ((timer_cycles == 0) || (timer_cycles > 0xFFFF)) {
+      return ADC_ERROR;
+    }
+    init.timerCycles = (uint16_t)timer_cycles;
+#if defined(_IADC_CFG_DIGAVG_MASK)
+    initAllConfigs.configs[0].digAvg =
+      (IADC_CfgDigitalAverage_t)_stream->average;
+#else
+    if (_stream->average != ANALOG_IN_AVERAGE_1) {
+      return ADC_ERROR;
+    }
+#endif
+    initSingle.triggerSelect = iadcTriggerSelTimer;
+    initSingle.triggerAction = iadcTriggerActionOnce;
+    initSingle.dataValidLevel = iadcFifoCfgDvl1;
+    initSingle.fifoDmaWakeup = true;
+    initSingle.start = true;
+  }
+
   /**
    * CLK_SRC_ADC must be prescaled by some value greater than 1 to
    * derive the intended CLK_ADC frequency.
@@ -687,6 +945,18 @@ uint16_t hal_adc_read(analog_in_t *obj)
   return IADC_pullSingleFifoResult((IADC_TypeDef *)obj->handle).data;
 }
 
+static err_t hal_adc_stream_trigger_start(analog_in_t *obj)
+{
+  IADC_command((IADC_TypeDef *)obj->handle, iadcCmdEnableTimer);
+  return ADC_SUCCESS;
+}
+
+static void hal_adc_stream_trigger_stop(analog_in_t *obj)
+{
+  IADC_command((IADC_TypeDef *)obj->handle, iadcCmdDisableTimer);
+  IADC_command((IADC_TypeDef *)obj->handle, iadcCmdStopSingle);
+}
+
 #endif
 
 // ------------------------------------------------------------------------- END
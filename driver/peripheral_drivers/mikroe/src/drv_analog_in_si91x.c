@@ -191,6 +191,34 @@ void analog_in_close(analog_in_t *obj)
   _owner = NULL;
 }
 
+void analog_in_stream_configure_default(analog_in_stream_config_t *config)
+{
+  config->sample_rate = 1000;
+  config->average = ANALOG_IN_AVERAGE_DEFAULT;
+  config->buffer[0] = NULL;
+  config->buffer[1] = NULL;
+  config->buffer_length = 0;
+  config->callback = NULL;
+  config->user_data = NULL;
+}
+
+err_t analog_in_stream_start(analog_in_t *obj,
+                             analog_in_stream_config_t *config)
+{
+  (void)obj;
+  (void)config;
+
+  // Continuous sampling is not supported on Si91x yet
+  return ADC_ERROR;
+}
+
+err_t analog_in_stream_stop(analog_in_t *obj)
+{
+  (void)obj;
+
+  return ADC_ERROR;
+}
+
 static err_t _acquire(analog_in_t *obj, bool obj_open_state)
 {
   err_t status = ACQUIRE_SUCCESS;
@@ -85,6 +85,37 @@ extern "C" {
 // </e>
 // </h>
 
+// <h> Update settings
+
+// <q MIKROE_EINK_DISPLAY_PARTIAL_UPDATE> Partial update
+// <i> The changed bands of the GLIB frame are updated with the partial
+// <i> waveform, without flashing the whole panel.
+// <i> Default: 1
+#define MIKROE_EINK_DISPLAY_PARTIAL_UPDATE            1
+
+// <o MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL> Partial updates between full refreshes <0-255>
+// <i> Ghosting builds up with partial updates, a full refresh is done
+// <i> after this many partial updates. 0 means never.
+// <i> Default: 8
+#define MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL     8
+
+// <o MIKROE_EINK_DISPLAY_BAND_HEIGHT> Height of a dirty band (rows) <1-64>
+// <i> Changes are tracked per band of rows, only the changed columns of
+// <i> the changed bands are sent to the panel.
+// <i> Default: 8
+#define MIKROE_EINK_DISPLAY_BAND_HEIGHT               8
+
+// <o MIKROE_EINK_DISPLAY_BUSY_TIMEOUT_MS> BUSY timeout (ms) <100-60000>
+// <i> Default: 10000
+#define MIKROE_EINK_DISPLAY_BUSY_TIMEOUT_MS           10000
+
+// <o MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS> Refresh delay without BUSY (ms) <100-10000>
+// <i> Only used if EINK_DISPLAY_BSY is not configured, a refresh is taken
+// <i> as completed after this time, like the click library's fixed delays.
+// <i> Default: 200
+#define MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS          200
+// </h>
+
 // The block ends with the following line or at the end of the file:
 // <<< end of configuration section >>>
 
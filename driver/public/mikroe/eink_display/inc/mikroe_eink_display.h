@@ -47,6 +47,7 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include "sl_status.h"
 #include "mikroe_eink_display_config.h"
 
@@ -185,6 +186,15 @@ typedef eink290inch_xy_t eink_display_xy_t;
 #define EINK_DISPLAY_CMD_SET_RAM_Y_ADDRESS_COUNTER                     0x4F
 #define EINK_DISPLAY_CMD_TERMINATE_FRAME_READ_WRITE                    0xFF
 
+/* Refresh mode */
+typedef enum {
+  MIKROE_EINK_DISPLAY_REFRESH_FULL,     ///< Full waveform, the panel flashes
+  MIKROE_EINK_DISPLAY_REFRESH_PARTIAL   ///< Partial waveform, no flashing
+} mikroe_eink_display_refresh_t;
+
+/* Called from the BUSY interrupt when a refresh is completed */
+typedef void (*mikroe_eink_display_callback_t)(void);
+
 // -----------------------------------------------------------------------------
 //                       Public Functions
 // -----------------------------------------------------------------------------
@@ -292,6 +302,10 @@ sl_status_t mikroe_eink_display_start_config(void);
  * @return
  *    SL_STATUS_OK if Succeed .
  *    SL_STATUS_FAIL if failed.
+ *
+ * @note
+ *    The table is not copied, it's loaded again for full refreshes after a
+ *    partial update. A default table is used for the selected panel.
  ******************************************************************************/
 sl_status_t mikroe_eink_display_set_lut(const uint8_t *lut,
                                         uint8_t n_bytes);
@@ -334,6 +348,114 @@ sl_status_t mikroe_eink_display_set_memory_area(eink_display_xy_t *xy);
  ******************************************************************************/
 sl_status_t mikroe_eink_display_update_display();
 
+/***************************************************************************//**
+ * @brief
+ *    Set the partial update LUT table.
+ *
+ * @param[in] lut
+ *    Lut table, it's not copied
+ * @param[in] n_bytes
+ *    Number of bytes in Lut table
+ *
+ * @return
+ *    SL_STATUS_OK if Succeed .
+ *    SL_STATUS_NULL_POINTER if lut is NULL.
+ *
+ * @note
+ *    A default table is used for the selected panel. The table passed to
+ *    \ref mikroe_eink_display_set_lut() is used for full refreshes.
+ ******************************************************************************/
+sl_status_t mikroe_eink_display_set_partial_lut(const uint8_t *lut,
+                                                uint8_t n_bytes);
+
+/***************************************************************************//**
+ * @brief
+ *    Write a window of a frame to the display RAM.
+ *
+ * @param[in] frame
+ *    Frame buffer, 1 bit per pixel, MSB first, row by row
+ * @param[in] stride
+ *    Number of bytes in a row of the frame buffer
+ * @param[in] x_start
+ *    First column, rounded down to a multiple of 8
+ * @param[in] y_start
+ *    First row
+ * @param[in] x_end
+ *    Last column, rounded up to the end of its byte
+ * @param[in] y_end
+ *    Last row
+ *
+ * @return
+ *    SL_STATUS_OK if Succeed .
+ *    SL_STATUS_NULL_POINTER if frame is NULL.
+ *    SL_STATUS_INVALID_PARAMETER if the window is empty.
+ *    SL_STATUS_TIMEOUT if the previous refresh is not completed.
+ *
+ * @note
+ *    Only the window is sent, the rest of the display RAM is left intact.
+ *    The controller toggles between two RAM banks on each refresh, so a
+ *    window shall also be written before the next refresh.
+ ******************************************************************************/
+sl_status_t mikroe_eink_display_write_window(const uint8_t *frame,
+                                             uint16_t stride,
+                                             uint16_t x_start,
+                                             uint16_t y_start,
+                                             uint16_t x_end,
+                                             uint16_t y_end);
+
+/***************************************************************************//**
+ * @brief
+ *    Start refreshing the display from its RAM.
+ *
+ * @param[in] mode
+ *    MIKROE_EINK_DISPLAY_REFRESH_FULL or MIKROE_EINK_DISPLAY_REFRESH_PARTIAL
+ *
+ * @return
+ *    SL_STATUS_OK if the refresh is started.
+ *    SL_STATUS_INVALID_PARAMETER if mode is invalid.
+ *    SL_STATUS_TIMEOUT if the previous refresh is not completed.
+ *
+ * @note
+ *    The LUT of the mode is loaded if another one is loaded. It returns
+ *    without waiting for the refresh, the callback set by
+ *    \ref mikroe_eink_display_set_callback() is called from the BUSY
+ *    interrupt when it's completed.
+ ******************************************************************************/
+sl_status_t mikroe_eink_display_refresh(mikroe_eink_display_refresh_t mode);
+
+/***************************************************************************//**
+ * @brief
+ *    Set the callback called when a refresh is completed.
+ *
+ * @param[in] callback
+ *    Callback, NULL to disable it
+ ******************************************************************************/
+void mikroe_eink_display_set_callback(mikroe_eink_display_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *    Is the display busy?
+ *
+ * @note
+ *    A refresh counts as busy from MASTER_ACTIVATION on, before the panel
+ *    raises BUSY, until BUSY is released.
+ ******************************************************************************/
+bool mikroe_eink_display_is_busy(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Wait in low power mode until the display is not busy.
+ *
+ * @return
+ *    SL_STATUS_OK if Succeed .
+ *    SL_STATUS_TIMEOUT if BUSY is not released in
+ *    MIKROE_EINK_DISPLAY_BUSY_TIMEOUT_MS.
+ *
+ * @note
+ *    The functions of this driver sending a command call it first.
+ ******************************************************************************/
+sl_status_t mikroe_eink_display_wait_idle(void);
+
 /***************************************************************************//**
  * @brief
  *    Function that fills the screen.
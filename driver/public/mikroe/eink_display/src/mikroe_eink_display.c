@@ -42,6 +42,27 @@
 // -----------------------------------------------------------------------------
 
 #include "mikroe_eink_display.h"
+#include "sl_sleeptimer.h"
+
+#if (!defined(SLI_SI917))
+#include "em_core.h"
+#include "em_emu.h"
+#endif
+
+#if defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN)
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define EINK_DISPLAY_BSY_INTR_NO      5 // M4 Pin interrupt number
+#define EINK_DISPLAY_BSY_AVL_INTR_NO  0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
+// Time a refresh is assumed to take when BUSY is not connected
+#ifndef MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS
+#define MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS  200
+#endif
 
 #if (CONFIG_EINK_DISPLAY_RESOLUTION == EINK_DISPLAY_1_54_INCH)
 #define EINK154_DUMMY               0
@@ -53,6 +74,16 @@
 #include "esl_tag_core.h"
 #endif
 #endif
+// Display update sequence, the same as the click library's
+#if (CONFIG_EINK_DISPLAY_RESOLUTION == EINK_DISPLAY_1_54_INCH)
+#define EINK_DISPLAY_UPDATE_SEQUENCE  0xC4
+#else
+#define EINK_DISPLAY_UPDATE_SEQUENCE  0xC7
+#endif
+
+// RAM address counters are incremented in X then in Y direction
+#define EINK_DISPLAY_DATA_ENTRY_X_Y_INC  0x03
+
 // -----------------------------------------------------------------------------
 //                       Local Variables
 // -----------------------------------------------------------------------------
@@ -61,6 +92,149 @@ static eink_display_t eink_ctx;
 static eink_display_cfg_t eink_cfg;
 static bool initialized = false;
 
+// Reference waveforms of the panels
+#if (CONFIG_EINK_DISPLAY_RESOLUTION == EINK_DISPLAY_2_13_INCH)
+static const uint8_t default_full_lut[30] =
+{
+  0x22, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x11,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+static const uint8_t default_partial_lut[30] =
+{
+  0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0F, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+#else
+static const uint8_t default_full_lut[30] =
+{
+  0x02, 0x02, 0x01, 0x11, 0x12, 0x12, 0x22, 0x22,
+  0x66, 0x69, 0x69, 0x59, 0x58, 0x99, 0x99, 0x88,
+  0x00, 0x00, 0x00, 0x00, 0xF8, 0xB4, 0x13, 0x51,
+  0x35, 0x51, 0x51, 0x19, 0x01, 0x00
+};
+
+static const uint8_t default_partial_lut[30] =
+{
+  0x10, 0x18, 0x18, 0x08, 0x18, 0x18, 0x08, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x13, 0x14, 0x44, 0x12,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+#endif
+
+static const uint8_t *full_lut = default_full_lut;
+static uint8_t full_lut_size = sizeof(default_full_lut);
+static const uint8_t *partial_lut = default_partial_lut;
+static uint8_t partial_lut_size = sizeof(default_partial_lut);
+
+// LUT in the controller, NULL if it's unknown
+static const uint8_t *loaded_lut = NULL;
+
+static mikroe_eink_display_callback_t refresh_callback = NULL;
+static volatile bool refresh_pending = false;
+static volatile bool busy_timeout = false;
+static sl_sleeptimer_timer_handle_t busy_timer;
+#if !(defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN))
+static sl_sleeptimer_timer_handle_t refresh_timer;
+#endif
+
+// -----------------------------------------------------------------------------
+//                       Local Functions
+// -----------------------------------------------------------------------------
+
+#if defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN)
+
+/***************************************************************************//**
+ * BUSY interrupt handler, BUSY is released on the falling edge
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+static void eink_display_busy_handler(uint32_t int_no)
+#else
+static void eink_display_busy_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  if (refresh_pending && !digital_in_read(&eink_ctx.bsy)) {
+    refresh_pending = false;
+    if (refresh_callback != NULL) {
+      refresh_callback();
+    }
+  }
+}
+
+#else
+
+/***************************************************************************//**
+ * Refresh delay elapsed, stands in for BUSY when the pin is not connected
+ ******************************************************************************/
+static void eink_display_refresh_elapsed(sl_sleeptimer_timer_handle_t *handle,
+                                         void *data)
+{
+  (void)handle;
+  (void)data;
+
+  if (refresh_pending) {
+    refresh_pending = false;
+    if (refresh_callback != NULL) {
+      refresh_callback();
+    }
+  }
+}
+
+#endif
+
+static void eink_display_busy_timeout(sl_sleeptimer_timer_handle_t *handle,
+                                      void *data)
+{
+  (void)handle;
+  (void)data;
+
+  busy_timeout = true;
+}
+
+/***************************************************************************//**
+ * Load a LUT unless it's loaded already.
+ ******************************************************************************/
+static void eink_display_load_lut(const uint8_t *lut, uint8_t n_bytes)
+{
+  if (lut != loaded_lut) {
+    eink_display_set_lut(&eink_ctx, lut, n_bytes);
+    loaded_lut = lut;
+  }
+}
+
+/***************************************************************************//**
+ * Wait for the display and restore the full LUT after partial updates, the
+ * click library's functions always refresh the whole display.
+ ******************************************************************************/
+static sl_status_t eink_display_prepare_full_update(void)
+{
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
+  if (loaded_lut == partial_lut) {
+    eink_display_load_lut(full_lut, full_lut_size);
+  }
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Send data bytes within a single chip select.
+ ******************************************************************************/
+static void eink_display_write_data(const uint8_t *data, uint16_t len)
+{
+  digital_out_high(&eink_ctx.dc);
+  spi_master_select_device(eink_ctx.chip_select);
+  spi_master_write(&eink_ctx.spi, (uint8_t *)data, len);
+  spi_master_deselect_device(eink_ctx.chip_select);
+}
+
 // -----------------------------------------------------------------------------
 //                       Public Functions
 // -----------------------------------------------------------------------------
@@ -104,6 +278,28 @@ sl_status_t mikroe_eink_display_init(mikroe_spi_handle_t spi_instance)
   if (eink_display_init(&eink_ctx, &eink_cfg) != EINK_DISPLAY_OK) {
     return SL_STATUS_INITIALIZATION;
   }
+
+#if defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN)
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { EINK_DISPLAY_BSY_PIN / 16,
+                              EINK_DISPLAY_BSY_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     EINK_DISPLAY_BSY_INTR_NO,
+                                     SL_GPIO_INTERRUPT_FALLING_EDGE,
+                                     eink_display_busy_handler,
+                                     EINK_DISPLAY_BSY_AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(EINK_DISPLAY_BSY_PIN, eink_display_busy_handler);
+  GPIO_ExtIntConfig(EINK_DISPLAY_BSY_PORT,
+                    EINK_DISPLAY_BSY_PIN,
+                    EINK_DISPLAY_BSY_PIN,
+                    false,
+                    true,
+                    true);
+#endif
+#endif
+
   initialized = true;
 
   return SL_STATUS_OK;
@@ -114,6 +310,9 @@ sl_status_t mikroe_eink_display_init(mikroe_spi_handle_t spi_instance)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_send_command(uint8_t command)
 {
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_send_command(&eink_ctx, command);
   return SL_STATUS_OK;
 }
@@ -133,6 +332,7 @@ sl_status_t mikroe_eink_display_send_data(uint8_t data)
 sl_status_t mikroe_eink_display_reset(void)
 {
   eink_display_reset(&eink_ctx);
+  loaded_lut = NULL;
   return SL_STATUS_OK;
 }
 
@@ -141,6 +341,9 @@ sl_status_t mikroe_eink_display_reset(void)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_sleep_mode(void)
 {
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_sleep_mode(&eink_ctx);
   return SL_STATUS_OK;
 }
@@ -151,6 +354,7 @@ sl_status_t mikroe_eink_display_sleep_mode(void)
 sl_status_t mikroe_eink_display_start_config(void)
 {
   eink_display_start_config(&eink_ctx);
+  loaded_lut = NULL;
   return SL_STATUS_OK;
 }
 
@@ -159,7 +363,27 @@ sl_status_t mikroe_eink_display_start_config(void)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_set_lut(const uint8_t *lut, uint8_t n_bytes)
 {
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_set_lut(&eink_ctx, lut, n_bytes);
+  full_lut = lut;
+  full_lut_size = n_bytes;
+  loaded_lut = lut;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+*  E-Paper set partial update lut.
+******************************************************************************/
+sl_status_t mikroe_eink_display_set_partial_lut(const uint8_t *lut,
+                                                uint8_t n_bytes)
+{
+  if (lut == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  partial_lut = lut;
+  partial_lut_size = n_bytes;
   return SL_STATUS_OK;
 }
 
@@ -168,6 +392,9 @@ sl_status_t mikroe_eink_display_set_lut(const uint8_t *lut, uint8_t n_bytes)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_set_memory_pointer(uint8_t x, uint8_t y)
 {
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_set_mem_pointer(&eink_ctx, x, y);
   return SL_STATUS_OK;
 }
@@ -177,6 +404,9 @@ sl_status_t mikroe_eink_display_set_memory_pointer(uint8_t x, uint8_t y)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_set_memory_area(eink_display_xy_t *xy)
 {
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_set_mem_area(&eink_ctx, xy);
   return SL_STATUS_OK;
 }
@@ -186,6 +416,9 @@ sl_status_t mikroe_eink_display_set_memory_area(eink_display_xy_t *xy)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_update_display(void)
 {
+  if (eink_display_prepare_full_update() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_update_display(&eink_ctx);
   return SL_STATUS_OK;
 }
@@ -195,6 +428,9 @@ sl_status_t mikroe_eink_display_update_display(void)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_fill_screen(uint8_t color)
 {
+  if (eink_display_prepare_full_update() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_fill_screen(&eink_ctx, color);
   return SL_STATUS_OK;
 }
@@ -204,10 +440,187 @@ sl_status_t mikroe_eink_display_fill_screen(uint8_t color)
 ******************************************************************************/
 sl_status_t mikroe_eink_display_display_image(const uint8_t *image_buffer)
 {
+  if (eink_display_prepare_full_update() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
   eink_display_display_image(&eink_ctx, image_buffer);
   return SL_STATUS_OK;
 }
 
+/**************************************************************************//**
+*  E-Paper write window.
+******************************************************************************/
+sl_status_t mikroe_eink_display_write_window(const uint8_t *frame,
+                                             uint16_t stride,
+                                             uint16_t x_start,
+                                             uint16_t y_start,
+                                             uint16_t x_end,
+                                             uint16_t y_end)
+{
+  uint8_t x_byte_start = (uint8_t)(x_start >> 3);
+  uint8_t x_byte_end = (uint8_t)(x_end >> 3);
+
+  if (frame == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if ((x_start > x_end) || (y_start > y_end) || (x_byte_end >= stride)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
+
+  // The click libraries may decrement Y, rows are written top to bottom here
+  eink_display_send_command(&eink_ctx,
+                            EINK_DISPLAY_CMD_DATA_ENTRY_MODE_SETTING);
+  eink_display_send_data(&eink_ctx, EINK_DISPLAY_DATA_ENTRY_X_Y_INC);
+
+  eink_display_send_command(
+    &eink_ctx,
+    EINK_DISPLAY_CMD_SET_RAM_X_ADDRESS_START_END_POSITION);
+  eink_display_send_data(&eink_ctx, x_byte_start);
+  eink_display_send_data(&eink_ctx, x_byte_end);
+  eink_display_send_command(
+    &eink_ctx,
+    EINK_DISPLAY_CMD_SET_RAM_Y_ADDRESS_START_END_POSITION);
+  eink_display_send_data(&eink_ctx, y_start & 0xFF);
+  eink_display_send_data(&eink_ctx, (y_start >> 8) & 0xFF);
+  eink_display_send_data(&eink_ctx, y_end & 0xFF);
+  eink_display_send_data(&eink_ctx, (y_end >> 8) & 0xFF);
+
+  // Set the counters directly, the click library waits 100 ms for BUSY
+  eink_display_send_command(&eink_ctx,
+                            EINK_DISPLAY_CMD_SET_RAM_X_ADDRESS_COUNTER);
+  eink_display_send_data(&eink_ctx, x_byte_start);
+  eink_display_send_command(&eink_ctx,
+                            EINK_DISPLAY_CMD_SET_RAM_Y_ADDRESS_COUNTER);
+  eink_display_send_data(&eink_ctx, y_start & 0xFF);
+  eink_display_send_data(&eink_ctx, (y_start >> 8) & 0xFF);
+
+  eink_display_send_command(&eink_ctx, EINK_DISPLAY_CMD_WRITE_RAM);
+  for (uint16_t y = y_start; y <= y_end; y++) {
+    eink_display_write_data(&frame[(uint32_t)y * stride + x_byte_start],
+                            x_byte_end - x_byte_start + 1);
+  }
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+*  E-Paper start refresh.
+******************************************************************************/
+sl_status_t mikroe_eink_display_refresh(mikroe_eink_display_refresh_t mode)
+{
+  if (mikroe_eink_display_wait_idle() != SL_STATUS_OK) {
+    return SL_STATUS_TIMEOUT;
+  }
+
+  switch (mode) {
+    case MIKROE_EINK_DISPLAY_REFRESH_FULL:
+      // Keep the LUT set by the application or the controller's default
+      if (loaded_lut == partial_lut) {
+        eink_display_load_lut(full_lut, full_lut_size);
+      }
+      break;
+
+    case MIKROE_EINK_DISPLAY_REFRESH_PARTIAL:
+      eink_display_load_lut(partial_lut, partial_lut_size);
+      break;
+
+    default:
+      return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  eink_display_send_command(&eink_ctx,
+                            EINK_DISPLAY_CMD_DISPLAY_UPDATE_CONTROL_2);
+  eink_display_send_data(&eink_ctx, EINK_DISPLAY_UPDATE_SEQUENCE);
+  refresh_pending = true;
+  eink_display_send_command(&eink_ctx, EINK_DISPLAY_CMD_MASTER_ACTIVATION);
+  eink_display_send_command(&eink_ctx,
+                            EINK_DISPLAY_CMD_TERMINATE_FRAME_READ_WRITE);
+#if !(defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN))
+  sl_sleeptimer_start_timer_ms(&refresh_timer,
+                               MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS,
+                               eink_display_refresh_elapsed,
+                               NULL,
+                               0,
+                               0);
+#endif
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+*  E-Paper set refresh callback.
+******************************************************************************/
+void mikroe_eink_display_set_callback(mikroe_eink_display_callback_t callback)
+{
+  refresh_callback = callback;
+}
+
+/**************************************************************************//**
+*  E-Paper busy state.
+******************************************************************************/
+bool mikroe_eink_display_is_busy(void)
+{
+#if defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN)
+  // BUSY goes high some time after MASTER_ACTIVATION, a refresh is pending
+  // from the activation until the falling edge of BUSY
+  return refresh_pending || (digital_in_read(&eink_ctx.bsy) != 0);
+#else
+  return refresh_pending;
+#endif
+}
+
+/**************************************************************************//**
+*  E-Paper wait until not busy.
+******************************************************************************/
+sl_status_t mikroe_eink_display_wait_idle(void)
+{
+  if (!mikroe_eink_display_is_busy()) {
+    return SL_STATUS_OK;
+  }
+
+  busy_timeout = false;
+  sl_sleeptimer_start_timer_ms(&busy_timer,
+                               MIKROE_EINK_DISPLAY_BUSY_TIMEOUT_MS,
+                               eink_display_busy_timeout,
+                               NULL,
+                               0,
+                               0);
+
+  // A pending interrupt wakes the core even if it's masked, so BUSY or the
+  // refresh delay can't end between the check and going to sleep
+#if (defined(SLI_SI917))
+  __disable_irq();
+  while (mikroe_eink_display_is_busy() && !busy_timeout) {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __enable_irq();
+#else
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  while (mikroe_eink_display_is_busy() && !busy_timeout) {
+    EMU_EnterEM1();
+    CORE_EXIT_ATOMIC();
+    CORE_ENTER_ATOMIC();
+  }
+  CORE_EXIT_ATOMIC();
+#endif
+
+  sl_sleeptimer_stop_timer(&busy_timer);
+  sl_status_t sc = mikroe_eink_display_is_busy()
+                   ? SL_STATUS_TIMEOUT : SL_STATUS_OK;
+#if defined(EINK_DISPLAY_BSY_PORT) && defined(EINK_DISPLAY_BSY_PIN)
+  // BUSY never went high, don't wait for a falling edge on the next call
+  if (refresh_pending && !digital_in_read(&eink_ctx.bsy)) {
+    refresh_pending = false;
+  }
+#endif
+  return sc;
+}
+
 /**************************************************************************//**
 *  E-Paper display image for ESL.
 ******************************************************************************/
@@ -37,14 +37,53 @@
 #include "mikroe_eink_display.h"
 #include "oled_display.h"
 
+/* The frame buffer is in the orientation of the display RAM, landscape
+ * frames are rotated. */
+#if (MIKROE_EINK_DISPLAY_WIDTH > MIKROE_EINK_DISPLAY_HEIGHT)
+#define EINK_FRAME_ROTATED          1
+#define EINK_FRAME_WIDTH            MIKROE_EINK_DISPLAY_HEIGHT
+#define EINK_FRAME_HEIGHT           MIKROE_EINK_DISPLAY_WIDTH
+#else
+#define EINK_FRAME_ROTATED          0
+#define EINK_FRAME_WIDTH            MIKROE_EINK_DISPLAY_WIDTH
+#define EINK_FRAME_HEIGHT           MIKROE_EINK_DISPLAY_HEIGHT
+#endif
+
+#define EINK_FRAME_STRIDE           ((EINK_FRAME_WIDTH + 7) / 8)
+#define EINK_BAND_COUNT             ((EINK_FRAME_HEIGHT                     \
+                                      + MIKROE_EINK_DISPLAY_BAND_HEIGHT - 1) \
+                                     / MIKROE_EINK_DISPLAY_BAND_HEIGHT)
+
+/* Bytes sent to set up a window besides its data */
+#define EINK_WINDOW_OVERHEAD        14
+
+/* Changed byte columns of a band, x_start > x_end if nothing changed */
+typedef struct {
+  uint8_t x_start;
+  uint8_t x_end;
+} eink_band_t;
+
 /* This oled_frame_buffer is large enough to store one full frame. */
-static uint8_t oled_frame_buffer[(MIKROE_EINK_DISPLAY_WIDTH
-                                  * MIKROE_EINK_DISPLAY_HEIGHT) / 8];
+static uint8_t oled_frame_buffer[EINK_FRAME_STRIDE * EINK_FRAME_HEIGHT];
+
+/* Bands changed since the last update */
+static eink_band_t dirty_bands[EINK_BAND_COUNT];
+
+/* Bands written by the last update, the controller toggles between two RAM
+ * banks on each refresh, so they are also written to the other bank by the
+ * next update. */
+static eink_band_t written_bands[EINK_BAND_COUNT];
+
+static uint8_t partial_updates;
+static bool full_refresh_pending;
 
 static sl_status_t driver_init(void);
 static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color);
 static sl_status_t fill_screen(uint16_t color);
 static sl_status_t update_display(void);
+static void mark_all_bands(eink_band_t *bands);
+static sl_status_t write_window(uint8_t x_start, uint8_t x_end,
+                                uint16_t y_start, uint16_t y_end);
 
 static oled_display_t oled_display_instance;
 static const oled_display_driver_api_t sl_memlcd_driver_api =
@@ -75,6 +114,13 @@ sl_status_t oled_display_init(void)
   oled_display_instance.width = MIKROE_EINK_DISPLAY_WIDTH;
   oled_display_instance.height = MIKROE_EINK_DISPLAY_HEIGHT;
   oled_display_instance.driver = &sl_memlcd_driver_api;
+
+  /* The content of both RAM banks is unknown, the first update is a full
+   * refresh of the whole frame. */
+  mark_all_bands(dirty_bands);
+  mark_all_bands(written_bands);
+  partial_updates = 0;
+  full_refresh_pending = true;
   initialized = true;
   return SL_STATUS_OK;
 }
@@ -83,13 +129,31 @@ static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color)
 {
   uint16_t off;
   uint16_t pos;
+  uint8_t value;
+  eink_band_t *band;
 
   if ((x >= 0) && (x < MIKROE_EINK_DISPLAY_WIDTH) && (y >= 0)
       && (y < MIKROE_EINK_DISPLAY_HEIGHT)) {
-    pos = (y * (MIKROE_EINK_DISPLAY_WIDTH / 8)) + (x / 8);
+#if EINK_FRAME_ROTATED
+    int16_t tmp = x;
+
+    x = EINK_FRAME_WIDTH - 1 - y;
+    y = tmp;
+#endif
+    pos = (y * EINK_FRAME_STRIDE) + (x / 8);
     off = 7 - (x % 8);
-    oled_frame_buffer[pos] &= ~(0x01 << off);
-    oled_frame_buffer[pos] |= ((color & 0x01) << off);
+    value = oled_frame_buffer[pos] & ~(0x01 << off);
+    value |= ((color & 0x01) << off);
+    if (value != oled_frame_buffer[pos]) {
+      oled_frame_buffer[pos] = value;
+      band = &dirty_bands[y / MIKROE_EINK_DISPLAY_BAND_HEIGHT];
+      if (band->x_start > (x / 8)) {
+        band->x_start = x / 8;
+      }
+      if (band->x_end < (x / 8)) {
+        band->x_end = x / 8;
+      }
+    }
   }
   return SL_STATUS_OK;
 }
@@ -100,29 +164,148 @@ static sl_status_t fill_screen(uint16_t color)
 
   /* Fill the display with the background color of the glib_context_t  */
   for (i = 0; i < sizeof(oled_frame_buffer); i++) {
-    oled_frame_buffer[i] = (uint8_t)color;
+    if (oled_frame_buffer[i] != (uint8_t)color) {
+      memset(oled_frame_buffer, (uint8_t)color, sizeof(oled_frame_buffer));
+      mark_all_bands(dirty_bands);
+      break;
+    }
   }
   return SL_STATUS_OK;
 }
 
 static sl_status_t update_display(void)
 {
-  eink_display_xy_t xy;
+  mikroe_eink_display_refresh_t mode = MIKROE_EINK_DISPLAY_REFRESH_PARTIAL;
+  eink_band_t band;
+  uint8_t x_start = 0;
+  uint8_t x_end = 0;
+  uint16_t y_start = 0;
+  uint16_t y_end = 0;
+  bool open = false;
+  bool changed = false;
+  sl_status_t sc = SL_STATUS_OK;
+
+  for (uint16_t i = 0; i < EINK_BAND_COUNT; i++) {
+    if (dirty_bands[i].x_start <= dirty_bands[i].x_end) {
+      changed = true;
+      break;
+    }
+  }
+  if (!changed) {
+    return SL_STATUS_OK;
+  }
+
+  if ((MIKROE_EINK_DISPLAY_PARTIAL_UPDATE == 0) || full_refresh_pending
+      || ((MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL != 0)
+          && (partial_updates >= MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL))) {
+    mode = MIKROE_EINK_DISPLAY_REFRESH_FULL;
+  }
+
+  /* Adjacent bands are merged into a window if it's cheaper than sending
+   * them separately. */
+  for (uint16_t i = 0; i < EINK_BAND_COUNT; i++) {
+    uint16_t band_y_start = i * MIKROE_EINK_DISPLAY_BAND_HEIGHT;
+    uint16_t band_y_end = band_y_start + MIKROE_EINK_DISPLAY_BAND_HEIGHT - 1;
+
+    if (band_y_end >= EINK_FRAME_HEIGHT) {
+      band_y_end = EINK_FRAME_HEIGHT - 1;
+    }
 
-  xy.x_start = 0;
-  xy.y_start = 0;
-  xy.x_end = MIKROE_EINK_DISPLAY_WIDTH - 1;
-  xy.y_end = MIKROE_EINK_DISPLAY_HEIGHT - 1;
+    band = dirty_bands[i];
+    if (written_bands[i].x_start < band.x_start) {
+      band.x_start = written_bands[i].x_start;
+    }
+    if (written_bands[i].x_end > band.x_end) {
+      band.x_end = written_bands[i].x_end;
+    }
+    written_bands[i] = dirty_bands[i];
+    dirty_bands[i].x_start = UINT8_MAX;
+    dirty_bands[i].x_end = 0;
 
-  mikroe_eink_display_set_memory_area(&xy);
-  mikroe_eink_display_set_memory_pointer(0, 0);
-  mikroe_eink_display_send_command(EINK_DISPLAY_CMD_WRITE_RAM);
+    if (band.x_start > band.x_end) {
+      if (open) {
+        sc = write_window(x_start, x_end, y_start, y_end);
+        if (sc != SL_STATUS_OK) {
+          break;
+        }
+        open = false;
+      }
+      continue;
+    }
 
-  for (uint16_t i = 0; i < sizeof(oled_frame_buffer); i++ )
-  {
-    mikroe_eink_display_send_data(oled_frame_buffer[i]);
+    if (open) {
+      uint8_t merged_x_start = (band.x_start < x_start)
+                               ? band.x_start : x_start;
+      uint8_t merged_x_end = (band.x_end > x_end) ? band.x_end : x_end;
+      uint32_t merged = (uint32_t)(band_y_end - y_start + 1)
+                        * (merged_x_end - merged_x_start + 1);
+      uint32_t separate = (uint32_t)(y_end - y_start + 1)
+                          * (x_end - x_start + 1)
+                          + (uint32_t)(band_y_end - band_y_start + 1)
+                          * (band.x_end - band.x_start + 1)
+                          + EINK_WINDOW_OVERHEAD;
+
+      if (merged <= separate) {
+        x_start = merged_x_start;
+        x_end = merged_x_end;
+        y_end = band_y_end;
+        continue;
+      }
+      sc = write_window(x_start, x_end, y_start, y_end);
+      if (sc != SL_STATUS_OK) {
+        break;
+      }
+    }
+    x_start = band.x_start;
+    x_end = band.x_end;
+    y_start = band_y_start;
+    y_end = band_y_end;
+    open = true;
+  }
+  if (open && (sc == SL_STATUS_OK)) {
+    sc = write_window(x_start, x_end, y_start, y_end);
+  }
+  if (sc != SL_STATUS_OK) {
+    /* The display RAM is not known to match the frame anymore */
+    mark_all_bands(dirty_bands);
+    mark_all_bands(written_bands);
+    full_refresh_pending = true;
+    return sc;
+  }
+
+  if (mode == MIKROE_EINK_DISPLAY_REFRESH_FULL) {
+    full_refresh_pending = false;
+    partial_updates = 0;
+  } else {
+    partial_updates++;
+  }
+
+  sc = mikroe_eink_display_refresh(mode);
+  if (sc != SL_STATUS_OK) {
+    return sc;
   }
-  return mikroe_eink_display_update_display();
+
+  /* GLIB expects the display to show the frame when this returns. */
+  return mikroe_eink_display_wait_idle();
+}
+
+static void mark_all_bands(eink_band_t *bands)
+{
+  for (uint16_t i = 0; i < EINK_BAND_COUNT; i++) {
+    bands[i].x_start = 0;
+    bands[i].x_end = EINK_FRAME_STRIDE - 1;
+  }
+}
+
+static sl_status_t write_window(uint8_t x_start, uint8_t x_end,
+                                uint16_t y_start, uint16_t y_end)
+{
+  return mikroe_eink_display_write_window(oled_frame_buffer,
+                                          EINK_FRAME_STRIDE,
+                                          x_start * 8,
+                                          y_start,
+                                          x_end * 8 + 7,
+                                          y_end);
 }
 
 const oled_display_t *oled_display_get(void)
@@ -0,0 +1,458 @@
+/***************************************************************************//**
+ * @file mikroe_eink_display_test.c
+ * @brief Host test of the windowed partial refresh of the E-Paper display
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+// Host test of the windowed partial refresh.
+//
+// The GLIB frame of the oled_display adapter is drawn into and updated, the
+// SPI traffic goes to a model of the controller: two RAM banks swapped by
+// MASTER_ACTIVATION, the RAM window and address counters. After each update
+// the shown bank must match the drawn pixels, and the bytes sent over SPI
+// are counted for the full and the partial updates.
+//
+// The panel raises BUSY only some reads after MASTER_ACTIVATION and keeps it
+// high for PANEL_REFRESH_MS. A command sent while a refresh is running fails
+// the test. Built with -DEINK_TEST_BSY the driver waits on BUSY, otherwise
+// on the MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS timer.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mikroe_eink_display.h"
+#include "oled_display.h"
+#include "sl_sleeptimer.h"
+#include "em_emu.h"
+#include "gpiointerrupt.h"
+
+#define FRAME_WIDTH           MIKROE_EINK_DISPLAY_WIDTH
+#define FRAME_HEIGHT          MIKROE_EINK_DISPLAY_HEIGHT
+#define FRAME_STRIDE          ((FRAME_WIDTH + 7) / 8)
+
+// The panel takes this long to refresh and raises BUSY only on this read
+// after MASTER_ACTIVATION
+#define PANEL_REFRESH_MS      150
+#define PANEL_BUSY_READS      3
+
+// Bound of the bytes of a partial update of the 48x16 price field, both RAM
+// banks are written with the field and its previous window
+#define PARTIAL_MAX_BYTES     256
+
+#define TIMER_COUNT           2
+
+// Data entry mode of the windows and first byte of the partial waveform
+#define DATA_ENTRY_X_Y_INC    0x03
+#define PARTIAL_LUT_FIRST     0x10
+
+typedef struct {
+  sl_sleeptimer_timer_handle_t *handle;
+  sl_sleeptimer_timer_callback_t callback;
+  void *data;
+  uint32_t deadline;
+} test_timer_t;
+
+// Controller model
+static uint8_t ram[2][FRAME_HEIGHT][FRAME_STRIDE];
+static uint8_t shown[FRAME_HEIGHT][FRAME_STRIDE];
+static int bank;
+static uint8_t command;
+static uint8_t params[4];
+static int param_count;
+static int x_start, x_end, x_counter, y_counter;
+static const uint8_t *lut;
+
+// Panel timing model
+static uint32_t now_ms;
+static bool refreshing;
+static uint32_t refresh_end_ms;
+static int busy_reads;
+static GPIOINT_IrqCallbackPtr_t busy_irq;
+static test_timer_t timers[TIMER_COUNT];
+
+// Counters
+static long spi_bytes;
+static long refreshes;
+static long full_refreshes;
+static long callbacks;
+static int errors;
+
+// Expected pixels in the GLIB orientation
+static uint8_t model[FRAME_HEIGHT][FRAME_WIDTH];
+static const oled_display_driver_api_t *driver;
+
+static void fail(const char *what)
+{
+  printf("FAIL: %s\n", what);
+  errors++;
+}
+
+static void data_byte(uint8_t data)
+{
+  spi_bytes++;
+  if (command == EINK_DISPLAY_CMD_WRITE_RAM) {
+    if ((y_counter >= FRAME_HEIGHT) || (x_counter >= FRAME_STRIDE)) {
+      fail("RAM write outside of the frame");
+      return;
+    }
+    ram[bank][y_counter][x_counter] = data;
+    if (++x_counter > x_end) {
+      x_counter = x_start;
+      y_counter++;
+    }
+    return;
+  }
+  if (param_count < (int)sizeof(params)) {
+    params[param_count++] = data;
+  }
+  switch (command) {
+    case EINK_DISPLAY_CMD_SET_RAM_X_ADDRESS_START_END_POSITION:
+      x_start = params[0];
+      x_end = params[1];
+      break;
+    case EINK_DISPLAY_CMD_SET_RAM_X_ADDRESS_COUNTER:
+      x_counter = params[0];
+      break;
+    case EINK_DISPLAY_CMD_SET_RAM_Y_ADDRESS_COUNTER:
+      y_counter = params[0] | (params[1] << 8);
+      break;
+    case EINK_DISPLAY_CMD_DATA_ENTRY_MODE_SETTING:
+      if (data != DATA_ENTRY_X_Y_INC) {
+        fail("unexpected data entry mode");
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//                       Click library and platform stubs
+// -----------------------------------------------------------------------------
+
+void eink154inch_send_cmd(eink154inch_t *ctx, uint8_t cmd)
+{
+  (void)ctx;
+  if (refreshing && (cmd != EINK_DISPLAY_CMD_TERMINATE_FRAME_READ_WRITE)) {
+    fail("command sent during a refresh");
+  }
+  spi_bytes++;
+  command = cmd;
+  param_count = 0;
+  if (cmd == EINK_DISPLAY_CMD_MASTER_ACTIVATION) {
+    memcpy(shown, ram[bank], sizeof(shown));
+    bank ^= 1;
+    refreshing = true;
+    refresh_end_ms = now_ms + PANEL_REFRESH_MS;
+    busy_reads = 0;
+    refreshes++;
+    if ((lut == NULL) || (lut[0] != PARTIAL_LUT_FIRST)) {
+      full_refreshes++;
+    }
+  }
+}
+
+void eink154inch_send_data(eink154inch_t *ctx, uint8_t c_data)
+{
+  (void)ctx;
+  data_byte(c_data);
+}
+
+void eink154inch_set_lut(eink154inch_t *ctx, const uint8_t *data,
+                         uint8_t n_bytes)
+{
+  eink154inch_send_cmd(ctx, EINK_DISPLAY_CMD_WRITE_LUT_REGISTER);
+  spi_bytes += n_bytes;
+  lut = data;
+}
+
+void digital_out_high(digital_out_t *out)
+{
+  (void)out;
+}
+
+void digital_out_low(digital_out_t *out)
+{
+  (void)out;
+}
+
+uint8_t digital_in_read(digital_in_t *in)
+{
+  (void)in;
+  if (!refreshing) {
+    return 0;
+  }
+  return ++busy_reads >= PANEL_BUSY_READS;
+}
+
+void spi_master_select_device(pin_name_t chip_select)
+{
+  (void)chip_select;
+}
+
+void spi_master_deselect_device(pin_name_t chip_select)
+{
+  (void)chip_select;
+}
+
+err_t spi_master_write(spi_master_t *obj, uint8_t *write_data_buf,
+                       size_t len_write_data)
+{
+  (void)obj;
+  for (size_t i = 0; i < len_write_data; i++) {
+    data_byte(write_data_buf[i]);
+  }
+  return 0;
+}
+
+sl_status_t sl_sleeptimer_start_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle,
+  uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback,
+  void *callback_data,
+  uint8_t priority,
+  uint16_t option_flags)
+{
+  (void)priority;
+  (void)option_flags;
+  sl_sleeptimer_stop_timer(handle);
+  for (int i = 0; i < TIMER_COUNT; i++) {
+    if (timers[i].handle == NULL) {
+      timers[i].handle = handle;
+      timers[i].callback = callback;
+      timers[i].data = callback_data;
+      timers[i].deadline = now_ms + timeout_ms;
+      return SL_STATUS_OK;
+    }
+  }
+  fail("out of timers");
+  return SL_STATUS_FAIL;
+}
+
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle)
+{
+  for (int i = 0; i < TIMER_COUNT; i++) {
+    if (timers[i].handle == handle) {
+      timers[i].handle = NULL;
+    }
+  }
+  return SL_STATUS_OK;
+}
+
+// Moves the time to the next event, the end of the refresh or a timer
+void EMU_EnterEM1(void)
+{
+  int next = -1;
+
+  for (int i = 0; i < TIMER_COUNT; i++) {
+    if ((timers[i].handle != NULL)
+        && ((next < 0) || (timers[i].deadline < timers[next].deadline))) {
+      next = i;
+    }
+  }
+  if (refreshing && ((next < 0) || (refresh_end_ms <= timers[next].deadline))) {
+    now_ms = refresh_end_ms;
+    refreshing = false;
+    if (busy_irq != NULL) {
+      busy_irq(1);
+    }
+    return;
+  }
+  if (next < 0) {
+    fail("sleeping without a wake up source");
+    exit(1);
+  }
+  test_timer_t timer = timers[next];
+  timers[next].handle = NULL;
+  now_ms = timer.deadline;
+  timer.callback(timer.handle, timer.data);
+}
+
+void GPIOINT_Init(void)
+{
+}
+
+void GPIOINT_CallbackRegister(uint8_t intNo,
+                              GPIOINT_IrqCallbackPtr_t callbackPtr)
+{
+  (void)intNo;
+  busy_irq = callbackPtr;
+}
+
+void GPIO_ExtIntConfig(int port,
+                       unsigned int pin,
+                       unsigned int intNo,
+                       bool risingEdge,
+                       bool fallingEdge,
+                       bool enable)
+{
+  (void)port;
+  (void)pin;
+  (void)intNo;
+  (void)risingEdge;
+  (void)fallingEdge;
+  (void)enable;
+}
+
+// -----------------------------------------------------------------------------
+//                       Test
+// -----------------------------------------------------------------------------
+
+static void on_refresh_done(void)
+{
+  callbacks++;
+}
+
+static void draw(int x, int y, int color)
+{
+  driver->draw_pixel(x, y, color);
+  model[y][x] = color;
+}
+
+// 48x16 field at (120, 100), the pattern changes with the value
+static void draw_price(int value)
+{
+  for (int y = 100; y < 116; y++) {
+    for (int x = 120; x < 168; x++) {
+      draw(x, y, ((x * 7 + y * 3 + value) % 5) == 0 ? 0 : 1);
+    }
+  }
+}
+
+static void check_shown(const char *what)
+{
+  for (int y = 0; y < FRAME_HEIGHT; y++) {
+    for (int x = 0; x < FRAME_WIDTH; x++) {
+      if (((shown[y][x / 8] >> (7 - x % 8)) & 1) != model[y][x]) {
+        printf("FAIL: %s, pixel %d,%d not shown\n", what, x, y);
+        errors++;
+        return;
+      }
+    }
+  }
+}
+
+// Updates the display and checks the refresh kind and the bytes sent
+static long update(const char *what, long expected_refreshes,
+                   long expected_full, long max_bytes)
+{
+  long bytes = spi_bytes;
+  long count = refreshes;
+  long full = full_refreshes;
+
+  if (driver->update_display() != SL_STATUS_OK) {
+    fail("update_display failed");
+  }
+  if (refreshing) {
+    fail("update_display returned during the refresh");
+  }
+  bytes = spi_bytes - bytes;
+  count = refreshes - count;
+  full = full_refreshes - full;
+  printf("%-24s %5ld bytes, %ld refresh, %ld full\n", what, bytes, count,
+         full);
+  if ((count != expected_refreshes) || (full != expected_full)) {
+    printf("FAIL: %s, expected %ld refresh, %ld full\n", what,
+           expected_refreshes, expected_full);
+    errors++;
+  }
+  if (bytes > max_bytes) {
+    printf("FAIL: %s, more than %ld bytes\n", what, max_bytes);
+    errors++;
+  }
+  check_shown(what);
+  return bytes;
+}
+
+int main(void)
+{
+  static int spi_handle;
+  char name[32];
+  long full_bytes;
+  long partial_bytes;
+
+#ifdef EINK_TEST_BSY
+  printf("panel %dx%d, waiting on BUSY\n", FRAME_WIDTH, FRAME_HEIGHT);
+#else
+  printf("panel %dx%d, waiting %d ms\n", FRAME_WIDTH, FRAME_HEIGHT,
+         MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS);
+#endif
+  if ((mikroe_eink_display_init(&spi_handle) != SL_STATUS_OK)
+      || (oled_display_init() != SL_STATUS_OK)) {
+    fail("init failed");
+    return 1;
+  }
+  mikroe_eink_display_set_callback(on_refresh_done);
+  driver = oled_display_get()->driver;
+
+  driver->fill_screen(EINK_DISPLAY_SCREEN_COLOR_WHITE);
+  memset(model, 1, sizeof(model));
+  full_bytes = update("first, full frame", 1, 1,
+                      2 * FRAME_STRIDE * FRAME_HEIGHT);
+  update("no change", 0, 0, 0);
+  driver->fill_screen(EINK_DISPLAY_SCREEN_COLOR_WHITE);
+  update("fill with the same color", 0, 0, 0);
+
+  // The other RAM bank is still unknown, the first partial update rewrites it
+  draw_price(1);
+  update("price, first partial", 1, 0, full_bytes + PARTIAL_MAX_BYTES);
+  draw_price(2);
+  partial_bytes = update("price", 1, 0, PARTIAL_MAX_BYTES);
+  update("no change", 0, 0, 0);
+  draw(0, 0, 0);
+  draw(FRAME_WIDTH - 1, FRAME_HEIGHT - 1, 0);
+  update("two corners", 1, 0, PARTIAL_MAX_BYTES);
+
+  // A full refresh after MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL partials
+  int partials = 3;
+  for (int i = 3; i < 3 + MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL; i++) {
+    bool full = (partials == MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL);
+
+    partials = full ? 0 : partials + 1;
+    snprintf(name, sizeof(name), "price %d%s", i, full ? ", full" : "");
+    draw_price(i);
+    update(name, 1, full ? 1 : 0, PARTIAL_MAX_BYTES);
+  }
+
+  if (callbacks != refreshes) {
+    printf("FAIL: %ld callbacks for %ld refreshes\n", callbacks, refreshes);
+    errors++;
+  }
+  printf("full frame %ld bytes, price field %ld bytes, %ld ms\n",
+         full_bytes, partial_bytes, (long)now_ms);
+  if (errors) {
+    printf("%d errors\n", errors);
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
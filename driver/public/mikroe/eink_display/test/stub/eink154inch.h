@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @file eink154inch.h
+ * @brief Host stub of the 1.54" click library, implemented by the test
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef EINK154INCH_H
+#define EINK154INCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int err_t;
+typedef uint16_t pin_name_t;
+typedef void *mikroe_spi_handle_t;
+
+#define HAL_PIN_NC                      0xFFFF
+#define hal_gpio_pin_name(port, pin)    ((pin_name_t)((port) * 16 + (pin)))
+
+typedef struct {
+  pin_name_t pin;
+} digital_out_t;
+
+typedef struct {
+  pin_name_t pin;
+} digital_in_t;
+
+typedef struct {
+  mikroe_spi_handle_t handle;
+} spi_master_t;
+
+typedef struct {
+  digital_out_t cs;
+  digital_out_t rst;
+  digital_out_t dc;
+  digital_in_t bsy;
+  spi_master_t spi;
+  pin_name_t chip_select;
+} eink154inch_t;
+
+typedef struct {
+  pin_name_t cs;
+  pin_name_t rst;
+  pin_name_t dc;
+  pin_name_t bsy;
+  uint32_t spi_speed;
+} eink154inch_cfg_t;
+
+typedef struct {
+  uint16_t x_start;
+  uint16_t y_start;
+  uint16_t x_end;
+  uint16_t y_end;
+} eink154inch_xy_t;
+
+void digital_out_high(digital_out_t *out);
+void digital_out_low(digital_out_t *out);
+uint8_t digital_in_read(digital_in_t *in);
+void spi_master_select_device(pin_name_t chip_select);
+void spi_master_deselect_device(pin_name_t chip_select);
+err_t spi_master_write(spi_master_t *obj, uint8_t *write_data_buf,
+                       size_t len_write_data);
+
+void eink154inch_send_cmd(eink154inch_t *ctx, uint8_t command);
+void eink154inch_send_data(eink154inch_t *ctx, uint8_t c_data);
+void eink154inch_set_lut(eink154inch_t *ctx, const uint8_t *lut,
+                         uint8_t n_bytes);
+
+// Functions of the click library the host test does not exercise
+#define eink154inch_cfg_setup(cfg)              ((void)(cfg))
+#define eink154inch_init(ctx, cfg)              ((void)(ctx), (void)(cfg), 0)
+#define eink154inch_reset(ctx)                  ((void)(ctx))
+#define eink154inch_sleep_mode(ctx)             ((void)(ctx))
+#define eink154inch_start_config(ctx)           ((void)(ctx))
+#define eink154inch_set_mem_pointer(ctx, x, y) \
+  ((void)(ctx), (void)(x), (void)(y))
+#define eink154inch_set_mem_area(ctx, xy)       ((void)(ctx), (void)(xy))
+#define eink154inch_update_display(ctx)         ((void)(ctx))
+#define eink154inch_fill_screen(ctx, color)     ((void)(ctx), (void)(color))
+#define eink154inch_image(ctx, image_buffer) \
+  ((void)(ctx), (void)(image_buffer))
+
+#endif // EINK154INCH_H
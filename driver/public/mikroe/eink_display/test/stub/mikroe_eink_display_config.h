@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @file mikroe_eink_display_config.h
+ * @brief Host test configuration of the E-Paper display
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef MIKROE_EINK_DISPLAY_CONFIG_H_
+#define MIKROE_EINK_DISPLAY_CONFIG_H_
+
+#define EINK_DISPLAY_1_54_INCH                        0
+#define EINK_DISPLAY_2_13_INCH                        1
+#define EINK_DISPLAY_2_90_INCH                        2
+
+// Default settings of the component configuration
+#define MIKROE_EINK_DISPLAY_SPI_UC                    0
+#define MIKROE_EINK_DISPLAY_SPI_UC_BITRATE            10000000
+#define CONFIG_EINK_DISPLAY_RESOLUTION                EINK_DISPLAY_1_54_INCH
+#define ESL_MODE                                      0
+#define MIKROE_EINK_DISPLAY_PARTIAL_UPDATE            1
+#define MIKROE_EINK_DISPLAY_FULL_REFRESH_INTERVAL     8
+#define MIKROE_EINK_DISPLAY_BAND_HEIGHT               8
+#define MIKROE_EINK_DISPLAY_BUSY_TIMEOUT_MS           10000
+#define MIKROE_EINK_DISPLAY_REFRESH_DELAY_MS          200
+
+#define EINK_DISPLAY_DC_PORT                          0
+#define EINK_DISPLAY_DC_PIN                           0
+#define EINK_DISPLAY_RST_PORT                         2
+#define EINK_DISPLAY_RST_PIN                          8
+
+// Built with -DEINK_TEST_BSY to wait on the BUSY pin instead of the delay
+#ifdef EINK_TEST_BSY
+#define EINK_DISPLAY_BSY_PORT                         1
+#define EINK_DISPLAY_BSY_PIN                          1
+#endif
+
+#define MIKROE_EINK_DISPLAY_WIDTH                     200
+#define MIKROE_EINK_DISPLAY_HEIGHT                    200
+
+#endif // MIKROE_EINK_DISPLAY_CONFIG_H_
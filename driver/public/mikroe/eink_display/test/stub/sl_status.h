@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file sl_status.h
+ * @brief Host stub of the status codes used by the driver
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef SL_STATUS_H
+#define SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK                     ((sl_status_t)0x0000)
+#define SL_STATUS_FAIL                   ((sl_status_t)0x0001)
+#define SL_STATUS_TIMEOUT                ((sl_status_t)0x0007)
+#define SL_STATUS_INITIALIZATION         ((sl_status_t)0x0010)
+#define SL_STATUS_ALREADY_INITIALIZED    ((sl_status_t)0x0011)
+#define SL_STATUS_INVALID_PARAMETER      ((sl_status_t)0x0021)
+#define SL_STATUS_NULL_POINTER           ((sl_status_t)0x0022)
+
+#endif // SL_STATUS_H
@@ -40,6 +40,7 @@
 #ifndef MIKROE_MAXM86161_H_
 #define MIKROE_MAXM86161_H_
 
+#include <stdbool.h>
 #include "sl_status.h"
 #include "drv_i2c_master.h"
 
@@ -314,6 +315,18 @@ extern "C" {
 
 /** \} */
 
+/**
+ * \defgroup fifo_burst_values Fifo burst values
+ * \{
+ */
+#define MIKROE_MAXM86161_FIFO_DEPTH                               128
+#define MIKROE_MAXM86161_FIFO_SAMPLE_SIZE                         3
+#define MIKROE_MAXM86161_FIFO_CHANNELS                            6
+#define MIKROE_MAXM86161_INT_1_FULL_EN                            0x80
+#define MIKROE_MAXM86161_INT_1_DATA_RDY_EN                        0x40
+
+/** \} */
+
 /**
  * \defgroup led_sequence_stucture_values Led sequence structure values
  * \{
@@ -537,6 +550,16 @@ typedef struct
   uint8_t sha;
 } mikroe_maxm86161_int_t;
 
+/***************************************************************************//**
+ * @brief
+ *    One LED sequence of PPG samples decoded from the FIFO
+ ******************************************************************************/
+typedef struct
+{
+  uint32_t ppg[MIKROE_MAXM86161_FIFO_CHANNELS];  // 19-bit counts, LEDC1..LEDC6
+  uint8_t  channel_mask;                          // bit n set if ppg[n] valid
+} mikroe_maxm86161_frame_t;
+
 /** \} */
 
 /***************************************************************************//**
@@ -781,6 +804,105 @@ uint8_t mikroe_maxm86161_get_gp(void);
  ******************************************************************************/
 sl_status_t mikroe_maxm86161_set_en(mikroe_state_pin_t state);
 
+/***************************************************************************//**
+ * @brief
+ *    Start the burst FIFO reader.
+ *
+ * @param[in] buffer
+ *    Caller provided storage for decoded frames.
+ *
+ * @param[in] size
+ *    Number of frames in buffer.
+ *
+ * @param[in] channels
+ *    Number of LED sequence slots in use (1 to 6). A frame is complete after
+ *    the sample of the last slot.
+ *
+ * @param[in] a_full_samples
+ *    Number of FIFO samples that raises the A_FULL interrupt (1 to 128).
+ *    Each LED sequence slot stores one sample.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if a parameter is out of range.
+ *
+ * @note
+ *    The FIFO is flushed, the A_FULL interrupt is enabled and the data ready
+ *    interrupt is disabled, so the host wakes once per a_full_samples.
+ *    The A_FULL status is cleared by the FIFO read.
+ ******************************************************************************/
+sl_status_t mikroe_maxm86161_fifo_start(mikroe_maxm86161_frame_t *buffer,
+                                        uint16_t size,
+                                        uint8_t channels,
+                                        uint8_t a_full_samples);
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the burst FIFO reader and disable the A_FULL interrupt.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ ******************************************************************************/
+sl_status_t mikroe_maxm86161_fifo_stop(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Drain the FIFO when the A_FULL interrupt is pending. Call it from the
+ *    main loop.
+ *
+ * @return
+ *    SL_STATUS_OK if the FIFO was drained.
+ *    SL_STATUS_EMPTY if no interrupt is pending.
+ *    SL_STATUS_INVALID_STATE if the reader is not started.
+ *    SL_STATUS_TRANSMIT if the I2C transfer failed.
+ *
+ * @note
+ *    The interrupt status, overflow counter and sample count are read in one
+ *    transfer, then all samples are read in a single burst. Without the
+ *    MAXM86161_INT pin the A_FULL status is polled.
+ ******************************************************************************/
+sl_status_t mikroe_maxm86161_fifo_process(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the oldest decoded frame.
+ *
+ * @param[out] frame
+ *    Pointer to store the frame.
+ *
+ * @return
+ *    true if a frame was returned, false if none is available.
+ ******************************************************************************/
+bool mikroe_maxm86161_fifo_read(mikroe_maxm86161_frame_t *frame);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of decoded frames.
+ *
+ * @return
+ *    Number of frames in the buffer.
+ ******************************************************************************/
+uint16_t mikroe_maxm86161_fifo_available(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of frames dropped because the buffer was full.
+ *
+ * @return
+ *    Number of dropped frames.
+ ******************************************************************************/
+uint32_t mikroe_maxm86161_fifo_get_dropped(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of samples the sensor overwrote because the FIFO was not
+ *    read in time.
+ *
+ * @return
+ *    Number of lost samples.
+ ******************************************************************************/
+uint32_t mikroe_maxm86161_fifo_get_overflow(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,205 @@
+/***************************************************************************//**
+ * @file mikroe_maxm86161_hrm.h
+ * @brief SCL MAXM86161 fixed-point heart rate and SpO2 estimator
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef MIKROE_MAXM86161_HRM_H_
+#define MIKROE_MAXM86161_HRM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup mikroe_maxm86161_hrm MAXM86161 - Heart rate and SpO2 estimator
+ * @brief  Integer only heart rate and SpO2 estimation from IR and red PPG
+ *         samples. It has no dependency on the sensor, so recorded PPG data
+ *         can be processed off target.
+ *
+ *    @n @section maxm86161_hrm_example MAXM86161 estimator example
+ *
+ *      @code{.c}
+ *
+ *    mikroe_maxm86161_hrm_t hrm;
+ *    mikroe_maxm86161_frame_t frame;
+ *
+ *    mikroe_maxm86161_hrm_init(&hrm, 50);
+ *
+ *    while (mikroe_maxm86161_fifo_read(&frame)) {
+ *      if (mikroe_maxm86161_hrm_update(&hrm, frame.ppg[1], frame.ppg[2])
+ *          && hrm.heart_rate_valid) {
+ *        ...
+ *      }
+ *    } @endcode
+ *
+ * @{
+ ******************************************************************************/
+
+/**
+ * \defgroup maxm86161_hrm_macros Macros
+ * \{
+ */
+#define MIKROE_MAXM86161_HRM_RATE_MIN                             25
+#define MIKROE_MAXM86161_HRM_RATE_MAX                             100
+#define MIKROE_MAXM86161_HRM_LP_TAPS_MAX                          10
+#define MIKROE_MAXM86161_HRM_INTERVALS                            4
+#define MIKROE_MAXM86161_HRM_BPM_MIN                              30
+#define MIKROE_MAXM86161_HRM_BPM_MAX                              220
+#define MIKROE_MAXM86161_HRM_CONTACT_MIN                          10000
+
+/** \} */
+
+/**
+ * \defgroup maxm86161_hrm_typedefs Types
+ * \{
+ */
+
+/***************************************************************************//**
+ * @brief
+ *    Filter state of one PPG channel
+ ******************************************************************************/
+typedef struct
+{
+  int32_t dc;                                      // DC level, Q4 counts
+  int32_t taps[MIKROE_MAXM86161_HRM_LP_TAPS_MAX];  // AC history, Q4 counts
+  int32_t sum;                                     // band-pass output
+  int32_t max;                                     // maximum since last beat
+  int32_t min;                                     // minimum since last beat
+} mikroe_maxm86161_hrm_channel_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Estimator state and results
+ ******************************************************************************/
+typedef struct
+{
+  // Configuration, derived from the sample rate
+  uint16_t sample_rate;
+  uint8_t  dc_shift;
+  uint8_t  decay_shift;
+  uint8_t  lp_taps;
+  uint16_t refractory;
+  uint16_t max_interval;
+  uint32_t contact_min;          // minimum IR DC level in counts
+
+  // Filter and peak detector state
+  mikroe_maxm86161_hrm_channel_t ir;
+  mikroe_maxm86161_hrm_channel_t red;
+  uint8_t  tap_index;
+  int32_t  prev[2];
+  int32_t  threshold;
+  uint16_t since_beat;
+  uint16_t intervals[MIKROE_MAXM86161_HRM_INTERVALS];
+  uint8_t  interval_index;
+  uint8_t  interval_count;
+  bool     started;
+
+  // Results
+  uint16_t heart_rate;           // beats per minute x10
+  uint16_t spo2;                 // percent x10
+  bool     heart_rate_valid;
+  bool     spo2_valid;
+  bool     contact;
+  uint32_t beats;
+} mikroe_maxm86161_hrm_t;
+
+/** \} */
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize the estimator.
+ *
+ * @param[out] hrm
+ *    Pointer to the estimator state.
+ *
+ * @param[in] sample_rate
+ *    PPG sample rate in Hz, MIKROE_MAXM86161_HRM_RATE_MIN to
+ *    MIKROE_MAXM86161_HRM_RATE_MAX.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if hrm is NULL or the rate is out of range.
+ ******************************************************************************/
+sl_status_t mikroe_maxm86161_hrm_init(mikroe_maxm86161_hrm_t *hrm,
+                                      uint16_t sample_rate);
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the filter state and the results, the configuration is kept.
+ *
+ * @param[in,out] hrm
+ *    Pointer to the estimator state.
+ ******************************************************************************/
+void mikroe_maxm86161_hrm_reset(mikroe_maxm86161_hrm_t *hrm);
+
+/***************************************************************************//**
+ * @brief
+ *    Process one IR and red sample pair.
+ *
+ * @param[in,out] hrm
+ *    Pointer to the estimator state.
+ *
+ * @param[in] ir
+ *    IR sample in ADC counts. The heart rate is detected on this channel, a
+ *    green sample can be passed instead for heart rate only.
+ *
+ * @param[in] red
+ *    Red sample in ADC counts, 0 if SpO2 is not needed.
+ *
+ * @return
+ *    true if a beat was detected and the results were updated.
+ *
+ * @note
+ *    Each sample costs two DC trackers, two moving sums and the peak test,
+ *    all in 32-bit integer arithmetic. One 64-bit division per beat updates
+ *    SpO2. The DC tracker removes the baseline below about 0.5 Hz and the
+ *    moving sum spans about 0.1 s, so the band-pass keeps the pulse band.
+ ******************************************************************************/
+bool mikroe_maxm86161_hrm_update(mikroe_maxm86161_hrm_t *hrm,
+                                 uint32_t ir,
+                                 uint32_t red);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+#endif // MIKROE_MAXM86161_HRM_H_
@@ -41,8 +41,61 @@
 #include "mikroe_maxm86161.h"
 #include "mikroe_maxm86161_config.h"
 
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN)
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define GPIO_M4_INTR              7 // M4 Pin interrupt number
+#define AVL_INTR_NO               0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
+// INT_STATUS_1 up to FIFO_DATA_COUNTER
+#define MAXM86161_FIFO_STATUS_LENGTH  8
+#define MAXM86161_FIFO_STATUS_OVF     6
+#define MAXM86161_FIFO_STATUS_CNT     7
+
+typedef struct {
+  mikroe_maxm86161_frame_t *buffer;
+  uint16_t size;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t count;
+  uint32_t dropped;
+  uint32_t overflow;
+  mikroe_maxm86161_frame_t frame;   // frame being assembled across bursts
+  uint8_t channels;
+  bool running;
+  volatile bool pending;
+} mikroe_maxm86161_fifo_t;
+
 static heartrate2_t heartrate2;
 static heartrate2_cfg_t heartrate2_cfg;
+static mikroe_maxm86161_fifo_t maxm86161_fifo;
+static uint8_t fifo_burst[MIKROE_MAXM86161_FIFO_DEPTH
+                          * MIKROE_MAXM86161_FIFO_SAMPLE_SIZE];
+
+static void maxm86161_fifo_push_frame(void);
+static void maxm86161_fifo_decode(const uint8_t *data, uint16_t samples);
+
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN)
+
+/***************************************************************************//**
+ * INT interrupt handler, the A_FULL threshold is reached
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+static void maxm86161_int_handler(uint32_t int_no)
+#else
+static void maxm86161_int_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  maxm86161_fifo.pending = true;
+}
+
+#endif
 
 sl_status_t mikroe_maxm86161_init(mikroe_i2c_handle_t i2cspm_instance)
 {
@@ -265,3 +318,240 @@ sl_status_t mikroe_maxm86161_set_en(mikroe_state_pin_t state)
                     ?HEARTRATE2_PIN_HIGH : HEARTRATE2_PIN_LOW);
   return SL_STATUS_OK;
 }
+
+sl_status_t mikroe_maxm86161_fifo_start(mikroe_maxm86161_frame_t *buffer,
+                                        uint16_t size,
+                                        uint8_t channels,
+                                        uint8_t a_full_samples)
+{
+  uint8_t int_enable;
+
+  if ((NULL == buffer) || (0 == size)
+      || (0 == channels) || (channels > MIKROE_MAXM86161_FIFO_CHANNELS)
+      || (0 == a_full_samples)
+      || (a_full_samples > MIKROE_MAXM86161_FIFO_DEPTH)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  maxm86161_fifo.buffer = buffer;
+  maxm86161_fifo.size = size;
+  maxm86161_fifo.head = 0;
+  maxm86161_fifo.tail = 0;
+  maxm86161_fifo.count = 0;
+  maxm86161_fifo.dropped = 0;
+  maxm86161_fifo.overflow = 0;
+  maxm86161_fifo.frame.channel_mask = 0;
+  maxm86161_fifo.channels = channels;
+  maxm86161_fifo.pending = false;
+
+  // FIFO_A_FULL holds the number of free entries left when A_FULL asserts
+  heartrate2_generic_write(&heartrate2,
+                           MIKROE_MAXM86161_REG_FIFO_CFG_1,
+                           MIKROE_MAXM86161_FIFO_DEPTH - a_full_samples);
+  heartrate2_generic_write(&heartrate2,
+                           MIKROE_MAXM86161_REG_FIFO_CFG_2,
+                           MIKROE_MAXM86161_FIFO_CFG_2_FLUSH_FIFO
+                           | MIKROE_MAXM86161_FIFO_CFG_2_FIFO_READ_DATA_CLR
+                           | MIKROE_MAXM86161_FIFO_CFG_2_FULL_TYPE_RPT
+                           | MIKROE_MAXM86161_FIFO_CFG_2_FIFO_ROLL_OVER);
+
+  int_enable = heartrate2_generic_read(&heartrate2,
+                                       MIKROE_MAXM86161_REG_INT_ENABLE_1);
+  int_enable |= MIKROE_MAXM86161_INT_1_FULL_EN;
+  int_enable &= ~MIKROE_MAXM86161_INT_1_DATA_RDY_EN;
+  heartrate2_generic_write(&heartrate2,
+                           MIKROE_MAXM86161_REG_INT_ENABLE_1,
+                           int_enable);
+
+  // Release INT before the edge interrupt is armed
+  heartrate2_generic_read(&heartrate2, MIKROE_MAXM86161_REG_INT_STATUS_1);
+
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN)
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { MAXM86161_INT_PIN / 16,
+                              MAXM86161_INT_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     GPIO_M4_INTR,
+                                     SL_GPIO_INTERRUPT_FALLING_EDGE,
+                                     maxm86161_int_handler,
+                                     AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(MAXM86161_INT_PIN, maxm86161_int_handler);
+  GPIO_ExtIntConfig(MAXM86161_INT_PORT,
+                    MAXM86161_INT_PIN,
+                    MAXM86161_INT_PIN,
+                    false,
+                    true,
+                    true);
+#endif
+#endif
+
+  maxm86161_fifo.running = true;
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t mikroe_maxm86161_fifo_stop(void)
+{
+  uint8_t int_enable;
+
+  maxm86161_fifo.running = false;
+
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN) \
+  && !defined(SLI_SI917)
+  GPIO_IntDisable(1 << MAXM86161_INT_PIN);
+#endif
+
+  int_enable = heartrate2_generic_read(&heartrate2,
+                                       MIKROE_MAXM86161_REG_INT_ENABLE_1);
+  heartrate2_generic_write(&heartrate2,
+                           MIKROE_MAXM86161_REG_INT_ENABLE_1,
+                           int_enable & ~MIKROE_MAXM86161_INT_1_FULL_EN);
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t mikroe_maxm86161_fifo_process(void)
+{
+  uint8_t status[MAXM86161_FIFO_STATUS_LENGTH];
+  uint8_t reg;
+  uint16_t samples;
+  uint16_t length;
+
+  if (!maxm86161_fifo.running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN)
+  if (!maxm86161_fifo.pending) {
+    return SL_STATUS_EMPTY;
+  }
+  maxm86161_fifo.pending = false;
+#endif
+
+  // Reading INT_STATUS_1 releases INT
+  reg = MIKROE_MAXM86161_REG_INT_STATUS_1;
+  if (I2C_MASTER_SUCCESS != i2c_master_write_then_read(&heartrate2.i2c,
+                                                       &reg, 1,
+                                                       status,
+                                                       sizeof(status))) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+#if !(defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN))
+  if (!(status[0] & MIKROE_MAXM86161_INT_1_FULL)) {
+    return SL_STATUS_EMPTY;
+  }
+#endif
+
+  maxm86161_fifo.overflow += status[MAXM86161_FIFO_STATUS_OVF];
+
+  samples = status[MAXM86161_FIFO_STATUS_CNT];
+  if (samples > MIKROE_MAXM86161_FIFO_DEPTH) {
+    samples = MIKROE_MAXM86161_FIFO_DEPTH;
+  }
+  if (0 == samples) {
+    return SL_STATUS_OK;
+  }
+
+  reg = MIKROE_MAXM86161_REG_FIFO_DATA_REG;
+  length = samples * MIKROE_MAXM86161_FIFO_SAMPLE_SIZE;
+  if (I2C_MASTER_SUCCESS != i2c_master_write_then_read(&heartrate2.i2c,
+                                                       &reg, 1,
+                                                       fifo_burst,
+                                                       length)) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  maxm86161_fifo_decode(fifo_burst, samples);
+
+#if defined(MAXM86161_INT_PORT) && defined(MAXM86161_INT_PIN)
+  // The threshold may have been crossed again during the burst
+  if (0 == heartrate2_get_int(&heartrate2)) {
+    maxm86161_fifo.pending = true;
+  }
+#endif
+
+  return SL_STATUS_OK;
+}
+
+bool mikroe_maxm86161_fifo_read(mikroe_maxm86161_frame_t *frame)
+{
+  if ((NULL == frame) || (0 == maxm86161_fifo.count)) {
+    return false;
+  }
+
+  *frame = maxm86161_fifo.buffer[maxm86161_fifo.tail];
+  maxm86161_fifo.tail = (maxm86161_fifo.tail + 1) % maxm86161_fifo.size;
+  maxm86161_fifo.count--;
+
+  return true;
+}
+
+uint16_t mikroe_maxm86161_fifo_available(void)
+{
+  return maxm86161_fifo.count;
+}
+
+uint32_t mikroe_maxm86161_fifo_get_dropped(void)
+{
+  return maxm86161_fifo.dropped;
+}
+
+uint32_t mikroe_maxm86161_fifo_get_overflow(void)
+{
+  return maxm86161_fifo.overflow;
+}
+
+/***************************************************************************//**
+ * Queue the assembled frame, it is dropped if the buffer is full
+ ******************************************************************************/
+static void maxm86161_fifo_push_frame(void)
+{
+  if (maxm86161_fifo.count >= maxm86161_fifo.size) {
+    maxm86161_fifo.dropped++;
+  } else {
+    maxm86161_fifo.buffer[maxm86161_fifo.head] = maxm86161_fifo.frame;
+    maxm86161_fifo.head = (maxm86161_fifo.head + 1) % maxm86161_fifo.size;
+    maxm86161_fifo.count++;
+  }
+
+  maxm86161_fifo.frame.channel_mask = 0;
+}
+
+/***************************************************************************//**
+ * Decode tagged samples into frames. A frame ends with the sample of the last
+ * LED sequence slot, or when a slot repeats because a sample was lost.
+ ******************************************************************************/
+static void maxm86161_fifo_decode(const uint8_t *data, uint16_t samples)
+{
+  for (uint16_t i = 0; i < samples; i++) {
+    uint32_t raw = ((uint32_t)data[0] << 16)
+                   | ((uint32_t)data[1] << 8)
+                   | data[2];
+    uint8_t tag = (raw >> HEARTRATE2_FIFO_RES) & HEARTRATE2_FIFO_TAG_MASK;
+
+    data += MIKROE_MAXM86161_FIFO_SAMPLE_SIZE;
+
+    // Ambient, proximity, DAC update and time stamp entries are skipped
+    if ((tag < MIKROE_MAXM86161_FIFO_TAG_PPG1_LEDC1)
+        || (tag > MIKROE_MAXM86161_FIFO_TAG_PPG1_LEDC6)) {
+      continue;
+    }
+
+    uint8_t slot = tag - MIKROE_MAXM86161_FIFO_TAG_PPG1_LEDC1;
+    uint8_t bit = 1 << slot;
+
+    if (maxm86161_fifo.frame.channel_mask & bit) {
+      maxm86161_fifo_push_frame();
+    }
+
+    maxm86161_fifo.frame.ppg[slot] = raw & HEARTRATE2_FIFO_DATA_MASK;
+    maxm86161_fifo.frame.channel_mask |= bit;
+
+    if ((slot + 1) >= maxm86161_fifo.channels) {
+      maxm86161_fifo_push_frame();
+    }
+  }
+}
@@ -0,0 +1,295 @@
+/***************************************************************************//**
+ * @file mikroe_maxm86161_hrm.c
+ * @brief SCL MAXM86161 fixed-point heart rate and SpO2 estimator
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "mikroe_maxm86161_hrm.h"
+
+// DC level and AC samples carry 4 fractional bits. A 19-bit sample is below
+// 2^23 and the moving sum of up to 10 taps stays below 2^27.
+#define HRM_FRAC_BITS 4
+
+static void hrm_channel_reset(mikroe_maxm86161_hrm_channel_t *ch,
+                              uint32_t sample);
+static int32_t hrm_channel_update(mikroe_maxm86161_hrm_t *hrm,
+                                  mikroe_maxm86161_hrm_channel_t *ch,
+                                  uint32_t sample);
+static void hrm_update_spo2(mikroe_maxm86161_hrm_t *hrm);
+static void hrm_update_heart_rate(mikroe_maxm86161_hrm_t *hrm);
+
+sl_status_t mikroe_maxm86161_hrm_init(mikroe_maxm86161_hrm_t *hrm,
+                                      uint16_t sample_rate)
+{
+  uint8_t shift = 0;
+
+  if ((NULL == hrm)
+      || (sample_rate < MIKROE_MAXM86161_HRM_RATE_MIN)
+      || (sample_rate > MIKROE_MAXM86161_HRM_RATE_MAX)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  hrm->sample_rate = sample_rate;
+
+  // Single pole high-pass at fs / (2 pi 2^shift), about 0.5 Hz
+  while ((1u << shift) < ((uint32_t)sample_rate * 10 / 31)) {
+    shift++;
+  }
+  hrm->dc_shift = shift;
+
+  // The detection threshold halves in about one second
+  hrm->decay_shift = shift + 2;
+
+  // Moving sum over 0.1 s, the first null is at 10 Hz
+  hrm->lp_taps = sample_rate / 10;
+  if (hrm->lp_taps < 2) {
+    hrm->lp_taps = 2;
+  }
+
+  hrm->refractory = (uint16_t)((uint32_t)sample_rate * 60
+                               / MIKROE_MAXM86161_HRM_BPM_MAX);
+  hrm->max_interval = (uint16_t)((uint32_t)sample_rate * 60
+                                 / MIKROE_MAXM86161_HRM_BPM_MIN);
+  hrm->contact_min = MIKROE_MAXM86161_HRM_CONTACT_MIN;
+
+  mikroe_maxm86161_hrm_reset(hrm);
+
+  return SL_STATUS_OK;
+}
+
+void mikroe_maxm86161_hrm_reset(mikroe_maxm86161_hrm_t *hrm)
+{
+  if (NULL == hrm) {
+    return;
+  }
+
+  hrm->started = false;
+  hrm->tap_index = 0;
+  hrm->prev[0] = 0;
+  hrm->prev[1] = 0;
+  hrm->threshold = 0;
+  hrm->since_beat = 0;
+  hrm->interval_index = 0;
+  hrm->interval_count = 0;
+  hrm->heart_rate = 0;
+  hrm->spo2 = 0;
+  hrm->heart_rate_valid = false;
+  hrm->spo2_valid = false;
+  hrm->contact = false;
+  hrm->beats = 0;
+}
+
+bool mikroe_maxm86161_hrm_update(mikroe_maxm86161_hrm_t *hrm,
+                                 uint32_t ir,
+                                 uint32_t red)
+{
+  int32_t ir_ac;
+  bool beat = false;
+
+  if (NULL == hrm) {
+    return false;
+  }
+
+  if (ir < hrm->contact_min) {
+    if (hrm->started) {
+      mikroe_maxm86161_hrm_reset(hrm);
+    }
+    return false;
+  }
+
+  // Start the DC trackers at the first level so there is no long settle
+  if (!hrm->started) {
+    hrm_channel_reset(&hrm->ir, ir);
+    hrm_channel_reset(&hrm->red, red);
+    hrm->started = true;
+    hrm->contact = true;
+  }
+
+  ir_ac = hrm_channel_update(hrm, &hrm->ir, ir);
+  hrm_channel_update(hrm, &hrm->red, red);
+  hrm->tap_index = (hrm->tap_index + 1) % hrm->lp_taps;
+
+  if (hrm->since_beat < UINT16_MAX) {
+    hrm->since_beat++;
+  }
+  hrm->threshold -= hrm->threshold >> hrm->decay_shift;
+
+  // prev[0] is a beat if it is a local maximum above the threshold and the
+  // previous beat is more than the refractory period away
+  if ((hrm->prev[0] > hrm->prev[1])
+      && (hrm->prev[0] >= ir_ac)
+      && (hrm->prev[0] > hrm->threshold)
+      && (hrm->since_beat > hrm->refractory)) {
+    hrm->threshold = hrm->prev[0] / 2;
+
+    hrm_update_heart_rate(hrm);
+    hrm_update_spo2(hrm);
+
+    // The peak is one sample old, since_beat counts from it
+    hrm->since_beat = 0;
+    hrm->beats++;
+    beat = true;
+  } else if (hrm->since_beat > hrm->max_interval) {
+    // Slower than MIKROE_MAXM86161_HRM_BPM_MIN, the rhythm is lost
+    hrm->interval_count = 0;
+    hrm->heart_rate_valid = false;
+    hrm->spo2_valid = false;
+  }
+
+  hrm->prev[1] = hrm->prev[0];
+  hrm->prev[0] = ir_ac;
+
+  return beat;
+}
+
+/***************************************************************************//**
+ * Start a channel at the given level
+ ******************************************************************************/
+static void hrm_channel_reset(mikroe_maxm86161_hrm_channel_t *ch,
+                              uint32_t sample)
+{
+  ch->dc = (int32_t)sample << HRM_FRAC_BITS;
+  for (uint8_t i = 0; i < MIKROE_MAXM86161_HRM_LP_TAPS_MAX; i++) {
+    ch->taps[i] = 0;
+  }
+  ch->sum = 0;
+  ch->max = INT32_MIN;
+  ch->min = INT32_MAX;
+}
+
+/***************************************************************************//**
+ * Remove the DC level and low-pass filter one sample. The result is inverted
+ * so the systolic peak, where the most light is absorbed, is a maximum.
+ ******************************************************************************/
+static int32_t hrm_channel_update(mikroe_maxm86161_hrm_t *hrm,
+                                  mikroe_maxm86161_hrm_channel_t *ch,
+                                  uint32_t sample)
+{
+  int32_t x = (int32_t)sample << HRM_FRAC_BITS;
+  int32_t ac;
+
+  ch->dc += (x - ch->dc) >> hrm->dc_shift;
+  ac = ch->dc - x;
+
+  ch->sum += ac - ch->taps[hrm->tap_index];
+  ch->taps[hrm->tap_index] = ac;
+
+  if (ch->sum > ch->max) {
+    ch->max = ch->sum;
+  }
+  if (ch->sum < ch->min) {
+    ch->min = ch->sum;
+  }
+
+  return ch->sum;
+}
+
+/***************************************************************************//**
+ * Average the last beat intervals
+ ******************************************************************************/
+static void hrm_update_heart_rate(mikroe_maxm86161_hrm_t *hrm)
+{
+  uint32_t total = 0;
+
+  // The first beat only starts the interval measurement
+  if ((0 == hrm->beats) || (hrm->since_beat > hrm->max_interval)) {
+    hrm->interval_count = 0;
+    return;
+  }
+
+  hrm->intervals[hrm->interval_index] = hrm->since_beat;
+  hrm->interval_index = (hrm->interval_index + 1)
+                        % MIKROE_MAXM86161_HRM_INTERVALS;
+  if (hrm->interval_count < MIKROE_MAXM86161_HRM_INTERVALS) {
+    hrm->interval_count++;
+  }
+
+  for (uint8_t i = 0; i < hrm->interval_count; i++) {
+    total += hrm->intervals[i];
+  }
+
+  hrm->heart_rate = (uint16_t)((600u * hrm->sample_rate * hrm->interval_count
+                                + total / 2) / total);
+  hrm->heart_rate_valid = (hrm->interval_count >= 2);
+}
+
+/***************************************************************************//**
+ * Estimate SpO2 from the ratio of ratios of the last beat,
+ * SpO2 = 110 - 25 * (AC_red / DC_red) / (AC_ir / DC_ir)
+ ******************************************************************************/
+static void hrm_update_spo2(mikroe_maxm86161_hrm_t *hrm)
+{
+  int64_t ir_ac = (int64_t)hrm->ir.max - hrm->ir.min;
+  int64_t red_ac = (int64_t)hrm->red.max - hrm->red.min;
+  int64_t num;
+  int64_t den;
+  int32_t ratio;    // Q8
+  int32_t spo2;
+
+  hrm->ir.max = INT32_MIN;
+  hrm->ir.min = INT32_MAX;
+  hrm->red.max = INT32_MIN;
+  hrm->red.min = INT32_MAX;
+
+  // A full beat is needed for the peak to peak amplitude
+  if ((0 == hrm->beats) || (ir_ac <= 0) || (red_ac <= 0)
+      || (hrm->red.dc <= 0)) {
+    return;
+  }
+
+  num = (red_ac * hrm->ir.dc) << 8;
+  den = ir_ac * hrm->red.dc;
+  ratio = (int32_t)(num / den);
+
+  // 0.4 < R < 1.6 covers SpO2 from 70 % to 100 %
+  if ((ratio < 102) || (ratio > 410)) {
+    hrm->spo2_valid = false;
+    return;
+  }
+
+  spo2 = 1100 - ((250 * ratio) >> 8);
+  if (spo2 > 1000) {
+    spo2 = 1000;
+  }
+
+  // Smooth over about four beats
+  if (hrm->spo2_valid) {
+    spo2 = hrm->spo2 + (spo2 - (int32_t)hrm->spo2) / 4;
+  }
+  hrm->spo2 = (uint16_t)spo2;
+  hrm->spo2_valid = true;
+}
@@ -0,0 +1,227 @@
+/***************************************************************************//**
+ * @file maxm86161_hrm_test.c
+ * @brief Host test of the MAXM86161 heart rate and SpO2 estimator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+// Host test of the heart rate and SpO2 estimator.
+//
+// A synthetic PPG trace, a systolic pulse with a dicrotic notch on a drifting
+// DC level plus noise, is generated for known heart rates and SpO2 levels
+// and fed through mikroe_maxm86161_hrm_update(). The estimates are checked
+// against the generated values, then the cost of one update is measured.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "mikroe_maxm86161_hrm.h"
+
+#define TRACE_SECONDS     30
+#define IR_DC             250000.0
+#define RED_DC            180000.0
+#define PERFUSION         0.02   // IR AC / DC
+#define NOISE             300    // peak noise in counts
+#define HR_TOLERANCE      3.0    // percent
+#define SPO2_TOLERANCE    2.0    // percent SpO2
+#define BENCH_RATE        100
+#define BENCH_SECONDS     600
+#define BENCH_PASSES      20
+
+static uint32_t noise_state;
+
+/***************************************************************************//**
+ * Uniform noise in [-NOISE, NOISE], same sequence on every run
+ ******************************************************************************/
+static int32_t noise(void)
+{
+  noise_state = noise_state * 1103515245u + 12345u;
+  return (int32_t)((noise_state >> 8) % (2 * NOISE + 1)) - NOISE;
+}
+
+/***************************************************************************//**
+ * Absorption over one beat, systolic peak and dicrotic notch
+ ******************************************************************************/
+static double pulse_shape(double phase)
+{
+  phase -= floor(phase);
+  return exp(-pow((phase - 0.15) / 0.07, 2))
+         + 0.35 * exp(-pow((phase - 0.45) / 0.1, 2));
+}
+
+/***************************************************************************//**
+ * Sample n of a trace, SpO2 = 110 - 25 * R sets the red AC amplitude
+ ******************************************************************************/
+static void ppg_sample(uint32_t n, uint16_t rate, double bpm, double spo2,
+                       uint32_t *ir, uint32_t *red)
+{
+  double t = (double)n / rate;
+  double r = (110.0 - spo2) / 25.0;
+  double shape = pulse_shape(t * bpm / 60.0);
+  double drift = 3000.0 * sin(2.0 * M_PI * 0.1 * t);
+
+  *ir = (uint32_t)(IR_DC + drift - PERFUSION * IR_DC * shape + noise());
+  *red = (uint32_t)(RED_DC + 0.7 * drift - r * PERFUSION * RED_DC * shape
+                    + noise());
+}
+
+static int check_trace(uint16_t rate, double bpm, double spo2)
+{
+  mikroe_maxm86161_hrm_t hrm;
+  uint32_t ir;
+  uint32_t red;
+  double hr_error;
+  double spo2_error;
+
+  if (SL_STATUS_OK != mikroe_maxm86161_hrm_init(&hrm, rate)) {
+    printf("FAIL: init at %u sps\n", rate);
+    return 1;
+  }
+
+  noise_state = 1;
+  for (uint32_t n = 0; n < (uint32_t)rate * TRACE_SECONDS; n++) {
+    ppg_sample(n, rate, bpm, spo2, &ir, &red);
+    mikroe_maxm86161_hrm_update(&hrm, ir, red);
+  }
+
+  hr_error = 100.0 * fabs(hrm.heart_rate / 10.0 - bpm) / bpm;
+  spo2_error = fabs(hrm.spo2 / 10.0 - spo2);
+  if (!hrm.heart_rate_valid || (hr_error > HR_TOLERANCE)
+      || (spo2_error > SPO2_TOLERANCE)) {
+    printf("FAIL: %3u sps, %5.1f bpm, SpO2 %4.1f %%: "
+           "heart rate %u.%u (valid %d), SpO2 %u.%u\n",
+           rate, bpm, spo2, hrm.heart_rate / 10, hrm.heart_rate % 10,
+           hrm.heart_rate_valid, hrm.spo2 / 10, hrm.spo2 % 10);
+    return 1;
+  }
+
+  printf("ok: %3u sps, %5.1f bpm, SpO2 %4.1f %%: "
+         "heart rate %3u.%u, SpO2 %u.%u, %lu beats\n",
+         rate, bpm, spo2, hrm.heart_rate / 10, hrm.heart_rate % 10,
+         hrm.spo2 / 10, hrm.spo2 % 10, (unsigned long)hrm.beats);
+  return 0;
+}
+
+static int check_contact_loss(void)
+{
+  mikroe_maxm86161_hrm_t hrm;
+  uint32_t ir;
+  uint32_t red;
+
+  mikroe_maxm86161_hrm_init(&hrm, 50);
+  noise_state = 1;
+  for (uint32_t n = 0; n < 50 * TRACE_SECONDS; n++) {
+    ppg_sample(n, 50, 72.0, 97.0, &ir, &red);
+    mikroe_maxm86161_hrm_update(&hrm, ir, red);
+  }
+
+  // The finger is removed, the IR level drops below the contact threshold
+  mikroe_maxm86161_hrm_update(&hrm, MIKROE_MAXM86161_HRM_CONTACT_MIN - 1, 0);
+  if (hrm.contact || hrm.heart_rate_valid || hrm.spo2_valid) {
+    printf("FAIL: estimates kept after contact loss\n");
+    return 1;
+  }
+
+  // A flat signal has no beat, the rhythm is lost after the longest interval
+  mikroe_maxm86161_hrm_init(&hrm, 50);
+  noise_state = 1;
+  for (uint32_t n = 0; n < 50 * 10; n++) {
+    ppg_sample(n, 50, 72.0, 97.0, &ir, &red);
+    mikroe_maxm86161_hrm_update(&hrm, ir, red);
+  }
+  for (uint32_t n = 0; n < 50 * 3; n++) {
+    mikroe_maxm86161_hrm_update(&hrm, (uint32_t)IR_DC, (uint32_t)RED_DC);
+  }
+  if (hrm.heart_rate_valid) {
+    printf("FAIL: heart rate kept without beats\n");
+    return 1;
+  }
+
+  printf("ok: contact loss and missing beats invalidate the estimates\n");
+  return 0;
+}
+
+int main(void)
+{
+  static const uint16_t rates[] = { 25, 50, 100 };
+  static const double bpm[] = { 45.0, 72.0, 120.0, 180.0 };
+  static const double spo2[] = { 98.0, 92.0, 85.0, 97.0 };
+  uint32_t samples = BENCH_RATE * BENCH_SECONDS;
+  uint32_t *ir = malloc(samples * sizeof(*ir));
+  uint32_t *red = malloc(samples * sizeof(*red));
+  mikroe_maxm86161_hrm_t hrm;
+  struct timespec start;
+  struct timespec end;
+  volatile uint32_t beats = 0;
+  double ns;
+
+  for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    for (uint8_t j = 0; j < sizeof(bpm) / sizeof(bpm[0]); j++) {
+      if (check_trace(rates[i], bpm[j], spo2[j])) {
+        return 1;
+      }
+    }
+  }
+
+  if (check_contact_loss()) {
+    return 1;
+  }
+
+  if ((NULL == ir) || (NULL == red)) {
+    return 1;
+  }
+
+  // The trace is generated up front so only the estimator is timed
+  noise_state = 1;
+  for (uint32_t n = 0; n < samples; n++) {
+    ppg_sample(n, BENCH_RATE, 72.0, 97.0, &ir[n], &red[n]);
+  }
+
+  mikroe_maxm86161_hrm_init(&hrm, BENCH_RATE);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+    for (uint32_t n = 0; n < samples; n++) {
+      beats += mikroe_maxm86161_hrm_update(&hrm, ir[n], red[n]);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec))
+       / ((double)samples * BENCH_PASSES);
+  printf("update at %u sps: %.1f ns per sample, %.1f us per second of PPG "
+         "(%lu beats)\n",
+         BENCH_RATE, ns, ns * BENCH_RATE / 1000.0, (unsigned long)beats);
+
+  free(ir);
+  free(red);
+  return 0;
+}
@@ -69,6 +69,11 @@
 // <i> Default: 0x28
 #define MIKROE_PN7150_ADDR                            0x28
 
+// <o MIKROE_PN7150_TML_POOL_SIZE> NCI TML packet pool size <1-8>
+// <i> Number of packets read from the NFCC ahead of the NCI layer.
+// <i> Default: 2
+#define MIKROE_PN7150_TML_POOL_SIZE                   2
+
 // The block ends with the following line or at the end of the file:
 // <<< end of configuration section >>>
 
@@ -136,6 +136,15 @@ sl_status_t mikroe_pn7150_generic_write(uint8_t *p_tx_data, uint8_t n_bytes);
 sl_status_t mikroe_pn7150_generic_read(uint8_t *p_rx_h_data,
                                        uint8_t *p_rx_p_data);
 
+/***************************************************************************//**
+ * @brief NFC 2 NCI packet reading function.
+ * @details This function reads the 3 byte NCI header, then the payload in a
+ * single burst right after it.
+ * @param[out] packet : Buffer for the packet, 258 bytes at most.
+ * @return SL_STATUS_OK if there are no errors.
+ ******************************************************************************/
+sl_status_t mikroe_pn7150_read_packet(uint8_t *packet);
+
 /***************************************************************************//**
  * @brief HW reset function.
  * @details The function hw reset
@@ -2,6 +2,7 @@
 #define __NCI_TML_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,6 +19,57 @@ typedef enum {
   nci_tml_err_comm_bus        = 0x01
 } nci_tml_err_t;
 
+/// Called from the IRQ handler when a packet is ready to be received.
+typedef void (*nci_tml_notify_t)(void);
+
+/// Per-packet latency counters, in microseconds from the IRQ edge.
+typedef struct {
+  uint32_t packets;                /* Packets read from the NFCC. */
+  uint32_t errors;                 /* Failed reads. */
+  uint32_t read_latency_us;        /* IRQ to packet read, last packet. */
+  uint32_t read_latency_max_us;    /* IRQ to packet read, worst case. */
+  uint32_t deliver_latency_us;     /* IRQ to packet received, last packet. */
+  uint32_t deliver_latency_max_us; /* IRQ to packet received, worst case. */
+} nci_tml_stats_t;
+
+/**************************************************************************//**
+ * @brief
+ *  Take over the PN7150 IRQ pin. On each rising edge the notify function is
+ *  called, and packets are read into the TML packet pool as soon as
+ *  nci_tml_process() or nci_tml_receive() runs.
+ *
+ * @param[in] notify
+ *  Function to call when a packet is ready, usually
+ *  nci_notify_incoming_packet(). May be NULL.
+ *
+ * @note
+ *  Requires MIKROE_PN7150_INT_PORT and MIKROE_PN7150_INT_PIN.
+ *  The application must not register its own IRQ callback.
+ *****************************************************************************/
+void nci_tml_init(nci_tml_notify_t notify);
+
+/**************************************************************************//**
+ * @brief
+ *  Read the packets the NFCC has ready into the packet pool. Call it from the
+ *  main loop to drain the NFCC before lengthy application work.
+ *****************************************************************************/
+void nci_tml_process(void);
+
+/**************************************************************************//**
+ * @brief
+ *  Get the latency counters.
+ *
+ * @param[out] stats
+ *  Counters since nci_tml_init() or the last reset.
+ *****************************************************************************/
+void nci_tml_get_stats(nci_tml_stats_t *stats);
+
+/**************************************************************************//**
+ * @brief
+ *  Reset the latency counters.
+ *****************************************************************************/
+void nci_tml_reset_stats(void);
+
 /**************************************************************************//**
  * @brief
  *  NCI TML transceive function wrapper for PN7150 I2C.
@@ -137,6 +137,29 @@ sl_status_t mikroe_pn7150_generic_read(uint8_t *p_rx_h_data,
   return (err == NFC2_OK) ? SL_STATUS_OK : SL_STATUS_TRANSMIT;
 }
 
+/***************************************************************************//**
+ * NFC 2 NCI packet reading function.
+ ******************************************************************************/
+sl_status_t mikroe_pn7150_read_packet(uint8_t *packet)
+{
+  if (NULL == packet) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (i2c_master_read(&nfc2.i2c, packet, 3) != I2C_MASTER_SUCCESS) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  // The NFCC holds the payload right after the header, no delay is needed
+  if ((packet[2] != 0)
+      && (i2c_master_read(&nfc2.i2c, &packet[3], packet[2])
+          != I2C_MASTER_SUCCESS)) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  return SL_STATUS_OK;
+}
+
 /***************************************************************************//**
  * HW reset function.
  ******************************************************************************/
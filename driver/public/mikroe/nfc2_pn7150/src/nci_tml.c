@@ -33,9 +33,175 @@
  * at the sole discretion of Silicon Labs.
  ******************************************************************************/
 
+#include <string.h>
 #include "sl_status.h"
+#include "sl_sleeptimer.h"
 #include "nci_tml.h"
 #include "mikroe_pn7150.h"
+#include "mikroe_pn7150_config.h"
+
+#if defined(MIKROE_PN7150_INT_PORT) && defined(MIKROE_PN7150_INT_PIN)
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define GPIO_M4_INTR              0 // M4 Pin interrupt number
+#define AVL_INTR_NO               0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
+#ifndef MIKROE_PN7150_TML_POOL_SIZE
+#define MIKROE_PN7150_TML_POOL_SIZE   2
+#endif
+
+#define NCI_TML_PACKET_MAX_LEN        (3 + 255)
+
+typedef struct {
+  uint8_t  packet[NCI_TML_PACKET_MAX_LEN];
+  uint32_t irq_tick;    /* Tick of the IRQ edge that announced the packet. */
+} nci_tml_slot_t;
+
+typedef struct {
+  nci_tml_slot_t slots[MIKROE_PN7150_TML_POOL_SIZE];
+  uint8_t head;
+  uint8_t tail;
+  uint8_t count;
+} nci_tml_pool_t;
+
+static nci_tml_pool_t pool;
+static nci_tml_stats_t tml_stats;
+static nci_tml_notify_t notify_callback = NULL;
+static volatile bool irq_pending = false;
+static volatile uint32_t irq_tick;
+
+/**************************************************************************//**
+ * @brief
+ *  Convert the ticks elapsed since the IRQ edge to microseconds.
+ *****************************************************************************/
+static uint32_t nci_tml_latency_us(uint32_t tick)
+{
+  uint32_t elapsed = sl_sleeptimer_get_tick_count() - tick;
+
+  return (uint32_t)(((uint64_t)elapsed * 1000000)
+                    / sl_sleeptimer_get_timer_frequency());
+}
+
+#if defined(MIKROE_PN7150_INT_PORT) && defined(MIKROE_PN7150_INT_PIN)
+
+/**************************************************************************//**
+ * @brief
+ *  IRQ pin handler, the NFCC has a packet ready.
+ *****************************************************************************/
+#if (defined(SLI_SI917))
+static void nci_tml_irq_handler(uint32_t int_no)
+#else
+static void nci_tml_irq_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  irq_tick = sl_sleeptimer_get_tick_count();
+  irq_pending = true;
+
+  if (notify_callback != NULL) {
+    notify_callback();
+  }
+}
+
+#endif
+
+/**************************************************************************//**
+ * @brief
+ *  Take over the PN7150 IRQ pin.
+ *
+ * @param[in] notify
+ *  Function to call when a packet is ready.
+ *****************************************************************************/
+void nci_tml_init(nci_tml_notify_t notify)
+{
+  notify_callback = notify;
+  pool.head = 0;
+  pool.tail = 0;
+  pool.count = 0;
+  irq_pending = false;
+  nci_tml_reset_stats();
+
+#if defined(MIKROE_PN7150_INT_PORT) && defined(MIKROE_PN7150_INT_PIN)
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { MIKROE_PN7150_INT_PIN / 16,
+                              MIKROE_PN7150_INT_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     GPIO_M4_INTR,
+                                     SL_GPIO_INTERRUPT_RISING_EDGE,
+                                     nci_tml_irq_handler,
+                                     AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(MIKROE_PN7150_INT_PIN, nci_tml_irq_handler);
+  GPIO_ExtIntConfig(MIKROE_PN7150_INT_PORT,
+                    MIKROE_PN7150_INT_PIN,
+                    MIKROE_PN7150_INT_PIN,
+                    true,
+                    false,
+                    true);
+#endif
+#endif
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read the packets the NFCC has ready into the packet pool.
+ *****************************************************************************/
+void nci_tml_process(void)
+{
+  while (irq_pending && (pool.count < MIKROE_PN7150_TML_POOL_SIZE)) {
+    nci_tml_slot_t *slot = &pool.slots[pool.head];
+
+    /* Clear first, an edge during the read announces another packet. */
+    irq_pending = false;
+    slot->irq_tick = irq_tick;
+
+    if (mikroe_pn7150_read_packet(slot->packet) != SL_STATUS_OK) {
+      tml_stats.errors++;
+      return;
+    }
+
+    pool.head = (pool.head + 1) % MIKROE_PN7150_TML_POOL_SIZE;
+    pool.count++;
+
+    tml_stats.packets++;
+    tml_stats.read_latency_us = nci_tml_latency_us(slot->irq_tick);
+    if (tml_stats.read_latency_us > tml_stats.read_latency_max_us) {
+      tml_stats.read_latency_max_us = tml_stats.read_latency_us;
+    }
+
+    /* IRQ stays high while the NFCC has more packets, there is no edge. */
+    if (!irq_pending && mikroe_pn7150_check_irq()) {
+      irq_tick = sl_sleeptimer_get_tick_count();
+      irq_pending = true;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get the latency counters.
+ *****************************************************************************/
+void nci_tml_get_stats(nci_tml_stats_t *stats)
+{
+  if (stats != NULL) {
+    *stats = tml_stats;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Reset the latency counters.
+ *****************************************************************************/
+void nci_tml_reset_stats(void)
+{
+  memset(&tml_stats, 0, sizeof(tml_stats));
+}
 
 /**************************************************************************//**
  * @brief
@@ -49,11 +215,34 @@
  *****************************************************************************/
 nci_tml_err_t nci_tml_receive(uint8_t *packet)
 {
-  sl_status_t ret;
+  nci_tml_slot_t *slot;
+  uint32_t latency_us;
 
-  ret = mikroe_pn7150_generic_read(packet, &packet[3]);
-  if (ret != SL_STATUS_OK) {
-    return nci_tml_err_comm_bus;
+  nci_tml_process();
+
+  /* IRQ not owned by the TML, read the packet directly. */
+  if (pool.count == 0) {
+    if (mikroe_pn7150_read_packet(packet) != SL_STATUS_OK) {
+      return nci_tml_err_comm_bus;
+    }
+    return nci_tml_err_none;
+  }
+
+  slot = &pool.slots[pool.tail];
+  memcpy(packet, slot->packet, slot->packet[2] + 3);
+
+  pool.tail = (pool.tail + 1) % MIKROE_PN7150_TML_POOL_SIZE;
+  pool.count--;
+
+  latency_us = nci_tml_latency_us(slot->irq_tick);
+  tml_stats.deliver_latency_us = latency_us;
+  if (latency_us > tml_stats.deliver_latency_max_us) {
+    tml_stats.deliver_latency_max_us = latency_us;
+  }
+
+  /* More packets were read ahead, ask the NCI layer to come back. */
+  if ((pool.count > 0) && (notify_callback != NULL)) {
+    notify_callback();
   }
 
   return nci_tml_err_none;
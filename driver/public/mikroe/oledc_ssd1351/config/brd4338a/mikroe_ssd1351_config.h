@@ -58,6 +58,16 @@
 #define MIKROE_SSD1351_SPI_BITRATE             10000000
 
 // </e>
+// </h>
+
+// <h> MIKROE SSD1351 Display Configuration
+
+// <q MIKROE_SSD1351_FRAME_BUFFER> Frame buffer
+// <i> Enable: Drawing goes to a frame buffer in RAM (18 KB), the rectangle changed since the last update is sent in one burst by the update.
+// <i> Disable: Every pixel and rectangle is sent to the display when it's drawn, pixels can't be read back.
+// <i> Default: 1
+#define MIKROE_SSD1351_FRAME_BUFFER            1
+
 // </h>
 // <<< end of configuration section >>>
 
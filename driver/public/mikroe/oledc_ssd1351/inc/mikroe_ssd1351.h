@@ -116,8 +116,8 @@ extern "C" {
 #define MIKROE_SSD1351_MUX_RATIO             0xCA
 #define MIKROE_SSD1351_COMMAND_LOCK          0xFD
 #define MIKROE_SSD1351_SCROLL_HOR            0x96
-#define MIKROE_SSD1351_START_MOV             0x9E
-#define MIKROE_SSD1351_STOP_MOV              0x9F
+#define MIKROE_SSD1351_START_MOV             0x9F
+#define MIKROE_SSD1351_STOP_MOV              0x9E
 
 #define MIKROE_SSD1351_DEFAULT_MUX_RATIO     95
 #define MIKROE_SSD1351_DEFAULT_START_LINE    0x80
@@ -131,6 +131,19 @@ extern "C" {
 #define MIKROE_SSD1351_DEFAULT_MASTER_CONT   0xCF
 #define MIKROE_SSD1351_DEFAULT_PRECHARGE_2   0x01
 
+/** \} */
+
+/**
+ * \defgroup scroll_interval Horizontal Scroll Time Interval
+ * \{
+ */
+#define MIKROE_SSD1351_SCROLL_TEST           0x00
+#define MIKROE_SSD1351_SCROLL_NORMAL         0x01
+#define MIKROE_SSD1351_SCROLL_SLOW           0x02
+#define MIKROE_SSD1351_SCROLL_SLOWEST        0x03
+
+/** \} */
+
 /***************************************************************************//**
  * @brief
  *    Initialization function.
@@ -263,6 +276,70 @@ sl_status_t mikroe_ssd1351_image(const uint8_t *img,
                                  uint8_t col_off,
                                  uint8_t row_off);
 
+/***************************************************************************//**
+ * @brief
+ *    Write a window of pixels in one burst.
+ *
+ * @param[in] col_off  Column offset from the left border of the screen.
+ * @param[in] row_off  Row offset from the top border of the screen.
+ * @param[in] col_end  Column end offset (exclusive) counted from the left.
+ * @param[in] row_end  Row end offset (exclusive) counted from the top.
+ * @param[in] data  Top left pixel of the window, RGB565 with the high byte
+ *                  first.
+ * @param[in] stride  Distance of two rows in data in bytes.
+ *
+ * @return
+ *    SL_STATUS_OK Successful transfer.
+ *    SL_STATUS_INVALID_PARAMETER The window is empty or off the screen.
+ *    SL_STATUS_TRANSMIT The SPI transfer failed.
+ *
+ * @note
+ *    The window is set once and the rows are sent in a single chip select,
+ *    as few DMA transfers as the row layout allows, rows of a full width
+ *    window are contiguous and they are merged.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_write_area(uint8_t col_off,
+                                      uint8_t row_off,
+                                      uint8_t col_end,
+                                      uint8_t row_end,
+                                      const uint8_t *data,
+                                      uint16_t stride);
+
+/***************************************************************************//**
+ * @brief
+ *    Start the horizontal scroll of the controller.
+ *
+ * @param[in] offset  Columns to move per step, 1..63 move the content to
+ *                    the left, negative values to the right.
+ * @param[in] start_row  First row to scroll.
+ * @param[in] rows  Number of rows to scroll.
+ * @param[in] interval  Time interval between steps, see
+ *                      \ref scroll_interval.
+ *
+ * @return
+ *    SL_STATUS_OK Successful initialization.
+ *    SL_STATUS_INVALID_PARAMETER offset is 0 or the rows are off the screen.
+ *
+ * @note
+ *    The content is moved by the controller, no pixel data is transferred.
+ *    The RAM shall not be written while the scroll is active, stop it with
+ *    \ref mikroe_ssd1351_stop_scroll() first.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_start_scroll(int8_t offset,
+                                        uint8_t start_row,
+                                        uint8_t rows,
+                                        uint8_t interval);
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the horizontal scroll of the controller.
+ *
+ * @return
+ *    SL_STATUS_OK Successful initialization.
+ *    SL_STATUS_FAIL Initialization failed.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_stop_scroll(void);
+
 /***************************************************************************//**
  * @brief
  *    Draw Text.
@@ -40,9 +40,30 @@
 #include "mikroe_ssd1351_config.h"
 #include "stdio.h"
 
+/// Bytes of pixel data prepared at once for a fill or an image
+#define MIKROE_SSD1351_BURST_SIZE     (MIKROE_SSD1351_SCREEN_WIDTH * 2 * 4)
+
+/// Longest single SPI transfer, DMADRV limits a transfer to 2048 items
+#define MIKROE_SSD1351_MAX_TRANSFER   2048
+
 static oledc_t oledc;
 static oledc_cfg_t oledc_cfg;
 static bool initialized = false;
+static uint8_t burst_buffer[MIKROE_SSD1351_BURST_SIZE];
+
+// -----------------------------------------------------------------------------
+// Static Function Declarations
+// -----------------------------------------------------------------------------
+static sl_status_t begin_write_ram(uint8_t col_off,
+                                   uint8_t row_off,
+                                   uint8_t col_end,
+                                   uint8_t row_end);
+static sl_status_t write_ram(uint8_t *data, uint16_t len);
+static sl_status_t fill_area(uint8_t col_off,
+                             uint8_t row_off,
+                             uint8_t col_end,
+                             uint8_t row_end,
+                             uint16_t color);
 
 // -----------------------------------------------------------------------------
 // Public Function Definition
@@ -177,9 +198,11 @@ sl_status_t mikroe_ssd1351_fill_screen(uint16_t color)
   if (!initialized) {
     return SL_STATUS_NOT_INITIALIZED;
   }
-  oledc_fill_screen(&oledc, color);
-
-  return SL_STATUS_OK;
+  return fill_area(0,
+                   0,
+                   MIKROE_SSD1351_SCREEN_WIDTH,
+                   MIKROE_SSD1351_SCREEN_HEIGHT,
+                   color);
 }
 
 /***************************************************************************//**
@@ -194,9 +217,7 @@ sl_status_t mikroe_ssd1351_rectangle(uint8_t col_off,
   if (!initialized) {
     return SL_STATUS_NOT_INITIALIZED;
   }
-  oledc_rectangle(&oledc, col_off, row_off, col_end, row_end, color);
-
-  return SL_STATUS_OK;
+  return fill_area(col_off, row_off, col_end, row_end, color);
 }
 
 /***************************************************************************//**
@@ -209,7 +230,132 @@ sl_status_t mikroe_ssd1351_image(const uint8_t *img,
   if (!initialized) {
     return SL_STATUS_NOT_INITIALIZED;
   }
-  oledc_image(&oledc, img, col_off, row_off);
+  if (NULL == img) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  // The image is stored with the low byte first, it's swapped row by row
+  // into the burst buffer, as many rows at once as the buffer holds.
+  uint8_t width = img[2];
+  uint8_t height = img[4];
+  uint16_t row_size = width * 2;
+  const uint8_t *ptr = img + MIKROE_SSD1351_IMG_HEAD;
+  sl_status_t sc;
+
+  if ((width == 0) || (row_size > MIKROE_SSD1351_BURST_SIZE)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sc = begin_write_ram(col_off, row_off, col_off + width, row_off + height);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  uint8_t rows_per_burst = MIKROE_SSD1351_BURST_SIZE / row_size;
+  for (uint8_t row = 0; (row < height) && (SL_STATUS_OK == sc); ) {
+    uint16_t len = 0;
+
+    for (uint8_t i = 0; (i < rows_per_burst) && (row < height); i++, row++) {
+      for (uint16_t j = 0; j < row_size; j += 2) {
+        burst_buffer[len++] = ptr[j + 1];
+        burst_buffer[len++] = ptr[j];
+      }
+      ptr += row_size;
+    }
+    sc = write_ram(burst_buffer, len);
+  }
+  spi_master_deselect_device(oledc.chip_select);
+
+  return sc;
+}
+
+/***************************************************************************//**
+ *    Write a window of pixels in one burst.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_write_area(uint8_t col_off,
+                                      uint8_t row_off,
+                                      uint8_t col_end,
+                                      uint8_t row_end,
+                                      const uint8_t *data,
+                                      uint16_t stride)
+{
+  if (!initialized) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  if (NULL == data) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  uint16_t row_size = (col_end - col_off) * 2;
+  uint16_t rows = row_end - row_off;
+  uint16_t rows_per_write = 1;
+  sl_status_t sc;
+
+  sc = begin_write_ram(col_off, row_off, col_end, row_end);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  // Rows follow each other without a gap, they are sent together
+  if (stride == row_size) {
+    rows_per_write = MIKROE_SSD1351_MAX_TRANSFER / row_size;
+  }
+
+  while ((rows > 0) && (SL_STATUS_OK == sc)) {
+    uint16_t count = (rows < rows_per_write) ? rows : rows_per_write;
+
+    sc = write_ram((uint8_t *)data, count * row_size);
+    data += count * stride;
+    rows -= count;
+  }
+  spi_master_deselect_device(oledc.chip_select);
+
+  return sc;
+}
+
+/***************************************************************************//**
+ *    Start the horizontal scroll of the controller.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_start_scroll(int8_t offset,
+                                        uint8_t start_row,
+                                        uint8_t rows,
+                                        uint8_t interval)
+{
+  if (!initialized) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  if ((offset == 0) || (offset > 63) || (rows == 0)
+      || ((start_row + rows) > MIKROE_SSD1351_SCREEN_HEIGHT)
+      || (interval > MIKROE_SSD1351_SCROLL_SLOWEST)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // 1..63 moves towards SEG127, 64..255 towards SEG0. With the column
+  // address remap of the default configuration SEG127 is on the left.
+  uint8_t args[5] = {
+    (offset > 0) ? (uint8_t)offset : (uint8_t)(256 + offset),
+    start_row + MIKROE_SSD1351_ROW_OFF,
+    rows,
+    0x00,
+    interval
+  };
+
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_STOP_MOV, 0, 0);
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_SCROLL_HOR, args, 5);
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_START_MOV, 0, 0);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *    Stop the horizontal scroll of the controller.
+ ******************************************************************************/
+sl_status_t mikroe_ssd1351_stop_scroll(void)
+{
+  if (!initialized) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_STOP_MOV, 0, 0);
 
   return SL_STATUS_OK;
 }
@@ -252,3 +398,97 @@ sl_status_t mikroe_ssd1351_set_contrast(uint8_t contrast)
   oledc_more_arg_commands(&oledc, OLEDC_CONTRAST, oledc_contrast, 3);
   return SL_STATUS_OK;
 }
+
+// -----------------------------------------------------------------------------
+// Static Function Definition
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ *    Set the RAM window and start the RAM write, the chip select is left
+ *    asserted on success.
+ ******************************************************************************/
+static sl_status_t begin_write_ram(uint8_t col_off,
+                                   uint8_t row_off,
+                                   uint8_t col_end,
+                                   uint8_t row_end)
+{
+  uint8_t cmd = MIKROE_SSD1351_WRITE_RAM;
+  uint8_t cols[2];
+  uint8_t rows[2];
+
+  if ((col_end > MIKROE_SSD1351_SCREEN_WIDTH)
+      || (row_end > MIKROE_SSD1351_SCREEN_HEIGHT)
+      || (col_end <= col_off)
+      || (row_end <= row_off)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  cols[0] = MIKROE_SSD1351_COL_OFF + col_off;
+  cols[1] = MIKROE_SSD1351_COL_OFF + col_end - 1;
+  rows[0] = MIKROE_SSD1351_ROW_OFF + row_off;
+  rows[1] = MIKROE_SSD1351_ROW_OFF + row_end - 1;
+
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_SET_COL_ADDRESS, cols, 2);
+  oledc_more_arg_commands(&oledc, MIKROE_SSD1351_SET_ROW_ADDRESS, rows, 2);
+
+  spi_master_select_device(oledc.chip_select);
+  digital_out_low(&oledc.dc);
+  if (spi_master_write(&oledc.spi, &cmd, 1) != SPI_MASTER_SUCCESS) {
+    digital_out_high(&oledc.dc);
+    spi_master_deselect_device(oledc.chip_select);
+    return SL_STATUS_TRANSMIT;
+  }
+  digital_out_high(&oledc.dc);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *    Send pixel data after \ref begin_write_ram().
+ ******************************************************************************/
+static sl_status_t write_ram(uint8_t *data, uint16_t len)
+{
+  if (spi_master_write(&oledc.spi, data, len) != SPI_MASTER_SUCCESS) {
+    return SL_STATUS_TRANSMIT;
+  }
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *    Fill a window with one color, the burst buffer is filled once and sent
+ *    as many times as needed.
+ ******************************************************************************/
+static sl_status_t fill_area(uint8_t col_off,
+                             uint8_t row_off,
+                             uint8_t col_end,
+                             uint8_t row_end,
+                             uint16_t color)
+{
+  sl_status_t sc;
+  uint32_t remaining;
+  uint16_t len;
+
+  sc = begin_write_ram(col_off, row_off, col_end, row_end);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  remaining = (uint32_t)(col_end - col_off) * (row_end - row_off) * 2;
+  len = (remaining < MIKROE_SSD1351_BURST_SIZE)
+        ? (uint16_t)remaining : MIKROE_SSD1351_BURST_SIZE;
+  for (uint16_t i = 0; i < len; i += 2) {
+    burst_buffer[i] = color >> 8;
+    burst_buffer[i + 1] = color & 0x00FF;
+  }
+
+  while ((remaining > 0) && (SL_STATUS_OK == sc)) {
+    if (remaining < len) {
+      len = (uint16_t)remaining;
+    }
+    sc = write_ram(burst_buffer, len);
+    remaining -= len;
+  }
+  spi_master_deselect_device(oledc.chip_select);
+
+  return sc;
+}
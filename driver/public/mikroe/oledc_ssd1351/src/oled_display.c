@@ -36,12 +36,27 @@
 #include "mikroe_ssd1351_config.h"
 #include "oled_display.h"
 
-#define FRAME_HEADER          6
-#define FRAME_BUFFER_SIZE     SSD1351_DISPLAY_HEIGHT *SSD1351_DISPLAY_WIDTH \
-  *SSD1351_DISPLAY_COLOR / 8 + FRAME_HEADER
+#ifndef MIKROE_SSD1351_FRAME_BUFFER
+#define MIKROE_SSD1351_FRAME_BUFFER   1
+#endif
+
+#define FRAME_STRIDE \
+  (SSD1351_DISPLAY_WIDTH * SSD1351_DISPLAY_COLOR / 8)
+#define FRAME_BUFFER_SIZE     (SSD1351_DISPLAY_HEIGHT * FRAME_STRIDE)
+
+#if MIKROE_SSD1351_FRAME_BUFFER
+/* This oled_frame_buffer is large enough to store one full frame, the pixels
+ * are RGB565 with the high byte first, the order the controller expects. */
+static uint8_t oled_frame_buffer[FRAME_BUFFER_SIZE];
+
+/* Rectangle changed since the last update, the end is exclusive. It's empty
+ * if dirty_x_end is 0. */
+static int16_t dirty_x_start;
+static int16_t dirty_y_start;
+static int16_t dirty_x_end;
+static int16_t dirty_y_end;
+#endif
 
-/* This oled_frame_buffer is large enough to store one full frame. */
-static uint8_t oled_frame_buffer[18438];
 static oled_display_t oled_display_instance;
 
 /** Flag to monitor is this driver has been initialized. The
@@ -57,7 +72,18 @@ static uint16_t get_raw_pixel(int16_t x, int16_t y);
 static sl_status_t enable_display(bool state);
 static sl_status_t set_contrast(uint8_t contrast);
 static sl_status_t fill_screen(uint16_t color);
+static sl_status_t fill_rect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color);
 static sl_status_t update_display(void);
+static sl_status_t scroll_right(uint8_t start_page_addr,
+                                uint8_t end_page_addr);
+static sl_status_t scroll_left(uint8_t start_page_addr,
+                               uint8_t end_page_addr);
+static sl_status_t stop_scroll(void);
+#if MIKROE_SSD1351_FRAME_BUFFER
+static void mark_dirty(int16_t x_start, int16_t y_start,
+                       int16_t x_end, int16_t y_end);
+#endif
 
 // -----------------------------------------------------------------------------
 // Public Function Definition
@@ -73,11 +99,12 @@ static const oled_display_driver_api_t sl_memlcd_driver_api =
   .set_invert_color = NULL,
   .set_normal_color = NULL,
   .set_contrast = set_contrast,
-  .scroll_right = NULL,
-  .scroll_left = NULL,
+  .scroll_right = scroll_right,
+  .scroll_left = scroll_left,
   .scroll_diag_right = NULL,
   .scroll_diag_left = NULL,
-  .stop_scroll = NULL,
+  .stop_scroll = stop_scroll,
+  .fill_rect = fill_rect,
 };
 
 sl_status_t oled_display_init(void)
@@ -85,12 +112,9 @@ sl_status_t oled_display_init(void)
   oled_display_instance.width = SSD1351_DISPLAY_WIDTH;
   oled_display_instance.height = SSD1351_DISPLAY_HEIGHT;
   oled_display_instance.driver = &sl_memlcd_driver_api;
-  oled_frame_buffer[0] = 0x00;
-  oled_frame_buffer[1] = 0x10;
-  oled_frame_buffer[2] = 0x60;
-  oled_frame_buffer[3] = 0x00;
-  oled_frame_buffer[4] = 0x60;
-  oled_frame_buffer[5] = 0x00;
+#if MIKROE_SSD1351_FRAME_BUFFER
+  dirty_x_end = 0;
+#endif
   initialized = true;
   return SL_STATUS_OK;
 }
@@ -114,45 +138,116 @@ static sl_status_t driver_init(void)
 
 static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color)
 {
-  if ((x > OLEDC_SCREEN_WIDTH) || (y > OLEDC_SCREEN_HEIGHT)) {
+  if ((x < 0) || (y < 0)
+      || (x >= SSD1351_DISPLAY_WIDTH) || (y >= SSD1351_DISPLAY_HEIGHT)) {
     return SL_STATUS_FAIL;
   }
 
-  size_t index = FRAME_HEADER + 2 * (y * SSD1351_DISPLAY_WIDTH + x);
+#if MIKROE_SSD1351_FRAME_BUFFER
+  size_t index = y * FRAME_STRIDE + x * 2;
 
   oled_frame_buffer[index] = color >> 8;
   oled_frame_buffer[index + 1] = color & 0x00FF;
+  mark_dirty(x, y, x + 1, y + 1);
 
   return SL_STATUS_OK;
+#else
+  return mikroe_ssd1351_rectangle(x, y, x + 1, y + 1, color);
+#endif
 }
 
 static uint16_t get_raw_pixel(int16_t x, int16_t y)
 {
-  uint8_t index = y * SSD1351_DISPLAY_WIDTH * 2 + x * 2 + FRAME_HEADER;
+#if MIKROE_SSD1351_FRAME_BUFFER
+  if ((x < 0) || (y < 0)
+      || (x >= SSD1351_DISPLAY_WIDTH) || (y >= SSD1351_DISPLAY_HEIGHT)) {
+    return 0;
+  }
+
+  size_t index = y * FRAME_STRIDE + x * 2;
   return (uint16_t)(oled_frame_buffer[index] << 8)
          | oled_frame_buffer[index + 1];
+#else
+  // The RAM of the controller can't be read over SPI
+  (void)x;
+  (void)y;
+  return 0;
+#endif
 }
 
 static sl_status_t fill_screen(uint16_t color)
 {
-  oled_frame_buffer[0] = 0x00;
-  oled_frame_buffer[1] = 0x10;
-  oled_frame_buffer[2] = 0x60;
-  oled_frame_buffer[3] = 0x00;
-  oled_frame_buffer[4] = 0x60;
-  oled_frame_buffer[5] = 0x00;
-
-  /* Fill the display with the color of the glib_context_t  */
-  for (size_t i = 0; i < 96 * 96; i++) {
-    oled_frame_buffer[FRAME_HEADER + i * 2] = color >> 8;
-    oled_frame_buffer[FRAME_HEADER + i * 2 + 1] = color & 0x00FF;
+  return fill_rect(0, 0, SSD1351_DISPLAY_WIDTH, SSD1351_DISPLAY_HEIGHT, color);
+}
+
+static sl_status_t fill_rect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color)
+{
+  int16_t x_end = x + w;
+  int16_t y_end = y + h;
+
+  if (x < 0) {
+    x = 0;
+  }
+  if (y < 0) {
+    y = 0;
+  }
+  if (x_end > SSD1351_DISPLAY_WIDTH) {
+    x_end = SSD1351_DISPLAY_WIDTH;
+  }
+  if (y_end > SSD1351_DISPLAY_HEIGHT) {
+    y_end = SSD1351_DISPLAY_HEIGHT;
   }
+  if ((x >= x_end) || (y >= y_end)) {
+    return SL_STATUS_OK;
+  }
+
+#if MIKROE_SSD1351_FRAME_BUFFER
+  uint8_t *row = &oled_frame_buffer[y * FRAME_STRIDE + x * 2];
+  uint16_t row_size = (x_end - x) * 2;
+
+  // The first row is filled pixel by pixel, the others are copies of it
+  for (uint16_t i = 0; i < row_size; i += 2) {
+    row[i] = color >> 8;
+    row[i + 1] = color & 0x00FF;
+  }
+  for (int16_t i = y + 1; i < y_end; i++) {
+    memcpy(row + (i - y) * FRAME_STRIDE, row, row_size);
+  }
+  mark_dirty(x, y, x_end, y_end);
+
   return SL_STATUS_OK;
+#else
+  return mikroe_ssd1351_rectangle(x, y, x_end, y_end, color);
+#endif
 }
 
 static sl_status_t update_display(void)
 {
-  return mikroe_ssd1351_image(oled_frame_buffer, 0, 0);
+#if MIKROE_SSD1351_FRAME_BUFFER
+  sl_status_t sc;
+
+  if (dirty_x_end == 0) {
+    return SL_STATUS_OK;
+  }
+
+  // Only the changed rectangle is sent, in one RAM write
+  sc = mikroe_ssd1351_write_area(dirty_x_start,
+                                 dirty_y_start,
+                                 dirty_x_end,
+                                 dirty_y_end,
+                                 &oled_frame_buffer[dirty_y_start
+                                                    * FRAME_STRIDE
+                                                    + dirty_x_start * 2],
+                                 FRAME_STRIDE);
+  if (SL_STATUS_OK == sc) {
+    dirty_x_end = 0;
+  }
+  return sc;
+#else
+  // Everything is drawn straight to the display
+  return SL_STATUS_OK;
+#endif
 }
 
 static sl_status_t set_contrast(uint8_t contrast)
@@ -164,3 +259,70 @@ sl_status_t enable_display(bool state)
 {
   return mikroe_ssd1351_enable(state);
 }
+
+static sl_status_t scroll_right(uint8_t start_page_addr,
+                                uint8_t end_page_addr)
+{
+  // A page is 8 rows, as on the monochrome displays
+  if (end_page_addr < start_page_addr) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return mikroe_ssd1351_start_scroll(-1,
+                                     start_page_addr * 8,
+                                     (end_page_addr - start_page_addr + 1) * 8,
+                                     MIKROE_SSD1351_SCROLL_NORMAL);
+}
+
+static sl_status_t scroll_left(uint8_t start_page_addr,
+                               uint8_t end_page_addr)
+{
+  if (end_page_addr < start_page_addr) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return mikroe_ssd1351_start_scroll(1,
+                                     start_page_addr * 8,
+                                     (end_page_addr - start_page_addr + 1) * 8,
+                                     MIKROE_SSD1351_SCROLL_NORMAL);
+}
+
+static sl_status_t stop_scroll(void)
+{
+  sl_status_t sc;
+
+  sc = mikroe_ssd1351_stop_scroll();
+#if MIKROE_SSD1351_FRAME_BUFFER
+  // The scroll has moved the content of the GDDRAM, it no longer matches
+  // the frame buffer, so the next update sends the whole frame
+  if (sc == SL_STATUS_OK) {
+    mark_dirty(0, 0, SSD1351_DISPLAY_WIDTH, SSD1351_DISPLAY_HEIGHT);
+  }
+#endif
+  return sc;
+}
+
+#if MIKROE_SSD1351_FRAME_BUFFER
+static void mark_dirty(int16_t x_start, int16_t y_start,
+                       int16_t x_end, int16_t y_end)
+{
+  if (dirty_x_end == 0) {
+    dirty_x_start = x_start;
+    dirty_y_start = y_start;
+    dirty_x_end = x_end;
+    dirty_y_end = y_end;
+    return;
+  }
+
+  if (x_start < dirty_x_start) {
+    dirty_x_start = x_start;
+  }
+  if (y_start < dirty_y_start) {
+    dirty_y_start = y_start;
+  }
+  if (x_end > dirty_x_end) {
+    dirty_x_end = x_end;
+  }
+  if (y_end > dirty_y_end) {
+    dirty_y_end = y_end;
+  }
+}
+#endif
@@ -93,6 +93,18 @@ extern "C" {
 #define LTC2497_ADDRESS                           0x14
 // </h>
 
+// <h> Trajectory
+// <o MIKROE_SERVO_TRAJECTORY_TICK_MS> Interpolation tick in milliseconds <5-1000>
+// <i> All moving channels are updated in one I2C burst per tick.
+// <i> Default: 20
+#define MIKROE_SERVO_TRAJECTORY_TICK_MS           20
+
+// <o MIKROE_SERVO_TRAJECTORY_DEFAULT_SPEED> Default speed limit in position units per second <0-65535>
+// <i> 0 disables the limit.
+// <i> Default: 90
+#define MIKROE_SERVO_TRAJECTORY_DEFAULT_SPEED     90
+// </h>
+
 // <<< end of configuration section >>>
 
 // <<< sl:start pin_tool >>>
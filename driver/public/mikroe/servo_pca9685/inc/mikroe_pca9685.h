@@ -40,6 +40,7 @@
 #ifndef MIKROE_PCA9685_H_
 #define MIKROE_PCA9685_H_
 
+#include <stdbool.h>
 #include "sl_status.h"
 #include "drv_i2c_master.h"
 #include "mikroe_servo_config.h"
@@ -206,6 +207,9 @@ typedef struct {
 #define MIKROE_SERVO_MOTOR_15                        0x3E
 #define MIKROE_SERVO_MOTOR_16                        0x42
 
+#define MIKROE_SERVO_CHANNEL_COUNT                   16
+#define MIKROE_SERVO_MOTOR_REG_SIZE                  4
+
 #define MIKROE_SERVO_POSITIVE_CH0_NEGATIVE_CH1       0xA0
 #define MIKROE_SERVO_POSITIVE_CH2_NEGATIVE_CH3       0xA1
 #define MIKROE_SERVO_POSITIVE_CH4_NEGATIVE_CH5       0xA2
@@ -465,6 +469,80 @@ sl_status_t mikroe_pca9685_get_channel(uint8_t channel, uint32_t *adc_value);
  */
 sl_status_t mikroe_pca9685_get_current(uint8_t channel, uint16_t *current_ma);
 
+/**
+ * @brief Set the position of several motors in one transfer.
+ *
+ * @param first_motor  First motor to be set, MIKROE_SERVO_MOTOR_1 to
+ *   MIKROE_SERVO_MOTOR_16.
+ * @param positions    Positions of first_motor and the motors following it.
+ * @param count        Number of motors to set.
+ *
+ * @return status of function.
+ *
+ * @description This function writes the ON/OFF registers of consecutive
+ *   motors in a single auto-increment I2C burst. The outputs change on the
+ *   STOP condition, so every motor switches to its new position in the same
+ *   PWM cycle.
+ */
+sl_status_t mikroe_pca9685_set_positions(uint8_t first_motor,
+                                         const uint8_t *positions,
+                                         uint8_t count);
+
+/**
+ * @brief Set the speed limit of a motor for trajectory moves.
+ *
+ * @param motor  Motor to be set.
+ * @param speed  Speed limit in position units per second, 0 disables the
+ *   limit.
+ *
+ * @return status of function.
+ *
+ * @description The limit defaults to MIKROE_SERVO_TRAJECTORY_DEFAULT_SPEED.
+ */
+sl_status_t mikroe_pca9685_trajectory_set_speed(uint8_t motor, uint16_t speed);
+
+/**
+ * @brief Start a coordinated move of several motors.
+ *
+ * @param positions     Target position of every channel, indexed from
+ *   motor 1. Only the channels selected by channel_mask are used.
+ * @param channel_mask  Bit n selects motor n + 1.
+ *
+ * @return status of function.
+ *
+ * @description The move takes as long as the motor that is slowest under its
+ *   speed limit needs, the other motors are slowed down so all of them
+ *   arrive together. Positions are interpolated every
+ *   MIKROE_SERVO_TRAJECTORY_TICK_MS milliseconds by
+ *   mikroe_pca9685_trajectory_process(). A motor whose position has never
+ *   been set goes to its target on the first tick.
+ */
+sl_status_t mikroe_pca9685_trajectory_move(const uint8_t *positions,
+                                           uint16_t channel_mask);
+
+/**
+ * @brief Trajectory process function.
+ *
+ * @return status of function.
+ *
+ * @description This function has to be called from the main loop. When a
+ *   tick has elapsed it advances all moving motors and writes them in one
+ *   I2C burst.
+ */
+sl_status_t mikroe_pca9685_trajectory_process(void);
+
+/**
+ * @brief Stop the trajectory, the motors hold their current position.
+ */
+void mikroe_pca9685_trajectory_stop(void);
+
+/**
+ * @brief Check if a trajectory move is in progress.
+ *
+ * @return true while any motor is moving.
+ */
+bool mikroe_pca9685_trajectory_is_busy(void);
+
 #ifdef __cplusplus
 }
 #endif
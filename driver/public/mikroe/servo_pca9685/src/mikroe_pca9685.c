@@ -40,10 +40,42 @@
 #include "stddef.h"
 #include "mikroe_pca9685.h"
 #include "servo.h"
+#include "sl_sleeptimer.h"
+
+// Lowest OFF count written by servo_set_position
+#define MIKROE_SERVO_MIN_COUNT    70
+
+// Trajectory positions are kept in 1/256 position units
+#define MIKROE_SERVO_Q8_SHIFT     8
+
+typedef struct {
+  int32_t current;
+  int32_t target;
+  int32_t step;
+  uint16_t ticks;
+  uint16_t speed;
+  bool valid;
+} mikroe_servo_joint_t;
 
 static servo_t servo_ctx;
 static servo_cfg_t servo_cfg;
 
+static mikroe_servo_joint_t servo_joint[MIKROE_SERVO_CHANNEL_COUNT];
+static sl_sleeptimer_timer_handle_t trajectory_timer;
+static volatile bool trajectory_tick = false;
+static bool trajectory_running = false;
+static bool trajectory_speed_init = false;
+
+static uint16_t mikroe_pca9685_counts(int32_t position_q8);
+static void mikroe_pca9685_write_counts(uint8_t first,
+                                        const uint16_t *counts,
+                                        uint8_t count);
+static void mikroe_pca9685_joint_set(uint8_t channel, uint8_t position);
+static void mikroe_pca9685_trajectory_speed_init(void);
+static void mikroe_pca9685_trajectory_timer_callback(
+  sl_sleeptimer_timer_handle_t *handle,
+  void *data);
+
 sl_status_t mikroe_pca9685_set_i2c_instance(mikroe_i2c_handle_t i2c_instance)
 {
   if (NULL == i2c_instance) {
@@ -201,6 +233,8 @@ sl_status_t mikroe_pca9685_set_position(uint8_t motor, uint8_t position)
   }
 
   servo_set_position(&servo_ctx, motor, position);
+  mikroe_pca9685_joint_set((motor - MIKROE_SERVO_MOTOR_1)
+                           / MIKROE_SERVO_MOTOR_REG_SIZE, position);
 
   return SL_STATUS_OK;
 }
@@ -233,3 +267,296 @@ sl_status_t mikroe_pca9685_get_current(uint8_t channel, uint16_t *current_ma)
 
   return SL_STATUS_OK;
 }
+
+sl_status_t mikroe_pca9685_set_positions(uint8_t first_motor,
+                                         const uint8_t *positions,
+                                         uint8_t count)
+{
+  uint16_t counts[MIKROE_SERVO_CHANNEL_COUNT];
+  uint8_t first;
+
+  if ((NULL == positions) || (first_motor < MIKROE_SERVO_MOTOR_1)
+      || (first_motor > MIKROE_SERVO_MOTOR_16)
+      || (((first_motor - MIKROE_SERVO_MOTOR_1)
+           % MIKROE_SERVO_MOTOR_REG_SIZE) != 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  first = (first_motor - MIKROE_SERVO_MOTOR_1) / MIKROE_SERVO_MOTOR_REG_SIZE;
+  if ((0 == count) || ((first + count) > MIKROE_SERVO_CHANNEL_COUNT)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if ((positions[i] < servo_ctx.min_pos)
+        || (positions[i] > servo_ctx.max_pos)) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    counts[i] = mikroe_pca9685_counts((int32_t)positions[i]
+                                      << MIKROE_SERVO_Q8_SHIFT);
+  }
+
+  mikroe_pca9685_write_counts(first, counts, count);
+
+  for (uint8_t i = 0; i < count; i++) {
+    mikroe_pca9685_joint_set(first + i, positions[i]);
+  }
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t mikroe_pca9685_trajectory_set_speed(uint8_t motor, uint16_t speed)
+{
+  if ((motor < MIKROE_SERVO_MOTOR_1) || (motor > MIKROE_SERVO_MOTOR_16)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  mikroe_pca9685_trajectory_speed_init();
+  servo_joint[(motor - MIKROE_SERVO_MOTOR_1)
+              / MIKROE_SERVO_MOTOR_REG_SIZE].speed = speed;
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t mikroe_pca9685_trajectory_move(const uint8_t *positions,
+                                           uint16_t channel_mask)
+{
+  uint32_t ticks = 1;
+  sl_status_t stt;
+
+  if ((NULL == positions) || (0 == channel_mask)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    if ((channel_mask & (1 << ch))
+        && ((positions[ch] < servo_ctx.min_pos)
+            || (positions[ch] > servo_ctx.max_pos))) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+  }
+
+  mikroe_pca9685_trajectory_speed_init();
+
+  // The slowest motor under its speed limit sets the duration of the move
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    mikroe_servo_joint_t *joint = &servo_joint[ch];
+    uint32_t distance;
+    uint64_t per_tick;
+    uint32_t needed;
+
+    if (!(channel_mask & (1 << ch))) {
+      continue;
+    }
+
+    joint->target = (int32_t)positions[ch] << MIKROE_SERVO_Q8_SHIFT;
+    if (!joint->valid || (0 == joint->speed)) {
+      continue;
+    }
+
+    distance = (joint->target > joint->current)
+               ? (uint32_t)(joint->target - joint->current)
+               : (uint32_t)(joint->current - joint->target);
+
+    // Q8 position units covered per tick at the speed limit
+    per_tick = ((uint64_t)joint->speed * MIKROE_SERVO_TRAJECTORY_TICK_MS
+                << MIKROE_SERVO_Q8_SHIFT) / 1000;
+    if (0 == per_tick) {
+      per_tick = 1;
+    }
+    needed = (uint32_t)((distance + per_tick - 1) / per_tick);
+    if (needed > ticks) {
+      ticks = needed;
+    }
+  }
+
+  if (ticks > UINT16_MAX) {
+    ticks = UINT16_MAX;
+  }
+
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    mikroe_servo_joint_t *joint = &servo_joint[ch];
+
+    if (!(channel_mask & (1 << ch))) {
+      continue;
+    }
+
+    if (!joint->valid) {
+      // Unknown start position, jump to the target on the first tick
+      joint->current = joint->target;
+      joint->step = 0;
+      joint->ticks = 1;
+      joint->valid = true;
+    } else {
+      joint->step = (joint->target - joint->current) / (int32_t)ticks;
+      joint->ticks = (uint16_t)ticks;
+    }
+  }
+
+  if (!trajectory_running) {
+    stt = sl_sleeptimer_start_periodic_timer_ms(
+      &trajectory_timer,
+      MIKROE_SERVO_TRAJECTORY_TICK_MS,
+      mikroe_pca9685_trajectory_timer_callback,
+      NULL,
+      0,
+      0);
+    if (SL_STATUS_OK != stt) {
+      return stt;
+    }
+    trajectory_running = true;
+  }
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t mikroe_pca9685_trajectory_process(void)
+{
+  uint16_t counts[MIKROE_SERVO_CHANNEL_COUNT];
+  uint8_t first = MIKROE_SERVO_CHANNEL_COUNT;
+  uint8_t last = 0;
+  bool busy = false;
+
+  if (!trajectory_tick) {
+    return SL_STATUS_OK;
+  }
+  trajectory_tick = false;
+
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    mikroe_servo_joint_t *joint = &servo_joint[ch];
+
+    if (0 == joint->ticks) {
+      continue;
+    }
+
+    joint->ticks--;
+    if (0 == joint->ticks) {
+      joint->current = joint->target;
+    } else {
+      joint->current += joint->step;
+      busy = true;
+    }
+
+    if (ch < first) {
+      first = ch;
+    }
+    last = ch;
+  }
+
+  if (!busy) {
+    mikroe_pca9685_trajectory_stop();
+  }
+
+  // One burst per run of known channels between the first and last update
+  while (first <= last) {
+    uint8_t count = 0;
+
+    while (((first + count) <= last) && servo_joint[first + count].valid) {
+      counts[count] = mikroe_pca9685_counts(servo_joint[first + count].current);
+      count++;
+    }
+    if (count > 0) {
+      mikroe_pca9685_write_counts(first, counts, count);
+    }
+    first += count + 1;
+  }
+
+  return SL_STATUS_OK;
+}
+
+void mikroe_pca9685_trajectory_stop(void)
+{
+  if (trajectory_running) {
+    sl_sleeptimer_stop_timer(&trajectory_timer);
+    trajectory_running = false;
+  }
+  trajectory_tick = false;
+
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    servo_joint[ch].ticks = 0;
+  }
+}
+
+bool mikroe_pca9685_trajectory_is_busy(void)
+{
+  return trajectory_running;
+}
+
+static uint16_t mikroe_pca9685_counts(int32_t position_q8)
+{
+  int32_t span = (int32_t)servo_ctx.max_pos - servo_ctx.min_pos;
+  int32_t counts;
+
+  if (span <= 0) {
+    return MIKROE_SERVO_MIN_COUNT;
+  }
+
+  // Same mapping as servo_set_position with a fractional position
+  counts = (((position_q8 - ((int32_t)servo_ctx.min_pos
+                             << MIKROE_SERVO_Q8_SHIFT))
+             * ((int32_t)servo_ctx.high_res - servo_ctx.low_res)) / span)
+           >> MIKROE_SERVO_Q8_SHIFT;
+  counts += servo_ctx.low_res + 10;
+
+  if (counts < MIKROE_SERVO_MIN_COUNT) {
+    counts = MIKROE_SERVO_MIN_COUNT;
+  }
+  return (uint16_t)(counts & 0x0FFF);
+}
+
+static void mikroe_pca9685_write_counts(uint8_t first,
+                                        const uint16_t *counts,
+                                        uint8_t count)
+{
+  uint8_t write_reg[MIKROE_SERVO_CHANNEL_COUNT * MIKROE_SERVO_MOTOR_REG_SIZE];
+
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t *reg = &write_reg[i * MIKROE_SERVO_MOTOR_REG_SIZE];
+
+    // ON at count 0, OFF at the pulse width
+    reg[0] = 0x00;
+    reg[1] = 0x00;
+    reg[2] = (uint8_t)counts[i];
+    reg[3] = (uint8_t)(counts[i] >> 8);
+  }
+
+  servo_start(&servo_ctx);
+  servo_generic_write_of_pca9685(&servo_ctx,
+                                 MIKROE_SERVO_MOTOR_1
+                                 + first * MIKROE_SERVO_MOTOR_REG_SIZE,
+                                 write_reg,
+                                 count * MIKROE_SERVO_MOTOR_REG_SIZE);
+}
+
+static void mikroe_pca9685_joint_set(uint8_t channel, uint8_t position)
+{
+  mikroe_servo_joint_t *joint = &servo_joint[channel];
+
+  mikroe_pca9685_trajectory_speed_init();
+  joint->current = (int32_t)position << MIKROE_SERVO_Q8_SHIFT;
+  joint->target = joint->current;
+  joint->ticks = 0;
+  joint->valid = true;
+}
+
+static void mikroe_pca9685_trajectory_speed_init(void)
+{
+  if (trajectory_speed_init) {
+    return;
+  }
+
+  for (uint8_t ch = 0; ch < MIKROE_SERVO_CHANNEL_COUNT; ch++) {
+    servo_joint[ch].speed = MIKROE_SERVO_TRAJECTORY_DEFAULT_SPEED;
+  }
+  trajectory_speed_init = true;
+}
+
+static void mikroe_pca9685_trajectory_timer_callback(
+  sl_sleeptimer_timer_handle_t *handle,
+  void *data)
+{
+  (void)handle;
+  (void)data;
+
+  trajectory_tick = true;
+}
@@ -57,6 +57,22 @@ extern "C"
 #define A4988_STEPPER_MOTOR_STEPS_PER_REV 64
 // </h> end Stepper Motor config
 
+// <h>Motion engine settings
+
+// <o A4988_STEPPER_MOTION_BUFFER_SIZE> Step period buffer size <4-1024>
+// <i> Step periods buffered for the LDMA, refilled half at a time.
+// <i> Default: 64
+#define A4988_STEPPER_MOTION_BUFFER_SIZE  64
+
+// <o A4988_STEPPER_MOTION_QUEUE_SIZE> Move queue size <1-32>
+// <i> Default: 4
+#define A4988_STEPPER_MOTION_QUEUE_SIZE   4
+
+// <o A4988_STEPPER_MOTION_PULSE_US> STEP pulse width in microseconds <1-100>
+// <i> Default: 2
+#define A4988_STEPPER_MOTION_PULSE_US     2
+// </h> end Motion engine config
+
 // <<< end of configuration section >>>
 
 // <<< sl:start pin_tool >>>
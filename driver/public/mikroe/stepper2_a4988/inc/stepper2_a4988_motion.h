@@ -0,0 +1,269 @@
+/***************************************************************************//**
+ * @file stepper2_a4988_motion.h
+ * @brief Hardware timed stepper motion engine.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef STEPPER2_A4988_MOTION_H_
+#define STEPPER2_A4988_MOTION_H_
+
+/***************************************************************************//**
+ * @addtogroup Stepper motor driver
+ * @{
+ *
+ * @brief
+ *  Motion engine for the A4988 driver. The STEP pulses are generated by the
+ *  TIMER of the PWM instance, the LDMA loads the period of every step into
+ *  the buffered TOP register on each overflow. Every axis uses its own TIMER
+ *  and LDMA channel so several axes run concurrently without CPU load.
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include "sl_status.h"
+#include "em_ldma.h"
+#include "stepper2_a4988.h"
+#include "stepper2_a4988_profile.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for one queued move.
+ ******************************************************************************/
+typedef struct a4988_stepper_move {
+  int32_t steps;                      ///< Steps to move, negative is CCW
+  uint32_t start_rate;                ///< Start and stop speed in steps/s
+  uint32_t max_rate;                  ///< Cruise speed in steps/s
+  uint32_t accel;                     ///< Acceleration in steps/s^2
+  a4988_stepper_profile_type_t type;  ///< Shape of the ramps
+} a4988_stepper_move_t;
+
+struct a4988_stepper_motion;
+
+/***************************************************************************//**
+ * @brief
+ *    Callback invoked from interrupt context after each completed move.
+ ******************************************************************************/
+typedef void (*a4988_stepper_motion_callback_t)(
+  struct a4988_stepper_motion *motion);
+
+/***************************************************************************//**
+ * @brief
+ *    Structure for one axis of the motion engine. The fields are private to
+ *    the engine.
+ ******************************************************************************/
+typedef struct a4988_stepper_motion {
+  a4988_stepper_inst_t *inst;
+  a4988_stepper_motion_callback_t callback;
+  unsigned int dma_channel;
+  LDMA_TransferCfg_t dma_xfer;
+  LDMA_Descriptor_t dma_desc[4];
+  uint32_t dma_stop[2];
+  uint32_t table[A4988_STEPPER_MOTION_BUFFER_SIZE];
+  uint16_t loaded[2];
+  uint8_t active_half;
+  uint8_t last_half;
+  a4988_stepper_profile_t profile;
+  a4988_stepper_move_t queue[A4988_STEPPER_MOTION_QUEUE_SIZE];
+  uint8_t queue_head;
+  volatile uint8_t queue_count;
+  volatile bool busy;
+  volatile bool stopping;
+  volatile uint32_t steps_done;
+  uint32_t move_steps;
+  int8_t move_sign;
+  volatile int32_t position;
+} a4988_stepper_motion_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * @brief
+ *    Attaches a motion engine axis to an initialized A4988 instance and
+ *    allocates its LDMA channel. The STEP pin has to be the output of the
+ *    PWM instance given to a4988_stepper_init().
+ *
+ * @param[out] motion
+ *    Motion engine axis.
+ *
+ * @param[in] inst
+ *    A4988 instance.
+ *
+ * @param[in] callback
+ *    Called after each completed move, can be NULL.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if a parameter is NULL or the instance has
+ *    no PWM instance.
+ *    SL_STATUS_NOT_AVAILABLE if the TIMER has no LDMA request.
+ *    SL_STATUS_ALLOCATION_FAILED if no LDMA channel is free.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_init(a4988_stepper_motion_t *motion,
+                                      a4988_stepper_inst_t *inst,
+                                      a4988_stepper_motion_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *    Appends a move to the queue of the axis. Moves queued while the axis is
+ *    running start back to back, the first one needs
+ *    a4988_stepper_motion_start().
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @param[in] move
+ *    Move parameters, copied into the queue.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if the move has no steps, max_rate is zero
+ *    or max_rate is above the A4988_STEPPER_MAX_RPM limit.
+ *    SL_STATUS_FULL if the queue is full.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_queue(a4988_stepper_motion_t *motion,
+                                       const a4988_stepper_move_t *move);
+
+/***************************************************************************//**
+ * @brief
+ *    Starts the queued moves of one or more axes. The timers of all axes are
+ *    started together so coordinated moves begin on the same tick.
+ *
+ * @param[in] axes
+ *    Array of motion engine axes.
+ *
+ * @param[in] count
+ *    Number of axes in the array.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if a parameter is NULL.
+ *    SL_STATUS_INVALID_STATE if an axis is running, has an empty queue or its
+ *    A4988 instance is not idle.
+ *    SL_STATUS_FAIL if a move cannot be timed by the TIMER or its LDMA
+ *    transfer cannot be started. No axis is started then and the queues of
+ *    all axes are left as they were.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_start(a4988_stepper_motion_t *const *axes,
+                                       uint8_t count);
+
+/***************************************************************************//**
+ * @brief
+ *    Stops the axis immediately and discards the queued moves. The motor is
+ *    not decelerated.
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if motion is NULL.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_abort(a4988_stepper_motion_t *motion);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns true while a move of the axis is running.
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @return
+ *    Running state of the axis.
+ ******************************************************************************/
+bool a4988_stepper_motion_is_busy(const a4988_stepper_motion_t *motion);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the number of STEP pulses issued by the current move, or by the
+ *    last move if the axis is idle.
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @return
+ *    Step count.
+ ******************************************************************************/
+uint32_t a4988_stepper_motion_get_steps(const a4988_stepper_motion_t *motion);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the position of the axis in steps, CW steps count up.
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @return
+ *    Position in steps.
+ ******************************************************************************/
+int32_t a4988_stepper_motion_get_position(const a4988_stepper_motion_t *motion);
+
+/***************************************************************************//**
+ * @brief
+ *    Sets the position of an idle axis, typically to 0 after homing.
+ *
+ * @param[in] motion
+ *    Motion engine axis.
+ *
+ * @param[in] position
+ *    New position in steps.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if motion is NULL.
+ *    SL_STATUS_BUSY if the axis is running.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_set_position(a4988_stepper_motion_t *motion,
+                                              int32_t position);
+
+/** @} (end addtogroup Stepper motor driver) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STEPPER2_A4988_MOTION_H_ */
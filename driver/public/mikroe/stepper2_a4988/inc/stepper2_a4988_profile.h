@@ -0,0 +1,201 @@
+/***************************************************************************//**
+ * @file stepper2_a4988_profile.h
+ * @brief Stepper motor acceleration profile generator.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef STEPPER2_A4988_PROFILE_H_
+#define STEPPER2_A4988_PROFILE_H_
+
+/***************************************************************************//**
+ * @addtogroup Stepper motor driver
+ * @{
+ *
+ * @brief
+ *  Step period generator for acceleration limited moves. The generator has no
+ *  dependency on the timer or the DMA so profiles can be checked off target.
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the shape of the acceleration and deceleration ramps.
+ ******************************************************************************/
+typedef enum {
+  A4988_PROFILE_TRAPEZOIDAL,  ///< Constant acceleration
+  A4988_PROFILE_SCURVE,       ///< Jerk limited, acceleration rises and falls
+} a4988_stepper_profile_type_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Parameters of one move.
+ ******************************************************************************/
+typedef struct a4988_stepper_profile_config {
+  uint32_t steps;                     ///< Number of steps
+  uint32_t start_rate;                ///< Start and stop speed in steps/s
+  uint32_t max_rate;                  ///< Cruise speed in steps/s
+  uint32_t accel;                     ///< Acceleration in steps/s^2, peak
+                                      ///< acceleration for S-curve ramps.
+                                      ///< 0 runs the move at max_rate.
+  a4988_stepper_profile_type_t type;  ///< Shape of the ramps
+} a4988_stepper_profile_config_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Generator state. The fields are private to the generator.
+ ******************************************************************************/
+typedef struct a4988_stepper_profile {
+  a4988_stepper_profile_type_t type;
+  uint32_t timer_freq;
+  uint32_t steps;
+  uint32_t ramp_steps;
+  uint32_t index;
+  uint32_t ramp_ticks;
+  float start_rate;
+  float peak_rate;
+  float accel;
+  float ramp_time;
+  float ramp_length;
+  float ramp_t;
+  float cruise_period;
+  float cruise_residual;
+  uint32_t cruise_ticks;
+  uint32_t cruise_fraction;
+  uint32_t cruise_phase;
+  int32_t cruise_adjust;
+} a4988_stepper_profile_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * @brief
+ *    Plans a move. The move is shortened to a triangular profile if it is too
+ *    short to reach max_rate.
+ *
+ * @param[out] profile
+ *    Generator state.
+ *
+ * @param[in] config
+ *    Move parameters.
+ *
+ * @param[in] timer_freq
+ *    Frequency of the timer counting the step periods in Hz.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if a parameter is NULL, steps or max_rate
+ *    is zero or max_rate is higher than timer_freq.
+ ******************************************************************************/
+sl_status_t a4988_stepper_profile_init(a4988_stepper_profile_t *profile,
+                                       const a4988_stepper_profile_config_t *config,
+                                       uint32_t timer_freq);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the time from one step to the next in timer ticks and advances
+ *    the generator. The sum of the periods tracks the ideal curve within one
+ *    tick, rounding errors do not accumulate. Ramps longer than 2^24 ticks
+ *    are limited by the float step time, within 1e-6 of the ramp time.
+ *
+ * @param[in,out] profile
+ *    Generator state.
+ *
+ * @return
+ *    Period in timer ticks, 0 after the last step.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_next(a4988_stepper_profile_t *profile);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the longest period of the move in timer ticks. It is used to
+ *    select a timer prescaler for which every period fits the counter.
+ *
+ * @param[in] profile
+ *    Generator state.
+ *
+ * @return
+ *    Longest period in timer ticks.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_max_period(const a4988_stepper_profile_t *profile);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the shortest period of the move in timer ticks.
+ *
+ * @param[in] profile
+ *    Generator state.
+ *
+ * @return
+ *    Shortest period in timer ticks.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_min_period(const a4988_stepper_profile_t *profile);
+
+/***************************************************************************//**
+ * @brief
+ *    Returns the number of periods not yet returned by
+ *    a4988_stepper_profile_next().
+ *
+ * @param[in] profile
+ *    Generator state.
+ *
+ * @return
+ *    Remaining steps.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_remaining(const a4988_stepper_profile_t *profile);
+
+/** @} (end addtogroup Stepper motor driver) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STEPPER2_A4988_PROFILE_H_ */
@@ -0,0 +1,707 @@
+/***************************************************************************//**
+ * @file stepper2_a4988_motion.c
+ * @brief Hardware timed stepper motion engine.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stddef.h>
+#include "stepper2_a4988_motion.h"
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_gpio.h"
+#include "em_timer.h"
+#include "dmadrv.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+#if (A4988_STEPPER_MOTION_BUFFER_SIZE < 4) \
+  || ((A4988_STEPPER_MOTION_BUFFER_SIZE % 2) != 0)
+#error "A4988_STEPPER_MOTION_BUFFER_SIZE must be an even number of 4 or more"
+#endif
+
+// The period table is split in two halves, one is refilled while the LDMA
+// is working on the other one.
+#define MOTION_HALF_SIZE  (A4988_STEPPER_MOTION_BUFFER_SIZE / 2)
+#define MOTION_NO_HALF    0xFF
+
+// Descriptors after the two period table halves. The first one writes 0 to
+// the buffered compare value so the overflow that ends the last period does
+// not start another pulse, the second one stops the timer on that overflow.
+#define MOTION_DESC_CC    2
+#define MOTION_DESC_STOP  3
+
+#if defined(_TIMER_CC_OCB_MASK)
+#define MOTION_CC_BUFFER(timer, ch)  (&(timer)->CC[ch].OCB)
+#else
+#define MOTION_CC_BUFFER(timer, ch)  (&(timer)->CC[ch].CCVB)
+#endif
+
+// Highest step rate accepted for a move
+#define MOTION_MAX_RATE \
+  ((A4988_STEPPER_MAX_RPM * A4988_STEPPER_MOTOR_STEPS_PER_REV) / 60)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static bool timer_lookup(TIMER_TypeDef *timer,
+                         CMU_Clock_TypeDef *clock,
+                         LDMA_PeripheralSignal_t *signal);
+static bool get_prescaler(TIMER_TypeDef *timer,
+                          uint32_t max_period,
+                          uint32_t *divider,
+                          TIMER_Prescale_TypeDef *prescale);
+static sl_status_t motion_plan(a4988_stepper_motion_t *motion,
+                               TIMER_Init_TypeDef *timer_init,
+                               uint32_t *timer_freq);
+static sl_status_t motion_prepare(a4988_stepper_motion_t *motion);
+static void motion_disarm(a4988_stepper_motion_t *motion);
+static void motion_fill(a4988_stepper_motion_t *motion, uint8_t half);
+static void motion_finish(a4988_stepper_motion_t *motion);
+static bool on_dma_callback(unsigned int channel,
+                            unsigned int sequenceNo,
+                            void *userParam);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Attaches a motion engine axis to an A4988 instance.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_init(a4988_stepper_motion_t *motion,
+                                      a4988_stepper_inst_t *inst,
+                                      a4988_stepper_motion_callback_t callback)
+{
+  CMU_Clock_TypeDef clock;
+  LDMA_PeripheralSignal_t signal;
+
+  if ((NULL == motion) || (NULL == inst) || (NULL == inst->pwm)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (!timer_lookup(inst->pwm->timer, &clock, &signal)) {
+    return SL_STATUS_NOT_AVAILABLE;
+  }
+
+  DMADRV_Init();
+  if (DMADRV_AllocateChannel(&motion->dma_channel, NULL)
+      != ECODE_EMDRV_DMADRV_OK) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+
+  motion->inst = inst;
+  motion->callback = callback;
+  motion->queue_head = 0;
+  motion->queue_count = 0;
+  motion->busy = false;
+  motion->stopping = false;
+  motion->steps_done = 0;
+  motion->move_steps = 0;
+  motion->move_sign = 1;
+  motion->position = 0;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Appends a move to the queue of the axis.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_queue(a4988_stepper_motion_t *motion,
+                                       const a4988_stepper_move_t *move)
+{
+  sl_status_t stt = SL_STATUS_FULL;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((NULL == motion) || (NULL == move) || (0 == move->steps)
+      || (0 == move->max_rate) || (move->max_rate > MOTION_MAX_RATE)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (motion->queue_count < A4988_STEPPER_MOTION_QUEUE_SIZE) {
+    uint8_t tail = (motion->queue_head + motion->queue_count)
+                   % A4988_STEPPER_MOTION_QUEUE_SIZE;
+
+    motion->queue[tail] = *move;
+    motion->queue_count++;
+    stt = SL_STATUS_OK;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return stt;
+}
+
+/***************************************************************************//**
+ * Starts the queued moves of one or more axes together.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_start(a4988_stepper_motion_t *const *axes,
+                                       uint8_t count)
+{
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  uint32_t timer_freq;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((NULL == axes) || (0 == count)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if ((NULL == axes[i]) || (NULL == axes[i]->inst)) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    if (axes[i]->busy || (0 == axes[i]->queue_count)
+        || (axes[i]->inst->state != IDLE)) {
+      return SL_STATUS_INVALID_STATE;
+    }
+  }
+
+  // Every first move has to fit its timer before any axis is touched
+  for (uint8_t i = 0; i < count; i++) {
+    if (motion_plan(axes[i], &timer_init, &timer_freq) != SL_STATUS_OK) {
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (motion_prepare(axes[i]) != SL_STATUS_OK) {
+      // Put the moves of the axes already armed back, no step was issued
+      while (i > 0) {
+        motion_disarm(axes[--i]);
+      }
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  // Every timer is armed, start them back to back
+  CORE_ENTER_ATOMIC();
+  for (uint8_t i = 0; i < count; i++) {
+    sl_pwm_start(axes[i]->inst->pwm);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Stops the axis immediately and discards the queued moves.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_abort(a4988_stepper_motion_t *motion)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((NULL == motion) || (NULL == motion->inst)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  motion->queue_count = 0;
+  if (motion->busy) {
+    uint32_t steps = a4988_stepper_motion_get_steps(motion);
+
+    DMADRV_StopTransfer(motion->dma_channel);
+    sl_pwm_stop(motion->inst->pwm);
+    GPIO_PinOutClear(motion->inst->gpio_config.step_port,
+                     motion->inst->gpio_config.step_pin);
+
+    motion->steps_done = steps;
+    motion->position += motion->move_sign * (int32_t)steps;
+    motion->busy = false;
+    if (motion->inst->state == RUNNING) {
+      motion->inst->state = IDLE;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Returns true while a move of the axis is running.
+ ******************************************************************************/
+bool a4988_stepper_motion_is_busy(const a4988_stepper_motion_t *motion)
+{
+  if (NULL == motion) {
+    return false;
+  }
+  return motion->busy;
+}
+
+/***************************************************************************//**
+ * Returns the number of STEP pulses issued by the current or last move.
+ ******************************************************************************/
+uint32_t a4988_stepper_motion_get_steps(const a4988_stepper_motion_t *motion)
+{
+  uint32_t steps;
+  CORE_DECLARE_IRQ_STATE;
+
+  if (NULL == motion) {
+    return 0;
+  }
+
+  CORE_ENTER_ATOMIC();
+  steps = motion->steps_done;
+  if (motion->busy && !motion->stopping) {
+    int remaining = 0;
+
+    // Each period loaded by the LDMA starts with a pulse
+    DMADRV_TransferRemainingCount(motion->dma_channel, &remaining);
+    if ((remaining >= 0)
+        && ((uint32_t)remaining <= motion->loaded[motion->active_half])) {
+      steps += motion->loaded[motion->active_half] - (uint32_t)remaining;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+
+  return (steps > motion->move_steps) ? motion->move_steps : steps;
+}
+
+/***************************************************************************//**
+ * Returns the position of the axis in steps.
+ ******************************************************************************/
+int32_t a4988_stepper_motion_get_position(const a4988_stepper_motion_t *motion)
+{
+  int32_t position;
+  CORE_DECLARE_IRQ_STATE;
+
+  if (NULL == motion) {
+    return 0;
+  }
+
+  CORE_ENTER_ATOMIC();
+  position = motion->position;
+  if (motion->busy) {
+    position += motion->move_sign
+                * (int32_t)a4988_stepper_motion_get_steps(motion);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return position;
+}
+
+/***************************************************************************//**
+ * Sets the position of an idle axis.
+ ******************************************************************************/
+sl_status_t a4988_stepper_motion_set_position(a4988_stepper_motion_t *motion,
+                                              int32_t position)
+{
+  if (NULL == motion) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (motion->busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  motion->position = position;
+  return SL_STATUS_OK;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Plans the move at the head of the queue and selects the timer prescaler.
+ * The move stays queued, nothing but the profile of the axis is changed.
+ ******************************************************************************/
+static sl_status_t motion_plan(a4988_stepper_motion_t *motion,
+                               TIMER_Init_TypeDef *timer_init,
+                               uint32_t *timer_freq)
+{
+  TIMER_TypeDef *timer = motion->inst->pwm->timer;
+  const a4988_stepper_move_t *move = &motion->queue[motion->queue_head];
+  a4988_stepper_profile_config_t config;
+  CMU_Clock_TypeDef clock;
+  LDMA_PeripheralSignal_t signal;
+  uint32_t clock_freq;
+  uint32_t divider;
+
+  timer_lookup(timer, &clock, &signal);
+  clock_freq = CMU_ClockFreqGet(clock);
+
+  config.steps = (move->steps < 0) ? (uint32_t)(-move->steps)
+                 : (uint32_t)move->steps;
+  config.start_rate = move->start_rate;
+  config.max_rate = move->max_rate;
+  config.accel = move->accel;
+  config.type = move->type;
+
+  // Plan at the timer clock first to find a prescaler for the slowest step
+  if (a4988_stepper_profile_init(&motion->profile, &config, clock_freq)
+      != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+  if (!get_prescaler(timer,
+                     a4988_stepper_profile_max_period(&motion->profile),
+                     &divider,
+                     &timer_init->prescale)) {
+    return SL_STATUS_FAIL;
+  }
+  *timer_freq = clock_freq / divider;
+  if (a4988_stepper_profile_init(&motion->profile, &config, *timer_freq)
+      != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Programs the timer and arms the LDMA for the move at the head of the
+ * queue. The move is only taken from the queue once the LDMA is armed. The
+ * timer is left stopped, it is started with sl_pwm_start().
+ ******************************************************************************/
+static sl_status_t motion_prepare(a4988_stepper_motion_t *motion)
+{
+  a4988_stepper_inst_t *inst = motion->inst;
+  TIMER_TypeDef *timer = inst->pwm->timer;
+  uint8_t channel = inst->pwm->channel;
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  TIMER_InitCC_TypeDef cc_init = TIMER_INITCC_DEFAULT;
+  const a4988_stepper_move_t *move = &motion->queue[motion->queue_head];
+  CMU_Clock_TypeDef clock;
+  LDMA_PeripheralSignal_t signal;
+  uint32_t timer_freq;
+  uint32_t pulse;
+  uint32_t first;
+  uint8_t start_desc;
+
+  if (motion_plan(motion, &timer_init, &timer_freq) != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+  timer_lookup(timer, &clock, &signal);
+
+  // Direction is set well ahead of the first pulse. An idle motor ignores
+  // it, so it is left as is if the move cannot be armed.
+  if (move->steps < 0) {
+    GPIO_PinOutClear(inst->gpio_config.dir_port, inst->gpio_config.dir_pin);
+    inst->dir = CCW;
+    motion->move_sign = -1;
+  } else {
+    GPIO_PinOutSet(inst->gpio_config.dir_port, inst->gpio_config.dir_pin);
+    inst->dir = CW;
+    motion->move_sign = 1;
+  }
+  motion->move_steps = (move->steps < 0) ? (uint32_t)(-move->steps)
+                       : (uint32_t)move->steps;
+  motion->steps_done = 0;
+
+  // STEP high time, at most half of the shortest period
+  pulse = (uint32_t)(((uint64_t)timer_freq * A4988_STEPPER_MOTION_PULSE_US)
+                     / 1000000) + 1;
+  if (pulse > (a4988_stepper_profile_min_period(&motion->profile) / 2)) {
+    pulse = a4988_stepper_profile_min_period(&motion->profile) / 2;
+  }
+  if (0 == pulse) {
+    pulse = 1;
+  }
+
+  // The pulse is set on overflow and cleared on compare match. A two tick
+  // lead-in period starts the first pulse, the LDMA loads the following
+  // periods into TOPB on every overflow.
+  timer_init.enable = false;
+  timer_init.dmaClrAct = true;
+  TIMER_Init(timer, &timer_init);
+  cc_init.mode = timerCCModePWM;
+  TIMER_InitCC(timer, channel, &cc_init);
+
+  first = a4988_stepper_profile_next(&motion->profile);
+  TIMER_CounterSet(timer, 0);
+  TIMER_TopSet(timer, 1);
+  TIMER_TopBufSet(timer, first - 1);
+  TIMER_CompareSet(timer, channel, pulse);
+  TIMER_CompareBufSet(timer, channel, pulse);
+
+  motion->dma_stop[0] = 0;
+  motion->dma_stop[1] = TIMER_CMD_STOP;
+  motion->dma_desc[MOTION_DESC_CC] = (LDMA_Descriptor_t)
+                                     LDMA_DESCRIPTOR_LINKABS_M2P_BYTE(
+    &motion->dma_stop[0], MOTION_CC_BUFFER(timer, channel), 1);
+  motion->dma_desc[MOTION_DESC_CC].xfer.size = ldmaCtrlSizeWord;
+  motion->dma_desc[MOTION_DESC_CC].xfer.doneIfs = 0;
+  motion->dma_desc[MOTION_DESC_CC].xfer.linkAddr =
+    (uint32_t)&motion->dma_desc[MOTION_DESC_STOP] >> 2;
+  motion->dma_desc[MOTION_DESC_STOP] = (LDMA_Descriptor_t)
+                                       LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(
+    &motion->dma_stop[1], &timer->CMD, 1);
+  motion->dma_desc[MOTION_DESC_STOP].xfer.size = ldmaCtrlSizeWord;
+  motion->dma_desc[MOTION_DESC_STOP].xfer.doneIfs = 1;
+
+  motion->active_half = 0;
+  motion->last_half = MOTION_NO_HALF;
+  motion->loaded[0] = 0;
+  motion->loaded[1] = 0;
+  start_desc = MOTION_DESC_CC;
+  if (a4988_stepper_profile_remaining(&motion->profile) > 0) {
+    motion_fill(motion, 0);
+    if (motion->last_half == MOTION_NO_HALF) {
+      motion_fill(motion, 1);
+    }
+    start_desc = 0;
+  }
+  motion->stopping = (start_desc == MOTION_DESC_CC);
+
+  motion->dma_xfer = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(signal);
+  if (DMADRV_LdmaStartTransfer(motion->dma_channel,
+                               &motion->dma_xfer,
+                               &motion->dma_desc[start_desc],
+                               on_dma_callback,
+                               motion) != ECODE_EMDRV_DMADRV_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  motion->queue_head = (motion->queue_head + 1)
+                       % A4988_STEPPER_MOTION_QUEUE_SIZE;
+  motion->queue_count--;
+
+  motion->busy = true;
+  inst->state = RUNNING;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Releases an axis armed by motion_prepare() whose timer was never started
+ * and puts its move back at the head of the queue.
+ ******************************************************************************/
+static void motion_disarm(a4988_stepper_motion_t *motion)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  DMADRV_StopTransfer(motion->dma_channel);
+  sl_pwm_stop(motion->inst->pwm);
+  motion->queue_head = (motion->queue_head + A4988_STEPPER_MOTION_QUEUE_SIZE
+                        - 1) % A4988_STEPPER_MOTION_QUEUE_SIZE;
+  motion->queue_count++;
+  motion->busy = false;
+  if (motion->inst->state == RUNNING) {
+    motion->inst->state = IDLE;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * Fills one half of the period table and links its descriptor either to the
+ * other half or, after the last period, to the stop sequence.
+ ******************************************************************************/
+static void motion_fill(a4988_stepper_motion_t *motion, uint8_t half)
+{
+  uint32_t *table = &motion->table[half * MOTION_HALF_SIZE];
+  LDMA_Descriptor_t *desc = &motion->dma_desc[half];
+  uint16_t count = 0;
+  uint32_t period;
+
+  while (count < MOTION_HALF_SIZE) {
+    period = a4988_stepper_profile_next(&motion->profile);
+    if (0 == period) {
+      break;
+    }
+    table[count++] = period - 1;
+  }
+  motion->loaded[half] = count;
+
+  *desc = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKABS_M2P_BYTE(
+    table, &motion->inst->pwm->timer->TOPB, count);
+  desc->xfer.size = ldmaCtrlSizeWord;
+  desc->xfer.doneIfs = 1;
+
+  if (a4988_stepper_profile_remaining(&motion->profile) == 0) {
+    desc->xfer.linkAddr = (uint32_t)&motion->dma_desc[MOTION_DESC_CC] >> 2;
+    motion->last_half = half;
+  } else {
+    desc->xfer.linkAddr = (uint32_t)&motion->dma_desc[half ^ 1] >> 2;
+  }
+}
+
+/***************************************************************************//**
+ * Completes the current move and starts the next queued one.
+ ******************************************************************************/
+static void motion_finish(a4988_stepper_motion_t *motion)
+{
+  a4988_stepper_inst_t *inst = motion->inst;
+
+  // The timer has been stopped by the last descriptor
+  sl_pwm_stop(inst->pwm);
+  GPIO_PinOutClear(inst->gpio_config.step_port, inst->gpio_config.step_pin);
+
+  motion->steps_done = motion->move_steps;
+  motion->position += motion->move_sign * (int32_t)motion->move_steps;
+  motion->busy = false;
+  if (inst->state == RUNNING) {
+    inst->state = IDLE;
+  }
+
+  if (NULL != motion->callback) {
+    motion->callback(motion);
+  }
+
+  if ((motion->queue_count > 0) && !motion->busy && (inst->state == IDLE)) {
+    if (motion_prepare(motion) == SL_STATUS_OK) {
+      sl_pwm_start(inst->pwm);
+    } else {
+      motion->queue_count = 0;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * LDMA callback, called when a period table half or the stop sequence is
+ * done.
+ ******************************************************************************/
+static bool on_dma_callback(unsigned int channel,
+                            unsigned int sequenceNo,
+                            void *userParam)
+{
+  a4988_stepper_motion_t *motion = (a4988_stepper_motion_t *)userParam;
+  uint8_t half = motion->active_half;
+
+  (void)channel;
+  (void)sequenceNo;
+
+  if (motion->stopping) {
+    motion_finish(motion);
+    return true;
+  }
+
+  motion->steps_done += motion->loaded[half];
+  if (half == motion->last_half) {
+    // Only the stop sequence is left
+    motion->stopping = true;
+    return true;
+  }
+
+  // The LDMA is working on the other half, refill this one
+  motion->active_half = half ^ 1;
+  if (motion->last_half == MOTION_NO_HALF) {
+    motion_fill(motion, half);
+  }
+
+  return true;
+}
+
+/***************************************************************************//**
+ * Utility function used to get the clock and the overflow LDMA request of a
+ * timer.
+ ******************************************************************************/
+static bool timer_lookup(TIMER_TypeDef *timer,
+                         CMU_Clock_TypeDef *clock,
+                         LDMA_PeripheralSignal_t *signal)
+{
+  switch ((uint32_t)timer) {
+#if defined(TIMER0_BASE)
+    case TIMER0_BASE:
+      *clock = cmuClock_TIMER0;
+      *signal = ldmaPeripheralSignal_TIMER0_UFOF;
+      return true;
+#endif
+#if defined(TIMER1_BASE)
+    case TIMER1_BASE:
+      *clock = cmuClock_TIMER1;
+      *signal = ldmaPeripheralSignal_TIMER1_UFOF;
+      return true;
+#endif
+#if defined(TIMER2_BASE)
+    case TIMER2_BASE:
+      *clock = cmuClock_TIMER2;
+      *signal = ldmaPeripheralSignal_TIMER2_UFOF;
+      return true;
+#endif
+#if defined(TIMER3_BASE)
+    case TIMER3_BASE:
+      *clock = cmuClock_TIMER3;
+      *signal = ldmaPeripheralSignal_TIMER3_UFOF;
+      return true;
+#endif
+#if defined(TIMER4_BASE)
+    case TIMER4_BASE:
+      *clock = cmuClock_TIMER4;
+      *signal = ldmaPeripheralSignal_TIMER4_UFOF;
+      return true;
+#endif
+#if defined(WTIMER0_BASE)
+    case WTIMER0_BASE:
+      *clock = cmuClock_WTIMER0;
+      *signal = ldmaPeripheralSignal_WTIMER0_UFOF;
+      return true;
+#endif
+#if defined(WTIMER1_BASE)
+    case WTIMER1_BASE:
+      *clock = cmuClock_WTIMER1;
+      *signal = ldmaPeripheralSignal_WTIMER1_UFOF;
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+/***************************************************************************//**
+ * Utility function used to pick the smallest prescaler for which the
+ * longest period fits the counter of the timer.
+ ******************************************************************************/
+static bool get_prescaler(TIMER_TypeDef *timer,
+                          uint32_t max_period,
+                          uint32_t *divider,
+                          TIMER_Prescale_TypeDef *prescale)
+{
+  uint64_t range = (uint64_t)TIMER_MaxCount(timer) + 1;
+
+#if defined(_SILICON_LABS_32B_SERIES_2)
+  // Linear prescaler, divide by 1 to 1024
+  *divider = (uint32_t)(max_period / range) + 1;
+  if (*divider > 1024) {
+    return false;
+  }
+  *prescale = (TIMER_Prescale_TypeDef)(*divider - 1);
+#else
+  // Power of two prescaler, divide by 1 to 1024
+  uint32_t shift = 0;
+
+  while (((range << shift) < max_period) && (shift < 10)) {
+    shift++;
+  }
+  if ((range << shift) < max_period) {
+    return false;
+  }
+  *divider = 1UL << shift;
+  *prescale = (TIMER_Prescale_TypeDef)shift;
+#endif
+
+  return true;
+}
@@ -0,0 +1,400 @@
+/***************************************************************************//**
+ * @file stepper2_a4988_profile.c
+ * @brief Stepper motor acceleration profile generator.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stddef.h>
+#include <math.h>
+#include "stepper2_a4988_profile.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// S-curve ramps follow v = v0 + dv * (3u^2 - 2u^3), u = t / T. The peak
+// acceleration is 1.5 * dv / T, so T = 1.5 * dv / accel and the ramp covers
+// T * (v0 + v) / 2 = 0.75 * (v^2 - v0^2) / accel steps.
+#define SCURVE_TIME_FACTOR      1.5f
+
+// Iteration limit of the S-curve position to time solver
+#define SCURVE_SOLVER_ITERATIONS 24
+
+// Relative error of the float step times of ramps longer than 2^24 ticks
+#define RAMP_TIME_ERROR         1.0e-6f
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static float ramp_time(const a4988_stepper_profile_t *profile,
+                       float position,
+                       float guess);
+static void profile_rewind(a4988_stepper_profile_t *profile);
+static uint64_t seconds_to_ticks_q8(float seconds, uint32_t timer_freq);
+static uint32_t seconds_to_ticks(float seconds, uint32_t timer_freq);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Plans a move.
+ ******************************************************************************/
+sl_status_t a4988_stepper_profile_init(a4988_stepper_profile_t *profile,
+                                       const a4988_stepper_profile_config_t *config,
+                                       uint32_t timer_freq)
+{
+  float v0;
+  float vmax;
+  float ramp_scale;
+  uint64_t cruise;
+
+  if ((NULL == profile) || (NULL == config) || (0 == config->steps)
+      || (0 == config->max_rate) || (config->max_rate > timer_freq)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  v0 = (float)config->start_rate;
+  vmax = (float)config->max_rate;
+
+  profile->type = config->type;
+  profile->timer_freq = timer_freq;
+  profile->steps = config->steps;
+  profile->start_rate = v0;
+  profile->accel = (float)config->accel;
+
+  if ((0 == config->accel) || (config->start_rate >= config->max_rate)) {
+    // Constant speed move
+    profile->peak_rate = vmax;
+    profile->ramp_time = 0.0f;
+    profile->ramp_length = 0.0f;
+  } else {
+    ramp_scale = (config->type == A4988_PROFILE_SCURVE)
+                 ? SCURVE_TIME_FACTOR : 1.0f;
+
+    profile->peak_rate = vmax;
+    profile->ramp_length = ramp_scale * (vmax * vmax - v0 * v0)
+                           / (2.0f * profile->accel);
+
+    if ((2.0f * profile->ramp_length) > (float)config->steps) {
+      // Too short to reach max_rate, meet in the middle
+      profile->ramp_length = (float)config->steps / 2.0f;
+      profile->peak_rate = sqrtf(v0 * v0
+                                 + 2.0f * profile->accel
+                                 * profile->ramp_length / ramp_scale);
+    }
+    profile->ramp_time = ramp_scale * (profile->peak_rate - v0)
+                         / profile->accel;
+  }
+
+  profile->ramp_steps = (uint32_t)profile->ramp_length;
+  if (profile->ramp_steps > (config->steps / 2)) {
+    profile->ramp_steps = config->steps / 2;
+  }
+  profile->cruise_period = (float)timer_freq / profile->peak_rate;
+
+  // The cruise period in 32.32 fixed point, exact when max_rate is reached.
+  // A float period would drift by up to 2^-24 of the period every step.
+  if (profile->peak_rate == vmax) {
+    cruise = ((uint64_t)timer_freq << 32) / config->max_rate;
+  } else {
+    cruise = (uint64_t)ldexpf(profile->cruise_period, 32);
+  }
+  profile->cruise_ticks = (uint32_t)(cruise >> 32);
+  profile->cruise_fraction = (uint32_t)cruise;
+
+  profile_rewind(profile);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Returns the next step period in timer ticks.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_next(a4988_stepper_profile_t *profile)
+{
+  uint32_t k;
+  uint32_t ticks;
+  uint32_t period;
+  uint32_t phase;
+  int32_t adjust;
+  float exact;
+
+  if ((NULL == profile) || (profile->index >= profile->steps)) {
+    return 0;
+  }
+
+  k = profile->index++;
+
+  if (k < profile->ramp_steps) {
+    // Acceleration, round the absolute step time so errors do not add up
+    profile->ramp_t = ramp_time(profile, (float)(k + 1), profile->ramp_t);
+    ticks = seconds_to_ticks(profile->ramp_t, profile->timer_freq);
+    period = ticks - profile->ramp_ticks;
+    profile->ramp_ticks = ticks;
+  } else if (k >= (profile->steps - profile->ramp_steps)) {
+    // Deceleration, the acceleration ramp in reverse
+    uint32_t j = profile->steps - 1 - k;
+
+    profile->ramp_t = ramp_time(profile, (float)j, profile->ramp_t);
+    ticks = seconds_to_ticks(profile->ramp_t, profile->timer_freq);
+    period = profile->ramp_ticks - ticks;
+    profile->ramp_ticks = ticks;
+  } else {
+    // Cruise, the first and last cruise steps include the end of the ramps.
+    // The step time is the exact fixed point sum of the periods plus the
+    // float offset of the ramp ends, rounded to the nearest tick.
+    exact = 0.0f;
+    if (k == profile->ramp_steps) {
+      exact += (profile->ramp_time
+                - ramp_time(profile,
+                            (float)profile->ramp_steps,
+                            profile->ramp_t))
+               * (float)profile->timer_freq
+               - (profile->ramp_length - (float)profile->ramp_steps)
+               * profile->cruise_period;
+    }
+    if (k == (profile->steps - profile->ramp_steps - 1)) {
+      exact += (profile->ramp_time
+                - ramp_time(profile,
+                            (float)profile->ramp_steps,
+                            profile->ramp_t))
+               * (float)profile->timer_freq
+               - (profile->ramp_length - (float)profile->ramp_steps)
+               * profile->cruise_period;
+      // The deceleration starts from the end of the acceleration
+      profile->ramp_t = ramp_time(profile,
+                                  (float)profile->ramp_steps,
+                                  profile->ramp_t);
+    }
+    profile->cruise_residual += exact;
+
+    phase = profile->cruise_phase + profile->cruise_fraction;
+    adjust = (int32_t)floorf(ldexpf((float)phase, -32)
+                             + profile->cruise_residual + 0.5f);
+    period = profile->cruise_ticks + (phase < profile->cruise_phase)
+             + (uint32_t)(adjust - profile->cruise_adjust);
+    profile->cruise_phase = phase;
+    profile->cruise_adjust = adjust;
+  }
+
+  return period;
+}
+
+/***************************************************************************//**
+ * Returns the longest period of the move in timer ticks.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_max_period(const a4988_stepper_profile_t *profile)
+{
+  a4988_stepper_profile_t first;
+
+  if (NULL == profile) {
+    return 0;
+  }
+
+  // Speed is lowest at both ends, rounding may add one tick at the end
+  first = *profile;
+  profile_rewind(&first);
+  return a4988_stepper_profile_next(&first) + 1;
+}
+
+/***************************************************************************//**
+ * Returns the shortest period of the move in timer ticks.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_min_period(const a4988_stepper_profile_t *profile)
+{
+  float period;
+
+  if (NULL == profile) {
+    return 0;
+  }
+
+  // Rounding may take one tick off the cruise period, the float step times
+  // of long ramps may also end a little short of it
+  period = profile->cruise_period - 1.0f;
+  if ((profile->ramp_time * (float)profile->timer_freq) > 16777216.0f) {
+    period -= 2.0f * RAMP_TIME_ERROR * profile->ramp_time
+              * (float)profile->timer_freq;
+  }
+  return (period > 1.0f) ? (uint32_t)period : 1;
+}
+
+/***************************************************************************//**
+ * Returns the number of steps not generated yet.
+ ******************************************************************************/
+uint32_t a4988_stepper_profile_remaining(const a4988_stepper_profile_t *profile)
+{
+  if ((NULL == profile) || (profile->index >= profile->steps)) {
+    return 0;
+  }
+  return profile->steps - profile->index;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Time in seconds at which the acceleration ramp reaches a position.
+ * The S-curve position is a quartic of time, it is solved with a bracketed
+ * Newton iteration started from the guess, the previous step time.
+ ******************************************************************************/
+static float ramp_time(const a4988_stepper_profile_t *profile,
+                       float position,
+                       float guess)
+{
+  float v0 = profile->start_rate;
+
+  if (position <= 0.0f) {
+    return 0.0f;
+  }
+
+  if (profile->type != A4988_PROFILE_SCURVE) {
+    // (sqrt(v0^2 + 2as) - v0) / a without the cancellation
+    return 2.0f * position
+           / (sqrtf(v0 * v0 + 2.0f * profile->accel * position) + v0);
+  } else {
+    float total = profile->ramp_time;
+    float dv = profile->peak_rate - v0;
+    float lo = 0.0f;
+    float hi = total;
+    float t = guess;
+
+    if ((t <= lo) || (t >= hi)) {
+      t = 0.5f * total;
+    }
+
+    for (uint8_t i = 0; i < SCURVE_SOLVER_ITERATIONS; i++) {
+      float u = t / total;
+      float u2 = u * u;
+      float s = v0 * t + dv * total * (u2 * u - 0.5f * u2 * u2);
+      float v = v0 + dv * (3.0f * u2 - 2.0f * u2 * u);
+      float next;
+
+      if (s > position) {
+        hi = t;
+      } else {
+        lo = t;
+      }
+
+      next = (v > 0.0f) ? (t - (s - position) / v) : lo;
+      if ((next <= lo) || (next >= hi)) {
+        // Newton left the bracket, bisect instead
+        next = 0.5f * (lo + hi);
+      }
+      if (fabsf(next - t) <= (total * 1.0e-7f)) {
+        return next;
+      }
+      t = next;
+    }
+    return t;
+  }
+}
+
+/***************************************************************************//**
+ * Restarts the generator at the first step of the planned move.
+ ******************************************************************************/
+static void profile_rewind(a4988_stepper_profile_t *profile)
+{
+  uint64_t exact;
+  uint32_t ticks;
+
+  profile->index = 0;
+  profile->ramp_ticks = 0;
+  profile->ramp_t = 0.0f;
+  profile->cruise_phase = 0;
+  profile->cruise_adjust = 0;
+
+  // Carry the rounding of the last acceleration step into the cruise
+  exact = seconds_to_ticks_q8(ramp_time(profile,
+                                        (float)profile->ramp_steps,
+                                        0.0f),
+                              profile->timer_freq);
+  ticks = seconds_to_ticks(ramp_time(profile,
+                                     (float)profile->ramp_steps,
+                                     0.0f),
+                           profile->timer_freq);
+  profile->cruise_residual =
+    (float)((int64_t)exact - ((int64_t)ticks << 8)) / 256.0f;
+}
+
+/***************************************************************************//**
+ * Converts a time in seconds to timer ticks with 8 fractional bits.
+ * The float mantissa is multiplied by the frequency in 64-bit integers, a
+ * float product would lose whole ticks above 2^24 ticks.
+ ******************************************************************************/
+static uint64_t seconds_to_ticks_q8(float seconds, uint32_t timer_freq)
+{
+  int exponent;
+  uint64_t product;
+  int shift;
+
+  if (!(seconds > 0.0f)) {
+    return 0;
+  }
+
+  // seconds = mantissa * 2^(exponent - 24), the mantissa has 24 bits
+  product = (uint64_t)ldexpf(frexpf(seconds, &exponent), 24)
+            * timer_freq;
+  shift = 16 - exponent;
+
+  if (shift >= 64) {
+    return 0;
+  }
+  if (shift > 0) {
+    return (product + ((uint64_t)1 << (shift - 1))) >> shift;
+  }
+  if ((-shift >= 8) || (product > (UINT64_MAX >> -shift))) {
+    // Hours of ramp, beyond any 32-bit tick count anyway
+    return UINT64_MAX;
+  }
+  return product << -shift;
+}
+
+/***************************************************************************//**
+ * Converts a time in seconds to the nearest number of timer ticks.
+ ******************************************************************************/
+static uint32_t seconds_to_ticks(float seconds, uint32_t timer_freq)
+{
+  uint64_t ticks = seconds_to_ticks_q8(seconds, timer_freq);
+
+  if (ticks >= ((uint64_t)UINT32_MAX << 8)) {
+    return UINT32_MAX;
+  }
+  return (uint32_t)((ticks + 128) >> 8);
+}
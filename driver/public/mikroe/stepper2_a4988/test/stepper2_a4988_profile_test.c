@@ -0,0 +1,231 @@
+/***************************************************************************//**
+ * @file stepper2_a4988_profile_test.c
+ * @brief Host test of the A4988 step period generator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+// Host test of the step period generator.
+//
+// Each move is generated with a4988_stepper_profile_next() and the time of
+// every step, the running sum of the periods, is compared against the ideal
+// curve computed in double precision: the trapezoidal or S-curve ramp, the
+// cruise at the peak rate and the mirrored deceleration. Triangular moves
+// that do not reach max_rate, single step moves and cruise periods that are
+// not a whole number of ticks are covered, the fraction carried from step to
+// step must not accumulate.
+
+#include <math.h>
+#include <stdio.h>
+#include "stepper2_a4988_profile.h"
+
+// Step times stay within this many ticks of the ideal curve
+#define TICK_TOLERANCE        1.5
+
+// Above 2^24 ticks the float ramp time limits the accuracy, relative bound
+#define LONG_RAMP_TOLERANCE   1.0e-6
+
+typedef struct {
+  a4988_stepper_profile_config_t config;
+  uint32_t timer_freq;
+  const char *name;
+} profile_case_t;
+
+static const profile_case_t cases[] = {
+  { { 1000, 0, 2000, 4000, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "trapezoid" },
+  { { 1000, 0, 2000, 4000, A4988_PROFILE_SCURVE }, 1000000,
+    "S-curve" },
+  { { 20000, 0, 20000, 50000, A4988_PROFILE_TRAPEZOIDAL }, 4000000,
+    "trapezoid, fast" },
+  { { 20000, 200, 20000, 50000, A4988_PROFILE_SCURVE }, 4000000,
+    "S-curve, fast" },
+  { { 5000, 100, 3000, 9000, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "trapezoid, fractional cruise period" },
+  { { 5000, 100, 3000, 9000, A4988_PROFILE_SCURVE }, 1000000,
+    "S-curve, fractional cruise period" },
+  { { 30000, 0, 7, 0, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "constant speed, fractional period" },
+  { { 500, 300, 300, 1000, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "start rate at max rate" },
+  { { 101, 100, 5000, 20000, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "triangle" },
+  { { 101, 100, 5000, 20000, A4988_PROFILE_SCURVE }, 1000000,
+    "S-curve triangle" },
+  { { 1, 0, 1000, 1000, A4988_PROFILE_TRAPEZOIDAL }, 1000000,
+    "single step" },
+  { { 2, 0, 1000, 1000, A4988_PROFILE_SCURVE }, 1000000,
+    "two steps" },
+  { { 3, 50, 1000, 1000, A4988_PROFILE_SCURVE }, 1000000,
+    "three steps" },
+  { { 12000, 0, 1000, 100, A4988_PROFILE_TRAPEZOIDAL }, 10000000,
+    "trapezoid, 10 s ramp" },
+  { { 12000, 0, 1000, 100, A4988_PROFILE_SCURVE }, 10000000,
+    "S-curve, 13 s ramp" },
+};
+
+/***************************************************************************//**
+ * Time in seconds at which the acceleration ramp reaches a position
+ ******************************************************************************/
+static double ideal_ramp_time(const a4988_stepper_profile_t *p, double s)
+{
+  double v0 = p->start_rate;
+  double dv = p->peak_rate - v0;
+  double total = p->ramp_time;
+  double lo = 0.0;
+  double hi = total;
+
+  if (s <= 0.0) {
+    return 0.0;
+  }
+
+  if (p->type != A4988_PROFILE_SCURVE) {
+    return 2.0 * s / (sqrt(v0 * v0 + 2.0 * p->accel * s) + v0);
+  }
+
+  // s(t) = v0 t + dv T (u^3 - u^4 / 2), u = t / T, increasing in t
+  for (int i = 0; i < 200; i++) {
+    double t = 0.5 * (lo + hi);
+    double u = t / total;
+
+    if (v0 * t + dv * total * (u * u * u - 0.5 * u * u * u * u) > s) {
+      hi = t;
+    } else {
+      lo = t;
+    }
+  }
+  return 0.5 * (lo + hi);
+}
+
+/***************************************************************************//**
+ * Ideal time in seconds of step k, counted from 1
+ ******************************************************************************/
+static double ideal_step_time(const a4988_stepper_profile_t *p, uint32_t k)
+{
+  double length = p->ramp_length;
+  double steps = p->steps;
+  double ramp = ideal_ramp_time(p, length);
+  double total = 2.0 * ramp + (steps - 2.0 * length) / p->peak_rate;
+
+  if (k <= length) {
+    return ideal_ramp_time(p, k);
+  }
+  if (k >= (steps - length)) {
+    return total - ideal_ramp_time(p, steps - k);
+  }
+  return ramp + (k - length) / p->peak_rate;
+}
+
+static int check_profile(const profile_case_t *c)
+{
+  a4988_stepper_profile_t profile;
+  uint32_t max_period;
+  uint32_t min_period;
+  uint32_t period;
+  uint32_t steps = 0;
+  uint32_t shortest = UINT32_MAX;
+  uint32_t longest = 0;
+  double ticks = 0.0;
+  double error = 0.0;
+  double tolerance;
+
+  if (SL_STATUS_OK != a4988_stepper_profile_init(&profile, &c->config,
+                                                 c->timer_freq)) {
+    printf("FAIL: %s, init\n", c->name);
+    return 1;
+  }
+
+  tolerance = (double)profile.ramp_time * c->timer_freq
+              * LONG_RAMP_TOLERANCE;
+  if (tolerance < TICK_TOLERANCE) {
+    tolerance = TICK_TOLERANCE;
+  }
+
+  max_period = a4988_stepper_profile_max_period(&profile);
+  min_period = a4988_stepper_profile_min_period(&profile);
+
+  while ((period = a4988_stepper_profile_next(&profile)) != 0) {
+    double ideal;
+
+    steps++;
+    ticks += period;
+    ideal = ideal_step_time(&profile, steps) * c->timer_freq;
+    if (fabs(ticks - ideal) > error) {
+      error = fabs(ticks - ideal);
+    }
+    if (period < shortest) {
+      shortest = period;
+    }
+    if (period > longest) {
+      longest = period;
+    }
+  }
+
+  if ((steps != c->config.steps) || (error > tolerance)
+      || (longest > max_period) || (shortest < min_period)
+      || (a4988_stepper_profile_remaining(&profile) != 0)) {
+    printf("FAIL: %s, %lu steps, error %.2f ticks (limit %.2f), "
+           "periods %lu..%lu (limits %lu..%lu)\n",
+           c->name, (unsigned long)steps, error, tolerance,
+           (unsigned long)shortest, (unsigned long)longest,
+           (unsigned long)min_period, (unsigned long)max_period);
+    return 1;
+  }
+
+  printf("ok: %s, %lu steps in %.4f s, peak %.1f steps/s, "
+         "error %.2f ticks\n",
+         c->name, (unsigned long)steps, ticks / c->timer_freq,
+         (double)profile.peak_rate, error);
+  return 0;
+}
+
+int main(void)
+{
+  a4988_stepper_profile_config_t config = cases[0].config;
+  a4988_stepper_profile_t profile;
+  int fail = 0;
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    fail |= check_profile(&cases[i]);
+  }
+
+  // Invalid moves are rejected
+  config.steps = 0;
+  fail |= (SL_STATUS_INVALID_PARAMETER
+           != a4988_stepper_profile_init(&profile, &config, 1000000));
+  config = cases[0].config;
+  config.max_rate = 2000000;
+  fail |= (SL_STATUS_INVALID_PARAMETER
+           != a4988_stepper_profile_init(&profile, &config, 1000000));
+
+  printf(fail ? "FAIL\n" : "PASS\n");
+  return fail;
+}
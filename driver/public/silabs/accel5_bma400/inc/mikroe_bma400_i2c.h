@@ -128,6 +128,25 @@ int8_t bma400_i2c_init(mikroe_i2c_handle_t i2cspm,
                        uint8_t bma400_i2c_addr,
                        struct bma400_dev *bma400);
 
+/***************************************************************************//**
+ * @brief
+ *  Enable the host interrupt on a BMA400 interrupt pin.
+ *
+ * @param[in] int_chan
+ *  BMA400_INT_CHANNEL_1 or BMA400_INT_CHANNEL_2. The pin must be configured
+ *  in mikroe_bma400_i2c_config.h.
+ * @param[in] callback
+ *  Called from interrupt context on the rising edge of the pin, for example
+ *  bma400_stream_notify().
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref BMA400_E_NULL_PTR if callback is NULL.
+ *  @ref BMA400_E_INVALID_CONFIG if the pin is not configured.
+ ******************************************************************************/
+int8_t bma400_i2c_enable_int(enum bma400_int_chan int_chan,
+                              void (*callback)(void));
+
 /** @} (end addtogroup BMA400) */
 
 #ifdef __cplusplus
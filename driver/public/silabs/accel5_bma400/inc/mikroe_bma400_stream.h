@@ -0,0 +1,265 @@
+/***************************************************************************//**
+ * @file mikroe_bma400_stream.h
+ * @brief FIFO streaming for the BMA400
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#ifndef MIKROE_BMA400_STREAM_H
+#define MIKROE_BMA400_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bma400.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup BMA400 - Accelerometer Sensor
+ * @brief FIFO streaming mode for the BMA400
+ *
+ *  The sensor buffers samples in its 1 KB FIFO while the host sleeps. When the
+ *  watermark is reached the INT pin wakes the host, the FIFO is drained in one
+ *  burst and the frames are decoded into a caller provided ring buffer.
+ *
+ *   @n @section bma400_stream_example BMA400 streaming example
+ *
+ *      @code{.c}
+ *
+ *   static struct bma400_sensor_data samples[128];
+ *
+ *   bma400_stream_config_t stream = {
+ *     .watermark = 600,
+ *     .int_chan = BMA400_INT_CHANNEL_1,
+ *     .sensor_time = true,
+ *     .fifo_8_bit = false,
+ *     .buffer = samples,
+ *     .size = 128,
+ *   };
+ *
+ *   bma400_i2c_enable_int(BMA400_INT_CHANNEL_1, bma400_stream_notify);
+ *   bma400_stream_start(&stream, &bma);
+ *   bma400_set_power_mode(BMA400_MODE_NORMAL, &bma);
+ *
+ *   while (1) {
+ *     uint16_t int_status;
+ *     struct bma400_sensor_data data;
+ *
+ *     bma400_stream_process(&int_status, &bma);
+ *     while (bma400_stream_read(&data, 1)) {
+ *       ...
+ *     }
+ *     // Enter EM2, the next watermark interrupt wakes the host
+ *   }
+ *
+ *   @endcode
+ *
+ * @{
+ ******************************************************************************/
+
+// Size of the BMA400 FIFO in bytes
+#define BMA400_STREAM_FIFO_SIZE  UINT16_C(1024)
+
+/***************************************************************************//**
+ * @brief Configuration of the FIFO streaming mode.
+ ******************************************************************************/
+typedef struct {
+  // FIFO fill level in bytes that asserts the interrupt, 1 - 1024
+  uint16_t watermark;
+  // Interrupt pin the watermark interrupt is routed to,
+  // BMA400_INT_CHANNEL_1 or BMA400_INT_CHANNEL_2
+  enum bma400_int_chan int_chan;
+  // Append the sensor time to each burst
+  bool sensor_time;
+  // Store 8 bit samples, doubling the FIFO depth at reduced resolution
+  bool fifo_8_bit;
+  // Caller provided ring buffer for decoded samples
+  struct bma400_sensor_data *buffer;
+  // Number of entries in buffer
+  uint16_t size;
+} bma400_stream_config_t;
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the FIFO and the watermark interrupt and start streaming.
+ *
+ * @param[in] config
+ *  Streaming configuration. The ring buffer must stay valid until
+ *  bma400_stream_stop() is called.
+ * @param[in] dev
+ *  The BMA400 device structure.
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref BMA400_E_NULL_PTR on a NULL pointer.
+ *  @ref BMA400_E_INVALID_CONFIG on an invalid configuration.
+ *  @ref On failure, the error of the sensor access is returned.
+ *
+ * @note
+ *  The accelerometer configuration and the power mode are left to the
+ *  application. The interrupt pin of the host is enabled separately with
+ *  bma400_i2c_enable_int() or bma400_spi_enable_int().
+ ******************************************************************************/
+int8_t bma400_stream_start(const bma400_stream_config_t *config,
+                           struct bma400_dev *dev);
+
+/***************************************************************************//**
+ * @brief
+ *  Disable the watermark interrupt and flush the FIFO.
+ *
+ * @param[in] dev
+ *  The BMA400 device structure.
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref On failure, the error of the sensor access is returned.
+ ******************************************************************************/
+int8_t bma400_stream_stop(struct bma400_dev *dev);
+
+/***************************************************************************//**
+ * @brief
+ *  Signal that the sensor asserted its interrupt pin.
+ *
+ * @note
+ *  Safe to call from interrupt context, pass it as the callback of
+ *  bma400_i2c_enable_int() or bma400_spi_enable_int().
+ ******************************************************************************/
+void bma400_stream_notify(void);
+
+/***************************************************************************//**
+ * @brief
+ *  GPIO port argument of bma400_stream_enable_int(), the port of the
+ *  configuration is not used on Si91x.
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+#define BMA400_STREAM_INT_PORT(port)  0
+#else
+#define BMA400_STREAM_INT_PORT(port)  ((uint8_t)(port))
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *  Enable the host interrupt on the GPIO connected to a BMA400 interrupt pin.
+ *
+ *  It's shared by bma400_i2c_enable_int() and bma400_spi_enable_int(), which
+ *  pass the pin of their configuration. INT1 and INT2 use distinct pin
+ *  interrupts, so both can be enabled at the same time.
+ *
+ * @param[in] int_chan
+ *  BMA400_INT_CHANNEL_1 or BMA400_INT_CHANNEL_2.
+ * @param[in] port
+ *  GPIO port, see BMA400_STREAM_INT_PORT().
+ * @param[in] pin
+ *  GPIO pin, the GPIO number on Si91x.
+ * @param[in] callback
+ *  Called from interrupt context on the rising edge of the pin.
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref BMA400_E_NULL_PTR if callback is NULL.
+ *  @ref BMA400_E_INVALID_CONFIG if int_chan is not INT1 or INT2.
+ ******************************************************************************/
+int8_t bma400_stream_enable_int(enum bma400_int_chan int_chan,
+                                uint8_t port,
+                                uint8_t pin,
+                                void (*callback)(void));
+
+/***************************************************************************//**
+ * @brief
+ *  Check whether an interrupt is waiting to be processed.
+ *
+ * @return
+ *  true if bma400_stream_process() has work to do.
+ ******************************************************************************/
+bool bma400_stream_pending(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Handle a pending interrupt.
+ *
+ *  The interrupt status is read once. On a FIFO watermark or FIFO full
+ *  interrupt the whole FIFO is read in a single burst and decoded into the
+ *  ring buffer. Without a pending interrupt the sensor is not accessed.
+ *
+ * @param[out] int_status
+ *  Interrupt status read from the sensor, see BMA400_ASSERTED_* in
+ *  bma400_defs.h. Step, activity and tap interrupts mapped to the same pin
+ *  are reported here. Set to 0 when nothing was pending. May be NULL.
+ * @param[in] dev
+ *  The BMA400 device structure.
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref On failure, the error of the sensor access is returned.
+ ******************************************************************************/
+int8_t bma400_stream_process(uint16_t *int_status, struct bma400_dev *dev);
+
+/***************************************************************************//**
+ * @brief
+ *  Copy the oldest decoded samples out of the ring buffer.
+ *
+ * @param[out] data
+ *  Destination for the samples.
+ * @param[in] count
+ *  Maximum number of samples to copy.
+ *
+ * @return
+ *  Number of samples copied.
+ ******************************************************************************/
+uint16_t bma400_stream_read(struct bma400_sensor_data *data, uint16_t count);
+
+/***************************************************************************//**
+ * @brief
+ *  Get the number of decoded samples in the ring buffer.
+ ******************************************************************************/
+uint16_t bma400_stream_available(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Get the number of samples lost because the ring buffer was full.
+ ******************************************************************************/
+uint32_t bma400_stream_get_dropped(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Get the sensor time of the last burst, in 39.0625 us ticks. 0 if the sensor
+ *  time is not enabled.
+ ******************************************************************************/
+uint32_t bma400_stream_get_sensor_time(void);
+
+/** @} (end addtogroup BMA400) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // End of MIKROE_BMA400_STREAM_H
@@ -37,6 +37,7 @@
 #include "sl_sleeptimer.h"
 #include "drv_spi_master.h"
 #include "drv_digital_in.h"
+#include "mikroe_bma400_stream.h"
 
 // Read write length varies based on user requirement
 #define READ_WRITE_LENGTH  UINT8_C(46)
@@ -124,6 +125,48 @@ int8_t bma400_spi_init(mikroe_spi_handle_t spidrv,
   return BMA400_OK;
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Enable the host interrupt on a BMA400 interrupt pin.
+ *
+ * @param[in] int_chan
+ *  BMA400_INT_CHANNEL_1 or BMA400_INT_CHANNEL_2.
+ * @param[in] callback
+ *  Called from interrupt context on the rising edge of the pin.
+ *
+ * @return
+ *  @ref BMA400_OK on success.
+ *  @ref BMA400_E_NULL_PTR if callback is NULL.
+ *  @ref BMA400_E_INVALID_CONFIG if the pin is not configured.
+ ******************************************************************************/
+int8_t bma400_spi_enable_int(enum bma400_int_chan int_chan,
+                              void (*callback)(void))
+{
+#ifdef  MIKROE_BMA400_INT1_PORT
+  if (int_chan == BMA400_INT_CHANNEL_1) {
+    return bma400_stream_enable_int(int_chan,
+                                    BMA400_STREAM_INT_PORT(
+                                      MIKROE_BMA400_INT1_PORT),
+                                    MIKROE_BMA400_INT1_PIN,
+                                    callback);
+  }
+#endif
+
+#ifdef  MIKROE_BMA400_INT2_PORT
+  if (int_chan == BMA400_INT_CHANNEL_2) {
+    return bma400_stream_enable_int(int_chan,
+                                    BMA400_STREAM_INT_PORT(
+                                      MIKROE_BMA400_INT2_PORT),
+                                    MIKROE_BMA400_INT2_PIN,
+                                    callback);
+  }
+#endif
+
+  (void) int_chan;
+  (void) callback;
+  return BMA400_E_INVALID_CONFIG;
+}
+
 /***************************************************************************//**
  * @brief SPI read function map to platform
  ******************************************************************************/
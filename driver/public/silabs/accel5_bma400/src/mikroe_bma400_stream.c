@@ -0,0 +1,424 @@
+/***************************************************************************//**
+ * @file mikroe_bma400_stream.c
+ * @brief FIFO streaming for the BMA400
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+
+#include <stddef.h>
+#include "mikroe_bma400_stream.h"
+
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define BMA400_INT1_M4_INTR       7 // M4 Pin interrupt number of INT1
+#define BMA400_INT2_M4_INTR       6 // M4 Pin interrupt number of INT2
+#define AVL_INTR_NO               0 // available interrupt number
+#else
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
+#endif
+
+// Frames decoded per call while the ring buffer is full
+#define DISCARD_FRAMES  UINT16_C(16)
+
+typedef struct
+{
+  struct bma400_sensor_data *buffer;
+  uint16_t size;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t count;
+  uint32_t dropped;
+  uint32_t sensor_time;
+  volatile bool pending;
+} bma400_stream_t;
+
+static bma400_stream_t bma400_stream;
+
+// Host interrupt callbacks of INT1 and INT2
+static void (*int_callback[2])(void);
+
+// The FIFO is drained in one burst. Room is left for the sensor time frame
+// appended after the last sample and the dummy byte of the SPI interface.
+static uint8_t fifo_buff[BMA400_STREAM_FIFO_SIZE
+                         + BMA400_FIFO_BYTES_OVERREAD + 1];
+
+// Local prototypes
+static int8_t bma400_stream_drain(struct bma400_dev *dev);
+static void bma400_stream_reset(void);
+#if (defined(SLI_SI917))
+static void bma400_int1_handler(uint32_t int_no);
+static void bma400_int2_handler(uint32_t int_no);
+#else
+static void bma400_int1_handler(uint8_t int_no);
+static void bma400_int2_handler(uint8_t int_no);
+#endif
+
+/***************************************************************************//**
+ * Configure the FIFO and the watermark interrupt and start streaming.
+ ******************************************************************************/
+int8_t bma400_stream_start(const bma400_stream_config_t *config,
+                           struct bma400_dev *dev)
+{
+  int8_t rslt;
+  struct bma400_device_conf dev_conf[2];
+  struct bma400_int_enable int_en;
+
+  if ((config == NULL) || (dev == NULL) || (config->buffer == NULL)) {
+    return BMA400_E_NULL_PTR;
+  }
+
+  if ((config->size == 0)
+      || (config->watermark == 0)
+      || (config->watermark > BMA400_STREAM_FIFO_SIZE)
+      || ((config->int_chan != BMA400_INT_CHANNEL_1)
+          && (config->int_chan != BMA400_INT_CHANNEL_2))) {
+    return BMA400_E_INVALID_CONFIG;
+  }
+
+  dev_conf[0].type = BMA400_FIFO_CONF;
+  rslt = bma400_get_device_conf(dev_conf, 1, dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  // Keep the newest samples when the host is late, the FIFO is not stopped
+  // on full and not flushed on power mode changes
+  dev_conf[0].param.fifo_conf.conf_regs = BMA400_FIFO_X_EN
+                                          | BMA400_FIFO_Y_EN
+                                          | BMA400_FIFO_Z_EN;
+  if (config->sensor_time) {
+    dev_conf[0].param.fifo_conf.conf_regs |= BMA400_FIFO_TIME_EN;
+  }
+  if (config->fifo_8_bit) {
+    dev_conf[0].param.fifo_conf.conf_regs |= BMA400_FIFO_8_BIT_EN;
+  }
+  dev_conf[0].param.fifo_conf.conf_status = BMA400_ENABLE;
+  dev_conf[0].param.fifo_conf.fifo_watermark = config->watermark;
+  dev_conf[0].param.fifo_conf.fifo_wm_channel = config->int_chan;
+
+  // Push-pull active high, the host triggers on the rising edge
+  dev_conf[1].type = BMA400_INT_PIN_CONF;
+  dev_conf[1].param.int_conf.int_chan = config->int_chan;
+  dev_conf[1].param.int_conf.pin_conf = BMA400_INT_PUSH_PULL_ACTIVE_1;
+
+  rslt = bma400_set_device_conf(dev_conf, 2, dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  bma400_stream.buffer = config->buffer;
+  bma400_stream.size = config->size;
+  bma400_stream_reset();
+
+  rslt = bma400_set_fifo_flush(dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  int_en.type = BMA400_FIFO_WM_INT_EN;
+  int_en.conf = BMA400_ENABLE;
+
+  return bma400_enable_interrupt(&int_en, 1, dev);
+}
+
+/***************************************************************************//**
+ * Disable the watermark interrupt and flush the FIFO.
+ ******************************************************************************/
+int8_t bma400_stream_stop(struct bma400_dev *dev)
+{
+  int8_t rslt;
+  struct bma400_int_enable int_en;
+
+  int_en.type = BMA400_FIFO_WM_INT_EN;
+  int_en.conf = BMA400_DISABLE;
+
+  rslt = bma400_enable_interrupt(&int_en, 1, dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  bma400_stream.pending = false;
+
+  return bma400_set_fifo_flush(dev);
+}
+
+/***************************************************************************//**
+ * Signal that the sensor asserted its interrupt pin.
+ ******************************************************************************/
+void bma400_stream_notify(void)
+{
+  bma400_stream.pending = true;
+}
+
+/***************************************************************************//**
+ * Enable the host interrupt on the GPIO connected to a BMA400 interrupt pin.
+ ******************************************************************************/
+int8_t bma400_stream_enable_int(enum bma400_int_chan int_chan,
+                                uint8_t port,
+                                uint8_t pin,
+                                void (*callback)(void))
+{
+  uint8_t index;
+
+  if (callback == NULL) {
+    return BMA400_E_NULL_PTR;
+  }
+  if (int_chan == BMA400_INT_CHANNEL_1) {
+    index = 0;
+  } else if (int_chan == BMA400_INT_CHANNEL_2) {
+    index = 1;
+  } else {
+    return BMA400_E_INVALID_CONFIG;
+  }
+  int_callback[index] = callback;
+
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { pin / 16, pin % 16 };
+
+  (void) port;
+  if (index == 0) {
+    sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                       BMA400_INT1_M4_INTR,
+                                       SL_GPIO_INTERRUPT_RISING_EDGE,
+                                       (void *)bma400_int1_handler,
+                                       AVL_INTR_NO);
+  } else {
+    sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                       BMA400_INT2_M4_INTR,
+                                       SL_GPIO_INTERRUPT_RISING_EDGE,
+                                       (void *)bma400_int2_handler,
+                                       AVL_INTR_NO);
+  }
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(pin,
+                           index ? bma400_int2_handler : bma400_int1_handler);
+  GPIO_ExtIntConfig((GPIO_Port_TypeDef)port,
+                    pin,
+                    pin,
+                    true,
+                    false,
+                    true);
+#endif
+
+  return BMA400_OK;
+}
+
+/***************************************************************************//**
+ * Check whether an interrupt is waiting to be processed.
+ ******************************************************************************/
+bool bma400_stream_pending(void)
+{
+  return bma400_stream.pending;
+}
+
+/***************************************************************************//**
+ * Handle a pending interrupt.
+ ******************************************************************************/
+int8_t bma400_stream_process(uint16_t *int_status, struct bma400_dev *dev)
+{
+  int8_t rslt;
+  uint16_t status = 0;
+
+  if (int_status != NULL) {
+    *int_status = 0;
+  }
+
+  if (!bma400_stream.pending) {
+    return BMA400_OK;
+  }
+
+  // Cleared before the sensor is accessed so an edge raised while the FIFO
+  // is drained is not lost
+  bma400_stream.pending = false;
+
+  rslt = bma400_get_interrupt_status(&status, dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  if (int_status != NULL) {
+    *int_status = status;
+  }
+
+  if ((bma400_stream.buffer != NULL)
+      && (status & (BMA400_ASSERTED_FIFO_WM_INT
+                    | BMA400_ASSERTED_FIFO_FULL_INT))) {
+    rslt = bma400_stream_drain(dev);
+  }
+
+  return rslt;
+}
+
+/***************************************************************************//**
+ * Copy the oldest decoded samples out of the ring buffer.
+ ******************************************************************************/
+uint16_t bma400_stream_read(struct bma400_sensor_data *data, uint16_t count)
+{
+  uint16_t n = 0;
+
+  if (data == NULL) {
+    return 0;
+  }
+
+  while ((n < count) && (bma400_stream.count > 0)) {
+    data[n++] = bma400_stream.buffer[bma400_stream.tail];
+    bma400_stream.tail = (bma400_stream.tail + 1) % bma400_stream.size;
+    bma400_stream.count--;
+  }
+
+  return n;
+}
+
+/***************************************************************************//**
+ * Get the number of decoded samples in the ring buffer.
+ ******************************************************************************/
+uint16_t bma400_stream_available(void)
+{
+  return bma400_stream.count;
+}
+
+/***************************************************************************//**
+ * Get the number of samples lost because the ring buffer was full.
+ ******************************************************************************/
+uint32_t bma400_stream_get_dropped(void)
+{
+  return bma400_stream.dropped;
+}
+
+/***************************************************************************//**
+ * Get the sensor time of the last burst.
+ ******************************************************************************/
+uint32_t bma400_stream_get_sensor_time(void)
+{
+  return bma400_stream.sensor_time;
+}
+
+/***************************************************************************//**
+ * @brief Read the whole FIFO in one burst and decode it into the ring.
+ *
+ *  Frames are decoded in place into the free space of the ring, at most two
+ *  runs when the free space wraps. The FIFO is always emptied so the
+ *  watermark interrupt deasserts, frames that do not fit are counted as
+ *  dropped.
+ ******************************************************************************/
+static int8_t bma400_stream_drain(struct bma400_dev *dev)
+{
+  int8_t rslt;
+  struct bma400_fifo_data fifo = { 0 };
+  struct bma400_sensor_data discard[DISCARD_FRAMES];
+  struct bma400_sensor_data *dest;
+  uint16_t frames;
+
+  fifo.data = fifo_buff;
+  fifo.length = BMA400_STREAM_FIFO_SIZE + BMA400_FIFO_BYTES_OVERREAD;
+
+  rslt = bma400_get_fifo_data(&fifo, dev);
+  if (rslt != BMA400_OK) {
+    return rslt;
+  }
+
+  while (fifo.accel_byte_start_idx < fifo.length) {
+    if (bma400_stream.count < bma400_stream.size) {
+      dest = &bma400_stream.buffer[bma400_stream.head];
+      if (bma400_stream.head >= bma400_stream.tail) {
+        frames = bma400_stream.size - bma400_stream.head;
+      } else {
+        frames = bma400_stream.tail - bma400_stream.head;
+      }
+    } else {
+      dest = discard;
+      frames = DISCARD_FRAMES;
+    }
+
+    rslt = bma400_extract_accel(&fifo, dest, &frames, dev);
+    if ((rslt != BMA400_OK) || (frames == 0)) {
+      break;
+    }
+
+    if (dest == discard) {
+      bma400_stream.dropped += frames;
+    } else {
+      bma400_stream.head = (bma400_stream.head + frames) % bma400_stream.size;
+      bma400_stream.count += frames;
+    }
+  }
+
+  if (fifo.fifo_sensor_time) {
+    bma400_stream.sensor_time = fifo.fifo_sensor_time;
+  }
+
+  return rslt;
+}
+
+/***************************************************************************//**
+ * @brief Empty the ring buffer and clear the statistics.
+ ******************************************************************************/
+static void bma400_stream_reset(void)
+{
+  bma400_stream.head = 0;
+  bma400_stream.tail = 0;
+  bma400_stream.count = 0;
+  bma400_stream.dropped = 0;
+  bma400_stream.sensor_time = 0;
+  bma400_stream.pending = false;
+}
+
+/***************************************************************************//**
+ * INT1 and INT2 pin interrupt handlers
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+static void bma400_int1_handler(uint32_t int_no)
+#else
+static void bma400_int1_handler(uint8_t int_no)
+#endif
+{
+  (void) int_no;
+
+  if (int_callback[0] != NULL) {
+    int_callback[0]();
+  }
+}
+
+#if (defined(SLI_SI917))
+static void bma400_int2_handler(uint32_t int_no)
+#else
+static void bma400_int2_handler(uint8_t int_no)
+#endif
+{
+  (void) int_no;
+
+  if (int_callback[1] != NULL) {
+    int_callback[1]();
+  }
+}
@@ -0,0 +1,247 @@
+/***************************************************************************//**
+ * @file bma400_stream_bench.c
+ * @brief Host benchmark of the BMA400 FIFO stream decoder
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+// Host benchmark of the FIFO frame decoder of the streaming mode.
+//
+// A mock bus serves a full 1 KB FIFO of 12 bit XYZ frames followed by the
+// sensor time frame. Each burst goes through bma400_stream_process() and
+// bma400_stream_read(), the decoded samples are checked against the values
+// that were encoded, then the cost of a burst is measured.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mikroe_bma400_stream.h"
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
+
+#define FRAME_SIZE        7
+#define FIFO_FRAMES       (BMA400_STREAM_FIFO_SIZE / FRAME_SIZE)
+#define FIFO_BYTES        (FIFO_FRAMES * FRAME_SIZE)
+#define SENSOR_TIME       UINT32_C(0x123456)
+#define BENCH_BURSTS      20000
+
+static uint8_t regs[256];
+static uint8_t fifo[BMA400_STREAM_FIFO_SIZE + BMA400_FIFO_BYTES_OVERREAD + 1];
+static struct bma400_sensor_data ring[2 * FIFO_FRAMES];
+static struct bma400_sensor_data out[2 * FIFO_FRAMES];
+
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port,
+                       unsigned int pin,
+                       unsigned int intNo,
+                       bool risingEdge,
+                       bool fallingEdge,
+                       bool enable)
+{
+  (void)port;
+  (void)pin;
+  (void)intNo;
+  (void)risingEdge;
+  (void)fallingEdge;
+  (void)enable;
+}
+
+void GPIOINT_Init(void)
+{
+}
+
+void GPIOINT_CallbackRegister(uint8_t intNo,
+                              GPIOINT_IrqCallbackPtr_t callbackPtr)
+{
+  (void)intNo;
+  (void)callbackPtr;
+}
+
+static int16_t sample_value(uint16_t frame, uint8_t axis)
+{
+  // Covers the whole 12 bit range, negative values included
+  return (int16_t)(((frame * 37 + axis * 1365) % 4096) - 2048);
+}
+
+static void fill_fifo(void)
+{
+  uint16_t i = 0;
+
+  for (uint16_t frame = 0; frame < FIFO_FRAMES; frame++) {
+    // Bit 4 of the header is set for 12 bit frames
+    fifo[i++] = BMA400_FIFO_XYZ_ENABLE
+                | (BMA400_12_BIT_FIFO_DATA << BMA400_FIFO_8_BIT_EN_POS);
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      uint16_t v = (uint16_t)sample_value(frame, axis) & 0x0FFF;
+
+      fifo[i++] = v & 0x0F;
+      fifo[i++] = v >> 4;
+    }
+  }
+  fifo[i++] = BMA400_FIFO_SENSOR_TIME;
+  fifo[i++] = SENSOR_TIME & 0xFF;
+  fifo[i++] = (SENSOR_TIME >> 8) & 0xFF;
+  fifo[i++] = (SENSOR_TIME >> 16) & 0xFF;
+  while (i < sizeof(fifo)) {
+    fifo[i++] = BMA400_FIFO_EMPTY_FRAME;
+  }
+}
+
+static BMA400_INTF_RET_TYPE mock_read(uint8_t reg_addr,
+                                      uint8_t *reg_data,
+                                      uint32_t length,
+                                      void *intf_ptr)
+{
+  (void)intf_ptr;
+
+  if (reg_addr == BMA400_REG_FIFO_DATA) {
+    memcpy(reg_data, fifo, length);
+  } else {
+    memcpy(reg_data, &regs[reg_addr], length);
+  }
+  return BMA400_INTF_RET_SUCCESS;
+}
+
+static BMA400_INTF_RET_TYPE mock_write(uint8_t reg_addr,
+                                       const uint8_t *reg_data,
+                                       uint32_t length,
+                                       void *intf_ptr)
+{
+  (void)intf_ptr;
+
+  memcpy(&regs[reg_addr], reg_data, length);
+  return BMA400_INTF_RET_SUCCESS;
+}
+
+static void mock_delay_us(uint32_t period, void *intf_ptr)
+{
+  (void)period;
+  (void)intf_ptr;
+}
+
+static void mock_watermark(void)
+{
+  regs[BMA400_REG_INT_STAT0] = BMA400_ASSERTED_FIFO_WM_INT & 0xFF;
+  regs[BMA400_REG_FIFO_LENGTH] = FIFO_BYTES & 0xFF;
+  regs[BMA400_REG_FIFO_LENGTH + 1] = FIFO_BYTES >> 8;
+  bma400_stream_notify();
+}
+
+static int check_burst(struct bma400_dev *dev, uint16_t ring_size)
+{
+  bma400_stream_config_t config = {
+    .watermark = 600,
+    .int_chan = BMA400_INT_CHANNEL_1,
+    .sensor_time = true,
+    .fifo_8_bit = false,
+    .buffer = ring,
+    .size = ring_size,
+  };
+  uint16_t expected = ring_size < FIFO_FRAMES ? ring_size : FIFO_FRAMES;
+  uint16_t n;
+
+  if (bma400_stream_start(&config, dev) != BMA400_OK) {
+    printf("FAIL: bma400_stream_start\n");
+    return 1;
+  }
+  mock_watermark();
+  if (bma400_stream_process(NULL, dev) != BMA400_OK) {
+    printf("FAIL: bma400_stream_process\n");
+    return 1;
+  }
+  n = bma400_stream_read(out, FIFO_FRAMES);
+  if (n != expected) {
+    printf("FAIL: ring %u, %u samples decoded, expected %u\n",
+           ring_size, n, expected);
+    return 1;
+  }
+  for (uint16_t i = 0; i < n; i++) {
+    if ((out[i].x != sample_value(i, 0))
+        || (out[i].y != sample_value(i, 1))
+        || (out[i].z != sample_value(i, 2))) {
+      printf("FAIL: ring %u, sample %u decoded as %d %d %d\n",
+             ring_size, i, out[i].x, out[i].y, out[i].z);
+      return 1;
+    }
+  }
+  if (bma400_stream_get_dropped() != (uint32_t)(FIFO_FRAMES - expected)) {
+    printf("FAIL: ring %u, %lu samples dropped\n",
+           ring_size, (unsigned long)bma400_stream_get_dropped());
+    return 1;
+  }
+  if (bma400_stream_get_sensor_time() != SENSOR_TIME) {
+    printf("FAIL: sensor time 0x%06lx\n",
+           (unsigned long)bma400_stream_get_sensor_time());
+    return 1;
+  }
+  printf("ok: ring of %u, %u frames decoded, %lu dropped\n",
+         ring_size, n, (unsigned long)bma400_stream_get_dropped());
+  return 0;
+}
+
+int main(void)
+{
+  struct bma400_dev dev = { 0 };
+  struct timespec start, end;
+  double ns;
+  int failed = 0;
+
+  dev.intf = BMA400_I2C_INTF;
+  dev.read = mock_read;
+  dev.write = mock_write;
+  dev.delay_us = mock_delay_us;
+  dev.intf_ptr = regs;
+  dev.chip_id = BMA400_CHIP_ID;
+  dev.resolution = 12;
+
+  fill_fifo();
+
+  failed |= check_burst(&dev, 100);
+  failed |= check_burst(&dev, 2 * FIFO_FRAMES);
+  if (failed) {
+    return 1;
+  }
+
+  // The ring holds two bursts, so every other burst wraps around its end
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t i = 0; i < BENCH_BURSTS; i++) {
+    mock_watermark();
+    bma400_stream_process(NULL, &dev);
+    bma400_stream_read(out, FIFO_FRAMES);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+  ns /= BENCH_BURSTS;
+  printf("decode of a 1 KB FIFO (%u frames): %.0f ns per burst, "
+         "%.1f ns per frame\n", FIFO_FRAMES, ns, ns / FIFO_FRAMES);
+
+  return 0;
+}
@@ -70,6 +70,21 @@ extern "C"
 // </h>
 // <<< end of configuration section >>>
 
+// <<< sl:start pin_tool >>>
+
+/*
+ * GPIO port/pin connected to the INT pin of the NeoTrellis boards. The INT
+ * outputs of tiled boards are open drain and can share this pin. When it is
+ * not configured the keypad FIFO of every board is polled on each read.
+ */
+// <gpio optional=true> NEOTRELLIS_INT
+// $[GPIO_NEOTRELLIS_INT]
+// #define NEOTRELLIS_INT_PORT              gpioPortB
+// #define NEOTRELLIS_INT_PIN               0
+// [GPIO_NEOTRELLIS_INT]$
+
+// <<< sl:end pin_tool >>>
+
 #ifdef __cplusplus
 extern "C"
 }
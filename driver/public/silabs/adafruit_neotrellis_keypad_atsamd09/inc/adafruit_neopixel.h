@@ -98,6 +98,10 @@ extern "C" {
 
 typedef uint16_t neoPixelType;
 
+// Maximum pixel bytes per SEESAW_NEOPIXEL_BUF write: the seesaw I2C buffer
+// minus the register address and the 16-bit buffer offset.
+#define NEOPIXEL_BUF_CHUNK_MAX (SEESAW_I2C_BUFFER_MAX - 4)
+
 typedef struct neopixel_t {
   bool is800KHz;   // ...true if 800 KHz pixels
   bool begun;          // true if begin() previously called
@@ -111,6 +115,9 @@ typedef struct neopixel_t {
   uint8_t bOffset;        // Index of blue byte
   uint8_t wOffset;        // Index of white byte (same as rOffset if no white)
   uint32_t endTime;   // Latch timing reference
+  uint16_t dirtyStart;    // First byte of 'pixels' not yet sent to seesaw
+  uint16_t dirtyEnd;      // One past the last byte not yet sent to seesaw
+  bool needsShow;         // Seesaw buffer changed since the last show
   uint16_t type;
   seesaw_t adafruit_seesaw;
 } neopixel_t;
@@ -138,7 +145,22 @@ sl_status_t adafruit_neopixel_init(neopixel_t *pixel,
 /**************************************************************************/
 
 /*!
- *     @brief  show all neopixels colors
+ *     @brief  Send the changed part of the local pixel buffer to the seesaw
+ *             in chunks of up to NEOPIXEL_BUF_CHUNK_MAX bytes, without
+ *             latching it to the LEDs.
+ *     @param  pixel point to pixel instance.
+ *     @return SL_STATUS_OK if success, Error code if not.
+ */
+
+/**************************************************************************/
+
+sl_status_t adafruit_neopixel_flush(neopixel_t *pixel);
+
+/**************************************************************************/
+
+/*!
+ *     @brief  show all neopixels colors. Pending pixel changes are flushed
+ *             first, the show command is skipped if nothing changed.
  *     @param  pixel point to pixel instance.
  *     @return SL_STATUS_OK if success, Error code if not.
  */
@@ -163,7 +185,8 @@ sl_status_t adafruit_neopixel_set_pin(neopixel_t *pixel, uint8_t p);
 /**************************************************************************/
 
 /*!
- *     @brief  Set pixel color with r, g, b components.
+ *     @brief  Set pixel color with r, g, b components in the local
+ *             buffer, the change is sent on the next show.
  *     @param  pixel point to pixel instance.
  *     @param  n     pixel number to set.
  *     @param  r     r value of rgb code.
@@ -183,7 +206,8 @@ sl_status_t adafruit_neopixel_set_pixelColor_rgb(neopixel_t *pixel,
 /**************************************************************************/
 
 /*!
- *     @brief  Set pixel color with r, g, b, w components.
+ *     @brief  Set pixel color with r, g, b, w components in the local
+ *             buffer, the change is sent on the next show.
  *     @param  pixel point to pixel instance.
  *     @param  n     pixel number to set.
  *     @param  r     r value of rgb code.
@@ -205,7 +229,8 @@ sl_status_t adafruit_neopixel_set_pixelColor_rgbw(neopixel_t *pixel,
 /**************************************************************************/
 
 /*!
- *     @brief  Set pixel color with rgb color code.
+ *     @brief  Set pixel color with rgb color code in the local
+ *             buffer, the change is sent on the next show.
  *     @param  pixel point to pixel instance.
  *     @param  n     pixel number to set.
  *     @param  c     rgb color code.
@@ -243,7 +243,8 @@ sl_status_t adafruit_neotrellis_setPixelColor(uint16_t num, uint32_t color);
 
 /*!
  *     @brief  call show for all connected neotrellis boards to show all
- *   neopixels
+ *   neopixels. Changed pixels of every board are sent first, then all boards
+ *   are latched together.
  */
 
 /**************************************************************************/
@@ -254,7 +255,8 @@ void adafruit_neotrellis_show();
 
 /*!
  *     @brief  read all events currently stored in the seesaw fifo and call any
- *    callbacks.
+ *    callbacks. When NEOTRELLIS_INT_PIN is configured the fifos are only read
+ *    after the INT pin signalled pending events.
  */
 
 /**************************************************************************/
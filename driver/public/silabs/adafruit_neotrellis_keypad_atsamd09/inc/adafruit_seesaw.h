@@ -47,6 +47,11 @@ extern "C" {
 /***************************************************************************//**
  *    //                       Macro
  ******************************************************************************/
+/** Size of the seesaw I2C receive buffer. A single transaction, including
+ *  the two register address bytes, must not exceed this length.
+ */
+#define SEESAW_I2C_BUFFER_MAX 32
+
 /** Module Base Addreses
  *  The module base addresses for keypad and neopixel seesaw modules.
  */
@@ -153,7 +158,8 @@ sl_status_t adafruit_seesaw_i2c_register_read(seesaw_t *seesaw_dev,
  *     @param  reg_high   Module base address
  *     @param  reg_low    Module function address
  *     @param  pdata      Data to be written
- *     @param  len        Length of data to be written
+ *     @param  len        Length of data to be written, at most
+ *                        SEESAW_I2C_BUFFER_MAX - 2 bytes
  *     @return SL_STATUS_OK if success, Error code if not.
  */
 
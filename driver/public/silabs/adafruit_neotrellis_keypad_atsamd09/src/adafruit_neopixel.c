@@ -39,9 +39,56 @@
 #include <string.h>
 #include "adafruit_neotrellis_config.h"
 
+// Empty dirty range marker
+#define NEOPIXEL_DIRTY_NONE 0xFFFF
+
+// Data latch time of the pixel stream in microseconds
+#define NEOPIXEL_LATCH_US   300UL
+
 static inline bool adafruit_neopixel_can_show(neopixel_t *pixel)
 {
-  return (sl_sleeptimer_get_tick_count() - pixel->endTime) >= 300L;
+  uint32_t latch_ticks = (sl_sleeptimer_get_timer_frequency()
+                          * NEOPIXEL_LATCH_US) / 1000000UL + 1;
+
+  return (sl_sleeptimer_get_tick_count() - pixel->endTime) >= latch_ticks;
+}
+
+static inline void adafruit_neopixel_mark_dirty(neopixel_t *pixel,
+                                                uint16_t offset,
+                                                uint16_t len)
+{
+  if ((pixel->dirtyStart == NEOPIXEL_DIRTY_NONE)
+      || (offset < pixel->dirtyStart)) {
+    pixel->dirtyStart = offset;
+  }
+  if ((offset + len) > pixel->dirtyEnd) {
+    pixel->dirtyEnd = offset + len;
+  }
+}
+
+static void adafruit_neopixel_store(neopixel_t *pixel,
+                                    uint16_t n,
+                                    uint8_t r,
+                                    uint8_t g,
+                                    uint8_t b,
+                                    uint8_t w)
+{
+  uint8_t len = (pixel->wOffset == pixel->rOffset ? 3 : 4);
+  uint8_t *p = &(pixel->pixels[n * len]);
+  uint8_t old[4];
+
+  memcpy(old, p, len);
+  if (len == 4) {
+    p[pixel->wOffset] = w;
+  }
+  p[pixel->rOffset] = r;
+  p[pixel->gOffset] = g;
+  p[pixel->bOffset] = b;
+
+  // Only pixels that actually changed are sent on the next flush
+  if (memcmp(old, p, len) != 0) {
+    adafruit_neopixel_mark_dirty(pixel, n * len, len);
+  }
 }
 
 sl_status_t adafruit_neopixel_init(neopixel_t *pixel,
@@ -62,6 +109,9 @@ sl_status_t adafruit_neopixel_init(neopixel_t *pixel,
   pixel->brightness = 0;
   pixel->pixels = NULL;
   pixel->endTime = 0;
+  pixel->dirtyStart = NEOPIXEL_DIRTY_NONE;
+  pixel->dirtyEnd = 0;
+  pixel->needsShow = false;
   pixel->adafruit_seesaw.i2c_instance.handle = i2c_inst;
 
   i2c_master_configure_default(&i2c_cfg);
@@ -86,13 +136,61 @@ sl_status_t adafruit_neopixel_init(neopixel_t *pixel,
   return sc;
 }
 
-sl_status_t adafruit_neopixel_show(neopixel_t *pixel)
+sl_status_t adafruit_neopixel_flush(neopixel_t *pixel)
 {
   sl_status_t sc;
+  uint8_t writeBuf[NEOPIXEL_BUF_CHUNK_MAX + 2];
+  uint16_t offset;
+  uint16_t len;
+
   if (!pixel->pixels) {
     return SL_STATUS_INVALID_PARAMETER;
   }
 
+  offset = pixel->dirtyStart;
+  while (offset < pixel->dirtyEnd) {
+    len = pixel->dirtyEnd - offset;
+    if (len > NEOPIXEL_BUF_CHUNK_MAX) {
+      len = NEOPIXEL_BUF_CHUNK_MAX;
+    }
+
+    writeBuf[0] = (offset >> 8);
+    writeBuf[1] = offset;
+    memcpy(&writeBuf[2], &pixel->pixels[offset], len);
+
+    sc = adafruit_seesaw_i2c_register_write(&pixel->adafruit_seesaw,
+                                            SEESAW_NEOPIXEL_BASE,
+                                            SEESAW_NEOPIXEL_BUF,
+                                            writeBuf, len + 2);
+    if (sc != SL_STATUS_OK) {
+      // Keep the unsent part dirty so the next flush retries it
+      pixel->dirtyStart = offset;
+      return sc;
+    }
+
+    offset += len;
+    pixel->needsShow = true;
+  }
+
+  pixel->dirtyStart = NEOPIXEL_DIRTY_NONE;
+  pixel->dirtyEnd = 0;
+  return SL_STATUS_OK;
+}
+
+sl_status_t adafruit_neopixel_show(neopixel_t *pixel)
+{
+  sl_status_t sc;
+
+  sc = adafruit_neopixel_flush(pixel);
+  if (sc != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  // Nothing changed since the last latch
+  if (!pixel->needsShow) {
+    return SL_STATUS_OK;
+  }
+
   // Data latch = 300+ microsecond pause in the output stream.  Rather than
   // put a delay at the end of the function, the ending time is noted and
   // the function will simply hold off (if needed) on issuing the
@@ -109,6 +207,7 @@ sl_status_t adafruit_neopixel_show(neopixel_t *pixel)
   if (sc != SL_STATUS_OK) {
     return SL_STATUS_FAIL;
   }
+  pixel->needsShow = false;
   // Save EOD time for latch on next call
   pixel->endTime = sl_sleeptimer_get_tick_count();
   return SL_STATUS_OK;
@@ -139,29 +238,8 @@ sl_status_t adafruit_neopixel_set_pixelColor_rgb(neopixel_t *pixel,
     b = (b * pixel->brightness) >> 8;
   }
 
-  uint8_t *p;
-  if (pixel->wOffset == pixel->rOffset) {   // Is an RGB-type strip
-    p = &(pixel->pixels[n * 3]);       // 3 bytes per pixel
-  } else {                    // Is a WRGB-type strip
-    p = &(pixel->pixels[n * 4]);       // 4 bytes per pixel
-    p[pixel->wOffset] = 0;           // But only R,G,B passed -- set W to 0
-  }
-  p[pixel->rOffset] = r;   // R,G,B always stored
-  p[pixel->gOffset] = g;
-  p[pixel->bOffset] = b;
-
-  uint8_t len = (pixel->wOffset == pixel->rOffset ? 3 : 4);
-  uint16_t offset = n * len;
-
-  uint8_t writeBuf[6];
-  writeBuf[0] = (offset >> 8);
-  writeBuf[1] = offset;
-  memcpy(&writeBuf[2], p, len);
-
-  return adafruit_seesaw_i2c_register_write(&pixel->adafruit_seesaw,
-                                            SEESAW_NEOPIXEL_BASE,
-                                            SEESAW_NEOPIXEL_BUF,
-                                            writeBuf, len + 2);
+  adafruit_neopixel_store(pixel, n, r, g, b, 0);
+  return SL_STATUS_OK;
 }
 
 sl_status_t adafruit_neopixel_set_pixelColor_rgbw(neopixel_t *pixel,
@@ -171,8 +249,6 @@ sl_status_t adafruit_neopixel_set_pixelColor_rgbw(neopixel_t *pixel,
                                                   uint8_t b,
                                                   uint8_t w)
 {
-  uint8_t *p;
-
   if (n >= pixel->numLEDs) {
     return SL_STATUS_INVALID_PARAMETER;
   }
@@ -184,28 +260,8 @@ sl_status_t adafruit_neopixel_set_pixelColor_rgbw(neopixel_t *pixel,
     w = (w * pixel->brightness) >> 8;
   }
 
-  if (pixel->wOffset == pixel->rOffset) {   // Is an RGB-type strip
-    p = &(pixel->pixels[n * 3]);       // 3 bytes per pixel (ignore W)
-  } else {                    // Is a WRGB-type strip
-    p = &(pixel->pixels[n * 4]);       // 4 bytes per pixel
-    p[pixel->wOffset] = w;           // Store W
-  }
-  p[pixel->rOffset] = r;   // Store R,G,B
-  p[pixel->gOffset] = g;
-  p[pixel->bOffset] = b;
-
-  uint8_t len = (pixel->wOffset == pixel->rOffset ? 3 : 4);
-  uint16_t offset = n * len;
-  uint8_t writeBuf[6];
-
-  writeBuf[0] = (offset >> 8);
-  writeBuf[1] = offset;
-  memcpy(&writeBuf[2], p, len);
-
-  return adafruit_seesaw_i2c_register_write(&pixel->adafruit_seesaw,
-                                            SEESAW_NEOPIXEL_BASE,
-                                            SEESAW_NEOPIXEL_BUF,
-                                            writeBuf, len + 2);
+  adafruit_neopixel_store(pixel, n, r, g, b, w);
+  return SL_STATUS_OK;
 }
 
 sl_status_t adafruit_neopixel_set_pixelColor(neopixel_t *pixel,
@@ -216,35 +272,17 @@ sl_status_t adafruit_neopixel_set_pixelColor(neopixel_t *pixel,
     return SL_STATUS_INVALID_PARAMETER;
   }
 
-  uint8_t *p, r = (uint8_t)(c >> 16), g = (uint8_t)(c >> 8), b = (uint8_t)c;
+  uint8_t r = (uint8_t)(c >> 16), g = (uint8_t)(c >> 8), b = (uint8_t)c;
+  uint8_t w = (uint8_t)(c >> 24);
   if (pixel->brightness) {   // See notes in setBrightness()
     r = (r * pixel->brightness) >> 8;
     g = (g * pixel->brightness) >> 8;
     b = (b * pixel->brightness) >> 8;
+    w = (w * pixel->brightness) >> 8;
   }
-  if (pixel->wOffset == pixel->rOffset) {
-    p = &(pixel->pixels[n * 3]);
-  } else {
-    p = &(pixel->pixels[n * 4]);
-    uint8_t w = (uint8_t)(c >> 24);
-    p[pixel->wOffset] = pixel->brightness ? ((w * pixel->brightness) >> 8) : w;
-  }
-  p[pixel->rOffset] = r;
-  p[pixel->gOffset] = g;
-  p[pixel->bOffset] = b;
-
-  uint8_t len = (pixel->wOffset == pixel->rOffset ? 3 : 4);
-  uint16_t offset = n * len;
 
-  uint8_t writeBuf[6];
-  writeBuf[0] = (offset >> 8);
-  writeBuf[1] = offset;
-  memcpy(&writeBuf[2], p, len);
-
-  return adafruit_seesaw_i2c_register_write(&pixel->adafruit_seesaw,
-                                            SEESAW_NEOPIXEL_BASE,
-                                            SEESAW_NEOPIXEL_BUF,
-                                            writeBuf, len + 2);
+  adafruit_neopixel_store(pixel, n, r, g, b, w);
+  return SL_STATUS_OK;
 }
 
 void adafruit_neopixel_set_brightness(neopixel_t *pixel, uint8_t b)
@@ -254,22 +292,16 @@ void adafruit_neopixel_set_brightness(neopixel_t *pixel, uint8_t b)
 
 sl_status_t adafruit_neopixel_clear(neopixel_t *pixel)
 {
-  sl_status_t sc = SL_STATUS_OK;
+  if (!pixel->pixels) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
   // Clear local pixel buffer
   memset(pixel->pixels, 0, pixel->numBytes);
 
   // Now clear the pixels on the seesaw
-  uint8_t writeBuf[32];
-  memset(writeBuf, 0, 32);
-  for (uint8_t offset = 0; offset < pixel->numBytes; offset += 32 - 4) {
-    writeBuf[0] = (offset >> 8);
-    writeBuf[1] = offset;
-    sc |= adafruit_seesaw_i2c_register_write(&pixel->adafruit_seesaw,
-                                             SEESAW_NEOPIXEL_BASE,
-                                             SEESAW_NEOPIXEL_BUF,
-                                             writeBuf, 32);
-  }
-  return sc;
+  adafruit_neopixel_mark_dirty(pixel, 0, pixel->numBytes);
+  return adafruit_neopixel_flush(pixel);
 }
 
 sl_status_t adafruit_neopixel_update_length(neopixel_t *pixel, uint16_t n)
@@ -279,9 +311,13 @@ sl_status_t adafruit_neopixel_update_length(neopixel_t *pixel, uint16_t n)
   }
   // Allocate new data -- note: ALL PIXELS ARE CLEARED
   pixel->numBytes = n * ((pixel->wOffset == pixel->rOffset) ? 3 : 4);
+  pixel->dirtyStart = NEOPIXEL_DIRTY_NONE;
+  pixel->dirtyEnd = 0;
   if ((pixel->pixels = (uint8_t *)malloc(pixel->numBytes))) {
     memset(pixel->pixels, 0, pixel->numBytes);
     pixel->numLEDs = n;
+    // Device buffer content is unknown, resend the whole frame on next show
+    adafruit_neopixel_mark_dirty(pixel, 0, pixel->numBytes);
   } else {
     pixel->numLEDs = pixel->numBytes = 0;
   }
@@ -37,12 +37,69 @@
 #include "adafruit_neotrellis_config.h"
 #include "sl_sleeptimer.h"
 
+#ifdef NEOTRELLIS_INT_PIN
+#include "drv_digital_in.h"
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define GPIO_M4_INTR               7 // M4 Pin interrupt number
+#define AVL_INTR_NO                0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
 #define TRELLIS_MAX_DEVICE_SUPPORT 31
 #define NUM_NEOTRELLIS_DEVICE      (NEOTRELLIS_NUM_COLUMN_BOARDS \
                                     * NEOTRELLIS_NUM_ROW_BOARDS)
 
 static neotrellis_t trellis_dev[NUM_NEOTRELLIS_DEVICE];
 
+#ifdef NEOTRELLIS_INT_PIN
+static digital_in_t trellis_int_pin;
+// Start pending so that events queued before init are drained
+static volatile bool trellis_int_pending = true;
+
+#if (defined(SLI_SI917))
+static void adafruit_neotrellis_int_handler(uint32_t int_no)
+#else
+static void adafruit_neotrellis_int_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+  trellis_int_pending = true;
+}
+
+static void adafruit_neotrellis_int_init(void)
+{
+  pin_name_t int_pin = hal_gpio_pin_name(NEOTRELLIS_INT_PORT,
+                                         NEOTRELLIS_INT_PIN);
+
+  // INT is open drain and active low while a keypad FIFO is not empty
+  digital_in_pullup_init(&trellis_int_pin, int_pin);
+
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { NEOTRELLIS_INT_PIN / 16,
+                              NEOTRELLIS_INT_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     GPIO_M4_INTR,
+                                     SL_GPIO_INTERRUPT_FALLING_EDGE,
+                                     adafruit_neotrellis_int_handler,
+                                     AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(NEOTRELLIS_INT_PIN,
+                           adafruit_neotrellis_int_handler);
+  GPIO_ExtIntConfig(NEOTRELLIS_INT_PORT,
+                    NEOTRELLIS_INT_PIN,
+                    NEOTRELLIS_INT_PIN,
+                    false,
+                    true,
+                    true);
+#endif
+}
+
+#endif
+
 sl_status_t adafruit_neotrellis_init(mikroe_i2c_handle_t i2cspm,
                                      uint8_t *trellis_addr,
                                      uint8_t addr_list_len)
@@ -78,15 +135,20 @@ sl_status_t adafruit_neotrellis_init(mikroe_i2c_handle_t i2cspm,
 
     uint8_t enable_interrupt = 0x01;
     // enable keypad interrupt
-    sc = adafruit_seesaw_i2c_register_write(&trellis_dev->pixel.adafruit_seesaw,
-                                            SEESAW_KEYPAD_BASE,
-                                            SEESAW_KEYPAD_INTENSET,
-                                            &enable_interrupt, 1);
+    sc = adafruit_seesaw_i2c_register_write(
+      &trellis_dev[i].pixel.adafruit_seesaw,
+      SEESAW_KEYPAD_BASE,
+      SEESAW_KEYPAD_INTENSET,
+      &enable_interrupt, 1);
     if (sc != SL_STATUS_OK) {
       return SL_STATUS_FAIL;
     }
   }
 
+#ifdef NEOTRELLIS_INT_PIN
+  adafruit_neotrellis_int_init();
+#endif
+
   return SL_STATUS_OK;
 }
 
@@ -175,7 +237,6 @@ sl_status_t adafruit_neotrellis_setPixelColor_xy(uint16_t x,
   int xkey = NEO_TRELLIS_X(x);
   int ykey = NEO_TRELLIS_Y(y % NEO_TRELLIS_NUM_ROWS * NEO_TRELLIS_NUM_COLS);
   int key = NEO_TRELLIS_XY(xkey, ykey);
-  printf("pixel color: index %d key %d\r\n", index, key);
   return adafruit_neopixel_set_pixelColor(&(trellis_dev[index].pixel),
                                           key,
                                           color);
@@ -191,6 +252,11 @@ sl_status_t adafruit_neotrellis_setPixelColor(uint16_t num, uint32_t color)
 
 void adafruit_neotrellis_show()
 {
+  // Send the pixel data of every board first, then latch all boards back to
+  // back so that tiled boards update together instead of visibly scanning.
+  for (uint8_t i = 0; i < NUM_NEOTRELLIS_DEVICE; i++) {
+    adafruit_neopixel_flush(&(trellis_dev[i].pixel));
+  }
   for (uint8_t i = 0; i < NUM_NEOTRELLIS_DEVICE; i++) {
     adafruit_neopixel_show(&(trellis_dev[i].pixel));
   }
@@ -198,6 +264,15 @@ void adafruit_neotrellis_show()
 
 void adafruit_neotrellis_read()
 {
+#ifdef NEOTRELLIS_INT_PIN
+  // INT stays low while any board still has events queued, so the level is
+  // checked as well as the latched edge.
+  if (!trellis_int_pending && digital_in_read(&trellis_int_pin)) {
+    return;
+  }
+  trellis_int_pending = false;
+#endif
+
   for (int n = 0; n < NUM_NEOTRELLIS_DEVICE; n++) {
     int8_t count = adafruit_seesaw_get_keypad_count(
       &trellis_dev[n].pixel.adafruit_seesaw);
@@ -49,10 +49,10 @@ sl_status_t adafruit_seesaw_i2c_register_read(seesaw_t *seesaw_dev,
   uint8_t read_now;
 
   while (pos < len) {
-    if ((pos + 32) < len) {
-      read_now = 32;
+    if ((len - pos) > SEESAW_I2C_BUFFER_MAX) {
+      read_now = SEESAW_I2C_BUFFER_MAX;
     } else {
-      read_now = len;
+      read_now = len - pos;
     }
 
     i2c_write_data[0] = reg_high;
@@ -73,7 +73,7 @@ sl_status_t adafruit_seesaw_i2c_register_read(seesaw_t *seesaw_dev,
     }
 
     pos += read_now;
-    pdata += pos;
+    pdata += read_now;
   }
 
   return SL_STATUS_OK;
@@ -85,6 +85,10 @@ sl_status_t adafruit_seesaw_i2c_register_write(seesaw_t *seesaw_dev,
                                                uint8_t *pdata,
                                                uint16_t len)
 {
+  if (len > (SEESAW_I2C_BUFFER_MAX - 2)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
   uint8_t data_buffer[len + 2];
   data_buffer[0] = reg_high;
   data_buffer[1] = reg_low;
@@ -74,6 +74,20 @@ extern "C" {
 // The block ends with the following line or at the end of the file:
 // <<< end of configuration section >>>
 
+// <<< sl:start pin_tool >>>
+
+/*
+ * GPIO port/pin connected to the GPIO1 (INT) pin of the sensor, used by the
+ * streaming mode to be notified of new measurements.
+ */
+// <gpio optional=true> VL53L1X_INT
+// $[GPIO_VL53L1X_INT]
+// #define VL53L1X_INT_PORT                     gpioPortB
+// #define VL53L1X_INT_PIN                      1
+// [GPIO_VL53L1X_INT]$
+
+// <<< sl:end pin_tool >>>
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,7 @@
 #ifndef VL53L1X_H_
 #define VL53L1X_H_
 
+#include <stdbool.h>
 #include "sl_status.h"
 #include "drv_i2c_master.h"
 
@@ -92,6 +93,22 @@ typedef struct {
   uint16_t number_per_spads; /*!< Result number per SPADs */
 } vl53l1x_result_t;
 
+/***************************************************************************//**
+ * @brief
+ *    Typedef for specifying the decoded result register bank.
+ ******************************************************************************/
+typedef struct {
+  uint8_t range_status; /*!< Range status, 0 if the distance is valid */
+  uint8_t stream_count; /*!< Measurement counter, wraps at 255 */
+  uint16_t distance_mm; /*!< Crosstalk corrected distance in mm */
+  uint16_t sigma_mm; /*!< Estimated distance standard deviation in mm */
+  uint16_t signal_rate_kcps; /*!< Return signal rate in kcps */
+  uint16_t ambient_rate_kcps; /*!< Ambient rate in kcps */
+  uint16_t signal_per_spad; /*!< As vl53l1x_get_signal_per_spad() */
+  uint16_t ambient_per_spad; /*!< As vl53l1x_get_ambient_per_spad() */
+  uint16_t spads_enabled; /*!< Number of SPADs used for the measurement */
+} vl53l1x_result_block_t;
+
 /***************************************************************************//**
  * @brief
  *    This function loads the 135 bytes default values to initialize the sensor.
@@ -911,6 +928,113 @@ sl_status_t vl53l1x_calibrate_xtalk(uint16_t dev,
                                     uint16_t target_distance_in_mm,
                                     uint16_t *xtalk);
 
+/***************************************************************************//**
+ * @brief
+ *    This function reads the whole result register bank in a single I2C
+ *    burst and decodes all fields.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @param[out] block
+ *    Returns the decoded measurement.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if block is invalid.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ *
+ * @note
+ *    The interrupt is not cleared, call vl53l1x_clear_interrupt() after it.
+ ******************************************************************************/
+sl_status_t vl53l1x_get_result_block(uint16_t dev,
+                                     vl53l1x_result_block_t *block);
+
+/***************************************************************************//**
+ * @brief
+ *    This function starts continuous ranging into a caller provided queue.
+ *
+ *    When the VL53L1X_INT pin (GPIO1 of the sensor) is configured, a GPIO
+ *    interrupt marks every new measurement and vl53l1x_stream_process() only
+ *    accesses the bus when a measurement is ready. Otherwise the data ready
+ *    status is polled.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @param[in] buffer
+ *    Storage for the queued measurements.
+ *
+ * @param[in] size
+ *    Number of entries in buffer.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if buffer or size is invalid.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_stream_start(uint16_t dev,
+                                 vl53l1x_result_block_t *buffer,
+                                 uint16_t size);
+
+/***************************************************************************//**
+ * @brief
+ *    This function stops continuous ranging. Queued measurements can still
+ *    be read.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_stream_stop(uint16_t dev);
+
+/***************************************************************************//**
+ * @brief
+ *    This function moves a ready measurement into the queue. It must be
+ *    called from the main loop, not from interrupt context.
+ *
+ *    A measurement costs one result block read and one interrupt clear.
+ *    When the queue is full the measurement is counted as dropped.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @return
+ *    SL_STATUS_OK if a measurement was queued.
+ *    SL_STATUS_EMPTY if no measurement is ready.
+ *    SL_STATUS_INVALID_STATE if streaming is not started.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_stream_process(uint16_t dev);
+
+/***************************************************************************//**
+ * @brief
+ *    This function gets the oldest measurement from the queue.
+ *
+ * @param[out] block
+ *    Returns the measurement.
+ *
+ * @return
+ *    true if a measurement was returned, false if the queue is empty.
+ ******************************************************************************/
+bool vl53l1x_stream_read(vl53l1x_result_block_t *block);
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of queued measurements.
+ ******************************************************************************/
+uint16_t vl53l1x_stream_available(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of measurements dropped because the
+ *    queue was full.
+ ******************************************************************************/
+uint32_t vl53l1x_stream_get_dropped(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,7 +43,53 @@
 #include "sparkfun_vl53l1x.h"
 #include "sparkfun_vl53l1x_config.h"
 
+#ifdef VL53L1X_INT_PIN
+#include "drv_digital_in.h"
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define GPIO_M4_INTR              7 // M4 Pin interrupt number
+#define AVL_INTR_NO               0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
+// RESULT__RANGE_STATUS up to the crosstalk corrected signal rate
+#define VL53L1X_RESULT_BLOCK_LENGTH 17
+
+typedef struct {
+  vl53l1x_result_block_t *buffer;
+  uint16_t size;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t count;
+  uint32_t dropped;
+  uint8_t int_polarity;
+  bool running;
+  volatile bool pending;
+} vl53l1x_stream_t;
+
 static i2c_master_t vl53l1x_inst;
+static vl53l1x_stream_t vl53l1x_stream;
+
+#ifdef VL53L1X_INT_PIN
+static digital_in_t vl53l1x_int_pin;
+
+/***************************************************************************//**
+ * GPIO1 interrupt handler, a new measurement is ready
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+static void vl53l1x_int_handler(uint32_t int_no)
+#else
+static void vl53l1x_int_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  vl53l1x_stream.pending = true;
+}
+
+#endif
 
 sl_status_t vl53l1x_init(uint16_t dev, mikroe_i2c_handle_t i2c_instance)
 {
@@ -420,3 +466,192 @@ sl_status_t vl53l1x_calibrate_xtalk(uint16_t dev,
   }
   return VL53L1X_CalibrateXtalk(dev, target_distance_in_mm, xtalk);
 }
+
+sl_status_t vl53l1x_get_result_block(uint16_t dev,
+                                     vl53l1x_result_block_t *block)
+{
+  uint8_t raw[VL53L1X_RESULT_BLOCK_LENGTH];
+  uint16_t spads;
+  uint16_t signal;
+  uint16_t ambient;
+  sl_status_t ret;
+
+  if (NULL == block) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  ret = VL53L1_ReadMulti(dev, VL53L1_RESULT__RANGE_STATUS, raw, sizeof(raw));
+  if (SL_STATUS_OK != ret) {
+    return ret;
+  }
+
+  spads = (uint16_t)(raw[3] << 8 | raw[4]);
+  ambient = (uint16_t)(raw[7] << 8 | raw[8]);
+  signal = (uint16_t)(raw[15] << 8 | raw[16]);
+
+  block->range_status = VL53L1X_DecodeRangeStatus(raw[0]);
+  block->stream_count = raw[2];
+  block->distance_mm = (uint16_t)(raw[13] << 8 | raw[14]);
+  block->sigma_mm = (uint16_t)(raw[9] << 8 | raw[10]) >> 2;
+  block->signal_rate_kcps = signal * 8;
+  block->ambient_rate_kcps = ambient * 8;
+  block->spads_enabled = spads >> 8;
+
+  // spads is in 8.8 fixed point, same scaling as the single getters
+  if (spads != 0) {
+    block->signal_per_spad = (uint16_t)((200UL * signal) / spads);
+    block->ambient_per_spad = (uint16_t)((200UL * ambient) / spads);
+  } else {
+    block->signal_per_spad = 0;
+    block->ambient_per_spad = 0;
+  }
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t vl53l1x_stream_start(uint16_t dev,
+                                 vl53l1x_result_block_t *buffer,
+                                 uint16_t size)
+{
+  sl_status_t ret;
+
+  if ((NULL == buffer) || (0 == size)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  vl53l1x_stream.buffer = buffer;
+  vl53l1x_stream.size = size;
+  vl53l1x_stream.head = 0;
+  vl53l1x_stream.tail = 0;
+  vl53l1x_stream.count = 0;
+  vl53l1x_stream.dropped = 0;
+  vl53l1x_stream.pending = false;
+
+  ret = VL53L1X_GetInterruptPolarity(dev, &vl53l1x_stream.int_polarity);
+  if (SL_STATUS_OK != ret) {
+    return ret;
+  }
+
+#ifdef VL53L1X_INT_PIN
+  pin_name_t int_pin = hal_gpio_pin_name(VL53L1X_INT_PORT, VL53L1X_INT_PIN);
+  bool active_high = (vl53l1x_stream.int_polarity != 0);
+
+  digital_in_init(&vl53l1x_int_pin, int_pin);
+
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { VL53L1X_INT_PIN / 16,
+                              VL53L1X_INT_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     GPIO_M4_INTR,
+                                     active_high
+                                     ? SL_GPIO_INTERRUPT_RISING_EDGE
+                                     : SL_GPIO_INTERRUPT_FALLING_EDGE,
+                                     vl53l1x_int_handler,
+                                     AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(VL53L1X_INT_PIN, vl53l1x_int_handler);
+  GPIO_ExtIntConfig(VL53L1X_INT_PORT,
+                    VL53L1X_INT_PIN,
+                    VL53L1X_INT_PIN,
+                    active_high,
+                    !active_high,
+                    true);
+#endif
+#endif
+
+  ret = VL53L1X_ClearInterrupt(dev);
+  if (SL_STATUS_OK != ret) {
+    return ret;
+  }
+
+  ret = VL53L1X_StartRanging(dev);
+  if (SL_STATUS_OK != ret) {
+    return ret;
+  }
+
+  vl53l1x_stream.running = true;
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t vl53l1x_stream_stop(uint16_t dev)
+{
+  vl53l1x_stream.running = false;
+
+#if defined(VL53L1X_INT_PIN) && !defined(SLI_SI917)
+  GPIO_IntDisable(1 << VL53L1X_INT_PIN);
+#endif
+
+  return VL53L1X_StopRanging(dev);
+}
+
+sl_status_t vl53l1x_stream_process(uint16_t dev)
+{
+  sl_status_t ret;
+
+  if (!vl53l1x_stream.running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+#ifdef VL53L1X_INT_PIN
+  if (!vl53l1x_stream.pending) {
+    return SL_STATUS_EMPTY;
+  }
+  vl53l1x_stream.pending = false;
+#else
+  uint8_t hv_status;
+
+  ret = VL53L1_RdByte(dev, GPIO__TIO_HV_STATUS, &hv_status);
+  if (SL_STATUS_OK != ret) {
+    return ret;
+  }
+  if ((hv_status & 1) != vl53l1x_stream.int_polarity) {
+    return SL_STATUS_EMPTY;
+  }
+#endif
+
+  // The measurement is discarded without reading it when the queue is full,
+  // the interrupt still has to be cleared for the next one to start
+  if (vl53l1x_stream.count >= vl53l1x_stream.size) {
+    vl53l1x_stream.dropped++;
+  } else {
+    ret = vl53l1x_get_result_block(dev,
+                                   &vl53l1x_stream.buffer[vl53l1x_stream.head]);
+    if (SL_STATUS_OK != ret) {
+      // Keep the measurement pending so that the read is retried on the next
+      // call, the sensor holds the interrupt until it is cleared
+#ifdef VL53L1X_INT_PIN
+      vl53l1x_stream.pending = true;
+#endif
+      return ret;
+    }
+    vl53l1x_stream.head = (vl53l1x_stream.head + 1) % vl53l1x_stream.size;
+    vl53l1x_stream.count++;
+  }
+
+  return VL53L1X_ClearInterrupt(dev);
+}
+
+bool vl53l1x_stream_read(vl53l1x_result_block_t *block)
+{
+  if ((NULL == block) || (0 == vl53l1x_stream.count)) {
+    return false;
+  }
+
+  *block = vl53l1x_stream.buffer[vl53l1x_stream.tail];
+  vl53l1x_stream.tail = (vl53l1x_stream.tail + 1) % vl53l1x_stream.size;
+  vl53l1x_stream.count--;
+
+  return true;
+}
+
+uint16_t vl53l1x_stream_available(void)
+{
+  return vl53l1x_stream.count;
+}
+
+uint32_t vl53l1x_stream_get_dropped(void)
+{
+  return vl53l1x_stream.dropped;
+}
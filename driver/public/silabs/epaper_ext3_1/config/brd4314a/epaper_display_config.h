@@ -52,6 +52,37 @@ extern "C"
 
 // A CMSIS annotation block starts with the following line:
 // <<< Use Configuration Wizard in Context Menu >>>
+// <h> Update settings
+
+// <q EPD_FAST_UPDATE_ENABLE> Fast update
+// <i> Use the fast update waveform for partial updates, only for panels
+// <i> with the embedded fast update waveform. A copy of the displayed frame
+// <i> (EPD_VERTICAL * EPD_HORIZONTAL / 8 bytes) is kept in RAM for it.
+// <i> Default: 0
+#define EPD_FAST_UPDATE_ENABLE      0
+
+// <o EPD_FULL_REFRESH_INTERVAL> Fast updates between full refreshes <0-255>
+// <i> Ghosting builds up with fast updates, an automatic update does a full
+// <i> refresh after this many fast updates. 0 means never.
+// <i> Default: 8
+#define EPD_FULL_REFRESH_INTERVAL   8
+
+// <q EPD_PARTIAL_WINDOW_ENABLE> Transfer changed lines only
+// <i> Restrict the RAM and update windows to the changed lines. The full
+// <i> frame is sent if the windows read from the OTP have another layout.
+// <i> Default: 0
+#define EPD_PARTIAL_WINDOW_ENABLE   0
+
+// <o EPD_TEMPERATURE> Ambient temperature (Celsius) <0-60>
+// <i> Selects the waveform, it can be updated by epd_set_temperature()
+// <i> Default: 20
+#define EPD_TEMPERATURE             20
+
+// <o EPD_REFRESH_TIMEOUT_MS> Refresh timeout (ms) <1000-60000>
+// <i> Default: 30000
+#define EPD_REFRESH_TIMEOUT_MS      30000
+// </h>
+
 // <h> SPIDRV settings
 
 // <o SPI_EPD_BITRATE> SPI bitrate
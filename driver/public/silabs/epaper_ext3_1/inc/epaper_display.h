@@ -52,6 +52,23 @@ extern "C"
 
 struct epd_driver;
 
+/// Update modes of \ref epd_update
+typedef enum {
+  EPD_UPDATE_AUTO = 0,  ///< Fast or windowed update if possible, a full
+                        ///< refresh every EPD_FULL_REFRESH_INTERVAL updates
+  EPD_UPDATE_FULL,      ///< Normal waveform on the whole panel
+  EPD_UPDATE_FAST,      ///< Fast waveform (requires EPD_FAST_UPDATE_ENABLE)
+} epd_update_mode_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Update completion callback.
+ *
+ * @param[in] status SL_STATUS_OK, or SL_STATUS_TIMEOUT if BUSY was not
+ *                   released within EPD_REFRESH_TIMEOUT_MS
+ ******************************************************************************/
+typedef void (*epd_update_callback_t)(sl_status_t status);
+
 // E-Paper Display (EPD)
 struct epd {
   const struct epd_driver *drv;
@@ -69,6 +86,8 @@ struct epd_driver {
   sl_status_t (*spi_command_write)(struct epd *epd,
                                    uint8_t cmd,
                                    const uint8_t *data, size_t len);
+  void (*busy_irq_init)(void (*callback)(void));
+  void (*wait_for_flag)(volatile bool *flag);
 };
 
 /***************************************************************************//**
@@ -78,6 +97,80 @@ void epd_init(void);
 
 void epd_driver_init(struct epd *epd);
 
+/***************************************************************************//**
+ * @brief
+ *    Start an incremental update of the panel.
+ *
+ * @param[in] image new frame, EPD_VERTICAL * EPD_HORIZONTAL / 8 bytes
+ * @param[in] mode update mode
+ * @param[in] callback called from \ref epd_process when the refresh is
+ *                     done, can be NULL
+ *
+ * @return
+ *    SL_STATUS_OK if the refresh has been started,
+ *    SL_STATUS_EMPTY if no line has changed since the last update (the panel
+ *      is not touched and the callback is not called),
+ *    SL_STATUS_BUSY if an update is in progress,
+ *    SL_STATUS_NULL_POINTER if image is NULL,
+ *    SL_STATUS_NOT_SUPPORTED if the fast mode is not enabled.
+ *
+ * @note
+ *    With EPD_FAST_UPDATE_ENABLE the frame is compared line by line against
+ *    the last displayed one. Otherwise the lines marked by
+ *    \ref epd_mark_dirty since the last update are taken as changed, images
+ *    not drawn through GLIB shall be marked or use EPD_UPDATE_FULL.
+ *    Only the changed lines are transferred if
+ *    EPD_PARTIAL_WINDOW_ENABLE is set and the COG supports windows, and the
+ *    fast waveform is used with the old frame in DRAM2 if
+ *    EPD_FAST_UPDATE_ENABLE is set. The image can be reused as soon as this
+ *    function returns. The end of the refresh is signalled by the BUSY pin
+ *    interrupt, the MCU can sleep meanwhile.
+ ******************************************************************************/
+sl_status_t epd_update(const uint8_t *image,
+                       epd_update_mode_t mode,
+                       epd_update_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *    Mark lines of the image as changed for the next \ref epd_update.
+ *
+ * @param[in] first_line first changed line, 0..EPD_HORIZONTAL - 1
+ * @param[in] last_line last changed line, inclusive
+ ******************************************************************************/
+void epd_mark_dirty(uint16_t first_line, uint16_t last_line);
+
+/***************************************************************************//**
+ * @brief
+ *    Finish a completed refresh: power off the COG and call the callback.
+ *
+ * @note
+ *    It shall be called from the main loop while an update is in progress.
+ ******************************************************************************/
+void epd_process(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Wait in low power mode until the update in progress is done.
+ *
+ * @return
+ *    The status of the update, SL_STATUS_OK if there's none in progress.
+ ******************************************************************************/
+sl_status_t epd_wait(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Is an update in progress?
+ ******************************************************************************/
+bool epd_is_busy(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Set the ambient temperature used to select the waveform.
+ *
+ * @param[in] celsius temperature, clamped to the 0..60 range
+ ******************************************************************************/
+void epd_set_temperature(int8_t celsius);
+
 // -----------------------------------------------------------------------------
 //                       COG related Function
 // -----------------------------------------------------------------------------
@@ -121,7 +214,7 @@ void cog_soft_start(void);
  *           1. Normal update: DRAM2 image is dummy data
  *           2. Fast update: DRAM2 image is the OLD image data
  ******************************************************************************/
-void cog_send_image(uint8_t *dram1, uint8_t *dram2);
+void cog_send_image(const uint8_t *dram1, const uint8_t *dram2);
 
 /***************************************************************************//**
  * @brief  Send updating command.
@@ -43,29 +43,308 @@
 #include "epaper_display.h"
 #include "epaper_display_config.h"
 
+#ifndef EPD_FAST_UPDATE_ENABLE
+#define EPD_FAST_UPDATE_ENABLE      0
+#endif
+
+#ifndef EPD_FULL_REFRESH_INTERVAL
+#define EPD_FULL_REFRESH_INTERVAL   8
+#endif
+
+#ifndef EPD_PARTIAL_WINDOW_ENABLE
+#define EPD_PARTIAL_WINDOW_ENABLE   0
+#endif
+
+#ifndef EPD_TEMPERATURE
+#define EPD_TEMPERATURE             20
+#endif
+
+#ifndef EPD_REFRESH_TIMEOUT_MS
+#define EPD_REFRESH_TIMEOUT_MS      30000
+#endif
+
+// The frame is sent in lines of EPD_VERTICAL pixels
+#define EPD_LINE_SIZE               (EPD_VERTICAL / 8)
+#define EPD_LINES                   EPD_HORIZONTAL
+#define EPD_IMAGE_SIZE              (EPD_LINES * EPD_LINE_SIZE)
+
+// OTP offsets of the default windows
+#define OTP_DRFW                    0x0c
+#define OTP_RAM_RW                  0x12
+#define OTP_DUW                     0x15
+
 static struct epd epd;
 
 // Internal variables
-static uint32_t image_data_size = 0;
 static uint8_t otp_data[128];
+static int8_t temperature = EPD_TEMPERATURE;
+
+// DRAM2 content of the normal update
+static const uint8_t dummy_frame[EPD_IMAGE_SIZE] = { 0 };
+
+static bool committed_valid = false;
+#if EPD_FAST_UPDATE_ENABLE
+// The fast waveform needs the old frame in DRAM2, the changed lines are
+// found by comparing against it
+static uint8_t committed_frame[EPD_IMAGE_SIZE];
+static uint8_t fast_updates = 0;
+static bool update_fast;
+#else
+// Lines changed since the last update, set by the draw path
+static uint8_t dirty_lines[(EPD_LINES + 7) / 8];
+#endif
+
+// Refresh state, set from the BUSY interrupt and the timeout
+static volatile bool busy_released;
+static volatile bool refresh_started;
+static volatile bool refresh_done;
+static volatile sl_status_t refresh_status;
+static bool update_in_progress = false;
+static epd_update_callback_t update_callback;
+static sl_sleeptimer_timer_handle_t refresh_timer;
 
 // SPI transfer protocol for index and data transmit to COG
-static void send_index_data(uint8_t index, uint8_t *data, uint32_t len);
+static void send_index_data(uint8_t index, const uint8_t *data, uint32_t len);
 static void send_command_data(uint8_t index, uint8_t data);
 
 // 2 format to perform soft reset
 static void soft_start_format1(uint8_t offset, uint8_t iREPEAT);
 static void soft_start_format2(uint8_t offset, uint8_t iREPEAT);
 
+static void cog_prepare(const uint8_t *dram1, const uint8_t *dram2,
+                        uint16_t first, uint16_t count, uint8_t waveform);
+static void cog_send_window(const uint8_t *dram1, const uint8_t *dram2,
+                            uint16_t first, uint16_t count);
+static void cog_wait_ready(void);
+static void busy_released_handler(void);
+static void refresh_timeout_handler(sl_sleeptimer_timer_handle_t *handle,
+                                    void *data);
+
 void epd_init()
 {
-  // Actually for 1 color, BWR requires 2 pages.
-  image_data_size = (uint32_t)EPD_VERTICAL * (uint32_t)(EPD_HORIZONTAL / 8);
-
   epd_driver_init(&epd);
+  epd.drv->busy_irq_init(busy_released_handler);
+}
+
+void epd_set_temperature(int8_t celsius)
+{
+  if (celsius < 0) {
+    celsius = 0;
+  } else if (celsius > 60) {
+    celsius = 60;
+  }
+  temperature = celsius;
+}
+
+bool epd_is_busy(void)
+{
+  return update_in_progress;
+}
+
+void epd_mark_dirty(uint16_t first_line, uint16_t last_line)
+{
+#if EPD_FAST_UPDATE_ENABLE
+  (void)first_line;
+  (void)last_line;
+#else
+  if (last_line >= EPD_LINES) {
+    last_line = EPD_LINES - 1;
+  }
+  for (uint16_t line = first_line; line <= last_line; line++) {
+    dirty_lines[line / 8] |= 1 << (line % 8);
+  }
+#endif
+}
+
+static bool is_line_changed(const uint8_t *image, uint16_t line)
+{
+#if EPD_FAST_UPDATE_ENABLE
+  return memcmp(&image[line * EPD_LINE_SIZE],
+                &committed_frame[line * EPD_LINE_SIZE],
+                EPD_LINE_SIZE) != 0;
+#else
+  (void)image;
+  return (dirty_lines[line / 8] & (1 << (line % 8))) != 0;
+#endif
+}
+
+sl_status_t epd_update(const uint8_t *image,
+                       epd_update_mode_t mode,
+                       epd_update_callback_t callback)
+{
+  uint16_t first = EPD_LINES;
+  uint16_t last = 0;
+  bool full;
+  bool fast = false;
+  const uint8_t *dram2 = dummy_frame;
+
+  if (image == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (update_in_progress) {
+    return SL_STATUS_BUSY;
+  }
+
+#if !EPD_FAST_UPDATE_ENABLE
+  if (mode == EPD_UPDATE_FAST) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+#endif
+
+  // find the changed line range, a failed refresh invalidates the whole
+  // committed frame
+  for (uint16_t line = 0; line < EPD_LINES; line++) {
+    if (!committed_valid || is_line_changed(image, line)) {
+      if (first == EPD_LINES) {
+        first = line;
+      }
+      last = line;
+    }
+  }
+#if !EPD_FAST_UPDATE_ENABLE
+  memset(dirty_lines, 0, sizeof(dirty_lines));
+#endif
+
+  full = (mode == EPD_UPDATE_FULL) || !committed_valid;
+  if (!full && (first == EPD_LINES)) {
+    return SL_STATUS_EMPTY;
+  }
+
+#if EPD_FAST_UPDATE_ENABLE
+  if (!full) {
+    fast = (mode == EPD_UPDATE_FAST)
+           || (EPD_FULL_REFRESH_INTERVAL == 0)
+           || (fast_updates < EPD_FULL_REFRESH_INTERVAL);
+    full = !fast;
+  }
+  update_fast = fast;
+  if (fast) {
+    dram2 = committed_frame;
+  }
+#endif
+
+  // the full refresh clears the whole panel
+  if (full || !EPD_PARTIAL_WINDOW_ENABLE) {
+    first = 0;
+    last = EPD_LINES - 1;
+  }
+
+  committed_valid = false;
+  update_callback = callback;
+  update_in_progress = true;
+  refresh_done = false;
+
+  // the waveform is selected by temperature, offset for the fast one
+  cog_prepare(image, dram2, first, last - first + 1,
+              (uint8_t)(temperature * 2 + (fast ? 0x50 : 0x00)));
+
+#if EPD_FAST_UPDATE_ENABLE
+  memcpy(&committed_frame[first * EPD_LINE_SIZE],
+         &image[first * EPD_LINE_SIZE],
+         (last - first + 1) * EPD_LINE_SIZE);
+#endif
+
+  cog_soft_start();
+
+  cog_wait_ready();
+  send_command_data(0x15, 0x3c);
+  refresh_started = true;
+
+  sl_sleeptimer_start_timer_ms(&refresh_timer,
+                               EPD_REFRESH_TIMEOUT_MS,
+                               refresh_timeout_handler,
+                               NULL,
+                               0,
+                               0);
+
+  return SL_STATUS_OK;
+}
+
+void epd_process(void)
+{
+  epd_update_callback_t callback;
+  sl_status_t status;
+
+  if (!update_in_progress || !refresh_done) {
+    return;
+  }
+
+  refresh_done = false;
+  status = refresh_status;
+  sl_sleeptimer_stop_timer(&refresh_timer);
+
+  cog_power_off();
+
+  if (status == SL_STATUS_OK) {
+    committed_valid = true;
+#if EPD_FAST_UPDATE_ENABLE
+    fast_updates = update_fast ? fast_updates + 1 : 0;
+#endif
+  }
+
+  callback = update_callback;
+  update_callback = NULL;
+  update_in_progress = false;
+
+  if (callback != NULL) {
+    callback(status);
+  }
+}
+
+sl_status_t epd_wait(void)
+{
+  sl_status_t status;
+
+  if (!update_in_progress) {
+    return SL_STATUS_OK;
+  }
+
+  epd.drv->wait_for_flag(&refresh_done);
+  status = refresh_status;
+  epd_process();
+
+  return status;
+}
+
+static void busy_released_handler(void)
+{
+  busy_released = true;
+
+  if (refresh_started) {
+    refresh_started = false;
+    refresh_status = SL_STATUS_OK;
+    refresh_done = true;
+  }
+}
+
+static void refresh_timeout_handler(sl_sleeptimer_timer_handle_t *handle,
+                                    void *data)
+{
+  (void) handle;
+  (void) data;
+
+  if (refresh_started) {
+    refresh_started = false;
+    refresh_status = SL_STATUS_TIMEOUT;
+    refresh_done = true;
+  }
 }
 
 void cog_initial(uint8_t *image1, uint8_t *image2)
+{
+  cog_prepare(image1, image2, 0, EPD_LINES, (uint8_t)(temperature * 2));
+
+  cog_soft_start();
+
+  cog_display_refresh();
+
+  cog_power_off();
+}
+
+// Power on the COG and load the frames and the waveform settings
+static void cog_prepare(const uint8_t *dram1, const uint8_t *dram2,
+                        uint16_t first, uint16_t count, uint8_t waveform)
 {
   uint8_t tmp[2] = {};
 
@@ -80,7 +359,7 @@ void cog_initial(uint8_t *image1, uint8_t *image2)
   tmp[1] = 0x00;
   send_index_data(0x01, tmp, 2);
 
-  cog_send_image(image1, image2);
+  cog_send_window(dram1, dram2, first, count);
 
   send_command_data(0x05, 0x7d);
   sl_sleeptimer_delay_millisecond(50);
@@ -104,10 +383,7 @@ void cog_initial(uint8_t *image1, uint8_t *image2)
   sl_sleeptimer_delay_millisecond(10);
 
   send_command_data(0x44, 0x06);
-
-  // check temperature, use normal mode
-  // uint8_t indexTemperature = u_temperature * 2 + 0x50;
-  send_command_data(0x45, 0x28);
+  send_command_data(0x45, waveform);
 
   send_command_data(0xa7, 0x10);
   sl_sleeptimer_delay_millisecond(2);
@@ -117,12 +393,6 @@ void cog_initial(uint8_t *image1, uint8_t *image2)
   send_command_data(0x60, otp_data[0x0b]); // TCON
   send_command_data(0x61, otp_data[0x1b]); // STV_DIR
   send_command_data(0x02, otp_data[0x11]); // VCOM
-
-  cog_soft_start();
-
-  cog_display_refresh();
-
-  cog_power_off();
 }
 
 void cog_power_on()
@@ -139,9 +409,7 @@ void cog_power_on()
 
 void cog_power_off()
 {
-  while (epd.drv->get_busy_pin()) {
-    // wait busy high
-  }
+  cog_wait_ready();
 
   send_command_data(0x09, 0x7b);
   send_command_data(0x05, 0x5d);
@@ -149,9 +417,7 @@ void cog_power_off()
   sl_sleeptimer_delay_millisecond(15);
   send_command_data(0x09, 0x00);
 
-  while (epd.drv->get_busy_pin()) {
-    // wait busy high
-  }
+  cog_wait_ready();
 
 //  GPIO_PinOutClear(EPD_BUSY_PORT, EPD_BUSY_PIN);
 //  GPIO_PinOutClear(EPD_DC_PORT, EPD_DC_PIN);
@@ -170,19 +436,62 @@ void cog_get_data_otp(void)
                              otp_data, 128);
 }
 
-void cog_send_image(uint8_t *dram1, uint8_t *dram2)
+void cog_send_image(const uint8_t *dram1, const uint8_t *dram2)
+{
+  cog_send_window(dram1, dram2, 0, EPD_LINES);
+}
+
+// The OTP holds the full screen windows, the line fields are only patched if
+// they have the expected layout: DUW is x start, x end (bytes), y start and
+// y end (big endian lines), RAM_RW is x start and y start.
+static bool cog_window_supported(void)
 {
-  send_index_data(0x13, &otp_data[0x15], 6); // DUW
-  send_index_data(0x90, &otp_data[0x0C], 4); // DRFW
-  send_index_data(0x12, &otp_data[0x12], 3); // RAM_RW
+  const uint8_t *duw = &otp_data[OTP_DUW];
+  const uint8_t *ram_rw = &otp_data[OTP_RAM_RW];
+
+  return (duw[0] == 0)
+         && (duw[1] == EPD_LINE_SIZE - 1)
+         && (duw[2] == 0) && (duw[3] == 0)
+         && ((((uint16_t)duw[4] << 8) | duw[5]) == EPD_LINES - 1)
+         && (ram_rw[1] == 0) && (ram_rw[2] == 0);
+}
+
+static void cog_send_window(const uint8_t *dram1, const uint8_t *dram2,
+                            uint16_t first, uint16_t count)
+{
+  uint8_t duw[6];
+  uint8_t ram_rw[3];
+  uint16_t last;
+
+  memcpy(duw, &otp_data[OTP_DUW], sizeof(duw));
+  memcpy(ram_rw, &otp_data[OTP_RAM_RW], sizeof(ram_rw));
+
+  if (!cog_window_supported()) {
+    first = 0;
+    count = EPD_LINES;
+  } else if (count < EPD_LINES) {
+    last = first + count - 1;
+    duw[2] = first >> 8;
+    duw[3] = first & 0xff;
+    duw[4] = last >> 8;
+    duw[5] = last & 0xff;
+    ram_rw[1] = first >> 8;
+    ram_rw[2] = first & 0xff;
+  }
+
+  send_index_data(0x13, duw, 6); // DUW
+  send_index_data(0x90, &otp_data[OTP_DRFW], 4); // DRFW
+  send_index_data(0x12, ram_rw, 3); // RAM_RW
 
   // first frame
-  send_index_data(0x10, dram1, image_data_size); // First frame
+  send_index_data(0x10, &dram1[first * EPD_LINE_SIZE],
+                  (uint32_t)count * EPD_LINE_SIZE); // First frame
 
-  send_index_data(0x12, &otp_data[0x12], 3); // RAM_RW
+  send_index_data(0x12, ram_rw, 3); // RAM_RW
 
   // second frame
-  send_index_data(0x11, dram2, image_data_size); // Second frame
+  send_index_data(0x11, &dram2[first * EPD_LINE_SIZE],
+                  (uint32_t)count * EPD_LINE_SIZE); // Second frame
 }
 
 void cog_soft_start()
@@ -207,14 +516,26 @@ void cog_soft_start()
 // EPD Screen refresh function
 void cog_display_refresh()
 {
-  while (epd.drv->get_busy_pin()) {
-    sl_sleeptimer_delay_millisecond(32);
-  }
+  cog_wait_ready();
   send_command_data(0x15, 0x3c);
 }
 
+// Sleep until the BUSY pin is released
+static void cog_wait_ready(void)
+{
+  if (!epd.drv->get_busy_pin()) {
+    return;
+  }
+
+  // the edge may have come before the flag is cleared, check the pin again
+  busy_released = false;
+  if (epd.drv->get_busy_pin()) {
+    epd.drv->wait_for_flag(&busy_released);
+  }
+}
+
 // Implements SPI transfer of index and data
-static void send_index_data(uint8_t index, uint8_t *data, uint32_t len)
+static void send_index_data(uint8_t index, const uint8_t *data, uint32_t len)
 {
   epd.drv->spi_command_write(&epd, index, data, len);
 }
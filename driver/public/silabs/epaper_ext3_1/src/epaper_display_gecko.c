@@ -42,7 +42,10 @@
 #include "epaper_display_config.h"
 
 #include "spidrv.h"
+#include "em_core.h"
+#include "em_emu.h"
 #include "em_gpio.h"
+#include "gpiointerrupt.h"
 
 #include "sl_sleeptimer.h"
 #include "sl_udelay.h"
@@ -80,6 +83,9 @@ static bool get_busy_pin(void);
 
 static void delay_10us(uint32_t idelay);
 
+static void busy_irq_init(void (*callback)(void));
+static void wait_for_flag(volatile bool *flag);
+
 static sl_status_t sspi_command_read(struct epd *epd,
                                      uint8_t *cmds, size_t num_cmds,
                                      uint8_t *response, size_t len);
@@ -95,8 +101,12 @@ static const struct epd_driver epd_driver = {
   .delay_10us = delay_10us,
   .sspi_command_read = sspi_command_read,
   .spi_command_write = spi_command_write,
+  .busy_irq_init = busy_irq_init,
+  .wait_for_flag = wait_for_flag,
 };
 
+static void (*busy_callback)(void) = NULL;
+
 static void sspi_init(void)
 {
   GPIO_PinModeSet(SPI_EPD_CLK_PORT,
@@ -143,6 +153,45 @@ static void delay_10us(uint32_t idelay)
   sl_udelay_wait(10 * idelay);
 }
 
+static void busy_irq_handler(uint8_t int_no)
+{
+  (void) int_no;
+
+  if (busy_callback != NULL) {
+    busy_callback();
+  }
+}
+
+// BUSY is released on the rising edge
+static void busy_irq_init(void (*callback)(void))
+{
+  busy_callback = callback;
+
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(EPD_BUSY_PIN, busy_irq_handler);
+  GPIO_ExtIntConfig(EPD_BUSY_PORT,
+                    EPD_BUSY_PIN,
+                    EPD_BUSY_PIN,
+                    true,
+                    false,
+                    true);
+}
+
+static void wait_for_flag(volatile bool *flag)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  // a pending interrupt wakes the core from EM1 even if it's masked, so
+  // the flag can't be set between the check and going to sleep
+  CORE_ENTER_ATOMIC();
+  while (!*flag) {
+    EMU_EnterEM1();
+    CORE_EXIT_ATOMIC();
+    CORE_ENTER_ATOMIC();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
 static uint8_t sspi_read(void)
 {
   uint8_t value = 0;
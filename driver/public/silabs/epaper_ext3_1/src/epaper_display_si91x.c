@@ -41,6 +41,7 @@
 #include "sl_si91x_peripheral_gpio.h"
 #include "rsi_egpio.h"
 #include "sl_si91x_gspi.h"
+#include "sl_driver_gpio.h"
 
 #include "epaper_display.h"
 #include "epaper_display_config.h"
@@ -70,6 +71,9 @@
 #define GSPI_BIT_WIDTH               8         // Default Bit width
 #define GSPI_MAX_BIT_WIDTH           16        // Maximum Bit width
 
+#define EPD_BUSY_INTR_NO             1         // M4 pin interrupt number
+#define EPD_BUSY_AVL_INTR_NO         0         // available interrupt number
+
 static sl_gspi_handle_t spi_epd_handle = NULL;
 
 // read/write for OTP
@@ -86,6 +90,9 @@ static bool get_busy_pin(void);
 
 static void delay_10us(uint32_t idelay);
 
+static void busy_irq_init(void (*callback)(void));
+static void wait_for_flag(volatile bool *flag);
+
 static sl_status_t sspi_command_read(struct epd *epd,
                                      uint8_t *cmds, size_t num_cmds,
                                      uint8_t *response, size_t len);
@@ -101,8 +108,12 @@ static const struct epd_driver epd_driver = {
   .delay_10us = delay_10us,
   .sspi_command_read = sspi_command_read,
   .spi_command_write = spi_command_write,
+  .busy_irq_init = busy_irq_init,
+  .wait_for_flag = wait_for_flag,
 };
 
+static void (*busy_callback)(void) = NULL;
+
 #define wait_spi_transfer_ready(handle)               \
   do {                                                \
     sl_gspi_status_t gspi_status;                     \
@@ -348,6 +359,42 @@ static void delay_10us(uint32_t idelay)
   }
 }
 
+static void busy_irq_handler(uint32_t int_no)
+{
+  (void) int_no;
+
+  if (busy_callback != NULL) {
+    busy_callback();
+  }
+}
+
+// BUSY is released on the rising edge
+static void busy_irq_init(void (*callback)(void))
+{
+  sl_gpio_t gpio_port_pin = { si91x_get_port(EPD_BUSY_PIN),
+                              si91x_get_pin(EPD_BUSY_PIN) };
+
+  busy_callback = callback;
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     EPD_BUSY_INTR_NO,
+                                     SL_GPIO_INTERRUPT_RISING_EDGE,
+                                     busy_irq_handler,
+                                     EPD_BUSY_AVL_INTR_NO);
+}
+
+static void wait_for_flag(volatile bool *flag)
+{
+  // a pending interrupt wakes the core even if it's masked, so the flag
+  // can't be set between the check and going to sleep
+  __disable_irq();
+  while (!*flag) {
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __enable_irq();
+}
+
 static sl_status_t sspi_command_read(struct epd *epd,
                                      uint8_t *cmds, size_t num_cmds,
                                      uint8_t *response, size_t len)
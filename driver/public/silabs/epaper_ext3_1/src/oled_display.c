@@ -40,7 +40,6 @@
 
 /* This oled_frame_buffer is large enough to store one full frame. */
 static uint8_t oled_frame_buffer[(EPD_VERTICAL * EPD_HORIZONTAL) / 8];
-const uint8_t buffer0[(EPD_VERTICAL * EPD_HORIZONTAL) / 8] = {};
 
 static sl_status_t driver_init(void);
 static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color);
@@ -84,11 +83,16 @@ sl_status_t oled_display_init(void)
 static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color)
 {
   uint16_t i = x / 8 + y * EPD_VERTICAL / 8;
+  uint8_t old = oled_frame_buffer[i];
+
   if (color) {
     oled_frame_buffer[i] |= 1 << (7 - (x % 8));
   } else {
     oled_frame_buffer[i] &= ~(1 << (7 - (x % 8)));
   }
+  if (oled_frame_buffer[i] != old) {
+    epd_mark_dirty(y, y);
+  }
   return SL_STATUS_OK;
 }
 
@@ -101,16 +105,26 @@ static uint16_t get_raw_pixel(int16_t x, int16_t y)
 static sl_status_t fill_screen(uint16_t color)
 {
   /* Fill the display with the background color of the glib_context_t  */
-  for (uint16_t i = 0; i < sizeof(oled_frame_buffer); i++) {
-    oled_frame_buffer[i] = color == 0 ? 0x00 : 0xFF;
-  }
+  memset(oled_frame_buffer, color == 0 ? 0x00 : 0xFF,
+         sizeof(oled_frame_buffer));
+  epd_mark_dirty(0, EPD_HORIZONTAL - 1);
   return SL_STATUS_OK;
 }
 
 static sl_status_t update_display(void)
 {
-  cog_initial(oled_frame_buffer, (uint8_t *)buffer0);
-  return SL_STATUS_OK;
+  sl_status_t status;
+
+  // only the changed lines are updated, nothing to do if there's none
+  status = epd_update(oled_frame_buffer, EPD_UPDATE_AUTO, NULL);
+  if (status == SL_STATUS_EMPTY) {
+    return SL_STATUS_OK;
+  }
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return epd_wait();
 }
 
 const oled_display_t *oled_display_get(void)
@@ -58,6 +58,16 @@ extern "C" {
 #define SPARKFUN_MAX30101_I2C_SPEED_MODE          0
 
 // </e>
+// </h>
+
+// <h> FIFO streaming
+
+// <o CONFIG_BIO_HUB_FIFO_BURST_SAMPLES> Samples read per I2C burst <1-32>
+// <i> Largest number of output FIFO samples read in one transfer. The
+// <i> burst buffer uses 23 bytes per sample.
+// <i> Default: 8
+#define CONFIG_BIO_HUB_FIFO_BURST_SAMPLES         8
+
 // </h>
 // <<< end of configuration section >>>
 
@@ -276,6 +276,9 @@ typedef enum IDENTITY_INDEX_BYTES {
   READ_ALGO_VERS           = 0x07
 } identity_index_bytes_t;
 
+/// Completion callback of the asynchronous functions
+typedef void (*bio_hub_async_callback_t)(sl_status_t status, void *arg);
+
 typedef struct {
   uint32_t ir_led;
   uint32_t red_led;
@@ -1195,6 +1198,174 @@ sl_status_t bio_hub_write_spo2_algo_coef(int32_t int_A,
  ******************************************************************************/
 sl_status_t bio_hub_read_spo2_algo_coef(int32_t *user_array);
 
+/***************************************************************************//**
+ * @brief
+ *    Non-blocking version of bio_hub_init(). The reset sequence and the
+ *    command waits are timed with sleeptimer, the I2C transfers are done by
+ *    bio_hub_async_process().
+ *
+ * @param[in] i2cspm_instance
+ *    I2C instance
+ * @param[in] address
+ *    Device address, default is 0x55
+ * @param[in] callback
+ *    Called from bio_hub_async_process() when the sequence ends, may be NULL.
+ *    The status is SL_STATUS_FAIL if the device is not in application mode.
+ * @param[in] callback_arg
+ *    Argument passed to callback
+ *
+ * @return SL_STATUS_OK if the sequence is started.
+ *         SL_STATUS_BUSY if another sequence is running.
+ *         Error code otherwise.
+ ******************************************************************************/
+sl_status_t bio_hub_init_async(mikroe_i2c_handle_t i2cspm_instance,
+                               uint8_t address,
+                               bio_hub_async_callback_t callback,
+                               void *callback_arg);
+
+/***************************************************************************//**
+ * @brief
+ *    Non-blocking version of bio_hub_config_bpm().
+ *
+ * @param[in] mode
+ *    Algorithm mode
+ * @param[in] fifo_threshold
+ *    Number of samples in the output FIFO that pulls MFIO low, 1 to 255
+ * @param[in] callback
+ *    Called from bio_hub_async_process() when the sequence ends, may be NULL.
+ * @param[in] callback_arg
+ *    Argument passed to callback
+ *
+ * @return SL_STATUS_OK if the sequence is started.
+ *         SL_STATUS_BUSY if another sequence is running.
+ *         Error code otherwise.
+ ******************************************************************************/
+sl_status_t bio_hub_config_bpm_async(bio_hub_algo_mode_t mode,
+                                     uint8_t fifo_threshold,
+                                     bio_hub_async_callback_t callback,
+                                     void *callback_arg);
+
+/***************************************************************************//**
+ * @brief
+ *    Non-blocking version of bio_hub_config_sensor().
+ *
+ * @param[in] fifo_threshold
+ *    Number of samples in the output FIFO that pulls MFIO low, 1 to 255
+ * @param[in] callback
+ *    Called from bio_hub_async_process() when the sequence ends, may be NULL.
+ * @param[in] callback_arg
+ *    Argument passed to callback
+ *
+ * @return SL_STATUS_OK if the sequence is started.
+ *         SL_STATUS_BUSY if another sequence is running.
+ *         Error code otherwise.
+ ******************************************************************************/
+sl_status_t bio_hub_config_sensor_async(uint8_t fifo_threshold,
+                                        bio_hub_async_callback_t callback,
+                                        void *callback_arg);
+
+/***************************************************************************//**
+ * @brief
+ *    Non-blocking version of bio_hub_config_sensor_bpm().
+ *
+ * @param[in] mode
+ *    Algorithm mode
+ * @param[in] fifo_threshold
+ *    Number of samples in the output FIFO that pulls MFIO low, 1 to 255
+ * @param[in] callback
+ *    Called from bio_hub_async_process() when the sequence ends, may be NULL.
+ * @param[in] callback_arg
+ *    Argument passed to callback
+ *
+ * @return SL_STATUS_OK if the sequence is started.
+ *         SL_STATUS_BUSY if another sequence is running.
+ *         Error code otherwise.
+ ******************************************************************************/
+sl_status_t bio_hub_config_sensor_bpm_async(bio_hub_algo_mode_t mode,
+                                            uint8_t fifo_threshold,
+                                            bio_hub_async_callback_t callback,
+                                            void *callback_arg);
+
+/***************************************************************************//**
+ * @brief
+ *    This function runs the asynchronous engine, call it from the main loop.
+ *    It returns as soon as the current step waits for the sensor. While
+ *    streaming, it also drains the output FIFO when MFIO signals new samples.
+ *
+ * @return SL_STATUS_OK if there is nothing to do or the current step waits.
+ *         Error code of the step that failed otherwise, the sequence is
+ *         then ended and its callback gets the same status.
+ *
+ * @note
+ *    The blocking functions must not be called while
+ *    bio_hub_async_is_busy() returns true.
+ ******************************************************************************/
+sl_status_t bio_hub_async_process(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function checks if an asynchronous sequence is running.
+ *
+ * @return true while a sequence or a FIFO drain is running.
+ ******************************************************************************/
+bool bio_hub_async_is_busy(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function starts queueing output FIFO samples. On every MFIO
+ *    interrupt bio_hub_async_process() reads the sample count, then all
+ *    samples in one burst, and decodes them into the queue.
+ *    Without a MFIO pin, call bio_hub_stream_request() to start a drain.
+ *
+ * @param[in] buffer
+ *    Storage for the queued samples
+ * @param[in] size
+ *    Number of entries in buffer
+ *
+ * @return SL_STATUS_OK if successful.
+ *         SL_STATUS_INVALID_STATE if the output mode is not sensor data,
+ *         algorithm data or both.
+ *         SL_STATUS_INVALID_PARAMETER if buffer or size is invalid.
+ ******************************************************************************/
+sl_status_t bio_hub_stream_start(bio_hub_data_t *buffer, uint16_t size);
+
+/***************************************************************************//**
+ * @brief
+ *    This function stops queueing output FIFO samples.
+ ******************************************************************************/
+void bio_hub_stream_stop(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function requests a drain of the output FIFO on the next
+ *    bio_hub_async_process() call.
+ ******************************************************************************/
+void bio_hub_stream_request(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function gets the oldest queued sample.
+ *
+ * @param[out] data
+ *    Sample, the fields not present in the output mode are 0
+ *
+ * @return true if a sample was returned, false if the queue is empty.
+ ******************************************************************************/
+bool bio_hub_stream_read(bio_hub_data_t *data);
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of queued samples.
+ ******************************************************************************/
+uint16_t bio_hub_stream_available(void);
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of samples dropped because the queue
+ *    was full.
+ ******************************************************************************/
+uint32_t bio_hub_stream_get_dropped(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,10 @@
 #include "sparkfun_max30101_max32664.h"
 #include "sparkfun_max30101_max32664_config.h"
 
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+#include "gpiointerrupt.h"
+#endif
+
 #define BIO_HUB_ADDRESS           0x55
 
 #define ENABLE_CMD_DELAY          45 // Milliseconds
@@ -61,12 +65,72 @@
 #define BOOTLOADER_MODE           0x08
 #define NO_WRITE                  0x00
 
+#define ASYNC_MAX_STEPS           8
+#define FIFO_SAMPLE_MAX_LENGTH    (MAX30101_LED_ARRAY + MAXFAST_ARRAY_SIZE \
+                                   + MAXFAST_EXTENDED_DATA)
+
+// Steps of the asynchronous engine
+typedef enum {
+  ASYNC_STEP_WRITE,      // Command, wait, status byte
+  ASYNC_STEP_READ,       // Family and index, wait, status and one byte
+  ASYNC_STEP_READ2,      // Family, index and write byte, wait, status and byte
+  ASYNC_STEP_READ_FIFO,  // Family and index, wait, samples counted before
+  ASYNC_STEP_WAIT,       // Wait only
+  ASYNC_STEP_RESET,      // MFIO high, RESET low
+  ASYNC_STEP_RELEASE,    // RESET high
+  ASYNC_STEP_MFIO_INPUT  // MFIO as interrupt input
+} async_step_type_t;
+
+typedef struct {
+  uint8_t type;
+  uint8_t cmd[3];
+  uint16_t delay_ms;
+  uint8_t *result;
+} async_step_t;
+
+typedef struct {
+  async_step_t steps[ASYNC_MAX_STEPS];
+  uint8_t count;
+  uint8_t index;
+  bool busy;
+  bool issued;
+  bool drain;
+  bool check_device_mode;
+  uint8_t response;
+  uint8_t device_mode;
+  bio_hub_output_mode_write_byte_t output_mode;
+  bio_hub_algo_mode_t algo_mode;
+  volatile bool timer_expired;
+  sl_sleeptimer_timer_handle_t timer;
+  bio_hub_async_callback_t callback;
+  void *callback_arg;
+} async_engine_t;
+
+typedef struct {
+  bio_hub_data_t *buffer;
+  uint16_t size;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t count;
+  uint32_t dropped;
+  bool running;
+  volatile bool pending;
+} fifo_stream_t;
+
 // Variables ------------
 static i2c_master_t bio_hub;
 static bio_hub_algo_mode_t user_selected_mode;
 static uint8_t sample_rate = 100;
+static bio_hub_output_mode_write_byte_t output_mode =
+  BIO_HUB_OUTPUT_MODE_PAUSE;
+static async_engine_t bio_hub_async;
+static fifo_stream_t bio_hub_stream;
+static uint8_t fifo_burst[CONFIG_BIO_HUB_FIFO_BURST_SAMPLES
+                          * FIFO_SAMPLE_MAX_LENGTH + 1];
 
 // Private functions------------
+static sl_status_t open_i2c(mikroe_i2c_handle_t i2cspm_instance,
+                            uint8_t address);
 static sl_status_t read_version(uint8_t family,
                                 uint8_t index,
                                 bio_hub_version_t *vers);
@@ -111,6 +175,30 @@ static sl_status_t read_fill_array(uint8_t family_byte,
                                    uint8_t index_byte,
                                    uint8_t num_of_reads,
                                    uint8_t *array);
+static void async_timer_callback(sl_sleeptimer_timer_handle_t *handle,
+                                 void *data);
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+static void mfio_int_handler(uint8_t int_no);
+#endif
+static void async_add_step(uint8_t type,
+                           uint8_t family_byte,
+                           uint8_t index_byte,
+                           uint8_t write_byte,
+                           uint16_t delay_ms,
+                           uint8_t *result);
+static sl_status_t async_begin(bio_hub_async_callback_t callback,
+                               void *callback_arg);
+static void async_add_config_steps(bio_hub_output_mode_write_byte_t mode,
+                                   uint8_t fifo_threshold,
+                                   bool agc,
+                                   bio_hub_algo_mode_t algo);
+static void async_finish(sl_status_t status);
+static uint8_t fifo_sample_length(void);
+static void fifo_decode_sample(const uint8_t *raw, bio_hub_data_t *data);
+static sl_status_t fifo_read_burst(void);
+static sl_status_t async_issue(const async_step_t *step);
+static sl_status_t async_complete(const async_step_t *step);
+static void fifo_start_drain(void);
 
 /***************************************************************************//**
  * @brief
@@ -135,25 +223,9 @@ sl_status_t bio_hub_init(mikroe_i2c_handle_t i2cspm_instance, uint8_t address)
     return SL_STATUS_NULL_POINTER;
   }
 
-  bio_hub.handle = i2cspm_instance;
-
-  i2c_master_config_t i2c_cfg;
-  i2c_master_configure_default(&i2c_cfg);
-
-  if (address) {
-    i2c_cfg.addr = address;
-  } else {
-    i2c_cfg.addr = BIO_HUB_ADDRESS;
-  }
-
-  i2c_cfg.timeout_pass_count = 0;
-
-#if (SPARKFUN_MAX30101_I2C_UC == 1)
-  i2c_cfg.speed = SPARKFUN_MAX30101_I2C_SPEED_MODE;
-#endif
-
-  if (i2c_master_open(&bio_hub, &i2c_cfg) == I2C_MASTER_ERROR) {
-    return SL_STATUS_FAIL;
+  sc = open_i2c(i2cspm_instance, address);
+  if (SL_STATUS_OK != sc) {
+    return sc;
   }
 
   // The following function initializes the sensor. To place the MAX32664 into
@@ -1206,6 +1278,8 @@ sl_status_t bio_hub_accel_control(bool accel_switch)
 sl_status_t bio_hub_set_output_mode(
   bio_hub_output_mode_write_byte_t output_type)
 {
+  sl_status_t sc;
+
   // Bytes between 0x00 and 0x07
   if (output_type > BIO_HUB_OUTPUT_MODE_SENSOR_ALGO_COUNTER) {
     return SL_STATUS_INVALID_PARAMETER;
@@ -1213,7 +1287,11 @@ sl_status_t bio_hub_set_output_mode(
 
   // Check that communication was successful, not that the IC is outputting
   // correct format.
-  return write_byte(OUTPUT_MODE, SET_FORMAT, output_type);
+  sc = write_byte(OUTPUT_MODE, SET_FORMAT, output_type);
+  if (SL_STATUS_OK == sc) {
+    output_mode = output_type;
+  }
+  return sc;
 }
 
 /***************************************************************************//**
@@ -2177,8 +2255,721 @@ sl_status_t bio_hub_read_spo2_algo_coef(int32_t *user_array)
                                  user_array);
 }
 
+// ------------------- Non-blocking Functions -------------------
+
+/***************************************************************************//**
+ * @brief
+ *    This function initializes the sensor in application mode without
+ *    blocking.
+ ******************************************************************************/
+sl_status_t bio_hub_init_async(mikroe_i2c_handle_t i2cspm_instance,
+                               uint8_t address,
+                               bio_hub_async_callback_t callback,
+                               void *callback_arg)
+{
+  sl_status_t sc;
+
+  if (i2cspm_instance == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (bio_hub_async.busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  sc = open_i2c(i2cspm_instance, address);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  sc = async_begin(callback, callback_arg);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  // Same sequence and timing as bio_hub_init()
+#if defined(CONFIG_BIO_HUB_RESET_PORT) && defined(CONFIG_BIO_HUB_RESET_PIN)
+  async_add_step(ASYNC_STEP_RESET, 0, 0, 0, 10, NULL);
+  async_add_step(ASYNC_STEP_RELEASE, 0, 0, 0, 1000, NULL);
+#endif
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+  async_add_step(ASYNC_STEP_MFIO_INPUT, 0, 0, 0, 0, NULL);
+#endif
+  async_add_step(ASYNC_STEP_READ, READ_DEVICE_MODE, 0x00, 0,
+                 CMD_DELAY, &bio_hub_async.device_mode);
+
+  bio_hub_async.output_mode = output_mode;
+  bio_hub_async.algo_mode = user_selected_mode;
+  bio_hub_async.check_device_mode = true;
+  bio_hub_async.busy = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function is the non-blocking version of bio_hub_config_bpm().
+ ******************************************************************************/
+sl_status_t bio_hub_config_bpm_async(bio_hub_algo_mode_t mode,
+                                     uint8_t fifo_threshold,
+                                     bio_hub_async_callback_t callback,
+                                     void *callback_arg)
+{
+  sl_status_t sc;
+
+  if ((mode > BIO_HUB_ALGO_MODE_TWO) || (fifo_threshold == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sc = async_begin(callback, callback_arg);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  async_add_config_steps(BIO_HUB_OUTPUT_MODE_ALGO_DATA, fifo_threshold,
+                         true, mode);
+  async_add_step(ASYNC_STEP_READ2, READ_ALGORITHM_CONFIG,
+                 READ_AGC_NUM_SAMPLES, READ_AGC_NUM_SAMPLES_ID,
+                 CMD_DELAY, &sample_rate);
+  async_add_step(ASYNC_STEP_WAIT, 0, 0, 0, 1000, NULL);
+
+  bio_hub_async.output_mode = BIO_HUB_OUTPUT_MODE_ALGO_DATA;
+  bio_hub_async.algo_mode = mode;
+  bio_hub_async.check_device_mode = false;
+  bio_hub_async.busy = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function is the non-blocking version of bio_hub_config_sensor().
+ ******************************************************************************/
+sl_status_t bio_hub_config_sensor_async(uint8_t fifo_threshold,
+                                        bio_hub_async_callback_t callback,
+                                        void *callback_arg)
+{
+  sl_status_t sc;
+
+  if (fifo_threshold == 0) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sc = async_begin(callback, callback_arg);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  async_add_config_steps(BIO_HUB_OUTPUT_MODE_SENSOR_DATA, fifo_threshold,
+                         false, BIO_HUB_ALGO_MODE_ONE);
+  async_add_step(ASYNC_STEP_WAIT, 0, 0, 0, 1000, NULL);
+
+  bio_hub_async.output_mode = BIO_HUB_OUTPUT_MODE_SENSOR_DATA;
+  bio_hub_async.algo_mode = user_selected_mode;
+  bio_hub_async.check_device_mode = false;
+  bio_hub_async.busy = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function is the non-blocking version of
+ *    bio_hub_config_sensor_bpm().
+ ******************************************************************************/
+sl_status_t bio_hub_config_sensor_bpm_async(bio_hub_algo_mode_t mode,
+                                            uint8_t fifo_threshold,
+                                            bio_hub_async_callback_t callback,
+                                            void *callback_arg)
+{
+  sl_status_t sc;
+
+  if ((mode > BIO_HUB_ALGO_MODE_TWO) || (fifo_threshold == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sc = async_begin(callback, callback_arg);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+
+  async_add_config_steps(BIO_HUB_OUTPUT_MODE_SENSOR_AND_ALGORITHM,
+                         fifo_threshold, false, mode);
+  async_add_step(ASYNC_STEP_READ2, READ_ALGORITHM_CONFIG,
+                 READ_AGC_NUM_SAMPLES, READ_AGC_NUM_SAMPLES_ID,
+                 CMD_DELAY, &sample_rate);
+  async_add_step(ASYNC_STEP_WAIT, 0, 0, 0, 1000, NULL);
+
+  bio_hub_async.output_mode = BIO_HUB_OUTPUT_MODE_SENSOR_AND_ALGORITHM;
+  bio_hub_async.algo_mode = mode;
+  bio_hub_async.check_device_mode = false;
+  bio_hub_async.busy = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function runs the asynchronous engine.
+ ******************************************************************************/
+sl_status_t bio_hub_async_process(void)
+{
+  sl_status_t sc = SL_STATUS_OK;
+
+  if (!bio_hub_async.busy) {
+    if (!bio_hub_stream.running || !bio_hub_stream.pending) {
+      return SL_STATUS_OK;
+    }
+    fifo_start_drain();
+  }
+
+  while (bio_hub_async.busy) {
+    async_step_t *step = &bio_hub_async.steps[bio_hub_async.index];
+
+    if (!bio_hub_async.issued) {
+      sc = async_issue(step);
+      if (SL_STATUS_OK != sc) {
+        async_finish(sc);
+        return sc;
+      }
+
+      bio_hub_async.issued = true;
+      if (step->delay_ms > 0) {
+        bio_hub_async.timer_expired = false;
+        sc = sl_sleeptimer_start_timer_ms(&bio_hub_async.timer,
+                                          step->delay_ms,
+                                          async_timer_callback,
+                                          NULL,
+                                          0,
+                                          0);
+        if (SL_STATUS_OK != sc) {
+          async_finish(sc);
+        }
+        return sc;
+      }
+    } else if (!bio_hub_async.timer_expired) {
+      return SL_STATUS_OK;
+    }
+
+    sc = async_complete(step);
+    if (SL_STATUS_OK != sc) {
+      async_finish(sc);
+      return sc;
+    }
+
+    bio_hub_async.issued = false;
+    bio_hub_async.index++;
+    if (bio_hub_async.index >= bio_hub_async.count) {
+      if (bio_hub_async.check_device_mode && !bio_hub_async.drain
+          && (bio_hub_async.device_mode != APP_MODE)) {
+        sc = SL_STATUS_FAIL;
+      }
+      async_finish(sc);
+      return sc;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns true while a sequence is running.
+ ******************************************************************************/
+bool bio_hub_async_is_busy(void)
+{
+  return bio_hub_async.busy;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function starts queueing output FIFO samples.
+ ******************************************************************************/
+sl_status_t bio_hub_stream_start(bio_hub_data_t *buffer, uint16_t size)
+{
+  if ((buffer == NULL) || (size == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (fifo_sample_length() == 0) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  bio_hub_stream.buffer = buffer;
+  bio_hub_stream.size = size;
+  bio_hub_stream.head = 0;
+  bio_hub_stream.tail = 0;
+  bio_hub_stream.count = 0;
+  bio_hub_stream.dropped = 0;
+  bio_hub_stream.pending = true;
+  bio_hub_stream.running = true;
+
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+  // MFIO is pulled low by the MAX32664 when the FIFO threshold is reached
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(CONFIG_BIO_HUB_MFIO_PIN, mfio_int_handler);
+  GPIO_ExtIntConfig(CONFIG_BIO_HUB_MFIO_PORT,
+                    CONFIG_BIO_HUB_MFIO_PIN,
+                    CONFIG_BIO_HUB_MFIO_PIN,
+                    false,
+                    true,
+                    true);
+#endif
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function stops queueing output FIFO samples.
+ ******************************************************************************/
+void bio_hub_stream_stop(void)
+{
+  bio_hub_stream.running = false;
+  bio_hub_stream.pending = false;
+
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+  GPIO_IntDisable(1 << CONFIG_BIO_HUB_MFIO_PIN);
+#endif
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function requests a drain of the output FIFO.
+ ******************************************************************************/
+void bio_hub_stream_request(void)
+{
+  bio_hub_stream.pending = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function gets the oldest queued sample.
+ ******************************************************************************/
+bool bio_hub_stream_read(bio_hub_data_t *data)
+{
+  if ((data == NULL) || (bio_hub_stream.count == 0)) {
+    return false;
+  }
+
+  *data = bio_hub_stream.buffer[bio_hub_stream.tail];
+  bio_hub_stream.tail = (bio_hub_stream.tail + 1) % bio_hub_stream.size;
+  bio_hub_stream.count--;
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of queued samples.
+ ******************************************************************************/
+uint16_t bio_hub_stream_available(void)
+{
+  return bio_hub_stream.count;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the number of samples dropped because the queue
+ *    was full.
+ ******************************************************************************/
+uint32_t bio_hub_stream_get_dropped(void)
+{
+  return bio_hub_stream.dropped;
+}
+
 // ------------------- Private Functions -----------------------
 
+/***************************************************************************//**
+ * @brief
+ *    Sleeptimer callback of the asynchronous engine, the wait of the current
+ *    step has elapsed.
+ ******************************************************************************/
+static void async_timer_callback(sl_sleeptimer_timer_handle_t *handle,
+                                 void *data)
+{
+  (void)handle;
+  (void)data;
+
+  bio_hub_async.timer_expired = true;
+}
+
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+
+/***************************************************************************//**
+ * @brief
+ *    MFIO interrupt handler, the output FIFO reached its threshold.
+ ******************************************************************************/
+static void mfio_int_handler(uint8_t int_no)
+{
+  (void)int_no;
+
+  bio_hub_stream.pending = true;
+}
+
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    This function appends a command step to the asynchronous sequence.
+ ******************************************************************************/
+static void async_add_step(uint8_t type,
+                           uint8_t family_byte,
+                           uint8_t index_byte,
+                           uint8_t write_byte,
+                           uint16_t delay_ms,
+                           uint8_t *result)
+{
+  async_step_t *step = &bio_hub_async.steps[bio_hub_async.count++];
+
+  step->type = type;
+  step->cmd[0] = family_byte;
+  step->cmd[1] = index_byte;
+  step->cmd[2] = write_byte;
+  step->delay_ms = delay_ms;
+  step->result = result;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function prepares an empty asynchronous sequence.
+ ******************************************************************************/
+static sl_status_t async_begin(bio_hub_async_callback_t callback,
+                               void *callback_arg)
+{
+  if (bio_hub.handle == NULL) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+
+  if (bio_hub_async.busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  bio_hub_async.count = 0;
+  bio_hub_async.index = 0;
+  bio_hub_async.issued = false;
+  bio_hub_async.timer_expired = false;
+  bio_hub_async.callback = callback;
+  bio_hub_async.callback_arg = callback_arg;
+  bio_hub_async.drain = false;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function adds the steps shared by the configuration sequences:
+ *    output mode, FIFO threshold, AGC (optional), sensor and algorithm enable.
+ ******************************************************************************/
+static void async_add_config_steps(bio_hub_output_mode_write_byte_t mode,
+                                   uint8_t fifo_threshold,
+                                   bool agc,
+                                   bio_hub_algo_mode_t algo)
+{
+  async_add_step(ASYNC_STEP_WRITE, OUTPUT_MODE, SET_FORMAT, mode,
+                 CMD_DELAY, NULL);
+  async_add_step(ASYNC_STEP_WRITE, OUTPUT_MODE, WRITE_SET_THRESHOLD,
+                 fifo_threshold, CMD_DELAY, NULL);
+  if (agc) {
+    async_add_step(ASYNC_STEP_WRITE, ENABLE_ALGORITHM, ENABLE_AGC_ALGO, 1,
+                   ENABLE_CMD_DELAY, NULL);
+  }
+  async_add_step(ASYNC_STEP_WRITE, ENABLE_SENSOR, ENABLE_MAX30101, 1,
+                 ENABLE_CMD_DELAY, NULL);
+  async_add_step(ASYNC_STEP_WRITE, ENABLE_ALGORITHM, ENABLE_WHRM_ALGO, algo,
+                 ENABLE_CMD_DELAY, NULL);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function ends the running sequence and reports its status.
+ ******************************************************************************/
+static void async_finish(sl_status_t status)
+{
+  bio_hub_async_callback_t callback = bio_hub_async.callback;
+  void *callback_arg = bio_hub_async.callback_arg;
+
+  bio_hub_async.busy = false;
+
+  if (bio_hub_async.drain) {
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+    // MFIO stays low while the FIFO is above the threshold, no new edge
+    if (GPIO_PinInGet(CONFIG_BIO_HUB_MFIO_PORT,
+                      CONFIG_BIO_HUB_MFIO_PIN) == 0) {
+      bio_hub_stream.pending = true;
+    }
+#endif
+    return;
+  }
+
+  if (SL_STATUS_OK == status) {
+    output_mode = bio_hub_async.output_mode;
+    user_selected_mode = bio_hub_async.algo_mode;
+  }
+
+  if (callback != NULL) {
+    callback(status, callback_arg);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function returns the length of one output FIFO sample.
+ ******************************************************************************/
+static uint8_t fifo_sample_length(void)
+{
+  uint8_t algo_length = MAXFAST_ARRAY_SIZE;
+
+  if (user_selected_mode == BIO_HUB_ALGO_MODE_TWO) {
+    algo_length += MAXFAST_EXTENDED_DATA;
+  }
+
+  switch (output_mode) {
+    case BIO_HUB_OUTPUT_MODE_SENSOR_DATA:
+      return MAX30101_LED_ARRAY;
+    case BIO_HUB_OUTPUT_MODE_ALGO_DATA:
+      return algo_length;
+    case BIO_HUB_OUTPUT_MODE_SENSOR_AND_ALGORITHM:
+      return MAX30101_LED_ARRAY + algo_length;
+    default:
+      return 0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function decodes one output FIFO sample, the layout is the same as
+ *    the one used by bio_hub_read_sensor_bpm().
+ ******************************************************************************/
+static void fifo_decode_sample(const uint8_t *raw, bio_hub_data_t *data)
+{
+  memset(data, 0, sizeof(*data));
+
+  if ((output_mode == BIO_HUB_OUTPUT_MODE_SENSOR_DATA)
+      || (output_mode == BIO_HUB_OUTPUT_MODE_SENSOR_AND_ALGORITHM)) {
+    data->ir_led = (uint32_t)raw[0] << 16 | (uint32_t)raw[1] << 8 | raw[2];
+    data->red_led = (uint32_t)raw[3] << 16 | (uint32_t)raw[4] << 8 | raw[5];
+
+    // The two LED slots the MAX30101 does not have are skipped
+    raw += MAX30101_LED_ARRAY;
+  }
+
+  if (output_mode == BIO_HUB_OUTPUT_MODE_SENSOR_DATA) {
+    return;
+  }
+
+  data->heart_rate = ((uint16_t)raw[0] << 8 | raw[1]) / 10;
+  data->confidence = raw[2];
+  data->oxygen = ((uint16_t)raw[3] << 8 | raw[4]) / 10;
+  data->status = raw[5];
+
+  if (user_selected_mode == BIO_HUB_ALGO_MODE_TWO) {
+    data->r_value = ((uint16_t)raw[6] << 8 | raw[7]) / 10.0f;
+    data->ext_status = (int8_t)raw[8];
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function reads the samples counted by the previous step in a
+ *    single burst and appends them to the stream buffer.
+ ******************************************************************************/
+static sl_status_t fifo_read_burst(void)
+{
+  uint8_t sample_length = fifo_sample_length();
+  uint8_t samples = bio_hub_async.response;
+  uint8_t *raw;
+
+  if (samples == 0) {
+    return SL_STATUS_OK;
+  }
+
+  // The rest is read on the next MFIO interrupt
+  if (samples > CONFIG_BIO_HUB_FIFO_BURST_SAMPLES) {
+    samples = CONFIG_BIO_HUB_FIFO_BURST_SAMPLES;
+    bio_hub_stream.pending = true;
+  }
+
+  if (I2C_MASTER_SUCCESS != i2c_master_read(&bio_hub,
+                                            fifo_burst,
+                                            samples * sample_length + 1)) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  if (fifo_burst[0]) {
+    return SL_STATUS_IO; // Return the error, see: read_status_byte_value_t
+  }
+
+  raw = &fifo_burst[1];
+  for (uint8_t i = 0; i < samples; i++, raw += sample_length) {
+    if (bio_hub_stream.count >= bio_hub_stream.size) {
+      bio_hub_stream.dropped++;
+      continue;
+    }
+
+    fifo_decode_sample(raw, &bio_hub_stream.buffer[bio_hub_stream.head]);
+    bio_hub_stream.head = (bio_hub_stream.head + 1) % bio_hub_stream.size;
+    bio_hub_stream.count++;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function sends the command of a step or applies its pin action.
+ ******************************************************************************/
+static sl_status_t async_issue(const async_step_t *step)
+{
+  uint8_t length;
+
+  switch (step->type) {
+    case ASYNC_STEP_WAIT:
+      return SL_STATUS_OK;
+
+#if defined(CONFIG_BIO_HUB_RESET_PORT) && defined(CONFIG_BIO_HUB_RESET_PIN)
+    case ASYNC_STEP_RESET:
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+      // MFIO is held high during reset to select application mode
+      GPIO_PinModeSet(CONFIG_BIO_HUB_MFIO_PORT,
+                      CONFIG_BIO_HUB_MFIO_PIN,
+                      gpioModePushPull,
+                      1);
+#endif
+      GPIO_PinModeSet(CONFIG_BIO_HUB_RESET_PORT,
+                      CONFIG_BIO_HUB_RESET_PIN,
+                      gpioModePushPull,
+                      0);
+      return SL_STATUS_OK;
+
+    case ASYNC_STEP_RELEASE:
+      GPIO_PinOutSet(CONFIG_BIO_HUB_RESET_PORT, CONFIG_BIO_HUB_RESET_PIN);
+      return SL_STATUS_OK;
+#endif
+
+#if defined(CONFIG_BIO_HUB_MFIO_PORT) && defined(CONFIG_BIO_HUB_MFIO_PIN)
+    case ASYNC_STEP_MFIO_INPUT:
+      GPIO_PinModeSet(CONFIG_BIO_HUB_MFIO_PORT,
+                      CONFIG_BIO_HUB_MFIO_PIN,
+                      gpioModeInputPull,
+                      1);
+      return SL_STATUS_OK;
+#endif
+
+    case ASYNC_STEP_READ:
+    case ASYNC_STEP_READ_FIFO:
+      length = 2;
+      break;
+
+    case ASYNC_STEP_READ2:
+    case ASYNC_STEP_WRITE:
+      length = 3;
+      break;
+
+    default:
+      return SL_STATUS_FAIL;
+  }
+
+  if (I2C_MASTER_SUCCESS != i2c_master_write(&bio_hub,
+                                             (uint8_t *)step->cmd,
+                                             length)) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function reads the response of a step once its wait has elapsed.
+ ******************************************************************************/
+static sl_status_t async_complete(const async_step_t *step)
+{
+  uint8_t read_buf[2];
+
+  switch (step->type) {
+    case ASYNC_STEP_WRITE:
+      if (I2C_MASTER_SUCCESS != i2c_master_read(&bio_hub, read_buf, 1)) {
+        return SL_STATUS_TRANSMIT;
+      }
+      return (read_buf[0] == 0) ? SL_STATUS_OK : SL_STATUS_TRANSMIT;
+
+    case ASYNC_STEP_READ:
+    case ASYNC_STEP_READ2:
+      if (I2C_MASTER_SUCCESS != i2c_master_read(&bio_hub, read_buf, 2)) {
+        return SL_STATUS_TRANSMIT;
+      }
+      if (read_buf[0]) {
+        return SL_STATUS_IO; // Return the error, see: read_status_byte_value_t
+      }
+      bio_hub_async.response = read_buf[1];
+      if (step->result != NULL) {
+        *step->result = read_buf[1];
+      }
+      return SL_STATUS_OK;
+
+    case ASYNC_STEP_READ_FIFO:
+      return fifo_read_burst();
+
+    default:
+      return SL_STATUS_OK;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function queues the commands that drain the output FIFO.
+ ******************************************************************************/
+static void fifo_start_drain(void)
+{
+  bio_hub_stream.pending = false;
+
+  bio_hub_async.count = 0;
+  bio_hub_async.index = 0;
+  bio_hub_async.issued = false;
+  bio_hub_async.timer_expired = false;
+  bio_hub_async.callback = NULL;
+  bio_hub_async.drain = true;
+
+  async_add_step(ASYNC_STEP_READ, READ_DATA_OUTPUT, NUM_SAMPLES, 0,
+                 CMD_DELAY, NULL);
+  async_add_step(ASYNC_STEP_READ_FIFO, READ_DATA_OUTPUT, READ_DATA, 0,
+                 CMD_DELAY, NULL);
+  bio_hub_async.busy = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function opens the I2C instance used to talk to the MAX32664.
+ ******************************************************************************/
+static sl_status_t open_i2c(mikroe_i2c_handle_t i2cspm_instance,
+                            uint8_t address)
+{
+  i2c_master_config_t i2c_cfg;
+
+  bio_hub.handle = i2cspm_instance;
+
+  i2c_master_configure_default(&i2c_cfg);
+
+  if (address) {
+    i2c_cfg.addr = address;
+  } else {
+    i2c_cfg.addr = BIO_HUB_ADDRESS;
+  }
+
+  i2c_cfg.timeout_pass_count = 0;
+
+#if (SPARKFUN_MAX30101_I2C_UC == 1)
+  i2c_cfg.speed = SPARKFUN_MAX30101_I2C_SPEED_MODE;
+#endif
+
+  if (i2c_master_open(&bio_hub, &i2c_cfg) == I2C_MASTER_ERROR) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
 static sl_status_t read_version(uint8_t family,
                                 uint8_t index,
                                 bio_hub_version_t *vers)
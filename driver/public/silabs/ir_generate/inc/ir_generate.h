@@ -40,6 +40,7 @@
 #define __IRGENELATE_H__
 #include "em_gpio.h"
 #include "em_timer.h"
+#include "sl_status.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,10 +54,15 @@ extern "C" {
 #define NEC_REPEAT_HEAD_SPACE_BIT_SIZE  4
 #define BIT(n)              (1 << n)
 #define STREAM_BIT_NUM                  (200)
+// mark/space runs of a stream, plus the trailing guard space
+#define DURATION_TABLE_SIZE             (STREAM_BIT_NUM + 2)
 
 typedef enum {
   CODE_NEC,
   CODE_SONY,
+  CODE_NEC_EXT,
+  CODE_RC5,
+  CODE_RC6,
   CODE_NUM
 }code_t;
 
@@ -78,6 +84,7 @@ typedef struct {
   uint8_t index;
   uint8_t stream_index;
   bool stream_active;
+  bool toggle;
   bool stream[STREAM_BIT_NUM];
 }ir_t;
 
@@ -118,6 +125,27 @@ extern void ir_generate_stop(void);
  */
 extern void ir_generate_stream(uint16_t address, uint16_t command, bool repeat);
 
+/**
+ * @brief start a non-blocking ir signal stream.
+ *
+ * The stream is compiled into a mark/space duration table which the LDMA
+ * loads into the TIMER1 buffered top value on each overflow, while the
+ * TIMER1 CC0 output drives the modulation pin. No interrupt is taken per
+ * slot, the callback passed to ir_generate_init() is called once the last
+ * mark has been sent. The carrier is gated in hardware: TIMER1 CC0 starts
+ * and stops TIMER0 through PRS and is ANDed with the carrier output, so the
+ * carrier pin only toggles during the marks. Two PRS channels are used.
+ *
+ * @param address, command, repeat flag (NEC) or same toggle bit (RC5/RC6)
+ *
+ * @return SL_STATUS_OK if started, SL_STATUS_BUSY if a stream is active,
+ *         SL_STATUS_FAIL if the DMA could not be started
+ *
+ */
+extern sl_status_t ir_generate_stream_async(uint16_t address,
+                                            uint16_t command,
+                                            bool repeat);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,7 @@
 #include "em_chip.h"
 #include "em_gpio.h"
 #include "em_prs.h"
+#include "dmadrv.h"
 #include "ir_generate.h"
 #include "ir_generate_config.h"
 
@@ -60,24 +61,39 @@ const uint8_t ir_table[TABLE_INDEX_NUM][2] = {
 
 static ir_t ir = {
   .code = CODE_NEC,
-  .carrier = { 38000, 40000 },
-  .timebase = { 1769, 1659 },
-  .dutycycle = { 0.335, 0.335 },
-  .head_bit_size = { { 16, 8 }, { 4, 1 } },
-  .address_length = { 8, 7 },
-  .command_length = { 8, 8 },
+  .carrier = { 38000, 40000, 38000, 36000, 36000 },
+  .timebase = { 1769, 1659, 1769, 1125, 2250 },
+  .dutycycle = { 0.335, 0.335, 0.335, 0.335, 0.335 },
+  .head_bit_size = { { 16, 8 }, { 4, 1 }, { 16, 8 }, { 0, 0 }, { 6, 2 } },
+  .address_length = { 8, 7, 16, 5, 8 },
+  .command_length = { 8, 8, 8, 6, 8 },
   .stream_active = false,
   .stream_index = 0,
+  .toggle = false,
 };
 
 static ir_callback_t ir_complete_callback = 0;
 
+// LDMA sequenced transmission
+static bool ir_dma_mode = false;
+static unsigned int ir_dma_channel;
+static bool ir_dma_channel_allocated = false;
+static uint32_t ir_duration[DURATION_TABLE_SIZE];
+static LDMA_Descriptor_t ir_dma_desc;
+
+// PRS channels gating the carrier with the modulation
+static int ir_prs_modulation = -1;
+static int ir_prs_carrier = -1;
+
+__STATIC_INLINE void ir_generate_timebase(void);
+
 __STATIC_INLINE void ir_generate_stream_head(bool *stream, bool repeat)
 {
   uint8_t i;
   uint8_t spaceSize = ir.head_bit_size[ir.code][HEAD_SPACE];
 
-  if ((repeat == true) && (ir.code == CODE_NEC)) {
+  if ((repeat == true)
+      && ((ir.code == CODE_NEC) || (ir.code == CODE_NEC_EXT))) {
     spaceSize = NEC_REPEAT_HEAD_SPACE_BIT_SIZE; // 2.25ms for repeat stream
   }
 
@@ -97,6 +113,7 @@ __STATIC_INLINE void ir_generate_stream_logic(bool *stream, bool bit)
   bool *start_point = stream;
   switch (ir.code) {
     case CODE_NEC:
+    case CODE_NEC_EXT:
       // 1(1 pulse, 3 spaces),0(1 pulse, 1 space)
       *stream++ = true;
       *stream++ = false;
@@ -115,6 +132,18 @@ __STATIC_INLINE void ir_generate_stream_logic(bool *stream, bool bit)
       *stream++ = false;
       break;
 
+    case CODE_RC5:
+      // manchester, 1(space, pulse), 0(pulse, space)
+      *stream++ = !bit;
+      *stream++ = bit;
+      break;
+
+    case CODE_RC6:
+      // manchester, 1(pulse, space), 0(space, pulse)
+      *stream++ = bit;
+      *stream++ = !bit;
+      break;
+
     default:
       *stream = false;
       break;
@@ -122,6 +151,16 @@ __STATIC_INLINE void ir_generate_stream_logic(bool *stream, bool bit)
   ir.index += (stream - start_point);
 }
 
+__STATIC_INLINE void ir_generate_stream_byte_msb(uint16_t stream_data,
+                                                 uint8_t length)
+{
+  // RC5, RC6 send in MSB
+  for (uint8_t i = length; i > 0; i--) {
+    ir_generate_stream_logic(&ir.stream[ir.index],
+                             (stream_data & BIT(i - 1)) != 0);
+  }
+}
+
 __STATIC_INLINE void ir_generate_stream_byte(uint16_t stream_data,
                                              uint8_t length)
 {
@@ -132,20 +171,18 @@ __STATIC_INLINE void ir_generate_stream_byte(uint16_t stream_data,
   }
 }
 
-/**
- * @brief configure ir signal stream.
- *
- * @param address, command, repeat flag for NEC protocol
- *
- * @return none
- *
- */
-void ir_generate_stream(uint16_t address, uint16_t command, bool repeat)
+__STATIC_INLINE void ir_generate_stream_build(uint16_t address,
+                                              uint16_t command,
+                                              bool repeat)
 {
-  while (ir.stream_active) { // Wait until done transmitting last code
-  }
   ir.index = 0;
   ir_generate_stream_head(&ir.stream[ir.index], repeat);
+
+  // RC5/RC6 toggle bit changes on every new key press
+  if (repeat == false) {
+    ir.toggle = !ir.toggle;
+  }
+
   switch (ir.code) {
     case CODE_NEC:
       // address -> address complemented -> command -> command complemented
@@ -159,16 +196,64 @@ void ir_generate_stream(uint16_t address, uint16_t command, bool repeat)
       ir.stream[ir.index++] = true;
       break;
 
+    case CODE_NEC_EXT:
+      // 16 bit address -> command -> command complemented
+      if (repeat == false) {
+        ir_generate_stream_byte(address, ir.address_length[ir.code]);
+        ir_generate_stream_byte(command, ir.command_length[ir.code]);
+        ir_generate_stream_byte((~command), ir.command_length[ir.code]);
+      }
+      // Send trailing (pulse)
+      ir.stream[ir.index++] = true;
+      break;
+
     case CODE_SONY:
       // command -> address
       ir_generate_stream_byte(command, ir.command_length[ir.code]);
       ir_generate_stream_byte(address, ir.address_length[ir.code]);
       break;
 
+    case CODE_RC5:
+      // start -> field (inverted command bit 6) -> toggle -> address
+      //   -> command
+      ir_generate_stream_logic(&ir.stream[ir.index], true);
+      ir_generate_stream_logic(&ir.stream[ir.index], !(command & BIT(6)));
+      ir_generate_stream_logic(&ir.stream[ir.index], ir.toggle);
+      ir_generate_stream_byte_msb(address, ir.address_length[ir.code]);
+      ir_generate_stream_byte_msb(command, ir.command_length[ir.code]);
+      break;
+
+    case CODE_RC6:
+      // start -> mode 0 -> toggle (double width) -> address -> command
+      ir_generate_stream_logic(&ir.stream[ir.index], true);
+      ir_generate_stream_byte_msb(0, 3);
+      ir.stream[ir.index++] = ir.toggle;
+      ir.stream[ir.index++] = ir.toggle;
+      ir.stream[ir.index++] = !ir.toggle;
+      ir.stream[ir.index++] = !ir.toggle;
+      ir_generate_stream_byte_msb(address, ir.address_length[ir.code]);
+      ir_generate_stream_byte_msb(command, ir.command_length[ir.code]);
+      break;
+
     default:
       break;
   }
   ir.stream[ir.index] = false;
+}
+
+/**
+ * @brief configure ir signal stream.
+ *
+ * @param address, command, repeat flag for NEC protocol
+ *
+ * @return none
+ *
+ */
+void ir_generate_stream(uint16_t address, uint16_t command, bool repeat)
+{
+  while (ir.stream_active) { // Wait until done transmitting last code
+  }
+  ir_generate_stream_build(address, command, repeat);
 
   ir.stream_active = true;      // Enable sending code
   ir.stream_index = 0;        // start from 0, stop when ir.stream_index >=
@@ -300,12 +385,251 @@ __STATIC_INLINE void ir_generate_carrier(void)
 #endif
 }
 
+/***************************************************************************//**
+ * Compile the slot stream into a table of TIMER1 top values, one per
+ * mark/space run starting with a mark. A guard space is appended so the
+ * table always ends with the modulation output low.
+ * Returns the number of entries or 0 if the stream is empty.
+ ******************************************************************************/
+__STATIC_INLINE uint16_t ir_generate_compile(uint32_t slot_ticks)
+{
+  uint16_t count = 0;
+  uint16_t run = 0;
+  bool level = true;
+  uint8_t i = 0;
+
+  // Leading spaces are idle time
+  while ((i < ir.index) && (ir.stream[i] == false)) {
+    i++;
+  }
+  for (; i < ir.index; i++) {
+    if (ir.stream[i] != level) {
+      ir_duration[count++] = run * slot_ticks - 1;
+      level = !level;
+      run = 0;
+    }
+    run++;
+  }
+  if (run == 0) {
+    return 0;
+  }
+  ir_duration[count++] = run * slot_ticks - 1;
+  if (level) {
+    // Guard space, long enough for the completion interrupt
+    ir_duration[count++] = slot_ticks - 1;
+  }
+  return count;
+}
+
+/***************************************************************************//**
+ * Longest mark/space run of the current stream in slots.
+ ******************************************************************************/
+__STATIC_INLINE uint16_t ir_generate_max_run(void)
+{
+  uint16_t max_run = 0;
+  uint16_t run = 0;
+
+  for (uint8_t i = 0; i < ir.index; i++) {
+    if ((i > 0) && (ir.stream[i] != ir.stream[i - 1])) {
+      run = 0;
+    }
+    run++;
+    if (run > max_run) {
+      max_run = run;
+    }
+  }
+  return max_run;
+}
+
+static bool ir_generate_dma_done(unsigned int channel,
+                                 unsigned int sequenceNo,
+                                 void *userParam)
+{
+  (void)channel;
+  (void)sequenceNo;
+  (void)userParam;
+
+  // The last top value is loaded, the next overflow ends the last mark
+  TIMER_IntClear(TIMER1, TIMER_IF_OF);
+  TIMER_IntEnable(TIMER1, TIMER_IF_OF);
+  return true;
+}
+
+static void ir_generate_dma_finish(void)
+{
+  TIMER_InitCC_TypeDef carrierOff = TIMER_INITCC_DEFAULT;
+
+  ir_generate_stop();
+  TIMER_IntDisable(TIMER1, TIMER_IF_OF);
+
+  // Give the modulation and carrier pins back to GPIO and TIMER0
+  GPIO->TIMERROUTE[1].ROUTEEN = 0;
+  GPIO->PRSROUTE[0].ROUTEEN &= ~(1UL << (_GPIO_PRS_ROUTEEN_ASYNCH0PEN_SHIFT
+                                        + ir_prs_carrier));
+  GPIO_PinOutClear(IR_GENERATE_BSP_MODULATION_PORT,
+                   IR_GENERATE_BSP_MODULATION_PIN);
+
+  // Restore the carrier on CC0 and the per slot timebase
+  ir_dma_mode = false;
+  TIMER_InitCC(TIMER0, 1, &carrierOff);
+  ir_generate_carrier();
+  ir_generate_timebase();
+  ir.stream_active = false;
+  if (ir_complete_callback) {
+    ir_complete_callback();
+  }
+}
+
+/**
+ * @brief start a non-blocking ir signal stream.
+ *
+ * @param address, command, repeat flag (NEC) or same toggle bit (RC5/RC6)
+ *
+ * @return SL_STATUS_OK, SL_STATUS_BUSY or SL_STATUS_FAIL
+ *
+ */
+sl_status_t ir_generate_stream_async(uint16_t address,
+                                     uint16_t command,
+                                     bool repeat)
+{
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+  TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
+  TIMER_Init_TypeDef carrierInit = TIMER_INIT_DEFAULT;
+  TIMER_InitCC_TypeDef gateCCInit = TIMER_INITCC_DEFAULT;
+  TIMER_InitCC_TypeDef carrierCCInit = TIMER_INITCC_DEFAULT;
+  LDMA_TransferCfg_t xfer =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_TIMER1_UFOF);
+  uint32_t timerFreq;
+  uint32_t topValue;
+  uint32_t divider;
+  uint32_t slot_ticks;
+  uint16_t count;
+
+  if (ir.stream_active) {
+    return SL_STATUS_BUSY;
+  }
+  if (!ir_dma_channel_allocated) {
+    DMADRV_Init();
+    if (DMADRV_AllocateChannel(&ir_dma_channel, NULL)
+        != ECODE_EMDRV_DMADRV_OK) {
+      return SL_STATUS_FAIL;
+    }
+    ir_dma_channel_allocated = true;
+  }
+  if (ir_prs_carrier < 0) {
+    CMU_ClockEnable(cmuClock_PRS, true);
+    ir_prs_modulation = PRS_GetFreeChannel(prsTypeAsync);
+    if (ir_prs_modulation < 0) {
+      return SL_STATUS_FAIL;
+    }
+    // Reserve the channel before looking for the second one
+    PRS_ConnectSignal(ir_prs_modulation, prsTypeAsync, prsSignalTIMER1_CC0);
+    ir_prs_carrier = PRS_GetFreeChannel(prsTypeAsync);
+    if (ir_prs_carrier < 0) {
+      PRS_ConnectSignal(ir_prs_modulation, prsTypeAsync, prsSignalNone);
+      ir_prs_modulation = -1;
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  ir_generate_stream_build(address, command, repeat);
+
+  // Pick the smallest prescaler for which the longest run fits in 16 bits
+  timerFreq = CMU_ClockFreqGet(cmuClock_TIMER1);
+  divider = ((uint32_t)ir_generate_max_run()
+             * (timerFreq / ir.timebase[ir.code])) / 0x10000 + 1;
+  if (divider > 1024) {
+    return SL_STATUS_FAIL;
+  }
+  slot_ticks = (timerFreq / divider) / ir.timebase[ir.code];
+  count = ir_generate_compile(slot_ticks);
+  if (count < 2) {
+    return SL_STATUS_FAIL;
+  }
+
+  ir.stream_active = true;
+  ir_dma_mode = true;
+
+  // TIMER1 CC0 toggles on every overflow and drives the modulation pin
+  TIMER_IntDisable(TIMER1, TIMER_IF_OF);
+  timerInit.prescale = (TIMER_Prescale_TypeDef)(divider - 1);
+  timerInit.enable = false;
+  timerInit.dmaClrAct = true;
+  TIMER_Init(TIMER1, &timerInit);
+  timerCCInit.mode = timerCCModeCompare;
+  timerCCInit.cofoa = timerOutputActionToggle;
+  TIMER_InitCC(TIMER1, 0, &timerCCInit);
+  GPIO->TIMERROUTE[1].ROUTEEN = GPIO_TIMER_ROUTEEN_CC0PEN;
+  GPIO->TIMERROUTE[1].CC0ROUTE =
+    (IR_GENERATE_BSP_MODULATION_PORT << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT)
+    | (IR_GENERATE_BSP_MODULATION_PIN << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+
+  // A short first period, the first overflow starts the first mark
+  TIMER_CounterSet(TIMER1, 0);
+  TIMER_TopSet(TIMER1, 1);
+  TIMER_TopBufSet(TIMER1, ir_duration[0]);
+
+  // Each overflow requests the next top value
+  ir_dma_desc = (LDMA_Descriptor_t)
+                LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(&ir_duration[1],
+                                                &TIMER1->TOPB,
+                                                count - 1);
+  ir_dma_desc.xfer.size = ldmaCtrlSizeWord;
+  if (DMADRV_LdmaStartTransfer((int)ir_dma_channel,
+                               &xfer,
+                               &ir_dma_desc,
+                               ir_generate_dma_done,
+                               NULL) != ECODE_EMDRV_DMADRV_OK) {
+    ir_dma_mode = false;
+    ir.stream_active = false;
+    GPIO->TIMERROUTE[1].ROUTEEN = 0;
+    ir_generate_timebase();
+    return SL_STATUS_FAIL;
+  }
+
+  // TIMER1 CC0 only runs the carrier during the marks: TIMER0 is
+  // started on its rising edge and stopped on its falling edge. The carrier
+  // is moved to CC1 and ANDed with the modulation, so a carrier cycle cut
+  // at the end of a mark doesn't leave the pin high during the space.
+  TIMER_Enable(TIMER0, false);
+  GPIO->TIMERROUTE[0].ROUTEEN = 0;
+  carrierInit.prescale = timerPrescale1;
+  carrierInit.enable = false;
+  carrierInit.riseAction = timerInputActionReloadStart;
+  carrierInit.fallAction = timerInputActionStop;
+  TIMER_Init(TIMER0, &carrierInit);
+  gateCCInit.mode = timerCCModeCapture;
+  gateCCInit.edge = timerEdgeNone;
+  gateCCInit.prsInput = true;
+  gateCCInit.prsSel = (TIMER_PRSSEL_TypeDef)ir_prs_modulation;
+  gateCCInit.prsInputType = timerPrsInputAsyncLevel;
+  TIMER_InitCC(TIMER0, 0, &gateCCInit);
+  carrierCCInit.mode = timerCCModePWM;
+  TIMER_InitCC(TIMER0, 1, &carrierCCInit);
+  topValue = CMU_ClockFreqGet(cmuClock_TIMER0) / ir.carrier[ir.code];
+  TIMER_TopSet(TIMER0, topValue);
+  TIMER_CompareSet(TIMER0, 1, (uint32_t)(topValue * ir.dutycycle[ir.code]));
+  TIMER_CounterSet(TIMER0, 0);
+
+  PRS_ConnectSignal(ir_prs_carrier, prsTypeAsync, prsSignalTIMER0_CC1);
+  PRS_Combine(ir_prs_carrier, ir_prs_modulation, prsLogic_A_AND_B);
+  PRS_PinOutput(ir_prs_carrier, prsTypeAsync,
+                IR_GENERATE_BSP_CARRIER_PORT, IR_GENERATE_BSP_CARRIER_PIN);
+
+  TIMER_Enable(TIMER1, true);
+  return SL_STATUS_OK;
+}
+
 void TIMER1_IRQHandler(void)
 {
   // Acknowledge the interrupt
   uint32_t flags = TIMER_IntGet(TIMER1);
   TIMER_IntClear(TIMER1, flags);
-  ir_generate_send();
+  if (ir_dma_mode) {
+    ir_generate_dma_finish();
+  } else {
+    ir_generate_send();
+  }
 }
 
 __STATIC_INLINE void ir_generate_timebase(void)
@@ -44,6 +44,8 @@ static sl_status_t driver_init(void);
 static sl_status_t draw_pixel(int16_t x, int16_t y, uint16_t color);
 static uint16_t get_raw_pixel(int16_t x, int16_t y);
 static sl_status_t fill_screen(uint16_t color);
+static sl_status_t fill_rect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color);
 static sl_status_t update_display(void);
 
 static oled_display_t oled_display_instance;
@@ -63,6 +65,7 @@ static const oled_display_driver_api_t sl_memlcd_driver_api =
   .scroll_diag_right = ssd1306_scroll_diag_right,
   .scroll_diag_left = ssd1306_scroll_diag_left,
   .stop_scroll = ssd1306_stop_scroll,
+  .fill_rect = fill_rect,
 };
 
 /**
@@ -108,6 +111,30 @@ static sl_status_t fill_screen(uint16_t color)
   return SL_STATUS_OK;
 }
 
+static sl_status_t fill_rect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color)
+{
+  int16_t y_end = y + h;
+
+  // The rectangle is clipped by glib, a page of 8 rows is set at once
+  while (y < y_end) {
+    uint8_t bit = y % 8;
+    uint8_t rows = ((y_end - y) < (8 - bit)) ? (y_end - y) : (8 - bit);
+    uint8_t mask = (uint8_t)((0xFF >> (8 - rows)) << bit);
+    uint8_t *page = &oled_frame_buffer[x + (y / 8) * SSD1306_DISPLAY_WIDTH];
+
+    for (int16_t i = 0; i < w; i++) {
+      if (color) {
+        page[i] |= mask;
+      } else {
+        page[i] &= ~mask;
+      }
+    }
+    y += rows;
+  }
+  return SL_STATUS_OK;
+}
+
 static sl_status_t update_display(void)
 {
   return ssd1306_draw(oled_frame_buffer);
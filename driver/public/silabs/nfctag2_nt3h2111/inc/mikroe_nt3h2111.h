@@ -78,6 +78,8 @@
 
 #define NT3H2111_BLOCK_SIZE                              16
 #define NT3H2111_WRITE_DELAY_MS                          10
+#define NT3H2111_SRAM_SIZE \
+  (NT3H2111_MEM_SRAM_BLOCKS * NT3H2111_BLOCK_SIZE)
 
 #define BIT7_MASK                                        0x80
 #define BIT6_MASK                                        0x40
@@ -451,6 +453,99 @@ sl_status_t nt3h2111_write_bytes(uint8_t addr,
  ******************************************************************************/
 sl_status_t nt3h2111_read_bytes(uint8_t addr, uint8_t *bytes, uint16_t len);
 
+/***************************************************************************//**
+ * @brief Start a scheduled write of byte(s) to the selected device
+ *
+ *  Partial first and last blocks are read before the first block is
+ *  written. Each following block is prepared while the EEPROM programs the
+ *  previous one, and nt3h2111_write_bytes_process() sends it as soon as
+ *  EEPROM_WR_BUSY clears.
+ *
+ * @param[in] addr
+ *  The address of the byte of memory (SRAM or EEPROM)
+ *  that is intended to be written
+ *
+ * @param[in] bytes
+ *  Array of bytes to be written, must stay valid until the write completes
+ *
+ * @param[in] len
+ *  Number of bytes to be written
+ *
+ * @returns
+ *  SL_STATUS_OK if the write is scheduled.
+ *  SL_STATUS_BUSY if a scheduled write is in progress.
+ ******************************************************************************/
+sl_status_t nt3h2111_write_bytes_start(uint8_t addr,
+                                       const uint8_t *bytes,
+                                       uint16_t len);
+
+/***************************************************************************//**
+ * @brief Advance a scheduled write
+ *
+ *  Call it from the main loop. It never waits for the EEPROM.
+ *
+ * @returns
+ *  SL_STATUS_IN_PROGRESS while blocks remain or the last one is programming.
+ *  SL_STATUS_OK when all bytes are written, or when no write is scheduled.
+ *  Any other code aborts the write.
+ ******************************************************************************/
+sl_status_t nt3h2111_write_bytes_process(void);
+
+/***************************************************************************//**
+ * @brief Set up the SRAM pass-through mode
+ *
+ *  In pass-through mode the 64 byte SRAM is a mailbox between the NFC and
+ *  I2C interfaces and nothing is written to EEPROM.
+ *
+ * @param[in] enable
+ *  Enable or disable pass-through
+ *
+ * @param[in] transfer_dir
+ *  TRANSFER_DIR_I2C_TO_NFC or TRANSFER_DIR_NFC_TO_I2C
+ *
+ * @returns
+ *  I2C transfer status.
+ *
+ * @note
+ *  Details for pass-through mode, please refer to NT3H2111_2211 product
+ *  data sheet section 11.2.
+ ******************************************************************************/
+sl_status_t nt3h2111_passthrough_set(bool enable, bool transfer_dir);
+
+/***************************************************************************//**
+ * @brief Write a message to SRAM for the NFC side
+ *
+ *  The data blocks are written back to back, and the last SRAM block is
+ *  always written so that SRAM_RF_READY is set for the reader.
+ *
+ * @param[in] data
+ *  Message to be written
+ *
+ * @param[in] len
+ *  Message length, up to NT3H2111_SRAM_SIZE. The rest of the last block is
+ *  zero padded.
+ *
+ * @returns
+ *  SL_STATUS_OK on success.
+ *  SL_STATUS_BUSY if the NFC side has not read the previous message.
+ *  SL_STATUS_INVALID_PARAMETER if len exceeds NT3H2111_SRAM_SIZE.
+ ******************************************************************************/
+sl_status_t nt3h2111_sram_write(const uint8_t *data, uint8_t len);
+
+/***************************************************************************//**
+ * @brief Read the message the NFC side wrote to SRAM
+ *
+ *  Reading the last SRAM block hands the SRAM back to the NFC side.
+ *
+ * @param[out] data
+ *  Buffer of NT3H2111_SRAM_SIZE bytes
+ *
+ * @returns
+ *  SL_STATUS_OK on success.
+ *  SL_STATUS_NOT_READY if SRAM_I2C_READY is not set.
+ ******************************************************************************/
+sl_status_t nt3h2111_sram_read(uint8_t *data);
+
 /**************************************************************************//**
  * @brief
  *  Encode NC_REG content to one byte of data.
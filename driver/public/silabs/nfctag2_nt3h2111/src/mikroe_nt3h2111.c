@@ -47,14 +47,34 @@
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+#define NT3H2111_WRITE_TIMEOUT_MS  (NT3H2111_WRITE_DELAY_MS * 2)
+#define NT3H2111_MEM_BLOCK_END_SRAM \
+  (NT3H2111_MEM_BLOCK_START_SRAM + NT3H2111_MEM_SRAM_BLOCKS - 1)
+
 typedef struct
 {
   i2c_master_t i2c;
   digital_in_t fd_pin;
 }mikroe_nt3h2111_t;
 
+// Scheduled multi-block write
+typedef struct
+{
+  const uint8_t *bytes;
+  uint16_t len;
+  uint16_t written;                          // bytes handed to the device
+  uint16_t addr;
+  uint8_t buff[NT3H2111_BLOCK_SIZE + 1];     // next block, mema first
+  uint8_t buff_len;                          // new bytes in buff
+  uint8_t tail[NT3H2111_BLOCK_SIZE];         // content of a partial last block
+  uint32_t write_tick;
+  bool busy;                                 // EEPROM is programming
+  bool active;
+}nt3h2111_writer_t;
+
 // Global variables
 static mikroe_nt3h2111_t s_nt3h2111;
+static nt3h2111_writer_t s_writer;
 static bool nt3h2111_is_initialized = false;
 
 /**************************************************************************//**
@@ -401,68 +421,283 @@ sl_status_t nt3h2111_read_bytes(uint8_t addr, uint8_t *bytes, uint16_t len)
 }
 
 /***************************************************************************//**
- * Write byte(s) to the selected device
+ * Build the next block of a scheduled write in s_writer.buff.
  ******************************************************************************/
-sl_status_t nt3h2111_write_bytes(uint8_t addr,
-                                 const uint8_t *bytes,
-                                 uint16_t len)
+static void nt3h2111_writer_prepare(void)
 {
-  sl_status_t result = SL_STATUS_OK;
-  uint8_t rx_buff[16];
-  uint16_t bytes_written = 0;
+  uint16_t offset = s_writer.addr + s_writer.written;
+  uint8_t block = offset / NT3H2111_BLOCK_SIZE;
+  uint8_t begin = offset % NT3H2111_BLOCK_SIZE;
+  uint8_t *data = &s_writer.buff[1];
+
+  s_writer.buff_len = min(s_writer.len - s_writer.written,
+                          NT3H2111_BLOCK_SIZE - begin);
+
+  /* The partial first block was read in start(), a partial last block
+   * was saved in tail. */
+  if ((s_writer.written != 0)
+      && (s_writer.buff_len < NT3H2111_BLOCK_SIZE)) {
+    memcpy(data, s_writer.tail, NT3H2111_BLOCK_SIZE);
+  }
+
+  /* check if it is the first Block(0x00) and not the I2C Addr
+   * be careful with writing of first byte in management block
+   * the byte contains part of the serial number on read but
+   * on write the I2C address of the device can be modified
+   */
+  if ((0x00 == block) && (NT3H2111__MEM_ADRR_I2C_ADDR < begin)) {
+    data[0] = MIKROE_NT3H211_ADDR;
+  }
+
+  s_writer.buff[0] = block;
+  memcpy(&data[begin],
+         &s_writer.bytes[s_writer.written],
+         s_writer.buff_len);
+}
+
+/***************************************************************************//**
+ * Start a scheduled write of byte(s) to the selected device
+ ******************************************************************************/
+sl_status_t nt3h2111_write_bytes_start(uint8_t addr,
+                                       const uint8_t *bytes,
+                                       uint16_t len)
+{
+  sl_status_t result;
+  uint16_t end = addr + len;
 
   if (NULL == bytes) {
     return SL_STATUS_INVALID_PARAMETER;
   }
 
-  while (bytes_written < len) {
-    uint8_t current_block = (addr + bytes_written) / NT3H2111_BLOCK_SIZE;
-    uint8_t begin = (addr + bytes_written) % NT3H2111_BLOCK_SIZE;
-    uint8_t current_len = min(len - bytes_written, NT3H2111_BLOCK_SIZE - begin);
+  if (s_writer.active) {
+    return SL_STATUS_BUSY;
+  }
 
-    if (current_len < NT3H2111_BLOCK_SIZE) {
-      size_t i = 0;
+  s_writer.bytes = bytes;
+  s_writer.len = len;
+  s_writer.written = 0;
+  s_writer.addr = addr;
+  s_writer.busy = false;
 
-      /* Read block into rx_buff only */
-      result = nt3h2111_read_block(current_block, rx_buff);
-      if (result != SL_STATUS_OK) {
-        break;
-      }
+  if (len == 0) {
+    return SL_STATUS_OK;
+  }
 
-      /* check if it is the first Block(0x00) and not the I2C Addr
-       * be careful with writing of first byte in management block
-       * the byte contains part of the serial number on read but
-       * on write the I2C address of the device can be modified
-       */
-      if ((0x00 == current_block) && (NT3H2111__MEM_ADRR_I2C_ADDR < begin)) {
-        rx_buff[0] = MIKROE_NT3H211_ADDR;
-      }
+  /* Partial blocks must be read before the EEPROM starts programming. */
+  if (((addr % NT3H2111_BLOCK_SIZE) != 0) || (len < NT3H2111_BLOCK_SIZE)) {
+    result = nt3h2111_read_block(addr / NT3H2111_BLOCK_SIZE,
+                                 &s_writer.buff[1]);
+    if (result != SL_STATUS_OK) {
+      return result;
+    }
+  }
 
-      /* modify rx_buffer */
-      for (i = 0; i < current_len; i++) {
-        rx_buff[begin + i] = bytes[bytes_written + i];
-      }
+  if (((end % NT3H2111_BLOCK_SIZE) != 0)
+      && ((end / NT3H2111_BLOCK_SIZE) != (addr / NT3H2111_BLOCK_SIZE))) {
+    result = nt3h2111_read_block(end / NT3H2111_BLOCK_SIZE, s_writer.tail);
+    if (result != SL_STATUS_OK) {
+      return result;
+    }
+  }
 
-      /* Write back modified buffer */
-      result = nt3h2111_write_block(current_block, rx_buff);
-      if (result != SL_STATUS_OK) {
-        break;
-      }
-    } else {
-      /* Full block write */
-      result = nt3h2111_write_block(current_block,
-                                    (bytes + bytes_written));
-      if (result != SL_STATUS_OK) {
-        break;
+  nt3h2111_writer_prepare();
+  s_writer.active = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Advance a scheduled write
+ ******************************************************************************/
+sl_status_t nt3h2111_write_bytes_process(void)
+{
+  sl_status_t result;
+  uint8_t ns_reg;
+
+  if (!s_writer.active) {
+    return SL_STATUS_OK;
+  }
+
+  if (s_writer.busy) {
+    result = nt3h2111_get_session(SESSION_NS_REG, &ns_reg);
+    if (result != SL_STATUS_OK) {
+      s_writer.active = false;
+      return result;
+    }
+
+    if (ns_reg & NT3H2111_NS_REG_MASK_EEPROM_WR_BUSY) {
+      if ((sl_sleeptimer_get_tick_count() - s_writer.write_tick)
+          > sl_sleeptimer_ms_to_tick(NT3H2111_WRITE_TIMEOUT_MS)) {
+        s_writer.active = false;
+        return SL_STATUS_TIMEOUT;
       }
+      return SL_STATUS_IN_PROGRESS;
     }
 
-    bytes_written += current_len;
+    s_writer.busy = false;
+  }
+
+  if (s_writer.written >= s_writer.len) {
+    s_writer.active = false;
+    return SL_STATUS_OK;
+  }
+
+  /* Write the prepared block. */
+  result = nt3h2111_i2c_write_bytes(sizeof(s_writer.buff), s_writer.buff);
+  if (result != SL_STATUS_OK) {
+    s_writer.active = false;
+    return result;
+  }
+
+  /* SRAM blocks do not program. */
+  if ((s_writer.buff[0] < NT3H2111_MEM_BLOCK_START_SRAM)
+      || (s_writer.buff[0] > NT3H2111_MEM_BLOCK_END_SRAM)) {
+    s_writer.write_tick = sl_sleeptimer_get_tick_count();
+    s_writer.busy = true;
+  }
+
+  s_writer.written += s_writer.buff_len;
+
+  /* Build the next block while the EEPROM is busy. */
+  if (s_writer.written < s_writer.len) {
+    nt3h2111_writer_prepare();
+  }
+
+  return SL_STATUS_IN_PROGRESS;
+}
+
+/***************************************************************************//**
+ * Write byte(s) to the selected device
+ ******************************************************************************/
+sl_status_t nt3h2111_write_bytes(uint8_t addr,
+                                 const uint8_t *bytes,
+                                 uint16_t len)
+{
+  sl_status_t result;
+
+  result = nt3h2111_write_bytes_start(addr, bytes, len);
+  if (result != SL_STATUS_OK) {
+    return result;
+  }
+
+  /* Poll EEPROM_WR_BUSY in 1 ms steps instead of waiting a fixed delay. */
+  while ((result = nt3h2111_write_bytes_process()) == SL_STATUS_IN_PROGRESS) {
+    if (s_writer.busy) {
+      sl_sleeptimer_delay_millisecond(1);
+    }
   }
 
   return result;
 }
 
+/***************************************************************************//**
+ * Set up the SRAM pass-through mode
+ ******************************************************************************/
+sl_status_t nt3h2111_passthrough_set(bool enable, bool transfer_dir)
+{
+  sl_status_t result;
+
+  /* TRANSFER_DIR can only be changed while pass-through is off. */
+  result = nt3h2111_set_session(SESSION_NC_REG,
+                                NT3H2111_NC_REG_MASK_PTHRU_ON_OFF,
+                                0);
+  if ((result != SL_STATUS_OK) || !enable) {
+    return result;
+  }
+
+  result = nt3h2111_set_session(SESSION_NC_REG,
+                                NT3H2111_NC_REG_MASK_TRANSFER_DIR
+                                | NT3H2111_NC_REG_MASK_SRAM_MIRROR_ON_OFF,
+                                transfer_dir ? NT3H2111_NC_REG_MASK_TRANSFER_DIR
+                                : 0);
+  if (result != SL_STATUS_OK) {
+    return result;
+  }
+
+  return nt3h2111_set_session(SESSION_NC_REG,
+                              NT3H2111_NC_REG_MASK_PTHRU_ON_OFF,
+                              NT3H2111_NC_REG_MASK_PTHRU_ON_OFF);
+}
+
+/***************************************************************************//**
+ * Write a message to SRAM for the NFC side
+ ******************************************************************************/
+sl_status_t nt3h2111_sram_write(const uint8_t *data, uint8_t len)
+{
+  sl_status_t result;
+  uint8_t buff[NT3H2111_BLOCK_SIZE + 1];
+  uint8_t ns_reg;
+  uint8_t written = 0;
+  uint8_t block;
+
+  if ((NULL == data) || (len > NT3H2111_SRAM_SIZE)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  result = nt3h2111_get_session(SESSION_NS_REG, &ns_reg);
+  if (result != SL_STATUS_OK) {
+    return result;
+  }
+  if (ns_reg & NT3H2111_NS_REG_MASK_SRAM_RF_READY) {
+    return SL_STATUS_BUSY;
+  }
+
+  /* Data blocks, then the last SRAM block which signals the reader. */
+  for (block = NT3H2111_MEM_BLOCK_START_SRAM;
+       block <= NT3H2111_MEM_BLOCK_END_SRAM;
+       block++) {
+    uint8_t current_len = min(len - written, NT3H2111_BLOCK_SIZE);
+
+    if ((current_len == 0) && (block != NT3H2111_MEM_BLOCK_END_SRAM)) {
+      continue;
+    }
+
+    buff[0] = block;
+    memcpy(&buff[1], &data[written], current_len);
+    memset(&buff[1 + current_len], 0, NT3H2111_BLOCK_SIZE - current_len);
+
+    result = nt3h2111_i2c_write_bytes(sizeof(buff), buff);
+    if (result != SL_STATUS_OK) {
+      return result;
+    }
+
+    written += current_len;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Read the message the NFC side wrote to SRAM
+ ******************************************************************************/
+sl_status_t nt3h2111_sram_read(uint8_t *data)
+{
+  sl_status_t result;
+  uint8_t ns_reg;
+
+  if (NULL == data) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  result = nt3h2111_get_session(SESSION_NS_REG, &ns_reg);
+  if (result != SL_STATUS_OK) {
+    return result;
+  }
+  if (!(ns_reg & NT3H2111_NS_REG_MASK_SRAM_I2C_READY)) {
+    return SL_STATUS_NOT_READY;
+  }
+
+  for (uint8_t i = 0; i < NT3H2111_MEM_SRAM_BLOCKS; i++) {
+    result = nt3h2111_read_block(NT3H2111_MEM_BLOCK_START_SRAM + i,
+                                 &data[i * NT3H2111_BLOCK_SIZE]);
+    if (result != SL_STATUS_OK) {
+      return result;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
 /***************************************************************************//**
  *  Encode NC_REG content to one byte of data.
  ******************************************************************************/
@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file   enocean_proxy_config.h
+ * @brief  EnOcean switch proxy server config file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef ENOCEAN_PROXY_CONFIG_H
+#define ENOCEAN_PROXY_CONFIG_H
+
+// <<< Use Configuration Wizard in Context Menu >>>
+// <h> Telegram verification
+
+// <o ENOCEAN_PROXY_REPEAT_FILTER_SIZE> Number of rejected telegrams remembered <1-32>
+// <i> Repeats of these telegrams are dropped without another CCM check.
+// <i> Default: 8
+#define ENOCEAN_PROXY_REPEAT_FILTER_SIZE         8
+
+// </h>
+
+// <h> Persistent storage
+
+// <o ENOCEAN_PROXY_SEQUENCE_LEASE> Sequence counter lease <1-1024>
+// <i> The sequence counter of a switch is written to NVM only when it
+// <i> passes the stored value, which is then set this far ahead. After a
+// <i> reset the counter restarts from the stored value, so no telegram can
+// <i> be replayed, and up to this many telegrams of the switch are ignored.
+// <i> Default: 16
+#define ENOCEAN_PROXY_SEQUENCE_LEASE             16
+
+// </h>
+// <<< end of configuration section >>>
+
+#endif /* ENOCEAN_PROXY_CONFIG_H */
@@ -51,6 +51,7 @@ typedef struct {
   bool is_dimming_mode_active : 1;
   bool is_bound : 1;
   bool is_pressed : 1;
+  bool is_record_dirty : 1;
 } enocean_switch_flags_t;
 
 typedef struct {
@@ -64,6 +65,7 @@ typedef struct enocean_switch {
   uint8_t element_index;
   enocean_switch_flags_t flags;
   uint32_t sequence_counter;
+  uint32_t sequence_lease;
   psa_key_id_t key_id;
   uint32_t next_event_time;
   void (*next_event_callback)(struct enocean_switch *);
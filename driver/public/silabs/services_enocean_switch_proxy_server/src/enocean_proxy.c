@@ -37,6 +37,7 @@
 //                               Includes
 // -----------------------------------------------------------------------------
 #include "enocean_proxy.h"
+#include "enocean_proxy_config.h"
 #include "press_length_timer_callbacks.h"
 #include "psa_status_to_sl_status.h"
 #include "app_assert.h"
@@ -53,12 +54,33 @@
 #define AD_TYPE_MANUFACTURER_SPECIFIC_DATA       0xff
 #define SILABS_VENDOR_ID                         0x02ff
 
-#define ENOCEAN_PROXY_PS_KEY_NUM_STORED_SWITCHES 0x4065
+#define ENOCEAN_PROXY_PS_KEY_JOURNAL             0x4065
 #define ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN      ( \
-    ENOCEAN_PROXY_PS_KEY_NUM_STORED_SWITCHES + 1)
+    ENOCEAN_PROXY_PS_KEY_JOURNAL + 1)
+#define ENOCEAN_PROXY_JOURNAL_VERSION            2
+#define ENOCEAN_PROXY_JOURNAL_BOUND_SIZE         ((MAX_NUM_SWITCHES + 7) / 8)
+// Largest journal that can be migrated from a different MAX_NUM_SWITCHES
+#define ENOCEAN_PROXY_JOURNAL_MAX_SLOTS          64
+#if (MAX_NUM_SWITCHES > ENOCEAN_PROXY_JOURNAL_MAX_SLOTS)
+#error "MAX_NUM_SWITCHES is larger than the switch journal supports"
+#endif
 #define ENOCEAN_PROXY_SECURITY_KEY_SIZE          16
 #define ENOCEAN_PROXY_SIGNATURE_LENGTH           4
 #define ENOCEAN_PROXY_VENDOR_MODEL_OPCODE        9
+#define ENOCEAN_PROXY_DATA_TELEGRAM_MIN_LENGTH   13
+#define ENOCEAN_PROXY_DATA_TELEGRAM_MAX_LENGTH   17
+
+// Offset of the sequence leases in a journal of the given number of slots,
+// they follow the version, the slot count and the bound bitmap at 4 byte
+// alignment
+#define ENOCEAN_PROXY_JOURNAL_LEASE_OFFSET(slots) \
+  (((2 + ((slots) + 7) / 8) + 3) & ~3u)
+#define ENOCEAN_PROXY_JOURNAL_LENGTH(slots) \
+  (ENOCEAN_PROXY_JOURNAL_LEASE_OFFSET(slots) + 4 * (slots))
+
+// Open addressed address index, always has at least one empty slot
+#define ENOCEAN_PROXY_SWITCH_INDEX_SIZE          (2 * MAX_NUM_SWITCHES + 1)
+#define ENOCEAN_PROXY_SWITCH_INDEX_EMPTY         0xff
 
 typedef struct {
   bool button_b_down : 1;
@@ -89,6 +111,12 @@ enum enocean_proxy_subopcode {
 
 typedef uint8_t enocean_proxy_subopcode_t;
 
+typedef struct {
+  bd_addr address;
+  uint32_t sequence_counter;
+  uint32_t signature;
+} enocean_telegram_id_t;
+
 // -----------------------------------------------------------------------------
 //                       Local Variables
 // -----------------------------------------------------------------------------
@@ -98,6 +126,10 @@ static bool is_provisioned = false;
 static bool is_commissioning_mode_active = false;
 static app_timer_t commisioning_mode_timer;
 static app_timer_t long_press_timer;
+static uint8_t switch_index[ENOCEAN_PROXY_SWITCH_INDEX_SIZE];
+static enocean_telegram_id_t rejected_telegrams[
+  ENOCEAN_PROXY_REPEAT_FILTER_SIZE];
+static uint8_t rejected_telegram_next = 0;
 
 SL_WEAK void enocean_proxy_num_switches_changed(uint8_t new_switch_count)
 {
@@ -140,22 +172,49 @@ uint8_t get_num_switches(void)
   return num_bound_switches;
 }
 
-enocean_switch_t * get_switch_by_address(const uint8_t *address)
+static uint16_t hash_address(const uint8_t *address)
+{
+  // FNV-1a over the 6 address bytes
+  uint32_t hash = 2166136261u;
+  for (uint8_t i = 0; i < sizeof(bd_addr); i++) {
+    hash ^= address[i];
+    hash *= 16777619u;
+  }
+  return hash % ENOCEAN_PROXY_SWITCH_INDEX_SIZE;
+}
+
+// Must be called whenever a switch is bound or unbound
+static void rebuild_switch_index(void)
 {
+  memset(switch_index, ENOCEAN_PROXY_SWITCH_INDEX_EMPTY, sizeof(switch_index));
   for (uint8_t i = 0; i < MAX_NUM_SWITCHES; i++) {
     if (!enocean_switches[i].flags.is_bound) {
       continue;
     }
-    bool is_matching = true;
-    for (int j = 0; j < 6; j++) {
-      if (address[j] != enocean_switches[i].address.addr[j]) {
-        is_matching = false;
-        break;
-      }
+    uint16_t slot = hash_address(enocean_switches[i].address.addr);
+    while (switch_index[slot] != ENOCEAN_PROXY_SWITCH_INDEX_EMPTY) {
+      slot = (slot + 1) % ENOCEAN_PROXY_SWITCH_INDEX_SIZE;
     }
-    if (is_matching) {
-      return &enocean_switches[i];
+    switch_index[slot] = i;
+  }
+  // A rebound switch may reuse an address with a new key
+  memset(rejected_telegrams, 0, sizeof(rejected_telegrams));
+}
+
+enocean_switch_t * get_switch_by_address(const uint8_t *address)
+{
+  uint16_t slot = hash_address(address);
+  for (uint16_t probe = 0; probe < ENOCEAN_PROXY_SWITCH_INDEX_SIZE; probe++) {
+    if (switch_index[slot] >= MAX_NUM_SWITCHES) {
+      break;
     }
+    enocean_switch_t *enocean_switch = &enocean_switches[switch_index[slot]];
+    if (enocean_switch->flags.is_bound
+        && (memcmp(address, enocean_switch->address.addr,
+                   sizeof(enocean_switch->address.addr)) == 0)) {
+      return enocean_switch;
+    }
+    slot = (slot + 1) % ENOCEAN_PROXY_SWITCH_INDEX_SIZE;
   }
   return NULL;
 }
@@ -191,12 +250,42 @@ struct enocean_switch_persistent_data {
   uint8_t element_index;
 };
 
+// Switch records are stored per slot and only rewritten when the binding
+// changes. The journal holds everything that changes at runtime so that a
+// lease extension or an unbind is a single NVM write. Each switch has a
+// sequence lease, a counter value at or above every counter accepted so far.
+// The lease is extended before a telegram beyond it is acted on, so after a
+// reset the counter restarts from the lease and no telegram can be replayed.
+struct enocean_proxy_journal {
+  uint8_t version;
+  uint8_t num_slots;
+  uint8_t bound[ENOCEAN_PROXY_JOURNAL_BOUND_SIZE];
+  uint32_t sequence_lease[MAX_NUM_SWITCHES];
+};
+
+// Last journal content written to or read from NVM
+static struct enocean_proxy_journal persisted_journal;
+
+static void build_journal(struct enocean_proxy_journal *journal)
+{
+  memset(journal, 0, sizeof(*journal));
+  journal->version = ENOCEAN_PROXY_JOURNAL_VERSION;
+  journal->num_slots = MAX_NUM_SWITCHES;
+  for (uint8_t i = 0; i < MAX_NUM_SWITCHES; i++) {
+    if (!enocean_switches[i].flags.is_bound) {
+      continue;
+    }
+    journal->bound[i / 8] |= 1 << (i % 8);
+    journal->sequence_lease[i] = enocean_switches[i].sequence_lease;
+  }
+}
+
 sl_status_t store_state_in_persistent_storage(void)
 {
-  uint8_t count = 0;
   sl_status_t sc;
-  for (int i = 0; i < MAX_NUM_SWITCHES; i++) {
-    if (!enocean_switches[i].flags.is_bound) {
+  for (uint8_t i = 0; i < MAX_NUM_SWITCHES; i++) {
+    if (!enocean_switches[i].flags.is_bound
+        || !enocean_switches[i].flags.is_record_dirty) {
       continue;
     }
     struct enocean_switch_persistent_data persistent_data = {
@@ -206,64 +295,222 @@ sl_status_t store_state_in_persistent_storage(void)
       .element_index = enocean_switches[i].element_index
     };
     sc =
-      sl_bt_nvm_save(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + count,
+      sl_bt_nvm_save(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + i,
                      sizeof(persistent_data),
                      (const uint8_t *)&persistent_data);
     if (sc) {
       app_log_status_error_f(sc, "sl_bt_nvm_save failed\n");
       return sc;
     }
-    count += 1;
+    enocean_switches[i].flags.is_record_dirty = false;
   }
 
-  sc =
-    sl_bt_nvm_save(ENOCEAN_PROXY_PS_KEY_NUM_STORED_SWITCHES, sizeof(count),
-                   (const uint8_t *)&count);
-  app_log_status_error_f(sc, "sl_bt_nvm_save failed\n");
-  return sc;
+  struct enocean_proxy_journal journal;
+  build_journal(&journal);
+  if (memcmp(&journal, &persisted_journal, sizeof(journal)) == 0) {
+    return SL_STATUS_OK;
+  }
+  sc = sl_bt_nvm_save(ENOCEAN_PROXY_PS_KEY_JOURNAL, sizeof(journal),
+                      (const uint8_t *)&journal);
+  if (sc) {
+    app_log_status_error_f(sc, "sl_bt_nvm_save failed\n");
+    return sc;
+  }
+  persisted_journal = journal;
+  return SL_STATUS_OK;
+}
+
+// Converts a stored journal of any slot count to the current layout
+static sl_status_t parse_journal(const uint8_t *data,
+                                 size_t length,
+                                 struct enocean_proxy_journal *journal,
+                                 uint8_t *num_slots)
+{
+  uint8_t slots;
+
+  if ((length < 2) || (data[0] != ENOCEAN_PROXY_JOURNAL_VERSION)) {
+    return SL_STATUS_INVALID_CONFIGURATION;
+  }
+  slots = data[1];
+  if ((slots == 0) || (slots > ENOCEAN_PROXY_JOURNAL_MAX_SLOTS)
+      || (ENOCEAN_PROXY_JOURNAL_LENGTH(slots) != length)) {
+    return SL_STATUS_INVALID_CONFIGURATION;
+  }
+
+  memset(journal, 0, sizeof(*journal));
+  journal->version = ENOCEAN_PROXY_JOURNAL_VERSION;
+  journal->num_slots = MAX_NUM_SWITCHES;
+  for (uint8_t i = 0; i < slots; i++) {
+    uint32_t lease;
+    if (!(data[2 + i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
+    memcpy(&lease,
+           &data[ENOCEAN_PROXY_JOURNAL_LEASE_OFFSET(slots) + 4 * i],
+           sizeof(lease));
+    if (i < MAX_NUM_SWITCHES) {
+      journal->bound[i / 8] |= 1 << (i % 8);
+      journal->sequence_lease[i] = lease;
+    }
+  }
+  *num_slots = slots;
+  return SL_STATUS_OK;
+}
+
+// Moves the records of the slots beyond MAX_NUM_SWITCHES to free slots
+static void migrate_switch_records(const uint8_t *data,
+                                   struct enocean_proxy_journal *journal,
+                                   uint8_t num_slots)
+{
+  struct enocean_switch_persistent_data persistent_data;
+  sl_status_t sc;
+
+  for (uint8_t i = MAX_NUM_SWITCHES; i < num_slots; i++) {
+    uint8_t free_slot;
+    uint32_t lease;
+
+    if (!(data[2 + i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
+    for (free_slot = 0; free_slot < MAX_NUM_SWITCHES; free_slot++) {
+      if (!(journal->bound[free_slot / 8] & (1 << (free_slot % 8)))) {
+        break;
+      }
+    }
+    if (free_slot == MAX_NUM_SWITCHES) {
+      app_log("No free slot for switch record %u, dropped\n", i);
+      continue;
+    }
+    sc = sl_bt_nvm_load(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + i,
+                        sizeof(persistent_data),
+                        NULL,
+                        (uint8_t *)&persistent_data);
+    if (sc == SL_STATUS_OK) {
+      sc = sl_bt_nvm_save(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + free_slot,
+                          sizeof(persistent_data),
+                          (const uint8_t *)&persistent_data);
+    }
+    if (sc) {
+      app_log_status_error_f(sc, "Switch record %u not migrated\n", i);
+      continue;
+    }
+    sl_bt_nvm_erase(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + i);
+    memcpy(&lease,
+           &data[ENOCEAN_PROXY_JOURNAL_LEASE_OFFSET(num_slots) + 4 * i],
+           sizeof(lease));
+    journal->bound[free_slot / 8] |= 1 << (free_slot % 8);
+    journal->sequence_lease[free_slot] = lease;
+  }
 }
 
 sl_status_t load_state_from_persistent_storage(void)
 {
   sl_status_t sc;
+  uint8_t data[ENOCEAN_PROXY_JOURNAL_LENGTH(ENOCEAN_PROXY_JOURNAL_MAX_SLOTS)];
+  size_t journal_length = 0;
+  uint8_t num_slots = 0;
+  bool is_rewrite_needed = false;
 
-  uint8_t num_bound_switches;
-  sc = sl_bt_nvm_load(ENOCEAN_PROXY_PS_KEY_NUM_STORED_SWITCHES,
-                      sizeof(num_bound_switches),
-                      NULL,
-                      (uint8_t *)&num_bound_switches);
+  memset(enocean_switches, 0, sizeof(enocean_switches));
+  memset(&persisted_journal, 0, sizeof(persisted_journal));
+  sc = sl_bt_nvm_load(ENOCEAN_PROXY_PS_KEY_JOURNAL,
+                      sizeof(data),
+                      &journal_length,
+                      data);
   if (sc) {
     if (sc == SL_STATUS_BT_PS_KEY_NOT_FOUND) {
       sc = SL_STATUS_OK;
     } else {
       app_log_status_f(sc, "sl_bt_nvm_load failed\n");
-      return sc;
     }
+    rebuild_switch_index();
+    return sc;
+  }
+
+  struct enocean_proxy_journal journal;
+  if (journal_length == sizeof(uint8_t)) {
+    // Earlier releases stored the number of switches in this key, followed
+    // by that many records in slot order
+    uint8_t num_bound_switches = data[0];
+    app_assert(num_bound_switches <= MAX_NUM_SWITCHES,
+               "Invalid switch_count value loaded\n");
+    memset(&journal, 0, sizeof(journal));
+    for (uint8_t i = 0; i < num_bound_switches; i++) {
+      journal.bound[i / 8] |= 1 << (i % 8);
+    }
+    is_rewrite_needed = true;
+  } else if (parse_journal(data, journal_length, &journal, &num_slots)
+             != SL_STATUS_OK) {
+    app_log("Invalid switch journal loaded\n");
+    rebuild_switch_index();
+    return SL_STATUS_INVALID_CONFIGURATION;
+  } else if (num_slots != MAX_NUM_SWITCHES) {
+    // Written with another MAX_NUM_SWITCHES
+    app_log("Migrating switch journal of %u slots\n", num_slots);
+    migrate_switch_records(data, &journal, num_slots);
+    is_rewrite_needed = true;
+  } else {
+    persisted_journal = journal;
   }
-  app_assert(num_bound_switches <= MAX_NUM_SWITCHES,
-             "Invalid switch_count value loaded\n");
 
-  memset(enocean_switches, MAX_NUM_SWITCHES, sizeof(enocean_switch_t));
   struct enocean_switch_persistent_data persistent_data;
-  for (int i = 0; i < num_bound_switches; i++) {
+  for (uint8_t i = 0; i < MAX_NUM_SWITCHES; i++) {
+    if (!(journal.bound[i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
     sc = sl_bt_nvm_load(ENOCEAN_PROXY_PS_KEY_SWITCHES_BEGIN + i,
                         sizeof(persistent_data),
                         NULL,
                         (uint8_t *)&persistent_data);
     if (sc) {
       app_log_status_f(sc, "sl_bt_nvm_load failed\n");
-      return sc;
+      continue;
     }
     if (persistent_data.element_index >= SL_BTMESH_CONFIG_MAX_ELEMENTS) {
       app_log("Invalid element index loaded\n");
       continue;
     }
     enocean_switches[i].address = persistent_data.address;
+    // Telegrams up to the lease may have been accepted before the reset
     enocean_switches[i].sequence_counter = persistent_data.sequence_counter;
+    if (journal.sequence_lease[i] > persistent_data.sequence_counter) {
+      enocean_switches[i].sequence_counter = journal.sequence_lease[i];
+    }
+    enocean_switches[i].sequence_lease = enocean_switches[i].sequence_counter;
     enocean_switches[i].key_id = persistent_data.key_id;
     enocean_switches[i].flags.is_bound = true;
     enocean_switches[i].element_index = persistent_data.element_index;
   }
+  rebuild_switch_index();
+
+  if (is_rewrite_needed) {
+    // Records are already in place, write the journal in the current layout
+    sc = store_state_in_persistent_storage();
+  }
+  return sc;
+}
+
+// Extends the lease before a telegram beyond it is acted on. If the journal
+// cannot be written the old lease is kept, the telegram must then be dropped.
+static sl_status_t extend_sequence_lease(enocean_switch_t *enocean_switch)
+{
+  uint32_t sequence_lease = enocean_switch->sequence_lease;
+  sl_status_t sc;
+
+  if (enocean_switch->sequence_counter <= enocean_switch->sequence_lease) {
+    return SL_STATUS_OK;
+  }
+  if (enocean_switch->sequence_counter
+      > (UINT32_MAX - ENOCEAN_PROXY_SEQUENCE_LEASE)) {
+    enocean_switch->sequence_lease = UINT32_MAX;
+  } else {
+    enocean_switch->sequence_lease = enocean_switch->sequence_counter
+                                     + ENOCEAN_PROXY_SEQUENCE_LEASE;
+  }
+  sc = store_state_in_persistent_storage();
+  if (sc) {
+    enocean_switch->sequence_lease = sequence_lease;
+  }
   return sc;
 }
 
@@ -274,6 +521,7 @@ sl_status_t remove_switch_by_element_index(uint8_t element_index)
     return SL_STATUS_NOT_FOUND;
   }
   enocean_switch->flags.is_bound = false;
+  rebuild_switch_index();
   sl_status_t sc =
     psa_status_to_sl_status(psa_destroy_key(enocean_switch->key_id));
   app_log_status_error_f(sc, "psa_destroy_key failed\n");
@@ -343,11 +591,14 @@ sl_status_t bind_switch(const uint8_t *address,
   enocean_switch_t *new_switch = &enocean_switches[free_index];
   memcpy(new_switch->address.addr, address, sizeof(new_switch->address.addr));
   new_switch->sequence_counter = sequence_counter;
+  new_switch->sequence_lease = sequence_counter;
   new_switch->flags.is_bound = true;
   new_switch->flags.is_pressed = false;
   new_switch->flags.is_dimming_mode_active = false;
   new_switch->next_event_time = 0;
   new_switch->element_index = element_index;
+  new_switch->flags.is_record_dirty = true;
+  rebuild_switch_index();
 
   sc = import_key(security_key, free_index, &new_switch->key_id);
   if (sc != SL_STATUS_OK) {
@@ -491,6 +742,85 @@ void handle_switch_action(switch_action_t switch_action,
   }
 }
 
+static bool is_same_telegram(const bd_addr *address,
+                             uint32_t sequence_counter,
+                             uint32_t signature,
+                             const bd_addr *other_address,
+                             uint32_t other_sequence_counter,
+                             uint32_t other_signature)
+{
+  return (sequence_counter == other_sequence_counter)
+         && (signature == other_signature)
+         && (memcmp(address->addr, other_address->addr,
+                    sizeof(address->addr)) == 0);
+}
+
+// Repeats of a telegram that already failed verification are dropped without
+// running the cipher again. Repeats of accepted telegrams are caught by the
+// sequence counter.
+static bool is_repeated_telegram(const enocean_telegram_id_t *telegram)
+{
+  for (uint8_t i = 0; i < ENOCEAN_PROXY_REPEAT_FILTER_SIZE; i++) {
+    if (is_same_telegram(&telegram->address,
+                         telegram->sequence_counter,
+                         telegram->signature,
+                         &rejected_telegrams[i].address,
+                         rejected_telegrams[i].sequence_counter,
+                         rejected_telegrams[i].signature)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void remember_rejected_telegram(const enocean_telegram_id_t *telegram)
+{
+  rejected_telegrams[rejected_telegram_next] = *telegram;
+  rejected_telegram_next = (rejected_telegram_next + 1)
+                           % ENOCEAN_PROXY_REPEAT_FILTER_SIZE;
+}
+
+static sl_status_t process_data_telegram(enocean_switch_t *enocean_switch,
+                                         const enocean_telegram_id_t *telegram,
+                                         const uint8_t *payload,
+                                         uint8_t payload_length)
+{
+  if (!authenticate_data_telegram(telegram->sequence_counter,
+                                  enocean_switch->address.addr,
+                                  payload,
+                                  payload_length
+                                  - ENOCEAN_PROXY_SIGNATURE_LENGTH,
+                                  telegram->signature,
+                                  enocean_switch->key_id)) {
+    remember_rejected_telegram(telegram);
+    app_log("Telegram authentication failed\n");
+    return SL_STATUS_INVALID_SIGNATURE;
+  }
+  // Only authenticated telegrams may move the counter forward
+  uint32_t sequence_counter = enocean_switch->sequence_counter;
+  enocean_switch->sequence_counter = telegram->sequence_counter;
+  sl_status_t sc = extend_sequence_lease(enocean_switch);
+  if (sc) {
+    // Not acted on, a repetition of the telegram may be accepted later
+    enocean_switch->sequence_counter = sequence_counter;
+    app_log_status_error_f(sc, "Sequence lease not stored, telegram dropped\n");
+    return sc;
+  }
+
+  switch_action_t switch_action = parse_switch_action(payload[8]);
+  uint8_t element_index = enocean_switch - &enocean_switches[0]
+                          + ENOCEAN_PROXY_SWITCH_1;
+  print_switch_status(element_index, switch_action);
+
+  if (!is_provisioned) {
+    app_log("Not provisioned\n");
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  handle_switch_action(switch_action, enocean_switch);
+  return SL_STATUS_OK;
+}
+
 enum payload_type {
   DATA,
   COMMISSIONING,
@@ -518,7 +848,8 @@ sl_status_t handle_advertisement(
   }
 
   payload_type_t payload_type = UNKNOWN;
-  if ((13 <= payload_length) && (payload_length <= 17)) {
+  if ((ENOCEAN_PROXY_DATA_TELEGRAM_MIN_LENGTH <= payload_length)
+      && (payload_length <= ENOCEAN_PROXY_DATA_TELEGRAM_MAX_LENGTH)) {
     payload_type = DATA;
   } else if ((payload_length == 30) || (payload_length == 29)) {
     payload_type = COMMISSIONING;
@@ -533,41 +864,34 @@ sl_status_t handle_advertisement(
     return sc;
   }
 
+  if (payload_type != DATA) {
+    return SL_STATUS_OK;
+  }
+
   enocean_switch_t *enocean_switch = get_switch_by_address(
     advertisement_report->address.addr);
   if (!enocean_switch) {
     return SL_STATUS_OK;
   }
 
-  uint32_t sequence_counter = *(uint32_t *)&payload[4];
-  if (sequence_counter <= enocean_switch->sequence_counter) {
+  // The sequence counter only moves forward, which drops repeats of accepted
+  // telegrams and keeps the telegrams of a switch in order
+  enocean_telegram_id_t telegram;
+  telegram.address = advertisement_report->address;
+  telegram.sequence_counter = *(uint32_t *)&payload[4];
+  if (telegram.sequence_counter <= enocean_switch->sequence_counter) {
     return SL_STATUS_INVALID_COUNT;
   }
-  enocean_switch->sequence_counter = sequence_counter;
-  switch_action_t switch_action = parse_switch_action(payload[8]);
-  uint8_t element_index = enocean_switch - &enocean_switches[0]
-                          + ENOCEAN_PROXY_SWITCH_1;
-  print_switch_status(element_index, switch_action);
-
-  uint8_t authentication_input_length = payload_length
-                                        - ENOCEAN_PROXY_SIGNATURE_LENGTH;
-  if (!authenticate_data_telegram(sequence_counter,
-                                  enocean_switch->address.addr,
-                                  payload, authentication_input_length,
-                                  *(uint32_t *)&payload[
-                                    authentication_input_length],
-                                  enocean_switch->key_id)) {
-    app_log("Telegram authentication failed\n");
-    return SL_STATUS_INVALID_SIGNATURE;
-  }
-
-  if (!is_provisioned) {
-    app_log("Not provisioned\n");
-    return SL_STATUS_INVALID_STATE;
+  telegram.signature =
+    *(uint32_t *)&payload[payload_length - ENOCEAN_PROXY_SIGNATURE_LENGTH];
+  if (is_repeated_telegram(&telegram)) {
+    return SL_STATUS_INVALID_COUNT;
   }
 
-  handle_switch_action(switch_action, enocean_switch);
-  return SL_STATUS_OK;
+  return process_data_telegram(enocean_switch,
+                               &telegram,
+                               payload,
+                               payload_length);
 }
 
 sl_status_t enocean_proxy_enter_commissioning_mode(uint8_t element_index)
@@ -726,6 +1050,7 @@ sl_status_t initialize(bool is_already_provisioned)
   app_log_status_error_f(sc, "Failed to init sleeptimer\n");
   sc = psa_status_to_sl_status(psa_crypto_init());
   app_log_status_error_f(sc, "Failed to init crypto\n");
+  rebuild_switch_index();
 
   if (is_already_provisioned) {
     is_provisioned = true;
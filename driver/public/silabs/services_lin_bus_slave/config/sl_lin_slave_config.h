@@ -63,6 +63,21 @@ extern "C" {
 #define LIN_DELAY_TIMER_NUM  3
 // </h> end TIMER configuration
 
+// <h> Statistics configuration
+// <o SL_LIN_LATENCY_BIN_TICKS> Latency histogram bin width <1-32>
+// <i> Width of a break-to-response latency histogram bin in 32.768 kHz ticks
+// <i> Default: 1
+#define SL_LIN_LATENCY_BIN_TICKS  1
+// </h> end Statistics configuration
+
+// <h> Transport layer configuration
+// <o SL_LIN_TP_TIMEOUT_MS> Consecutive frame timeout (ms) <100-10000>
+// <i> A segmented request is dropped if no consecutive frame is received
+// <i> within this time (N_Cr)
+// <i> Default: 1000
+#define SL_LIN_TP_TIMEOUT_MS  1000
+// </h> end Transport layer configuration
+
 // <<< end of configuration section >>>
 
 // <<< sl:start pin_tool >>>
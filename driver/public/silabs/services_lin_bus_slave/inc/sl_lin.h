@@ -59,6 +59,17 @@
  */
 #define SL_LIN_TIMEOUT      300
 
+/**
+ * @brief      Number of bins in the break-to-response latency histogram
+ *
+ * The first bin starts at the nominal length of the header (BREAK, DELIM,
+ * SYNC and PID, 34 bits) at the detected baud rate, so the histogram shows
+ * how much of the response space has been used. The width of a bin is
+ * SL_LIN_LATENCY_BIN_TICKS 32.768 kHz ticks, the last bin also collects every
+ * longer latency.
+ */
+#define SL_LIN_LATENCY_HISTOGRAM_BINS 16
+
 /**
  * @brief      Sigature of the callback to be called on events
  *
@@ -68,7 +79,8 @@
  * @param[in]  len                Number of bytes in data
  * @param[in]  success            Was the operation successful?
  *
- * @note       The ID is a 6-bit unprotected ID in the 0..59 range.
+ * @note       The ID is a 6-bit unprotected ID in the 0..59 range, or one of
+ *             the diagnostic IDs 0x3c/0x3d.
  *             The same callback might be registered for multiple readable
  *             or writable endpoints. The data is only expected to be valid
  *             during the scope of the callback's invocation, so the data shall
@@ -83,6 +95,26 @@ typedef void (*sl_lin_callback_t)(uint8_t frame_id,
                                   int len,
                                   bool success);
 
+/**
+ * @brief      Frame-level timing and error statistics
+ *
+ * @note       Latencies are measured from the falling edge of the BREAK to the
+ *             moment the DMA transfer of the response (readable endpoints) or
+ *             of the reception (writable endpoints) is launched, in
+ *             32.768 kHz ticks (30.5 usecs).
+ */
+typedef struct sl_lin_slave_statistics {
+  uint32_t frames;            ///< Transfers completed on registered IDs
+  uint32_t checksum_errors;   ///< Writable frames received with bad checksum
+  uint32_t framing_errors;    ///< Framing, overflow or underflow errors
+  uint32_t parity_errors;     ///< Headers with invalid PID parity bits
+  uint32_t conflict_errors;   ///< Collisions detected during a response
+  uint32_t missed_slots;      ///< Registered frames not completed in time
+  uint16_t latency_min;       ///< Shortest latency seen (0xffff if none)
+  uint16_t latency_max;       ///< Longest latency seen
+  uint32_t latency_histogram[SL_LIN_LATENCY_HISTOGRAM_BINS];
+} sl_lin_slave_statistics_t;
+
 /**
  * @brief      Initialize the peripherals for LIN bus communication
  */
@@ -103,9 +135,12 @@ void sl_lin_slave_init(void);
  *             SL_STATUS_OK             everything went well
  *
  * @note       The ID is expected to be a 6-bit unprotected ID in the 0..59
- *             range. Diagnostics and reserved messages are not supported.
- *             The master might send a "bus sleep" message, which reuses a
- *             diagnostics message ID, and it's not supported (ignored).
+ *             range, or 0x3c for the master request frame, which is used by
+ *             the transport layer (see sl_lin_tp.h). Diagnostic frames always
+ *             use the classic checksum. Reserved messages are not supported.
+ *             The master might send a "bus sleep" message, which reuses the
+ *             master request frame ID with a NAD of 0, and it's left for the
+ *             callback to ignore.
  *             The device goes to sleep after processing the message as soon as
  *             possible anyway, so this should not cause a problem.
  *             It's safe to call this function anytime.
@@ -133,7 +168,9 @@ sl_status_t sl_lin_slave_register_writable_endpoint(
  *             SL_STATUS_OK             everything went well
  *
  * @note       The ID is expected to be a 6-bit unprotected ID in the 0..59
- *             range. Diagnostics and reserved messages are not supported.
+ *             range, or 0x3d for the slave response frame, which is used by
+ *             the transport layer (see sl_lin_tp.h). Diagnostic frames always
+ *             use the classic checksum. Reserved messages are not supported.
  *             The data to be sent can be updated later by the
  *             \ref sl_lin_slave_update_readable_endpoint() call.
  *             It's safe to call this function anytime.
@@ -161,6 +198,15 @@ sl_status_t sl_lin_slave_register_readable_endpoint(
  */
 sl_status_t sl_lin_slave_unregister_endpoint(uint8_t frame_id);
 
+/**
+ * @brief      Check whether an ID is registered
+ *
+ * @param[in]  frame_id           ID to check
+ *
+ * @returns    true if the ID is registered, enabled or not
+ */
+bool sl_lin_slave_is_endpoint_registered(uint8_t frame_id);
+
 /**
  * @brief      Update data for an ID registered for slave->master communication
  *
@@ -199,6 +245,97 @@ sl_status_t sl_lin_slave_update_readable_endpoint(uint8_t frame_id,
  */
 sl_status_t sl_lin_slave_inject_checksum_error(uint8_t frame_id);
 
+/**
+ * @brief      Get the free buffer of a readable endpoint for in-place update
+ *
+ * @param[in]  frame_id           ID to update
+ *
+ * @returns    Pointer to the buffer of the registered length, or NULL if
+ *             frame_id is not registered as readable
+ *
+ * @note       This is the zero-copy variant of
+ *             \ref sl_lin_slave_update_readable_endpoint(). The buffer is
+ *             neither published nor owned by the DMA, so it can be filled
+ *             directly, then it's sent after
+ *             \ref sl_lin_slave_publish_readable_buffer() is called.
+ *             The acquire/publish pair must not be interleaved with other
+ *             updates of the same ID. It may be called from the callback of
+ *             the ID.
+ */
+uint8_t *sl_lin_slave_acquire_readable_buffer(uint8_t frame_id);
+
+/**
+ * @brief      Publish the buffer acquired for a readable endpoint
+ *
+ * @param[in]  frame_id           ID to update
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_INVALID_RANGE  frame_id is invalid
+ *             SL_STATUS_INVALID_KEY    frame_id is not registered as readable
+ *             SL_STATUS_OK             everything went well
+ *
+ * @note       The checksum is calculated here, the buffer is sent on the
+ *             next header of the ID.
+ */
+sl_status_t sl_lin_slave_publish_readable_buffer(uint8_t frame_id);
+
+/**
+ * @brief      Enable or disable a registered ID
+ *
+ * @param[in]  frame_id           ID to enable or disable
+ * @param[in]  enabled            Shall the ID be handled on the bus?
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_INVALID_RANGE  frame_id is invalid
+ *             SL_STATUS_EMPTY          frame_id is not registered
+ *             SL_STATUS_OK             everything went well
+ *
+ * @note       A disabled ID keeps its registration and data, but its headers
+ *             are ignored, e.g. a slave response frame is disabled while no
+ *             response is pending. IDs are enabled when registered.
+ *             It's safe to call this function anytime.
+ */
+sl_status_t sl_lin_slave_set_endpoint_enabled(uint8_t frame_id, bool enabled);
+
+/**
+ * @brief      Move a registered ID to another ID
+ *
+ * @param[in]  frame_id           ID to move
+ * @param[in]  new_frame_id       ID to register instead
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_INVALID_RANGE  an ID is invalid
+ *             SL_STATUS_EMPTY          frame_id is not registered
+ *             SL_STATUS_ALREADY_EXISTS new_frame_id is already registered
+ *             SL_STATUS_OK             everything went well
+ *
+ * @note       The length, direction, checksum model, callback and the last
+ *             published data are kept, the ID is enabled. This is used by the
+ *             "Assign frame ID range" node configuration service, the
+ *             callback receives the new ID afterwards.
+ *             Only IDs in the 0..59 range can be moved.
+ */
+sl_status_t sl_lin_slave_move_endpoint(uint8_t frame_id, uint8_t new_frame_id);
+
+/**
+ * @brief      Get a snapshot of the frame statistics
+ *
+ * @param[out] statistics         Points to the structure to fill
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_NULL_POINTER   statistics is NULL
+ *             SL_STATUS_OK             everything went well
+ *
+ * @note       The snapshot is taken with interrupts disabled, so the counters
+ *             are consistent with each other.
+ */
+sl_status_t sl_lin_slave_get_statistics(sl_lin_slave_statistics_t *statistics);
+
+/**
+ * @brief      Reset all frame statistics to zero
+ */
+void sl_lin_slave_clear_statistics(void);
+
 /**
  * @brief      Generate a wakeup signal on the bus as per 2.6.2 (of 2.2A spec)
  *
@@ -208,4 +345,15 @@ sl_status_t sl_lin_slave_inject_checksum_error(uint8_t frame_id);
  */
 void sl_lin_bus_wakeup(void);
 
+/**
+ * @brief      Calculate the protected ID of a frame ID
+ *
+ * @param[in]  frame_id           6-bit frame ID, 0..63
+ *
+ * @returns    The frame ID with the P0 and P1 parity bits
+ *
+ * @note       The input is not masked, the upper two bits shall be zero.
+ */
+uint8_t sl_lin_frame_id_to_pid(uint8_t frame_id);
+
 #endif
@@ -0,0 +1,269 @@
+/***************************************************************************//**
+ * @file sl_lin_tp.h
+ * @brief LIN diagnostic transport layer for slave devices
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef SL__LIN_TP_H
+#define SL__LIN_TP_H
+
+#include <sl_status.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief      Frame IDs of the master request and the slave response frames
+ */
+#define SL_LIN_TP_MRF_ID              0x3c
+#define SL_LIN_TP_SRF_ID              0x3d
+
+/**
+ * @brief      Special node addresses
+ *
+ * A master request frame with a NAD of 0 is the "go to sleep" command, it's
+ * ignored by the transport layer. The functional NAD addresses every node,
+ * but only single frames are accepted with it, and no response is sent.
+ * The wildcard NAD is accepted by the node configuration services.
+ */
+#define SL_LIN_TP_NAD_SLEEP           0x00
+#define SL_LIN_TP_NAD_FUNCTIONAL      0x7e
+#define SL_LIN_TP_NAD_WILDCARD        0x7f
+
+/**
+ * @brief      Wildcards of the product identification
+ */
+#define SL_LIN_TP_SUPPLIER_WILDCARD   0x7fff
+#define SL_LIN_TP_FUNCTION_WILDCARD   0x3fff
+
+/**
+ * @brief      Longest message, the length field of a first frame is 12 bits
+ */
+#define SL_LIN_TP_MAX_LENGTH          4095
+
+/**
+ * @brief      Negative response service ID and the response codes used
+ */
+#define SL_LIN_TP_NEGATIVE_RESPONSE   0x7f
+#define SL_LIN_TP_NRC_SUBFUNCTION_NOT_SUPPORTED   0x12
+#define SL_LIN_TP_NRC_CONDITIONS_NOT_CORRECT      0x22
+
+/**
+ * @brief      Sigature of the callback called on a reassembled request
+ *
+ * @param[in]  nad                NAD the request was addressed to
+ * @param[in]  data               Request, starting with the service ID
+ * @param[in]  len                Number of bytes in data
+ *
+ * @note       It's called from \ref sl_lin_tp_process(), data points into the
+ *             receive buffer of the configuration and it's valid during the
+ *             scope of the callback's invocation. A response may be sent by
+ *             calling \ref sl_lin_tp_send_response() from the callback, or
+ *             later. Requests to the functional NAD shall not be answered.
+ */
+typedef void (*sl_lin_tp_request_callback_t)(uint8_t nad,
+                                             const uint8_t *data,
+                                             uint16_t len);
+
+/**
+ * @brief      Sigature of the callback reading user defined identifiers
+ *
+ * @param[in]  identifier         Identifier in the 32..63 range
+ * @param[out] data               Five bytes to be sent
+ *
+ * @returns    Is the identifier supported?
+ *
+ * @note       It's called from \ref sl_lin_tp_process().
+ */
+typedef bool (*sl_lin_tp_read_by_id_callback_t)(uint8_t identifier,
+                                                uint8_t *data);
+
+/**
+ * @brief      Sigature of the callback called on a "Save configuration"
+ *
+ * @param[in]  nad                Current NAD
+ * @param[in]  frame_ids          Configurable frames by message index
+ * @param[in]  count              Number of entries in frame_ids
+ *
+ * @note       It's called from \ref sl_lin_tp_process(), the configuration
+ *             shall be stored in non-volatile memory and restored by the
+ *             application before \ref sl_lin_tp_init() is called.
+ */
+typedef void (*sl_lin_tp_save_callback_t)(uint8_t nad,
+                                          const uint8_t *frame_ids,
+                                          uint8_t count);
+
+/**
+ * @brief      Sigature of the callback called on a received block
+ *
+ * @param[in]  data               Block data
+ * @param[in]  len                Number of bytes in data
+ * @param[in]  offset             Offset of the block in the request
+ * @param[in]  last               Is this the end of the request?
+ *
+ * @note       It's called from \ref sl_lin_tp_process(), while the next block
+ *             is received into the other half of the block buffer. The block
+ *             is released when the callback returns. If a request is dropped
+ *             while it's streamed, the callback is called with NULL data,
+ *             a len of 0 and last set.
+ */
+typedef void (*sl_lin_tp_block_callback_t)(const uint8_t *data,
+                                           uint16_t len,
+                                           uint32_t offset,
+                                           bool last);
+
+/**
+ * @brief      Configuration of the transport layer
+ */
+typedef struct sl_lin_tp_config {
+  uint8_t nad;                ///< NAD to use, restored from storage or initial
+  uint8_t initial_nad;        ///< NAD accepted by "Assign NAD"
+  uint16_t supplier_id;       ///< Product identification
+  uint16_t function_id;       ///< Product identification
+  uint8_t variant;            ///< Product identification
+  uint32_t serial_number;     ///< Read by identifier 1
+  uint8_t *frame_ids;         ///< Configurable frames by message index,
+                              ///< updated by "Assign frame ID range"
+  uint8_t frame_id_count;     ///< Number of entries in frame_ids
+  uint8_t *rx_buffer;         ///< Buffer to reassemble requests into
+  uint16_t rx_buffer_size;    ///< Size of rx_buffer, longer requests are
+                              ///< dropped outside of block transfer mode
+  sl_lin_tp_request_callback_t request_callback;
+  sl_lin_tp_read_by_id_callback_t read_by_id_callback; ///< Optional
+  sl_lin_tp_save_callback_t save_callback;             ///< Optional
+} sl_lin_tp_config_t;
+
+/**
+ * @brief      Initialize the transport layer
+ *
+ * @param[in]  config             Configuration, it's copied
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_NULL_POINTER   config or a mandatory field is NULL
+ *             SL_STATUS_ALREADY_EXISTS the diagnostic frames are registered
+ *             SL_STATUS_OK             everything went well
+ *
+ * @note       The master request and slave response frames are registered
+ *             with \ref sl_lin_slave_register_writable_endpoint() and
+ *             \ref sl_lin_slave_register_readable_endpoint(), so
+ *             \ref sl_lin_slave_init() shall be called first. Requests are
+ *             reassembled straight from the endpoint's DMA buffers into the
+ *             receive buffer, and responses are segmented straight from the
+ *             caller's buffer into the endpoint's free buffer.
+ *             The node configuration services "Assign NAD", "Read by
+ *             identifier", "Save configuration" and "Assign frame ID range"
+ *             are handled here, all other requests are passed to the request
+ *             callback.
+ */
+sl_status_t sl_lin_tp_init(const sl_lin_tp_config_t *config);
+
+/**
+ * @brief      Dispatch received requests and blocks, handle timeouts
+ *
+ * @note       It shall be called from the main loop.
+ */
+void sl_lin_tp_process(void);
+
+/**
+ * @brief      Send a response
+ *
+ * @param[in]  data               Response, starting with the response SID
+ * @param[in]  len                Number of bytes in data
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_NULL_POINTER       data is NULL
+ *             SL_STATUS_INVALID_PARAMETER  len is 0 or too long
+ *             SL_STATUS_BUSY               a response is still pending
+ *             SL_STATUS_OK                 everything went well
+ *
+ * @note       The data is not copied, it shall be kept intact until
+ *             \ref sl_lin_tp_is_response_pending() returns false. The response
+ *             is sent with the current NAD when the master polls the slave
+ *             response frame, and it's dropped when the master sends a new
+ *             request.
+ */
+sl_status_t sl_lin_tp_send_response(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief      Send a negative response
+ *
+ * @param[in]  sid                Service ID of the request
+ * @param[in]  nrc                Negative response code
+ *
+ * @returns    Same as \ref sl_lin_tp_send_response()
+ */
+sl_status_t sl_lin_tp_send_negative_response(uint8_t sid, uint8_t nrc);
+
+/**
+ * @brief      Is a response still waiting to be fetched by the master?
+ */
+bool sl_lin_tp_is_response_pending(void);
+
+/**
+ * @brief      Get the current NAD
+ */
+uint8_t sl_lin_tp_get_nad(void);
+
+/**
+ * @brief      Start the block transfer mode
+ *
+ * @param[in]  buffer             Buffer of 2 * block_size bytes
+ * @param[in]  block_size         Size of a block
+ * @param[in]  callback           Callback to call on a received block
+ *
+ * @returns    Status code indicating success of the function call
+ *             SL_STATUS_NULL_POINTER       buffer or callback is NULL
+ *             SL_STATUS_INVALID_PARAMETER  block_size is 0
+ *             SL_STATUS_BUSY               a request is being received
+ *             SL_STATUS_OK                 everything went well
+ *
+ * @note       While it's active, segmented requests are not reassembled into
+ *             the receive buffer, but streamed to the callback in blocks,
+ *             e.g. flash pages, with the service ID and its parameters at
+ *             offset 0. The other half of the buffer is filled meanwhile, so
+ *             the master can send the consecutive frames back to back, and
+ *             the length of a request is only limited by the transport layer.
+ *             Single frames are still passed to the request callback. If
+ *             both halves are full, the request is dropped.
+ */
+sl_status_t sl_lin_tp_start_block_transfer(uint8_t *buffer,
+                                           uint16_t block_size,
+                                           sl_lin_tp_block_callback_t callback);
+
+/**
+ * @brief      Stop the block transfer mode
+ *
+ * @note       A request being streamed is dropped.
+ */
+void sl_lin_tp_stop_block_transfer(void);
+
+#endif
@@ -84,8 +84,14 @@
 
 #include "system.h"
 
-#define SL_LIN_MAX_ENDPOINT 59
-#define CURRENT_IDX         2
+// application frames are 0..59, 0x3c and 0x3d are the diagnostic frames
+#define SL_LIN_MAX_ENDPOINT 0x3d
+#define SL_LIN_MAX_APP_ENDPOINT 59
+#define SL_LIN_BUFFER_COUNT 3
+
+#ifndef SL_LIN_LATENCY_BIN_TICKS
+#define SL_LIN_LATENCY_BIN_TICKS 1
+#endif
 
 // the baud rate is (HFXO * 2) / USART_CLKDIV_DIV (fractional as-is)
 // N bits of time is (500000 * N * USART_CLKDIV_DIV) / HFXO usecs
@@ -98,17 +104,29 @@
 
 typedef struct sl_lin_endpoint {
   sl_lin_callback_t callback;
-  uint8_t bytes; // 0 if unused
-  uint8_t next;  // used for triple buffering
+  uint8_t bytes;  // 0 if unused
+  uint8_t next;   // used for triple buffering
+  uint8_t locked; // buffer handed to the DMA last (readable endpoints)
+  uint8_t cksum_init; // PID for enhanced checksums, 0 otherwise
+  uint8_t pending; // buffer acquired for an in-place update
   bool writable;
+  bool disabled; // registered, but ignored on the bus
   bool enhcksum;
-  uint8_t data[3][9]; // max. 8 bytes of data + 1 bytes of checksum
+  uint8_t data[SL_LIN_BUFFER_COUNT][9]; // max. 8 bytes of data + 1 checksum
+  // prepared at registration, so the ISR only has to launch them
+  LDMA_Descriptor_t desc[SL_LIN_BUFFER_COUNT];
 } sl_lin_endpoint_t;
 
 static volatile sl_lin_endpoint_t sl_lin_endpoints[SL_LIN_MAX_ENDPOINT + 1];
 
+// protected ID of every 6-bit frame ID, filled by sl_lin_slave_init()
+static uint8_t sl_lin_pids[64];
+
+static volatile sl_lin_slave_statistics_t sl_lin_stats;
+
 #define SL_LIN_SYNC_BYTE    0x55
 #define SL_LIN_DIAG_REQUEST 0x3c
+#define SL_LIN_DIAG_RESPONSE 0x3d
 
 // can be 0..5
 #define PRS_USART_RX        4
@@ -199,16 +217,9 @@ static volatile sl_lin_endpoint_t sl_lin_endpoints[SL_LIN_MAX_ENDPOINT + 1];
 #define LIN_DELAY_TIMER_IRQ_N                TIMER_IRQN(3)
 #endif
 
-static LDMA_Descriptor_t tx_desc = LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(NULL,
-                                                                   (void *)&(
-                                                                     LIN_USART->
-                                                                     TXDATA),
-                                                                   0);
 static LDMA_TransferCfg_t tx_transfer = LDMA_TRANSFER_CFG_PERIPHERAL(
   LDMA_PERIPHERAL_SIGNAL_USART_TXBL);
 
-static LDMA_Descriptor_t rx_desc =
-  LDMA_DESCRIPTOR_SINGLE_P2M_BYTE((void *)&(LIN_USART->RXDATA), NULL, 0);
 static LDMA_TransferCfg_t rx_transfer = LDMA_TRANSFER_CFG_PERIPHERAL(
   LDMA_PERIPHERAL_SIGNAL_USART_RXDATAV);
 
@@ -239,7 +250,7 @@ static void sl_lin_delay(int usecs)
 
 // take care, input is not masked to gain speed
 __attribute__((__pure__))
-static uint8_t sl_lin_frame_id_to_pid(uint8_t frame_id)
+uint8_t sl_lin_frame_id_to_pid(uint8_t frame_id)
 {
   return frame_id
          | ((((frame_id >> 0U) & 1U)
@@ -324,24 +335,65 @@ static void sl_lin_clear_buffer_and_checksum(uint8_t *dst, int len,
   *dst++ = init ^ 0xff;
 }
 
-static void dma_start_tx(int frame_id)
+static void sl_lin_prepare_descriptors(volatile sl_lin_endpoint_t *ep,
+                                       bool writable,
+                                       int len)
 {
-  CORE_DECLARE_IRQ_STATE;
-  volatile sl_lin_endpoint_t *ep = &sl_lin_endpoints[frame_id];
+  for (int i = 0; i < SL_LIN_BUFFER_COUNT; i++)
+  {
+    LDMA_Descriptor_t desc;
 
-  __CORE_ENTER_CRITICAL();
-  sl_lin_copy_buffer((void *)ep->data[CURRENT_IDX],
-                     (void *)ep->data[ep->next],
-                     ep->bytes + 1);
-  __CORE_EXIT_CRITICAL();
+    if (writable) {
+      desc = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(
+        (void *)&(LIN_USART->RXDATA), (void *)ep->data[i], len + 1);
+    } else {
+      desc = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(
+        (void *)ep->data[i], (void *)&(LIN_USART->TXDATA), len + 1);
+      // use the TXC interrupt of USART instead
+      desc.xfer.doneIfs = 0;
+    }
+
+    ep->desc[i] = desc;
+  }
+}
+
+// header_ticks is the nominal BREAK, DELIM, SYNC and PID time at the
+// detected baud rate, the histogram starts there
+__attribute__((__always_inline__))
+static inline void sl_lin_record_latency(uint32_t ticks, uint32_t header_ticks)
+{
+  uint32_t bin = 0;
+
+  if (ticks > header_ticks) {
+    bin = (ticks - header_ticks) / SL_LIN_LATENCY_BIN_TICKS;
+  }
+
+  if (unlikely(bin >= SL_LIN_LATENCY_HISTOGRAM_BINS)) {
+    bin = SL_LIN_LATENCY_HISTOGRAM_BINS - 1;
+  }
+  sl_lin_stats.latency_histogram[bin]++;
 
-  tx_desc.xfer.srcAddr = (uint32_t)ep->data[CURRENT_IDX];
-  tx_desc.xfer.xferCnt = ep->bytes + 1 - 1;
+  if (ticks < sl_lin_stats.latency_min) {
+    sl_lin_stats.latency_min = ticks;
+  }
+  if (ticks > sl_lin_stats.latency_max) {
+    sl_lin_stats.latency_max = ticks;
+  }
+}
+
+static void dma_start_tx(volatile sl_lin_endpoint_t *ep)
+{
+  uint8_t idx = ep->next;
+
+  // updates leave this buffer alone until another one gets locked
+  ep->locked = idx;
   __DSB();
 
   USART_IntClear(LIN_USART, USART_IF_TXC);
 
-  LDMA_StartTransfer(LIN_DMA_CH_USART_TX, &tx_transfer, &tx_desc);
+  LDMA_StartTransfer(LIN_DMA_CH_USART_TX,
+                     &tx_transfer,
+                     (const LDMA_Descriptor_t *)&ep->desc[idx]);
 }
 
 SL_RAMFUNC_DEFINITION_BEGIN
@@ -365,7 +417,7 @@ static void dma_rx_callback(int ch, void *param)
   ep = &sl_lin_endpoints[frame_id];
 
   if (likely((slave_state == STATE_PROCESSING) && (ep->bytes > 0))) {
-    uint8_t tmp, pid, checksum;
+    uint8_t tmp, checksum;
 
     slave_state = STATE_COMPLETED;
 
@@ -374,16 +426,17 @@ static void dma_rx_callback(int ch, void *param)
     ep->next = 1 - tmp;
     __CORE_EXIT_CRITICAL();
 
-    pid = sl_lin_frame_id_to_pid(frame_id);
-    checksum = sl_lin_calc_checksum((ep->enhcksum) ? pid : 0x00,
+    checksum = sl_lin_calc_checksum(ep->cksum_init,
                                     (uint8_t *)ep->data[tmp],
                                     ep->bytes + 1);
 
-#if defined(LIN_CHECKSUM_ERR_PORT) && defined(LIN_CHECKSUM_ERR_PIN)
+    sl_lin_stats.frames++;
     if (unlikely(checksum != 0x00)) {
+      sl_lin_stats.checksum_errors++;
+#if defined(LIN_CHECKSUM_ERR_PORT) && defined(LIN_CHECKSUM_ERR_PIN)
       GPIO_PinOutToggle(LIN_CHECKSUM_ERR_PORT, LIN_CHECKSUM_ERR_PIN);
-    }
 #endif
+    }
 
     if (likely(ep->callback != NULL)) {
       ep->callback(frame_id, true, (uint8_t *)ep->data[tmp], ep->bytes,
@@ -403,16 +456,12 @@ static void dma_rx_callback(int ch, void *param)
 
 SL_RAMFUNC_DEFINITION_END
 
-static void dma_start_rx(int frame_id)
+static void dma_start_rx(volatile sl_lin_endpoint_t *ep, int frame_id)
 {
-  volatile sl_lin_endpoint_t *ep = &sl_lin_endpoints[frame_id];
-
-  rx_desc.xfer.dstAddr = (uint32_t)ep->data[ep->next];
-  rx_desc.xfer.xferCnt = ep->bytes + 1 - 1;
-  __DSB();
-
   LDMA_UpdateCallbackParam(LIN_DMA_CH_USART_RX, (void *)frame_id);
-  LDMA_StartTransfer(LIN_DMA_CH_USART_RX, &rx_transfer, &rx_desc);
+  LDMA_StartTransfer(LIN_DMA_CH_USART_RX,
+                     &rx_transfer,
+                     (const LDMA_Descriptor_t *)&ep->desc[ep->next]);
 }
 
 static void sl_lin_slave_reinit_uart(void)
@@ -469,8 +518,12 @@ void sl_lin_slave_init(void)
   LETIMER_Init_TypeDef letimer = LETIMER_INIT_DEFAULT;
   TIMER_Init_TypeDef wakeTimer = TIMER_INIT_DEFAULT;
 
-  // use the TXC interrupt of USART instead
-  tx_desc.xfer.doneIfs = 0;
+  for (int i = 0; i < 64; i++)
+  {
+    sl_lin_pids[i] = sl_lin_frame_id_to_pid(i);
+  }
+
+  sl_lin_slave_clear_statistics();
 
   // 360 - 380 usecs (re-enables and waits for clocks)
   NVIC_SetPriority(GPIO_EVEN_IRQn, CORE_INTERRUPT_DEFAULT_PRIORITY + 1);
@@ -658,6 +711,10 @@ static void sl_lin_slave_abort_uart(void)
   if (current_frame_id != 0xff) {
     volatile sl_lin_endpoint_t *ep = &sl_lin_endpoints[current_frame_id];
 
+    if (likely(ep->bytes > 0)) {
+      sl_lin_stats.missed_slots++;
+    }
+
     if (likely((ep->callback != NULL) && (ep->bytes > 0))) {
       // NOTE: it might be impossible to detect the correct 'data'
       // for RX (writable endpoints) it is '_current'
@@ -720,6 +777,7 @@ void USART_TX_IRQ_HANDLER(void)
   USART_IntClear(LIN_USART, flags);
 
   if (unlikely((flags & USART_IF_CCF) != 0)) {
+    sl_lin_stats.conflict_errors++;
 #if defined(LIN_CONFLICT_ERR_PORT) && defined(LIN_CONFLICT_ERR_PIN)
     GPIO_PinOutToggle(LIN_CONFLICT_ERR_PORT, LIN_CONFLICT_ERR_PIN);
 #endif
@@ -736,6 +794,8 @@ void USART_TX_IRQ_HANDLER(void)
       slave_state = STATE_COMPLETED;
       __DSB();
 
+      sl_lin_stats.frames++;
+
       LETIMER_IntDisable(LETIMER0, LETIMER_IEN_UF);
       LETIMER_IntClear(LETIMER0, LETIMER_IF_UF);
       NVIC_ClearPendingIRQ(LETIMER0_IRQn);
@@ -743,7 +803,7 @@ void USART_TX_IRQ_HANDLER(void)
       if (likely(ep->callback != NULL)) {
         ep->callback(frame_id,
                      false,
-                     (uint8_t *)ep->data[CURRENT_IDX],
+                     (uint8_t *)ep->data[ep->locked],
                      ep->bytes,
                      (LIN_USART->IF & USART_IF_CCF) == 0);
       }
@@ -776,6 +836,7 @@ void USART_RX_IRQ_HANDLER(void)
   flags = USART_IntGetEnabled(LIN_USART);
 
   if (unlikely(flags & (USART_IF_FERR | USART_IF_RXOF | USART_IF_RXUF))) {
+    sl_lin_stats.framing_errors++;
 #if defined(LIN_GENERIC_ERR_PORT) && defined(LIN_GENERIC_ERR_PIN)
     GPIO_PinOutToggle(LIN_GENERIC_ERR_PORT, LIN_GENERIC_ERR_PIN);
 #endif
@@ -789,7 +850,7 @@ void USART_RX_IRQ_HANDLER(void)
 
     pid = LIN_USART->RXDATA;
 
-    // TODO: test maximum time
+    // the actual time is recorded in the latency histogram
     // start a HFXO-based timer at the rising edge of the BREAK detection
     // it's followed by at least 1-bit time of delimiter (calculate with 2)
     // next is the 10-bit time of SYNC
@@ -828,32 +889,38 @@ void USART_RX_IRQ_HANDLER(void)
     if (likely((slave_state == STATE_WAITING)
                && ((now + ticks) <= (SL_LIN_TIMEOUT + 2)))) {
       volatile sl_lin_endpoint_t *ep = NULL;
-      uint8_t check, frame_id;
+      uint8_t frame_id;
       uint8_t bytes = 0;
 
       frame_id = pid & 0x3f;
-      check = sl_lin_frame_id_to_pid(frame_id);
 
-      if (likely((check == pid) && (frame_id <= SL_LIN_MAX_ENDPOINT))) {
-        current_frame_id = frame_id;
+      if (unlikely(sl_lin_pids[frame_id] != pid)) {
+        sl_lin_stats.parity_errors++;
+      } else if (likely(frame_id <= SL_LIN_MAX_ENDPOINT)) {
         ep = &sl_lin_endpoints[frame_id];
-        bytes = ep->bytes;
+        if (likely(!ep->disabled)) {
+          bytes = ep->bytes;
+        }
       }
 
       if (bytes) {
+        current_frame_id = frame_id;
         slave_state = STATE_PROCESSING;
         __DSB();
 
         if (ep->writable) {
-          dma_start_rx(frame_id);
+          dma_start_rx(ep, frame_id);
         } else {
           // time to enable the transmitter
           // the TX FIFO is going to be filled by the DMA
           // have to keep the RX enabled for collision detection
           // but RX has to be blocked to not receive our transmission
           LIN_USART->CMD = USART_CMD_TXEN | USART_CMD_RXBLOCKEN;
-          dma_start_tx(frame_id);
+          dma_start_tx(ep);
         }
+
+        sl_lin_record_latency(SL_LIN_TIMEOUT - LETIMER_CounterGet(LETIMER0),
+                              ticks);
       } else {
         sl_lin_slave_abort_uart();
       }
@@ -911,7 +978,12 @@ static sl_status_t register_endpoint(uint8_t frame_id,
     return SL_STATUS_INVALID_RANGE;
   }
 
-  if (unlikely(frame_id >= 0x3c)) {
+  if (unlikely(frame_id > SL_LIN_MAX_APP_ENDPOINT)) {
+    // only the master request and the slave response frames
+    if (unlikely(frame_id != (writable ? SL_LIN_DIAG_REQUEST
+                              : SL_LIN_DIAG_RESPONSE))) {
+      return SL_STATUS_INVALID_RANGE;
+    }
     enhanced_checksum = false;
   }
 
@@ -924,19 +996,24 @@ static sl_status_t register_endpoint(uint8_t frame_id,
   ep->enhcksum = enhanced_checksum;
   ep->callback = callback;
   ep->next = 0;
+  ep->locked = SL_LIN_BUFFER_COUNT - 1;
+  ep->pending = 0;
+  ep->disabled = false;
 
   pid = sl_lin_frame_id_to_pid(frame_id);
+  ep->cksum_init = (enhanced_checksum) ? pid : 0x00;
 
   if (initdata) {
     sl_lin_copy_buffer_and_checksum((void *)ep->data[0], initdata, len,
-                                    (enhanced_checksum) ? pid : 0x00);
+                                    ep->cksum_init);
   } else {
     sl_lin_clear_buffer_and_checksum((void *)ep->data[0], len,
-                                     (enhanced_checksum) ? pid : 0x00);
+                                     ep->cksum_init);
   }
 
   sl_lin_copy_buffer((void *)ep->data[1], (void *)ep->data[0], len + 1);
   sl_lin_copy_buffer((void *)ep->data[2], (void *)ep->data[0], len + 1);
+  sl_lin_prepare_descriptors(ep, writable, len);
   __DSB();
 
   ep->bytes = len;
@@ -991,13 +1068,40 @@ sl_status_t sl_lin_slave_unregister_endpoint(uint8_t frame_id)
   return SL_STATUS_OK;
 }
 
+bool sl_lin_slave_is_endpoint_registered(uint8_t frame_id)
+{
+  if (unlikely(frame_id > SL_LIN_MAX_ENDPOINT)) {
+    return false;
+  }
+
+  return sl_lin_endpoints[frame_id].bytes != 0;
+}
+
+// pick the buffer which is neither published nor handed to the DMA
+// the ISR only ever locks the published one
+static uint8_t sl_lin_free_buffer(volatile sl_lin_endpoint_t *ep)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint8_t tmp;
+
+  __CORE_ENTER_CRITICAL();
+  if (ep->next == ep->locked) {
+    tmp = (ep->next + 1) % SL_LIN_BUFFER_COUNT;
+  } else {
+    tmp = SL_LIN_BUFFER_COUNT - ep->next - ep->locked;
+  }
+  __CORE_EXIT_CRITICAL();
+
+  return tmp;
+}
+
 sl_status_t sl_lin_slave_update_readable_endpoint(uint8_t frame_id,
                                                   const uint8_t *data)
 {
   volatile sl_lin_endpoint_t *ep;
   volatile uint8_t *dest;
   int len;
-  uint8_t tmp, pid;
+  uint8_t tmp;
 
   if (unlikely(frame_id > SL_LIN_MAX_ENDPOINT)) {
     return SL_STATUS_INVALID_RANGE;
@@ -1013,12 +1117,10 @@ sl_status_t sl_lin_slave_update_readable_endpoint(uint8_t frame_id,
     return SL_STATUS_INVALID_KEY;
   }
 
-  tmp = 1 - ep->next;
+  tmp = sl_lin_free_buffer(ep);
   dest = ep->data[tmp];
-  pid = sl_lin_frame_id_to_pid(frame_id);
 
-  sl_lin_copy_buffer_and_checksum((void *)dest, data, len,
-                                  (ep->enhcksum) ? pid : 0x00);
+  sl_lin_copy_buffer_and_checksum((void *)dest, data, len, ep->cksum_init);
 
   __DSB();
 
@@ -1028,6 +1130,105 @@ sl_status_t sl_lin_slave_update_readable_endpoint(uint8_t frame_id,
   return SL_STATUS_OK;
 }
 
+uint8_t *sl_lin_slave_acquire_readable_buffer(uint8_t frame_id)
+{
+  volatile sl_lin_endpoint_t *ep;
+
+  if (unlikely(frame_id > SL_LIN_MAX_ENDPOINT)) {
+    return NULL;
+  }
+
+  ep = &sl_lin_endpoints[frame_id];
+  if (unlikely(!ep->bytes || ep->writable)) {
+    return NULL;
+  }
+
+  ep->pending = sl_lin_free_buffer(ep);
+
+  return (uint8_t *)ep->data[ep->pending];
+}
+
+sl_status_t sl_lin_slave_publish_readable_buffer(uint8_t frame_id)
+{
+  volatile sl_lin_endpoint_t *ep;
+  volatile uint8_t *buf;
+  int len;
+
+  if (unlikely(frame_id > SL_LIN_MAX_ENDPOINT)) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+
+  ep = &sl_lin_endpoints[frame_id];
+  len = ep->bytes;
+  if (unlikely(!len || ep->writable)) {
+    return SL_STATUS_INVALID_KEY;
+  }
+
+  buf = ep->data[ep->pending];
+  buf[len] = sl_lin_calc_checksum(ep->cksum_init, (uint8_t *)buf, len);
+  __DSB();
+
+  ep->next = ep->pending;
+  __DSB();
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_lin_slave_set_endpoint_enabled(uint8_t frame_id, bool enabled)
+{
+  volatile sl_lin_endpoint_t *ep;
+
+  if (unlikely(frame_id > SL_LIN_MAX_ENDPOINT)) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+
+  ep = &sl_lin_endpoints[frame_id];
+  if (unlikely(!ep->bytes)) {
+    return SL_STATUS_EMPTY;
+  }
+
+  ep->disabled = !enabled;
+  __DSB();
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_lin_slave_move_endpoint(uint8_t frame_id, uint8_t new_frame_id)
+{
+  volatile sl_lin_endpoint_t *ep;
+  uint8_t data[8];
+  sl_status_t status;
+
+  if (unlikely((frame_id > SL_LIN_MAX_APP_ENDPOINT)
+               || (new_frame_id > SL_LIN_MAX_APP_ENDPOINT))) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+
+  ep = &sl_lin_endpoints[frame_id];
+  if (unlikely(!ep->bytes)) {
+    return SL_STATUS_EMPTY;
+  }
+
+  if (new_frame_id == frame_id) {
+    return sl_lin_slave_set_endpoint_enabled(frame_id, true);
+  }
+
+  // the checksum depends on the PID, so the data is re-registered
+  sl_lin_copy_buffer(data, (void *)ep->data[ep->next], ep->bytes);
+
+  status = register_endpoint(new_frame_id,
+                             ep->writable,
+                             ep->bytes,
+                             ep->callback,
+                             ep->writable ? NULL : data,
+                             ep->enhcksum);
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return sl_lin_slave_unregister_endpoint(frame_id);
+}
+
 sl_status_t sl_lin_slave_inject_checksum_error(uint8_t frame_id)
 {
   volatile sl_lin_endpoint_t *ep;
@@ -1051,3 +1252,28 @@ sl_status_t sl_lin_slave_inject_checksum_error(uint8_t frame_id)
 
   return SL_STATUS_OK;
 }
+
+sl_status_t sl_lin_slave_get_statistics(sl_lin_slave_statistics_t *statistics)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (unlikely(!statistics)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  __CORE_ENTER_CRITICAL();
+  *statistics = *(sl_lin_slave_statistics_t *)&sl_lin_stats;
+  __CORE_EXIT_CRITICAL();
+
+  return SL_STATUS_OK;
+}
+
+void sl_lin_slave_clear_statistics(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  __CORE_ENTER_CRITICAL();
+  memset((void *)&sl_lin_stats, 0, sizeof(sl_lin_stats));
+  sl_lin_stats.latency_min = 0xffff;
+  __CORE_EXIT_CRITICAL();
+}
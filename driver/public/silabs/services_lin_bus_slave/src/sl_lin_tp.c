@@ -0,0 +1,760 @@
+/***************************************************************************//**
+ * @file sl_lin_tp.c
+ * @brief LIN diagnostic transport layer for slave devices
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "sl_lin_slave_config.h"
+#include "sl_lin.h"
+#include "sl_lin_tp.h"
+
+#include <em_core.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include "sl_sleeptimer.h"
+
+#include "system.h"
+
+#ifndef SL_LIN_TP_TIMEOUT_MS
+#define SL_LIN_TP_TIMEOUT_MS 1000
+#endif
+
+#define SL_LIN_TP_FRAME_LEN   8
+#define SL_LIN_TP_PADDING     0xff
+
+// protocol control information, the low nibble is a length or a sequence
+#define SL_LIN_TP_PCI_TYPE    0xf0
+#define SL_LIN_TP_PCI_SF      0x00
+#define SL_LIN_TP_PCI_FF      0x10
+#define SL_LIN_TP_PCI_CF      0x20
+
+// payload bytes of a single, first and consecutive frame
+#define SL_LIN_TP_SF_PAYLOAD  6
+#define SL_LIN_TP_FF_PAYLOAD  5
+#define SL_LIN_TP_CF_PAYLOAD  6
+
+// node configuration services
+#define SL_LIN_TP_SID_ASSIGN_NAD            0xb0
+#define SL_LIN_TP_SID_READ_BY_ID            0xb2
+#define SL_LIN_TP_SID_SAVE_CONFIGURATION    0xb6
+#define SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE 0xb7
+#define SL_LIN_TP_RSID(sid)                 ((sid) + 0x40)
+
+#define SL_LIN_TP_ID_PRODUCT      0
+#define SL_LIN_TP_ID_SERIAL       1
+#define SL_LIN_TP_ID_USER_FIRST   32
+#define SL_LIN_TP_ID_USER_LAST    63
+
+#define SL_LIN_TP_PID_UNASSIGN    0x00
+#define SL_LIN_TP_PID_DONT_CARE   0xff
+#define SL_LIN_TP_MAX_FRAME_ID    59
+
+enum {
+  SL_LIN_TP_RX_IDLE,
+  SL_LIN_TP_RX_RECEIVING,
+  SL_LIN_TP_RX_COMPLETE,
+};
+
+static sl_lin_tp_config_t sl_lin_tp_config;
+static volatile uint8_t sl_lin_tp_nad;
+static uint32_t sl_lin_tp_timeout_ticks;
+
+// reception, advanced by the master request frame callback
+static volatile uint8_t sl_lin_tp_rx_state;
+static volatile uint8_t sl_lin_tp_rx_nad;
+static volatile uint8_t sl_lin_tp_rx_sn;
+static volatile bool sl_lin_tp_rx_streamed;
+static volatile uint16_t sl_lin_tp_rx_length;
+static volatile uint16_t sl_lin_tp_rx_offset;
+static volatile uint32_t sl_lin_tp_rx_tick;
+
+// block transfer, one half is filled while the other is processed
+static uint8_t *volatile sl_lin_tp_block_buffer;
+static uint16_t sl_lin_tp_block_size;
+static sl_lin_tp_block_callback_t sl_lin_tp_block_callback;
+static volatile uint8_t sl_lin_tp_block_fill;   // half being filled
+static volatile uint8_t sl_lin_tp_block_next;   // half to be processed next
+static volatile uint8_t sl_lin_tp_block_ready;  // halves handed over, bitmask
+static volatile uint16_t sl_lin_tp_block_used;
+static volatile uint32_t sl_lin_tp_block_base;  // request offset of the fill
+static volatile uint16_t sl_lin_tp_block_len[2];
+static volatile uint32_t sl_lin_tp_block_offset[2];
+static volatile bool sl_lin_tp_block_last[2];
+static volatile bool sl_lin_tp_block_dropped;
+
+// transmission, advanced by the slave response frame callback
+static const uint8_t *volatile sl_lin_tp_tx_data;
+static volatile uint16_t sl_lin_tp_tx_length;
+static volatile uint16_t sl_lin_tp_tx_offset;
+static volatile uint8_t sl_lin_tp_tx_sn;
+static volatile uint8_t sl_lin_tp_tx_nad;
+static volatile bool sl_lin_tp_tx_busy;
+static uint8_t sl_lin_tp_tx_local[SL_LIN_TP_SF_PAYLOAD];
+
+static bool sl_lin_tp_pid_valid(uint8_t pid)
+{
+  uint8_t id = pid & 0x3f;
+
+  return (id <= SL_LIN_TP_MAX_FRAME_ID)
+         && (pid == sl_lin_frame_id_to_pid(id));
+}
+
+static bool sl_lin_tp_product_matches(const uint8_t *data)
+{
+  uint16_t supplier_id = data[0] | (data[1] << 8);
+  uint16_t function_id = data[2] | (data[3] << 8);
+
+  return ((supplier_id == sl_lin_tp_config.supplier_id)
+          || (supplier_id == SL_LIN_TP_SUPPLIER_WILDCARD))
+         && ((function_id == sl_lin_tp_config.function_id)
+             || (function_id == SL_LIN_TP_FUNCTION_WILDCARD));
+}
+
+// called with the reception owned, i.e. from the ISR or in a critical section
+static void sl_lin_tp_rx_drop(void)
+{
+  if (sl_lin_tp_rx_streamed) {
+    sl_lin_tp_block_dropped = true;
+    sl_lin_tp_rx_streamed = false;
+  }
+  sl_lin_tp_rx_state = SL_LIN_TP_RX_IDLE;
+}
+
+static void sl_lin_tp_block_handover(bool last)
+{
+  uint8_t half = sl_lin_tp_block_fill;
+
+  sl_lin_tp_block_len[half] = sl_lin_tp_block_used;
+  sl_lin_tp_block_offset[half] = sl_lin_tp_block_base;
+  sl_lin_tp_block_last[half] = last;
+  sl_lin_tp_block_base += sl_lin_tp_block_used;
+  sl_lin_tp_block_used = 0;
+  sl_lin_tp_block_fill = half ^ 1;
+  __DSB();
+
+  sl_lin_tp_block_ready |= 1 << half;
+}
+
+// copy the payload of a frame straight from the endpoint buffer
+static bool sl_lin_tp_store(const uint8_t *src, uint16_t len)
+{
+  uint16_t offset = sl_lin_tp_rx_offset;
+  uint16_t end = offset + len;
+  bool complete = end == sl_lin_tp_rx_length;
+
+  if (!sl_lin_tp_rx_streamed) {
+    memcpy(&sl_lin_tp_config.rx_buffer[offset], src, len);
+  } else {
+    while (len) {
+      uint8_t half = sl_lin_tp_block_fill;
+      uint16_t used = sl_lin_tp_block_used;
+      uint16_t n = sl_lin_tp_block_size - used;
+
+      if (unlikely(sl_lin_tp_block_ready & (1 << half))) {
+        return false; // overrun, the other half is not processed yet
+      }
+
+      if (n > len) {
+        n = len;
+      }
+      memcpy(&sl_lin_tp_block_buffer[half * sl_lin_tp_block_size + used],
+             src, n);
+      src += n;
+      len -= n;
+      sl_lin_tp_block_used = used + n;
+
+      if (sl_lin_tp_block_used == sl_lin_tp_block_size) {
+        sl_lin_tp_block_handover(complete && !len);
+      }
+    }
+
+    if (complete && sl_lin_tp_block_used) {
+      sl_lin_tp_block_handover(true);
+    }
+  }
+
+  sl_lin_tp_rx_offset = end;
+  sl_lin_tp_rx_tick = sl_sleeptimer_get_tick_count();
+  if (complete) {
+    sl_lin_tp_rx_state = SL_LIN_TP_RX_COMPLETE;
+  }
+
+  return true;
+}
+
+static void sl_lin_tp_request_frame(uint8_t frame_id,
+                                    bool writable,
+                                    uint8_t *data,
+                                    int len,
+                                    bool success)
+{
+  uint8_t nad, pci, n;
+  uint16_t length;
+
+  (void)frame_id;
+  (void)writable;
+
+  if (unlikely(!success || (data == NULL) || (len != SL_LIN_TP_FRAME_LEN))) {
+    return;
+  }
+
+  nad = data[0];
+  pci = data[1];
+
+  if (nad == SL_LIN_TP_NAD_SLEEP) {
+    return;
+  }
+
+  // a new request ends the pending response
+  if (sl_lin_tp_tx_busy) {
+    sl_lin_tp_tx_busy = false;
+    sl_lin_slave_set_endpoint_enabled(SL_LIN_TP_SRF_ID, false);
+  }
+
+  if ((nad != sl_lin_tp_nad)
+      && (nad != sl_lin_tp_config.initial_nad)
+      && (nad != SL_LIN_TP_NAD_FUNCTIONAL)
+      && (nad != SL_LIN_TP_NAD_WILDCARD)) {
+    return;
+  }
+
+  switch (pci & SL_LIN_TP_PCI_TYPE) {
+    case SL_LIN_TP_PCI_SF:
+      n = pci & 0x0f;
+      if (unlikely((n == 0) || (n > SL_LIN_TP_SF_PAYLOAD)
+                   || (n > sl_lin_tp_config.rx_buffer_size))) {
+        return;
+      }
+      // the previous request is not processed yet
+      if (sl_lin_tp_rx_state == SL_LIN_TP_RX_COMPLETE) {
+        return;
+      }
+      sl_lin_tp_rx_drop();
+      sl_lin_tp_rx_nad = nad;
+      sl_lin_tp_rx_length = n;
+      sl_lin_tp_rx_offset = 0;
+      sl_lin_tp_store(&data[2], n);
+      break;
+
+    case SL_LIN_TP_PCI_FF:
+      length = ((pci & 0x0f) << 8) | data[2];
+      // functional requests are single frames only
+      if (unlikely((nad == SL_LIN_TP_NAD_FUNCTIONAL)
+                   || (length <= SL_LIN_TP_SF_PAYLOAD))) {
+        return;
+      }
+      if (sl_lin_tp_rx_state == SL_LIN_TP_RX_COMPLETE) {
+        return;
+      }
+      sl_lin_tp_rx_drop();
+      if (sl_lin_tp_block_buffer != NULL) {
+        if (sl_lin_tp_block_ready) {
+          return;
+        }
+        sl_lin_tp_block_fill = sl_lin_tp_block_next;
+        sl_lin_tp_block_used = 0;
+        sl_lin_tp_block_base = 0;
+        sl_lin_tp_rx_streamed = true;
+      } else if (length > sl_lin_tp_config.rx_buffer_size) {
+        return;
+      }
+      sl_lin_tp_rx_nad = nad;
+      sl_lin_tp_rx_length = length;
+      sl_lin_tp_rx_offset = 0;
+      sl_lin_tp_rx_sn = 1;
+      sl_lin_tp_rx_state = SL_LIN_TP_RX_RECEIVING;
+      if (unlikely(!sl_lin_tp_store(&data[3], SL_LIN_TP_FF_PAYLOAD))) {
+        sl_lin_tp_rx_drop();
+      }
+      break;
+
+    case SL_LIN_TP_PCI_CF:
+      if ((sl_lin_tp_rx_state != SL_LIN_TP_RX_RECEIVING)
+          || (nad != sl_lin_tp_rx_nad)) {
+        return;
+      }
+      if (unlikely((pci & 0x0f) != (sl_lin_tp_rx_sn & 0x0f))) {
+        sl_lin_tp_rx_drop();
+        return;
+      }
+      sl_lin_tp_rx_sn++;
+      length = sl_lin_tp_rx_length - sl_lin_tp_rx_offset;
+      n = (length < SL_LIN_TP_CF_PAYLOAD) ? length : SL_LIN_TP_CF_PAYLOAD;
+      if (unlikely(!sl_lin_tp_store(&data[2], n))) {
+        sl_lin_tp_rx_drop();
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+// build the next frame of the response in the endpoint's free buffer
+static void sl_lin_tp_load_frame(void)
+{
+  uint8_t *frame = sl_lin_slave_acquire_readable_buffer(SL_LIN_TP_SRF_ID);
+  uint16_t offset = sl_lin_tp_tx_offset;
+  uint16_t length = sl_lin_tp_tx_length;
+  uint8_t i = 0;
+  uint8_t n;
+
+  if (unlikely(frame == NULL)) {
+    return;
+  }
+
+  frame[i++] = sl_lin_tp_tx_nad;
+  if ((offset == 0) && (length <= SL_LIN_TP_SF_PAYLOAD)) {
+    frame[i++] = SL_LIN_TP_PCI_SF | length;
+    n = length;
+  } else if (offset == 0) {
+    frame[i++] = SL_LIN_TP_PCI_FF | (length >> 8);
+    frame[i++] = length & 0xff;
+    n = SL_LIN_TP_FF_PAYLOAD;
+  } else {
+    frame[i++] = SL_LIN_TP_PCI_CF | (sl_lin_tp_tx_sn++ & 0x0f);
+    length -= offset;
+    n = (length < SL_LIN_TP_CF_PAYLOAD) ? length : SL_LIN_TP_CF_PAYLOAD;
+  }
+
+  memcpy(&frame[i], &sl_lin_tp_tx_data[offset], n);
+  i += n;
+  memset(&frame[i], SL_LIN_TP_PADDING, SL_LIN_TP_FRAME_LEN - i);
+  sl_lin_tp_tx_offset = offset + n;
+
+  sl_lin_slave_publish_readable_buffer(SL_LIN_TP_SRF_ID);
+}
+
+static void sl_lin_tp_response_frame(uint8_t frame_id,
+                                     bool writable,
+                                     uint8_t *data,
+                                     int len,
+                                     bool success)
+{
+  (void)frame_id;
+  (void)writable;
+  (void)data;
+  (void)len;
+
+  // a failed frame stays published, and it's repeated on the next header
+  if (!success || !sl_lin_tp_tx_busy) {
+    return;
+  }
+
+  if (sl_lin_tp_tx_offset < sl_lin_tp_tx_length) {
+    sl_lin_tp_load_frame();
+  } else {
+    sl_lin_tp_tx_busy = false;
+    sl_lin_slave_set_endpoint_enabled(SL_LIN_TP_SRF_ID, false);
+  }
+}
+
+static void sl_lin_tp_read_by_id(const uint8_t *data)
+{
+  uint8_t identifier = data[1];
+  uint8_t *rsp = sl_lin_tp_tx_local;
+
+  if (!sl_lin_tp_product_matches(&data[2])) {
+    return;
+  }
+
+  rsp[0] = SL_LIN_TP_RSID(SL_LIN_TP_SID_READ_BY_ID);
+  if (identifier == SL_LIN_TP_ID_PRODUCT) {
+    rsp[1] = sl_lin_tp_config.supplier_id & 0xff;
+    rsp[2] = sl_lin_tp_config.supplier_id >> 8;
+    rsp[3] = sl_lin_tp_config.function_id & 0xff;
+    rsp[4] = sl_lin_tp_config.function_id >> 8;
+    rsp[5] = sl_lin_tp_config.variant;
+    sl_lin_tp_send_response(rsp, 6);
+  } else if (identifier == SL_LIN_TP_ID_SERIAL) {
+    rsp[1] = sl_lin_tp_config.serial_number & 0xff;
+    rsp[2] = (sl_lin_tp_config.serial_number >> 8) & 0xff;
+    rsp[3] = (sl_lin_tp_config.serial_number >> 16) & 0xff;
+    rsp[4] = sl_lin_tp_config.serial_number >> 24;
+    sl_lin_tp_send_response(rsp, 5);
+  } else if ((identifier >= SL_LIN_TP_ID_USER_FIRST)
+             && (identifier <= SL_LIN_TP_ID_USER_LAST)
+             && (sl_lin_tp_config.read_by_id_callback != NULL)
+             && sl_lin_tp_config.read_by_id_callback(identifier, &rsp[1])) {
+    sl_lin_tp_send_response(rsp, 6);
+  } else {
+    sl_lin_tp_send_negative_response(SL_LIN_TP_SID_READ_BY_ID,
+                                     SL_LIN_TP_NRC_SUBFUNCTION_NOT_SUPPORTED);
+  }
+}
+
+static void sl_lin_tp_assign_frame_id_range(const uint8_t *data)
+{
+  uint8_t start = data[1];
+  const uint8_t *pids = &data[2];
+  uint8_t *frame_ids = sl_lin_tp_config.frame_ids;
+  uint8_t index;
+  uint64_t registered = 0;
+
+  // validate everything first, the assignment is done as a whole
+  for (uint8_t i = 0; i < 4; i++) {
+    if (pids[i] == SL_LIN_TP_PID_DONT_CARE) {
+      continue;
+    }
+    index = start + i;
+    if ((index < start) || (index >= sl_lin_tp_config.frame_id_count)
+        || ((pids[i] != SL_LIN_TP_PID_UNASSIGN)
+            && !sl_lin_tp_pid_valid(pids[i]))) {
+      sl_lin_tp_send_negative_response(SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE,
+                                       SL_LIN_TP_NRC_SUBFUNCTION_NOT_SUPPORTED);
+      return;
+    }
+  }
+
+  // replay the moves on a copy of the registrations, so that no slot is
+  // moved unless all of them can be
+  for (uint8_t id = 0; id <= SL_LIN_TP_MAX_FRAME_ID; id++) {
+    if (sl_lin_slave_is_endpoint_registered(id)) {
+      registered |= (uint64_t)1 << id;
+    }
+  }
+  for (uint8_t i = 0; i < 4; i++) {
+    uint8_t from;
+    uint8_t to = pids[i] & 0x3f;
+
+    if ((pids[i] == SL_LIN_TP_PID_DONT_CARE)
+        || (pids[i] == SL_LIN_TP_PID_UNASSIGN)) {
+      continue;
+    }
+    from = frame_ids[start + i];
+    if ((from > SL_LIN_TP_MAX_FRAME_ID)
+        || !(registered & ((uint64_t)1 << from))
+        || ((to != from) && (registered & ((uint64_t)1 << to)))) {
+      sl_lin_tp_send_negative_response(SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE,
+                                       SL_LIN_TP_NRC_CONDITIONS_NOT_CORRECT);
+      return;
+    }
+    registered &= ~((uint64_t)1 << from);
+    registered |= (uint64_t)1 << to;
+  }
+
+  for (uint8_t i = 0; i < 4; i++) {
+    if (pids[i] == SL_LIN_TP_PID_DONT_CARE) {
+      continue;
+    }
+    index = start + i;
+    if (pids[i] == SL_LIN_TP_PID_UNASSIGN) {
+      sl_lin_slave_set_endpoint_enabled(frame_ids[index], false);
+    } else if (sl_lin_slave_move_endpoint(frame_ids[index], pids[i] & 0x3f)
+               == SL_STATUS_OK) {
+      frame_ids[index] = pids[i] & 0x3f;
+    } else {
+      sl_lin_tp_send_negative_response(SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE,
+                                       SL_LIN_TP_NRC_CONDITIONS_NOT_CORRECT);
+      return;
+    }
+  }
+
+  sl_lin_tp_tx_local[0] = SL_LIN_TP_RSID(SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE);
+  sl_lin_tp_send_response(sl_lin_tp_tx_local, 1);
+}
+
+// returns false if the request shall be passed to the application
+static bool sl_lin_tp_node_configuration(uint8_t nad,
+                                         const uint8_t *data,
+                                         uint16_t len)
+{
+  uint8_t sid = data[0];
+
+  if (nad == SL_LIN_TP_NAD_FUNCTIONAL) {
+    return false;
+  }
+
+  // assign NAD is addressed with the initial NAD, the others with the current
+  if (sid == SL_LIN_TP_SID_ASSIGN_NAD) {
+    if ((len == 6)
+        && ((nad == sl_lin_tp_config.initial_nad)
+            || (nad == SL_LIN_TP_NAD_WILDCARD))
+        && sl_lin_tp_product_matches(&data[1])) {
+      // the response is sent with the former NAD
+      sl_lin_tp_tx_local[0] = SL_LIN_TP_RSID(SL_LIN_TP_SID_ASSIGN_NAD);
+      if (sl_lin_tp_send_response(sl_lin_tp_tx_local, 1) == SL_STATUS_OK) {
+        sl_lin_tp_nad = data[5];
+      }
+    }
+    return true;
+  }
+
+  if ((nad != sl_lin_tp_nad) && (nad != SL_LIN_TP_NAD_WILDCARD)) {
+    return true;
+  }
+
+  switch (sid) {
+    case SL_LIN_TP_SID_READ_BY_ID:
+      if (len == 6) {
+        sl_lin_tp_read_by_id(data);
+      }
+      return true;
+
+    case SL_LIN_TP_SID_SAVE_CONFIGURATION:
+      if (sl_lin_tp_config.save_callback == NULL) {
+        return false;
+      }
+      sl_lin_tp_config.save_callback(sl_lin_tp_nad,
+                                     sl_lin_tp_config.frame_ids,
+                                     sl_lin_tp_config.frame_id_count);
+      sl_lin_tp_tx_local[0] = SL_LIN_TP_RSID(SL_LIN_TP_SID_SAVE_CONFIGURATION);
+      sl_lin_tp_send_response(sl_lin_tp_tx_local, 1);
+      return true;
+
+    case SL_LIN_TP_SID_ASSIGN_FRAME_ID_RANGE:
+      if (len == 6) {
+        sl_lin_tp_assign_frame_id_range(data);
+      }
+      return true;
+
+    default:
+      // only the wildcard is reserved for node configuration
+      return nad == SL_LIN_TP_NAD_WILDCARD;
+  }
+}
+
+static void sl_lin_tp_process_blocks(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint8_t half;
+  bool last;
+
+  while (sl_lin_tp_block_ready & (1 << sl_lin_tp_block_next)) {
+    half = sl_lin_tp_block_next;
+    last = sl_lin_tp_block_last[half];
+
+    if (sl_lin_tp_block_callback != NULL) {
+      sl_lin_tp_block_callback(
+        &sl_lin_tp_block_buffer[half * sl_lin_tp_block_size],
+        sl_lin_tp_block_len[half],
+        sl_lin_tp_block_offset[half],
+        last);
+    }
+
+    CORE_ENTER_ATOMIC();
+    sl_lin_tp_block_next = half ^ 1;
+    sl_lin_tp_block_ready &= ~(1 << half);
+    if (last && sl_lin_tp_rx_streamed
+        && (sl_lin_tp_rx_state == SL_LIN_TP_RX_COMPLETE)) {
+      sl_lin_tp_rx_streamed = false;
+      sl_lin_tp_rx_state = SL_LIN_TP_RX_IDLE;
+    }
+    CORE_EXIT_ATOMIC();
+  }
+
+  if (sl_lin_tp_block_dropped) {
+    sl_lin_tp_block_dropped = false;
+    if (sl_lin_tp_block_callback != NULL) {
+      sl_lin_tp_block_callback(NULL, 0, 0, true);
+    }
+  }
+}
+
+sl_status_t sl_lin_tp_init(const sl_lin_tp_config_t *config)
+{
+  sl_status_t status;
+
+  if ((config == NULL) || (config->rx_buffer == NULL)
+      || (config->request_callback == NULL)
+      || (config->frame_id_count && (config->frame_ids == NULL))) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  sl_lin_tp_config = *config;
+  sl_lin_tp_nad = config->nad;
+  sl_lin_tp_timeout_ticks = sl_sleeptimer_ms_to_tick(SL_LIN_TP_TIMEOUT_MS);
+  sl_lin_tp_rx_state = SL_LIN_TP_RX_IDLE;
+  sl_lin_tp_rx_streamed = false;
+  sl_lin_tp_tx_busy = false;
+  sl_lin_tp_block_buffer = NULL;
+
+  status = sl_lin_slave_register_writable_endpoint(SL_LIN_TP_MRF_ID,
+                                                   SL_LIN_TP_FRAME_LEN,
+                                                   sl_lin_tp_request_frame,
+                                                   false);
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  status = sl_lin_slave_register_readable_endpoint(SL_LIN_TP_SRF_ID,
+                                                   SL_LIN_TP_FRAME_LEN,
+                                                   sl_lin_tp_response_frame,
+                                                   NULL,
+                                                   false);
+  if (status != SL_STATUS_OK) {
+    sl_lin_slave_unregister_endpoint(SL_LIN_TP_MRF_ID);
+    return status;
+  }
+
+  // the slave response frame is only answered while a response is pending
+  return sl_lin_slave_set_endpoint_enabled(SL_LIN_TP_SRF_ID, false);
+}
+
+void sl_lin_tp_process(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  sl_lin_tp_process_blocks();
+
+  if ((sl_lin_tp_rx_state == SL_LIN_TP_RX_COMPLETE)
+      && !sl_lin_tp_rx_streamed) {
+    uint8_t nad = sl_lin_tp_rx_nad;
+    const uint8_t *data = sl_lin_tp_config.rx_buffer;
+    uint16_t len = sl_lin_tp_rx_length;
+
+    if (!sl_lin_tp_node_configuration(nad, data, len)
+        && ((nad == sl_lin_tp_nad) || (nad == SL_LIN_TP_NAD_FUNCTIONAL))) {
+      sl_lin_tp_config.request_callback(nad, data, len);
+    }
+
+    sl_lin_tp_rx_state = SL_LIN_TP_RX_IDLE;
+  }
+
+  if (sl_lin_tp_rx_state == SL_LIN_TP_RX_RECEIVING) {
+    CORE_ENTER_ATOMIC();
+    if ((sl_lin_tp_rx_state == SL_LIN_TP_RX_RECEIVING)
+        && ((sl_sleeptimer_get_tick_count() - sl_lin_tp_rx_tick)
+            > sl_lin_tp_timeout_ticks)) {
+      sl_lin_tp_rx_drop();
+    }
+    CORE_EXIT_ATOMIC();
+  }
+}
+
+sl_status_t sl_lin_tp_send_response(const uint8_t *data, uint16_t len)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (data == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if ((len == 0) || (len > SL_LIN_TP_MAX_LENGTH)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (sl_lin_tp_tx_busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  sl_lin_tp_tx_data = data;
+  sl_lin_tp_tx_length = len;
+  sl_lin_tp_tx_offset = 0;
+  sl_lin_tp_tx_sn = 1;
+  sl_lin_tp_tx_nad = sl_lin_tp_nad;
+  sl_lin_tp_tx_busy = true;
+
+  sl_lin_tp_load_frame();
+
+  // a request received meanwhile has dropped the response
+  CORE_ENTER_ATOMIC();
+  if (sl_lin_tp_tx_busy) {
+    sl_lin_slave_set_endpoint_enabled(SL_LIN_TP_SRF_ID, true);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_lin_tp_send_negative_response(uint8_t sid, uint8_t nrc)
+{
+  if (sl_lin_tp_tx_busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  sl_lin_tp_tx_local[0] = SL_LIN_TP_NEGATIVE_RESPONSE;
+  sl_lin_tp_tx_local[1] = sid;
+  sl_lin_tp_tx_local[2] = nrc;
+
+  return sl_lin_tp_send_response(sl_lin_tp_tx_local, 3);
+}
+
+bool sl_lin_tp_is_response_pending(void)
+{
+  return sl_lin_tp_tx_busy;
+}
+
+uint8_t sl_lin_tp_get_nad(void)
+{
+  return sl_lin_tp_nad;
+}
+
+sl_status_t sl_lin_tp_start_block_transfer(uint8_t *buffer,
+                                           uint16_t block_size,
+                                           sl_lin_tp_block_callback_t callback)
+{
+  CORE_DECLARE_IRQ_STATE;
+  sl_status_t status = SL_STATUS_OK;
+
+  if ((buffer == NULL) || (callback == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (block_size == 0) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (sl_lin_tp_rx_state != SL_LIN_TP_RX_IDLE) {
+    status = SL_STATUS_BUSY;
+  } else {
+    sl_lin_tp_block_size = block_size;
+    sl_lin_tp_block_callback = callback;
+    sl_lin_tp_block_fill = 0;
+    sl_lin_tp_block_next = 0;
+    sl_lin_tp_block_ready = 0;
+    sl_lin_tp_block_dropped = false;
+    sl_lin_tp_block_buffer = buffer;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return status;
+}
+
+void sl_lin_tp_stop_block_transfer(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (sl_lin_tp_rx_streamed) {
+    sl_lin_tp_rx_streamed = false;
+    sl_lin_tp_rx_state = SL_LIN_TP_RX_IDLE;
+  }
+  sl_lin_tp_block_buffer = NULL;
+  sl_lin_tp_block_callback = NULL;
+  sl_lin_tp_block_ready = 0;
+  sl_lin_tp_block_dropped = false;
+  CORE_EXIT_ATOMIC();
+}
@@ -76,6 +76,13 @@
 // <LV_INPUT_TYPE_ENCODER=> Encoder with only Left, Right turn and a Button
 #define LV_INPUT_TYPE   LV_INPUT_TYPE_NONE
 
+// <q LV_INPUT_TOUCH_IRQ> Interrupt driven touch input
+// <i> Sample the touch screen only while it is touched and feed LVGL with
+// <i> the queued points. The input device is idle without a touch.
+// <i> lv_port_indev_process() shall be called from the main loop.
+// <d> 0
+#define LV_INPUT_TOUCH_IRQ   0
+
 // </h>
 
 // <h> Color Settings
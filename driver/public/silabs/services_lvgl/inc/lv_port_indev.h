@@ -19,6 +19,10 @@ extern "C" {
 
 void lv_port_indev_init(void);
 
+/* Take the touch samples of the interrupt driven mode (LV_INPUT_TOUCH_IRQ),
+ * call it from the loop running lv_timer_handler() */
+void lv_port_indev_process(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
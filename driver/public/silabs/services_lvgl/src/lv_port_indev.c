@@ -14,6 +14,14 @@
 #include "lvgl_input.h"
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
 
+#if LV_INPUT_TOUCH_IRQ
+static void touchpad_read_buffered(lv_indev_drv_t *indev_drv,
+                                   lv_indev_data_t *data);
+static void touchpad_wakeup(void);
+static void touchpad_ring_push(const lvgl_input_point_t *point);
+static bool touchpad_ring_pop(lvgl_input_point_t *point);
+#endif
+
 #if 0
 static void mouse_init(void);
 static void mouse_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
@@ -44,6 +52,16 @@ static void encoder_handler(void);
 lv_indev_t *indev_touchpad;
 lvgl_input_t *input_dev = NULL;
 
+#if LV_INPUT_TOUCH_IRQ
+#define TOUCHPAD_RING_SIZE    (16)
+
+/* Samples taken by lv_port_indev_process(), read by LVGL */
+static lvgl_input_point_t touchpad_ring[TOUCHPAD_RING_SIZE];
+static uint8_t touchpad_ring_head = 0;
+static uint8_t touchpad_ring_tail = 0;
+static volatile bool touchpad_wakeup_pending = false;
+#endif
+
 #if 0
 lv_indev_t *indev_mouse;
 #endif
@@ -95,8 +113,23 @@ void lv_port_indev_init(void)
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = touchpad_read;
+
+#if LV_INPUT_TOUCH_IRQ
+  /* Read the queued points only after a touch interrupt */
+  if ((NULL != input_dev) && (NULL != input_dev->driver->irq_init)
+      && (SL_STATUS_OK == input_dev->driver->irq_init(touchpad_wakeup))) {
+    indev_drv.read_cb = touchpad_read_buffered;
+  }
+#endif
+
   indev_touchpad = lv_indev_drv_register(&indev_drv);
 
+#if LV_INPUT_TOUCH_IRQ
+  if (indev_drv.read_cb == touchpad_read_buffered) {
+    lv_timer_pause(indev_touchpad->driver->read_timer);
+  }
+#endif
+
 #if 0
 
   /*------------------
@@ -185,6 +218,24 @@ void lv_port_indev_init(void)
 #endif
 }
 
+void lv_port_indev_process(void)
+{
+#if (LV_INPUT_TYPE == LV_INPUT_TYPE_POINTER) && LV_INPUT_TOUCH_IRQ
+  lvgl_input_point_t point;
+
+  if (!touchpad_wakeup_pending) {
+    return;
+  }
+  touchpad_wakeup_pending = false;
+
+  /* Take the sample here, the bus is not accessed from interrupt context */
+  if (SL_STATUS_OK == input_dev->driver->sample(&point)) {
+    touchpad_ring_push(&point);
+    lv_timer_resume(indev_touchpad->driver->read_timer);
+  }
+#endif
+}
+
 #if (LV_INPUT_TYPE == LV_INPUT_TYPE_POINTER)
 
 /* Will be called by the library to read the touchpad */
@@ -211,6 +262,63 @@ static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
   }
 }
 
+#if LV_INPUT_TOUCH_IRQ
+
+/* Will be called by the library while touch points are queued */
+static void touchpad_read_buffered(lv_indev_drv_t *indev_drv,
+                                   lv_indev_data_t *data)
+{
+  static lvgl_input_point_t last = { 0, 0, false, 0 };
+  lvgl_input_point_t point;
+
+  /* The ring is filled from the same task, no wakeup can be lost here */
+  if (touchpad_ring_pop(&point)) {
+    last = point;
+  } else if (!last.pressed) {
+    lv_timer_pause(indev_drv->read_timer);
+  }
+
+  data->point.x = last.x;
+  data->point.y = last.y;
+  data->state = last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+  data->continue_reading = (touchpad_ring_tail != touchpad_ring_head);
+}
+
+/* Called from interrupt context when a touch sample is due */
+static void touchpad_wakeup(void)
+{
+  touchpad_wakeup_pending = true;
+}
+
+/* Queue a point, a release replaces the newest point when the ring is full */
+static void touchpad_ring_push(const lvgl_input_point_t *point)
+{
+  uint8_t next = (touchpad_ring_head + 1) % TOUCHPAD_RING_SIZE;
+  uint8_t slot = touchpad_ring_head;
+
+  if (next == touchpad_ring_tail) {
+    if (point->pressed) {
+      return;
+    }
+    slot = (touchpad_ring_head + TOUCHPAD_RING_SIZE - 1) % TOUCHPAD_RING_SIZE;
+    next = touchpad_ring_head;
+  }
+  touchpad_ring[slot] = *point;
+  touchpad_ring_head = next;
+}
+
+static bool touchpad_ring_pop(lvgl_input_point_t *point)
+{
+  if (touchpad_ring_tail == touchpad_ring_head) {
+    return false;
+  }
+  *point = touchpad_ring[touchpad_ring_tail];
+  touchpad_ring_tail = (touchpad_ring_tail + 1) % TOUCHPAD_RING_SIZE;
+  return true;
+}
+
+#endif
+
 #if 0
 
 /*------------------
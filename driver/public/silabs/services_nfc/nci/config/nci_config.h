@@ -47,6 +47,19 @@
 // <i> Default: 0
 #define NFC_NCI_TML_DBG       0
 
+// <o NCI_PACKET_QUEUE_SIZE> Number of received packets queued <1-16>
+// <i> Packets are read from the NFCC as soon as it signals them and kept
+// <i> until nci_get_event() hands them out in order. When it's full, the
+// <i> next packet is left in the NFCC and nci_err_rx_queue_full is returned.
+// <i> Default: 4
+#define NCI_PACKET_QUEUE_SIZE     4
+
+// <o NCI_DATA_MESSAGE_MAX_LEN> Maximum length of a segmented data message <255-4096>
+// <i> Size of the buffers used to segment outgoing and to reassemble
+// <i> incoming data messages.
+// <i> Default: 1024
+#define NCI_DATA_MESSAGE_MAX_LEN  1024
+
 // </h>
 // <<< end of configuration section >>>
 
@@ -375,6 +375,7 @@ typedef struct {
 
 typedef struct {
   uint8_t  conn_id;
+  uint16_t len;       /* Length of the reassembled message. */
   uint8_t *payload;
 } nci_rec_data_packet_t;
 
@@ -485,6 +486,8 @@ typedef struct {
 **********************************/
 
 typedef struct {
+  uint8_t  num_of_entries;
+  uint8_t *entries;   /* Conn ID and credits pairs. */
 } nci_core_conn_credits_ntf_t;
 
 /**********************************
@@ -847,6 +850,16 @@ void nci_notify_incoming_packet(void);
  ******************************************************************************/
 bool nci_check_incoming_packet(void);
 
+/***************************************************************************//**
+ * @brief
+ *  Get the event being loaded, without processing incoming packets. For use
+ *  by the proprietary packet parsers.
+ *
+ * @returns
+ *  Pointer to current NCI event.
+ ******************************************************************************/
+nci_evt_t * nci_get_current_event(void);
+
 /***************************************************************************//**
  * @brief
  *  Encode and send a NCI data packet.
@@ -856,9 +869,49 @@ bool nci_check_incoming_packet(void);
  *
  * @returns
  *  Any error code.
+ *
+ * @note
+ *  The packet is segmented if it exceeds the maximum data packet payload size
+ *  of the connection, and held back while the connection has no credits.
  ******************************************************************************/
 nci_err_t nci_data_packet_send(nci_data_packet_t *packet);
 
+/***************************************************************************//**
+ * @brief
+ *  Segment and send a NCI data message.
+ *
+ * @param[in] conn_id
+ *  Connection ID.
+ *
+ * @param[in] data
+ *  Message to be sent, it is copied.
+ *
+ * @param[in] len
+ *  Message length, up to NCI_DATA_MESSAGE_MAX_LEN.
+ *
+ * @returns
+ *  nci_err_none if the message is sent or queued.
+ *  nci_err_busy if the previous message is still waiting for credits.
+ *  nci_err_payload_exceed_mtu if len exceeds NCI_DATA_MESSAGE_MAX_LEN.
+ *
+ * @note
+ *  Segments are sent while the connection has credits. The rest are sent by
+ *  nci_get_event() when CORE_CONN_CREDITS_NTF returns credits.
+ ******************************************************************************/
+nci_err_t nci_data_message_send(uint8_t conn_id,
+                                const uint8_t *data,
+                                uint16_t len);
+
+/***************************************************************************//**
+ * @brief
+ *  Check if a data message is waiting for credits.
+ *
+ * @returns
+ *  true  - if segments of the last message are not sent yet.
+ *  false - otherwise.
+ ******************************************************************************/
+bool nci_data_tx_pending(void);
+
 /***************************************************************************//**
  * @brief
  *  Encode and send CORE_RESET_CMD.
@@ -1051,11 +1104,24 @@ nci_err_t nci_nfcee_mode_set(nci_nfcee_mode_set_cmd_t *cmd);
 
 /***************************************************************************//**
  * @brief
- *  Parse the incoming packet header and send to corresponding processing
- *  functions.
+ *  Read the packets signaled with nci_notify_incoming_packet() into the
+ *  receive queue, up to NCI_PACKET_QUEUE_SIZE packets. Nothing is decoded.
+ *  It can be called from the main loop to empty the NFCC before lengthy
+ *  application work, nci_get_event() calls it too.
  *
  * @returns
- *  Any error code.
+ *  Any error code. nci_err_rx_queue_full if the queue is full and a packet
+ *  is left in the NFCC, it is read once nci_get_event() frees a slot.
+ ******************************************************************************/
+nci_err_t nci_incoming_packet_receive(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Receive the incoming packets, then decode the queued packets in order
+ *  until one of them completes an event.
+ *
+ * @returns
+ *  Any error code. nci_err_rx_queue_full if a packet is left in the NFCC.
  ******************************************************************************/
 nci_err_t nci_incoming_packet_process(void);
 
@@ -43,6 +43,9 @@ typedef enum {
   nci_err_uknown_mt                           = 0x03,
   nci_err_uknown_gid                          = 0x04,
   nci_err_uknown_oid                          = 0x05,
+  nci_err_busy                                = 0x06,
+  nci_err_rx_overflow                         = 0x07,
+  nci_err_rx_queue_full                       = 0x08,
 } nci_err_t;
 
 #endif
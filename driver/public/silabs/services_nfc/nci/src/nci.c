@@ -43,8 +43,48 @@
 #define NCI_PACKET_MAX_LEN \
   (NCI_PACKET_HEADER_LEN + NCI_PACKET_PAYLOAD_MAX_LEN)
 
+#define NCI_CONN_ID_MAX                   (16)
+#define NCI_CONN_ID_STATIC_RF             (0)
+
+/* Credits value of a connection without flow control. */
+#define NCI_CONN_CREDITS_UNLIMITED        (0xFF)
+
+/// Received packets waiting to be loaded to an event.
+typedef struct {
+  uint8_t packets[NCI_PACKET_QUEUE_SIZE][NCI_PACKET_MAX_LEN];
+  uint8_t head;
+  uint8_t tail;
+  uint8_t count;
+  bool    held;       /* Tail packet is referenced by the current event. */
+} nci_packet_queue_t;
+
+/// Outgoing data message, sent in segments as credits allow.
+typedef struct {
+  uint8_t        buff[NCI_DATA_MESSAGE_MAX_LEN];
+  const uint8_t *data;
+  uint16_t       len;
+  uint16_t       offset;
+  uint8_t        conn_id;
+  uint8_t        pbf; /* PBF of the last segment. */
+  bool           pending;
+} nci_data_tx_t;
+
+/// Incoming data message being reassembled.
+typedef struct {
+  uint8_t  buff[NCI_DATA_MESSAGE_MAX_LEN];
+  uint16_t len;
+  uint8_t  conn_id;
+  bool     overflow;
+} nci_data_rx_t;
+
 static uint16_t nci_tml_mtu = NCI_PACKET_MAX_LEN;
-static uint8_t packet_buff[NCI_PACKET_MAX_LEN];
+static uint8_t tx_packet_buff[NCI_PACKET_MAX_LEN];
+static uint8_t *packet_buff;
+static nci_packet_queue_t rx_queue;
+static nci_data_tx_t data_tx;
+static nci_data_rx_t data_rx;
+static uint8_t conn_credits[NCI_CONN_ID_MAX];
+static uint8_t conn_max_payload[NCI_CONN_ID_MAX];
 static nci_evt_t nci_evt;
 static volatile bool packet_ready = false;
 static bool startup_event_passed = false;
@@ -55,6 +95,43 @@ extern nci_err_t nci_incoming_proprietary_packet_rsp_process(
 extern nci_err_t nci_incoming_proprietary_packet_ntf_process(
   uint8_t *packet_buff);
 
+static nci_err_t nci_data_tx_flush(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Reset a connection to no flow control and the maximum payload size.
+ *  Pending transfers on the connection are dropped.
+ ******************************************************************************/
+static void nci_conn_reset(uint8_t conn_id)
+{
+  conn_credits[conn_id] = NCI_CONN_CREDITS_UNLIMITED;
+  conn_max_payload[conn_id] = NCI_PACKET_PAYLOAD_MAX_LEN;
+
+  if (data_tx.conn_id == conn_id) {
+    data_tx.pending = false;
+  }
+  if (data_rx.conn_id == conn_id) {
+    data_rx.len = 0;
+    data_rx.overflow = false;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Set the parameters of an opened connection.
+ ******************************************************************************/
+static void nci_conn_open(uint8_t conn_id,
+                          uint8_t max_payload,
+                          uint8_t credits)
+{
+  nci_conn_reset(conn_id);
+
+  conn_credits[conn_id] = credits;
+  if (max_payload != 0) {
+    conn_max_payload[conn_id] = max_payload;
+  }
+}
+
 /***************************************************************************//**
  * @brief
  *  Initialize NCI.
@@ -62,6 +139,20 @@ extern nci_err_t nci_incoming_proprietary_packet_ntf_process(
 void nci_init(void)
 {
   nci_evt.header = nci_evt_startup;
+
+  rx_queue.head = 0;
+  rx_queue.tail = 0;
+  rx_queue.count = 0;
+  rx_queue.held = false;
+  packet_buff = rx_queue.packets[0];
+
+  data_tx.pending = false;
+  data_rx.len = 0;
+  data_rx.overflow = false;
+
+  for (uint8_t conn_id = 0; conn_id < NCI_CONN_ID_MAX; conn_id++) {
+    nci_conn_reset(conn_id);
+  }
 }
 
 /***************************************************************************//**
@@ -86,6 +177,18 @@ nci_evt_t *nci_get_event(void)
   return &nci_evt;
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Get the event being loaded, without processing incoming packets.
+ *
+ * @returns
+ *  Pointer to current NCI event.
+ ******************************************************************************/
+nci_evt_t *nci_get_current_event(void)
+{
+  return &nci_evt;
+}
+
 /***************************************************************************//**
  * @brief
  *  Calling this function would notify the NCI stack that a packet is incoming.
@@ -126,33 +229,135 @@ nci_err_t nci_control_packet_send(nci_control_packet_t *packet)
     return nci_err_payload_exceed_mtu;
   }
 
-  packet_buff[NCI_PACKET_MT_INDEX] &= ~NCI_PACKET_MT_M;
-  packet_buff[NCI_PACKET_MT_INDEX] += (packet->mt << NCI_PACKET_MT_SHIFT);
-  packet_buff[NCI_PACKET_PBF_INDEX] &= ~NCI_PACKET_PBF_M;
-  packet_buff[NCI_PACKET_PBF_INDEX] += (packet->pbf << NCI_PACKET_PBF_SHIFT);
-  packet_buff[NCI_PACKET_GID_INDEX] &= ~NCI_PACKET_GID_M;
-  packet_buff[NCI_PACKET_GID_INDEX] += (packet->gid << NCI_PACKET_GID_SHIFT);
-  packet_buff[NCI_PACKET_OID_INDEX] &= ~NCI_PACKET_OID_M;
-  packet_buff[NCI_PACKET_OID_INDEX] += (packet->oid << NCI_PACKET_OID_SHIFT);
-  packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX] = packet->payload_len;
-
-  memcpy(&packet_buff[NCI_PACKET_PAYLOAD_START_INDEX],
+  /* Packets are built in their own buffer, so the payload of the current
+   * event stays valid while the application replies to it. */
+  tx_packet_buff[NCI_PACKET_MT_INDEX]
+    = (packet->mt << NCI_PACKET_MT_SHIFT)
+      | (packet->pbf << NCI_PACKET_PBF_SHIFT)
+      | ((packet->gid << NCI_PACKET_GID_SHIFT) & NCI_PACKET_GID_M);
+  tx_packet_buff[NCI_PACKET_OID_INDEX]
+    = (packet->oid << NCI_PACKET_OID_SHIFT) & NCI_PACKET_OID_M;
+  tx_packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX] = packet->payload_len;
+
+  memcpy(&tx_packet_buff[NCI_PACKET_PAYLOAD_START_INDEX],
          packet->payload,
          packet->payload_len);
 
-  nci_tml_err_t nci_tml_err = nci_tml_transceive(packet_buff);
+  nci_tml_err_t nci_tml_err = nci_tml_transceive(tx_packet_buff);
 
   if (nci_tml_err != nci_tml_err_none) {
     return nci_err_tml;
   }
 
   nci_tml_log("NCI TML transceive: ");
-  nci_tml_packet_log(packet_buff, packet_buff[2] + 3);
+  nci_tml_packet_log(tx_packet_buff, tx_packet_buff[2] + 3);
   nci_tml_log_ln(" ");
 
   return nci_err_none;
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Send the segments of the pending data message while the connection has
+ *  credits.
+ *
+ * @returns
+ *  Any error code.
+ ******************************************************************************/
+static nci_err_t nci_data_tx_flush(void)
+{
+  while (data_tx.pending) {
+    uint8_t conn_id = data_tx.conn_id;
+    uint16_t remaining = data_tx.len - data_tx.offset;
+    uint8_t segment_len;
+    uint8_t pbf;
+
+    /* Wait for CORE_CONN_CREDITS_NTF. */
+    if (conn_credits[conn_id] == 0) {
+      return nci_err_none;
+    }
+
+    if (remaining > conn_max_payload[conn_id]) {
+      segment_len = conn_max_payload[conn_id];
+      pbf = nci_pbf_segment_msg;
+    } else {
+      segment_len = (uint8_t)remaining;
+      pbf = data_tx.pbf;
+    }
+
+    tx_packet_buff[NCI_PACKET_MT_INDEX]
+      = (nci_packet_data << NCI_PACKET_MT_SHIFT)
+        | (pbf << NCI_PACKET_PBF_SHIFT)
+        | (conn_id << NCI_PACKET_CONN_ID_SHIFT);
+    tx_packet_buff[NCI_PACKET_OID_INDEX] = 0;
+    tx_packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX] = segment_len;
+
+    memcpy(&tx_packet_buff[NCI_PACKET_PAYLOAD_START_INDEX],
+           &data_tx.data[data_tx.offset],
+           segment_len);
+
+    if (nci_tml_transceive(tx_packet_buff) != nci_tml_err_none) {
+      data_tx.pending = false;
+      return nci_err_tml;
+    }
+
+    nci_tml_log("NCI TML transceive: ");
+    nci_tml_packet_log(tx_packet_buff, tx_packet_buff[2] + 3);
+    nci_tml_log_ln(" ");
+
+    if (conn_credits[conn_id] != NCI_CONN_CREDITS_UNLIMITED) {
+      conn_credits[conn_id]--;
+    }
+
+    data_tx.offset += segment_len;
+    if (data_tx.offset >= data_tx.len) {
+      data_tx.pending = false;
+    }
+  }
+
+  return nci_err_none;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Start sending a data message.
+ ******************************************************************************/
+static nci_err_t nci_data_tx_start(uint8_t conn_id,
+                                   const uint8_t *data,
+                                   uint16_t len,
+                                   uint8_t pbf)
+{
+  nci_err_t err;
+
+  if (data_tx.pending) {
+    return nci_err_busy;
+  }
+
+  if (len > NCI_DATA_MESSAGE_MAX_LEN) {
+    nci_log_ln("NCI error: payload exceed MTU.");
+    return nci_err_payload_exceed_mtu;
+  }
+
+  data_tx.conn_id = conn_id & NCI_PACKET_CONN_ID_M;
+  data_tx.data = data;
+  data_tx.len = len;
+  data_tx.offset = 0;
+  data_tx.pbf = pbf;
+  data_tx.pending = true;
+
+  err = nci_data_tx_flush();
+
+  /* Keep the unsent segments, the caller's buffer may go away. */
+  if (data_tx.pending) {
+    data_tx.len -= data_tx.offset;
+    memcpy(data_tx.buff, &data_tx.data[data_tx.offset], data_tx.len);
+    data_tx.data = data_tx.buff;
+    data_tx.offset = 0;
+  }
+
+  return err;
+}
+
 /***************************************************************************//**
  * @brief
  *  Encode and send a NCI data packet.
@@ -165,35 +370,105 @@ nci_err_t nci_control_packet_send(nci_control_packet_t *packet)
  ******************************************************************************/
 nci_err_t nci_data_packet_send(nci_data_packet_t *packet)
 {
-  if (packet->payload_len > nci_tml_mtu) {
-    nci_log_ln("NCI error: payload exceed MTU.");
-    return nci_err_payload_exceed_mtu;
-  }
+  return nci_data_tx_start(packet->conn_id,
+                           packet->payload,
+                           packet->payload_len,
+                           packet->pbf);
+}
 
-  packet_buff[NCI_PACKET_MT_INDEX] &= ~NCI_PACKET_MT_M;
-  packet_buff[NCI_PACKET_MT_INDEX]
-    += (nci_packet_data << NCI_PACKET_MT_SHIFT);
-  packet_buff[NCI_PACKET_PBF_INDEX] &= ~NCI_PACKET_PBF_M;
-  packet_buff[NCI_PACKET_PBF_INDEX] += (packet->pbf << NCI_PACKET_PBF_SHIFT);
-  packet_buff[NCI_PACKET_CONN_ID_INDEX] &= ~NCI_PACKET_CONN_ID_M;
-  packet_buff[NCI_PACKET_CONN_ID_INDEX]
-    += (packet->conn_id << NCI_PACKET_CONN_ID_SHIFT);
+/***************************************************************************//**
+ * @brief
+ *  Segment and send a NCI data message.
+ *
+ * @param[in] conn_id
+ *  Connection ID.
+ *
+ * @param[in] data
+ *  Message to be sent.
+ *
+ * @param[in] len
+ *  Message length.
+ *
+ * @returns
+ *  Any error code.
+ ******************************************************************************/
+nci_err_t nci_data_message_send(uint8_t conn_id,
+                                const uint8_t *data,
+                                uint16_t len)
+{
+  return nci_data_tx_start(conn_id, data, len, nci_pbf_complete_msg);
+}
 
-  /* Clear previous leftover OLD in the buffer. */
-  packet_buff[NCI_PACKET_OID_INDEX] &= ~NCI_PACKET_OID_M;
-  packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX] = packet->payload_len;
+/***************************************************************************//**
+ * @brief
+ *  Check if a data message is waiting for credits.
+ *
+ * @returns
+ *  true if segments of the last message are not sent yet.
+ ******************************************************************************/
+bool nci_data_tx_pending(void)
+{
+  return data_tx.pending;
+}
 
-  memcpy(&packet_buff[NCI_PACKET_PAYLOAD_START_INDEX],
-         packet->payload,
-         packet->payload_len);
+/***************************************************************************//**
+ * @brief
+ *  Load a complete data message to nci event data.
+ ******************************************************************************/
+static void nci_data_evt_load(uint8_t conn_id, uint8_t *payload, uint16_t len)
+{
+  nci_evt.header = nci_evt_data_packet_rec;
+  nci_evt.data.is_terminator_packet = true;
+  nci_evt.data.len = (len > 0xFF) ? 0xFF : (uint8_t)len;
+  nci_evt.data.payload.nci_data.rec_data_packet.conn_id = conn_id;
+  nci_evt.data.payload.nci_data.rec_data_packet.len = len;
+  nci_evt.data.payload.nci_data.rec_data_packet.payload = payload;
+}
 
-  if (nci_tml_transceive(packet_buff) != nci_tml_err_none) {
-    return nci_err_tml;
+/***************************************************************************//**
+ * @brief
+ *  Process a received data packet. Segments are collected until the packet
+ *  with the PBF bit cleared, then one event carries the whole message.
+ *
+ * @returns
+ *  Any error code.
+ ******************************************************************************/
+static nci_err_t nci_data_packet_process(void)
+{
+  uint8_t conn_id = (packet_buff[NCI_PACKET_CONN_ID_INDEX]
+                     & NCI_PACKET_CONN_ID_M) >> NCI_PACKET_CONN_ID_SHIFT;
+  uint8_t len = packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX];
+  uint8_t *payload = &packet_buff[NCI_PACKET_PAYLOAD_START_INDEX];
+  bool segment = (packet_buff[NCI_PACKET_PBF_INDEX] & NCI_PACKET_PBF_M) != 0;
+
+  /* Unsegmented message, the event points into the packet. */
+  if (!segment && (data_rx.len == 0) && !data_rx.overflow) {
+    nci_data_evt_load(conn_id, payload, len);
+    return nci_err_none;
   }
 
-  nci_tml_log("NCI TML transceive: ");
-  nci_tml_packet_log(packet_buff, packet_buff[2] + 3);
-  nci_tml_log_ln(" ");
+  if ((data_rx.len + len) > NCI_DATA_MESSAGE_MAX_LEN) {
+    data_rx.overflow = true;
+  } else {
+    memcpy(&data_rx.buff[data_rx.len], payload, len);
+    data_rx.len += len;
+  }
+  data_rx.conn_id = conn_id;
+
+  if (segment) {
+    return nci_err_none;
+  }
+
+  if (data_rx.overflow) {
+    nci_log_ln("NCI error: data message exceed reassembly buffer.");
+    data_rx.len = 0;
+    data_rx.overflow = false;
+    return nci_err_rx_overflow;
+  }
+
+  /* The buffer is only written again by the next message's segments. */
+  nci_data_evt_load(conn_id, data_rx.buff, data_rx.len);
+  data_rx.len = 0;
 
   return nci_err_none;
 }
@@ -250,6 +525,10 @@ static void nci_core_reset_rsp_process(void)
     = packet_buff[index++];
   nci_evt.data.payload.nci_data.core_reset_rsp.config_status
     = packet_buff[index];
+
+  for (uint8_t conn_id = 0; conn_id < NCI_CONN_ID_MAX; conn_id++) {
+    nci_conn_reset(conn_id);
+  }
 }
 
 /***************************************************************************//**
@@ -497,6 +776,28 @@ static void nci_core_conn_close_rsp_process(void)
 static void nci_core_conn_credits_ntf_process(void)
 {
   nci_evt.header = nci_evt_core_conn_credits_ntf_rec;
+  nci_evt.data.is_terminator_packet = true;
+  nci_evt.data.len = packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX];
+
+  uint16_t index = NCI_PACKET_PAYLOAD_START_INDEX;
+  uint8_t num_of_entries = packet_buff[index++];
+
+  nci_evt.data.payload.nci_data.core_conn_credits_ntf.num_of_entries
+    = num_of_entries;
+  nci_evt.data.payload.nci_data.core_conn_credits_ntf.entries
+    = &packet_buff[index];
+
+  for (uint8_t i = 0; i < num_of_entries; i++) {
+    uint8_t conn_id = packet_buff[index++] & NCI_PACKET_CONN_ID_M;
+    uint16_t credits = conn_credits[conn_id] + packet_buff[index++];
+
+    if (conn_credits[conn_id] == NCI_CONN_CREDITS_UNLIMITED) {
+      continue;
+    }
+    conn_credits[conn_id] = (credits >= NCI_CONN_CREDITS_UNLIMITED)
+                            ? (NCI_CONN_CREDITS_UNLIMITED - 1)
+                            : (uint8_t)credits;
+  }
 }
 
 // -------------------------------
@@ -839,6 +1140,13 @@ static void nci_rf_intf_activated_ntf_process(void)
   nci_evt.data.payload.nci_data.rf_intf_activated_ntf.len_rf_tech_params
     = packet_buff[index++];
 
+  /* Activation opens the Static RF Connection. */
+  nci_conn_open(NCI_CONN_ID_STATIC_RF,
+                nci_evt.data.payload.nci_data.rf_intf_activated_ntf
+                .max_data_packet_payload_size,
+                nci_evt.data.payload.nci_data.rf_intf_activated_ntf
+                .init_num_of_credits);
+
   switch (nci_evt.data.payload.nci_data.rf_discover_ntf.rf_tech_and_mode) {
     case nci_nfc_a_passive_poll_mode:
       nci_evt.data.payload.nci_data.rf_discover_ntf.rf_tech_param
@@ -913,6 +1221,8 @@ nci_err_t nci_rf_deactivate(nci_rf_deactivate_cmd_t *cmd)
 static void nci_rf_deactivate_rsp_process(void)
 {
   nci_evt.header = nci_evt_rf_deactivate_rsp_rec;
+
+  nci_conn_reset(NCI_CONN_ID_STATIC_RF);
 }
 
 /***************************************************************************//**
@@ -922,6 +1232,8 @@ static void nci_rf_deactivate_rsp_process(void)
 static void nci_rf_deactivate_ntf_process(void)
 {
   nci_evt.header = nci_evt_rf_deactivate_ntf_rec;
+
+  nci_conn_reset(NCI_CONN_ID_STATIC_RF);
 }
 
 // -------------------------------
@@ -1118,60 +1430,74 @@ static void nci_nfcee_mode_set_rsp_process(void)
 
 /***************************************************************************//**
  * @brief
- *  Parse the incoming packet header and send to corresponding processing
- *  functions.
+ *  Free the queue slot of the packet loaded to the previous event.
+ ******************************************************************************/
+static void nci_packet_queue_release(void)
+{
+  if (!rx_queue.held) {
+    return;
+  }
+
+  rx_queue.held = false;
+  rx_queue.tail = (rx_queue.tail + 1) % NCI_PACKET_QUEUE_SIZE;
+  rx_queue.count--;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Read the packets signaled by the NFCC into the queue, until there is no
+ *  packet left or the queue is full. Packets that don't fit are left in the
+ *  NFCC until a slot is released.
  *
  * @returns
- *  Any error code.
+ *  Any error code, nci_err_rx_queue_full if a packet is left in the NFCC.
  ******************************************************************************/
-nci_err_t nci_incoming_packet_process(void)
+nci_err_t nci_incoming_packet_receive(void)
 {
-  if (!packet_ready) {
-    /* Clear nci event header */
-    nci_evt.header = nci_evt_none;
-    return nci_err_none;
-  }
+  while (packet_ready) {
+    if (rx_queue.count >= NCI_PACKET_QUEUE_SIZE) {
+      return nci_err_rx_queue_full;
+    }
 
-  packet_ready = false;
+    /* Clear first, the TML signals again if it has read ahead. */
+    packet_ready = false;
 
-  /* Get packet */
-  nci_tml_err_t nci_tml_err = nci_tml_receive(packet_buff);
-  if (nci_tml_err != nci_tml_err_none) {
-    return nci_err_tml;
-  }
+    uint8_t *packet = rx_queue.packets[rx_queue.head];
 
-  nci_tml_log("NCI TML receive:    ");
-  nci_tml_packet_log(packet_buff, packet_buff[2] + 3);
-  nci_tml_log_ln(" ");
+    /* Get packet */
+    nci_tml_err_t nci_tml_err = nci_tml_receive(packet);
+    if (nci_tml_err != nci_tml_err_none) {
+      return nci_err_tml;
+    }
 
-  /* Clear nci event header */
-  nci_evt.header = nci_evt_none;
+    nci_tml_log("NCI TML receive:    ");
+    nci_tml_packet_log(packet, packet[2] + 3);
+    nci_tml_log_ln(" ");
 
+    rx_queue.head = (rx_queue.head + 1) % NCI_PACKET_QUEUE_SIZE;
+    rx_queue.count++;
+  }
+
+  return nci_err_none;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Parse the header of the packet in packet_buff and send to corresponding
+ *  processing functions.
+ *
+ * @returns
+ *  Any error code.
+ ******************************************************************************/
+static nci_err_t nci_packet_decode(void)
+{
   /* Check Message Type */
   switch ((packet_buff[NCI_PACKET_MT_INDEX] & NCI_PACKET_MT_M)
           >> NCI_PACKET_MT_SHIFT) {
     /* Data packet. */
     case nci_packet_data: {
-      /* Set event header to data packet */
-      nci_evt.header = nci_evt_data_packet_rec;
-
-      /* Set PBF bit */
-      nci_evt.data.is_terminator_packet
-        = !(packet_buff[NCI_PACKET_PBF_INDEX]
-            & NCI_PACKET_PBF_M) ? true : false;
-
-      /* Set data length */
-      nci_evt.data.len = packet_buff[NCI_PACKET_PAYLOAD_LEN_INDEX];
-
-      /* Set connection id */
-      nci_evt.data.payload.nci_data.rec_data_packet.conn_id
-        = ((packet_buff[NCI_PACKET_CONN_ID_INDEX] & NCI_PACKET_CONN_ID_M)
-           >> NCI_PACKET_CONN_ID_SHIFT);
-
-      /* Assign payload pointer */
-      nci_evt.data.payload.nci_data.rec_data_packet.payload
-        = &packet_buff[NCI_PACKET_PAYLOAD_START_INDEX];
-      break;
+      /* Segments are reassembled before an event is loaded. */
+      return nci_data_packet_process();
     }
 
     /* Control Packet - Response Message */
@@ -1308,7 +1634,8 @@ nci_err_t nci_incoming_packet_process(void)
             case nci_oid_core_conn_credits:
               /* Process CORE_CONN_CREDITS_NTF */
               nci_core_conn_credits_ntf_process();
-              break;
+              /* Send the segments waiting for these credits. */
+              return nci_data_tx_flush();
             case nci_oid_core_generic_error:
               /* Process CORE_GENERIC_ERROR_NTF */
               nci_core_generic_error_ntf_process();
@@ -1403,3 +1730,51 @@ nci_err_t nci_incoming_packet_process(void)
   }
   return nci_err_none;
 }
+
+/***************************************************************************//**
+ * @brief
+ *  Receive incoming packets, then decode the queued packets in order until
+ *  one completes an event. The packets behind it stay queued for the next
+ *  call. The payload of the loaded event stays valid until the next call.
+ *
+ * @returns
+ *  Any error code, nci_err_rx_queue_full if a packet is left in the NFCC.
+ ******************************************************************************/
+nci_err_t nci_incoming_packet_process(void)
+{
+  nci_err_t err;
+  nci_err_t receive_err;
+
+  /* The previous event is consumed, its packet can be overwritten. */
+  nci_packet_queue_release();
+
+  /* Clear nci event header */
+  nci_evt.header = nci_evt_none;
+
+  receive_err = nci_incoming_packet_receive();
+
+  while (rx_queue.count > 0) {
+    packet_buff = rx_queue.packets[rx_queue.tail];
+    rx_queue.held = true;
+
+    err = nci_packet_decode();
+
+    if (nci_evt.header != nci_evt_none) {
+      return (err != nci_err_none) ? err : receive_err;
+    }
+
+    /* Data segments and unknown packets do not hold their slot. */
+    nci_packet_queue_release();
+
+    if (err != nci_err_none) {
+      return err;
+    }
+
+    /* A slot is free, read the packet left in the NFCC. */
+    if (receive_err == nci_err_rx_queue_full) {
+      receive_err = nci_incoming_packet_receive();
+    }
+  }
+
+  return receive_err;
+}
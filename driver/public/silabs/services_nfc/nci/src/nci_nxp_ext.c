@@ -81,7 +81,7 @@ nci_err_t nci_proprietary_nxp_act(void)
  *****************************************************************************/
 static void nci_proprietary_nxp_act_rsp_process(uint8_t *packet_buff)
 {
-  nci_evt_t *nci_evt = nci_get_event();
+  nci_evt_t *nci_evt = nci_get_current_event();
 
   nci_evt->header = nci_evt_proprietary_nxp_act_rsp_rec;
   nci_evt->data.is_terminator_packet = true;
@@ -49,6 +49,13 @@
 extern "C" {
 #endif
 
+// -----------------------------------------------------------------------------
+//                       Macros
+// -----------------------------------------------------------------------------
+
+// Maximum number of samples per axis for the median filter
+#define TOUCH_SCREEN_MAX_SAMPLES           16
+
 // -----------------------------------------------------------------------------
 //                       Typedefs
 // -----------------------------------------------------------------------------
@@ -92,6 +99,8 @@ enum TOUCH_SCREEN_CHANNEL {
   TOUCH_SCREEN_CHANNEL_YP,
 };
 
+typedef void (*touch_screen_irq_callback_t)(void *arg);
+
 struct touch_screen_analog_interface {
   void (*delay_10us)(uint32_t idelay);
   void (*set_input)(enum TOUCH_SCREEN_CHANNEL channel);
@@ -99,15 +108,44 @@ struct touch_screen_analog_interface {
   sl_status_t (*adc_start_read)(enum TOUCH_SCREEN_CHANNEL channel);
   uint16_t (*adc_read_u12)(void);
   void (*adc_stop)(void);
+
+  // Optional, acquire count samples of the started channel in one sequence
+  sl_status_t (*adc_read_burst_u12)(uint16_t *buffer, uint8_t count);
+
+  // Optional, bias the panel so that a touch triggers the callback
+  sl_status_t (*touch_irq_enable)(touch_screen_irq_callback_t callback,
+                                  void *arg);
+  void (*touch_irq_disable)(void);
+};
+
+struct touch_screen_filter {
+  // Samples per axis for the median filter, 0 selects the default of 6
+  uint8_t num_samples;
+
+  // IIR weight of a new position is 1 / 2^iir_shift, 0 disables the IIR
+  uint8_t iir_shift;
+
+  // Consecutive touched reads required before a touch is reported
+  uint8_t debounce;
+
+  // Minimum Z1 reading for a touch, 0 always samples the position
+  uint16_t z_threshold;
 };
 
 struct touch_screen {
   const struct touch_screen_config *config;
   const struct touch_screen_analog_interface *aif;
+  struct touch_screen_filter filter;
   uint16_t t_x;
   uint16_t t_y;
   uint16_t t_z1;
   uint16_t t_z2;
+
+  // Filter state, IIR positions in 1/256 ADC units
+  int32_t f_x;
+  int32_t f_y;
+  uint8_t debounce_count;
+  bool touched;
 };
 
 // Touch point properties struct
@@ -169,6 +207,47 @@ void touch_screen_set_config(struct touch_screen *ts,
 sl_status_t touch_screen_get_point(struct touch_screen *ts,
                                    touch_point_t *ts_point);
 
+/***************************************************************************//**
+ * @brief
+ *  Set the sampling filter. A zeroed filter gives the default median of 6
+ *  samples per axis without IIR, debounce or pressure gating.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_PARAMETER if num_samples is too large.
+ ******************************************************************************/
+sl_status_t touch_screen_set_filter(struct touch_screen *ts,
+                                    const struct touch_screen_filter *filter);
+
+/***************************************************************************//**
+ * @brief
+ *  Check whether the last touch_screen_get_point() call detected a touch.
+ *  When it did not, the point keeps its previous coordinates and r_touch is
+ *  set to FLT_MAX. Without pressure gating (z_threshold = 0) every
+ *  successful read counts as a touch.
+ ******************************************************************************/
+bool touch_screen_is_touched(struct touch_screen *ts);
+
+/***************************************************************************//**
+ * @brief
+ *  Arm the touch interrupt. The panel is biased so that pressing it
+ *  triggers the callback once, from interrupt context. Sampling the panel
+ *  disarms it, call again to wait for the next touch.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NOT_SUPPORTED if the interface has no touch interrupt.
+ ******************************************************************************/
+sl_status_t touch_screen_irq_enable(struct touch_screen *ts,
+                                    touch_screen_irq_callback_t callback,
+                                    void *arg);
+
+/***************************************************************************//**
+ * @brief
+ *  Disarm the touch interrupt.
+ ******************************************************************************/
+void touch_screen_irq_disable(struct touch_screen *ts);
+
 #ifdef __cplusplus
 extern "C"
 }
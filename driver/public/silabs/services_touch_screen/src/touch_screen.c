@@ -39,6 +39,7 @@
 // -----------------------------------------------------------------------------
 //                       Includes
 // -----------------------------------------------------------------------------
+#include <float.h>
 #include "touch_screen.h"
 
 // -----------------------------------------------------------------------------
@@ -72,6 +73,79 @@ static void insert_sort(int32_t *array, uint8_t size)
   }
 }
 
+/**************************************************************************//**
+ * Median of the configured number of samples on a channel.
+ *****************************************************************************/
+static int32_t read_channel_median(struct touch_screen *ts,
+                                   enum TOUCH_SCREEN_CHANNEL channel)
+{
+  uint16_t burst[TOUCH_SCREEN_MAX_SAMPLES];
+  int32_t samples[TOUCH_SCREEN_MAX_SAMPLES];
+  uint8_t n = ts->filter.num_samples ? ts->filter.num_samples : NUMSAMPLES;
+  uint8_t i;
+
+  ts->aif->adc_start_read(channel);
+  if ((ts->aif->adc_read_burst_u12 != NULL)
+      && (ts->aif->adc_read_burst_u12(burst, n) == SL_STATUS_OK)) {
+    for (i = 0; i < n; i++) {
+      samples[i] = burst[i];
+    }
+  } else {
+    for (i = 0; i < n; i++) {
+      samples[i] = ts->aif->adc_read_u12();
+    }
+  }
+  ts->aif->adc_stop();
+
+  insert_sort(samples, n);
+  return samples[n / 2];
+}
+
+/**************************************************************************//**
+ * Read pressure, Z1 on XM and Z2 on YP.
+ *****************************************************************************/
+static void read_pressure(struct touch_screen *ts)
+{
+  // XP = 0, YM = 1, XM = Hi-Z& YP as input
+  ts->aif->set_output(TOUCH_SCREEN_CHANNEL_XP, 0);
+  ts->aif->set_output(TOUCH_SCREEN_CHANNEL_YM, 1);
+  ts->aif->set_input(TOUCH_SCREEN_CHANNEL_XM);
+  ts->aif->set_input(TOUCH_SCREEN_CHANNEL_YP);
+
+  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_XM);
+  ts->t_z1 = ts->aif->adc_read_u12();
+  ts->aif->adc_stop();
+
+  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_YP);
+  ts->t_z2 = ts->aif->adc_read_u12();
+  ts->aif->adc_stop();
+}
+
+/**************************************************************************//**
+ * Forget the filter history when the panel is released.
+ *****************************************************************************/
+static void filter_reset(struct touch_screen *ts)
+{
+  ts->touched = false;
+  ts->debounce_count = 0;
+}
+
+/**************************************************************************//**
+ * Apply the IIR to the raw position, seeded by the first touched sample.
+ *****************************************************************************/
+static void filter_position(struct touch_screen *ts)
+{
+  if ((ts->filter.iir_shift == 0) || !ts->touched) {
+    ts->f_x = (int32_t)ts->t_x << 8;
+    ts->f_y = (int32_t)ts->t_y << 8;
+  } else {
+    ts->f_x += (((int32_t)ts->t_x << 8) - ts->f_x) >> ts->filter.iir_shift;
+    ts->f_y += (((int32_t)ts->t_y << 8) - ts->f_y) >> ts->filter.iir_shift;
+    ts->t_x = (uint16_t)(ts->f_x >> 8);
+    ts->t_y = (uint16_t)(ts->f_y >> 8);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //                       Public Function
 // -----------------------------------------------------------------------------
@@ -93,14 +167,39 @@ void touch_screen_set_config(struct touch_screen *ts,
   ts->config = config;
 }
 
+/**************************************************************************//**
+ * Set the sampling filter.
+ *****************************************************************************/
+sl_status_t touch_screen_set_filter(struct touch_screen *ts,
+                                    const struct touch_screen_filter *filter)
+{
+  if (filter->num_samples > TOUCH_SCREEN_MAX_SAMPLES) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  ts->filter = *filter;
+  filter_reset(ts);
+  return SL_STATUS_OK;
+}
+
 /**************************************************************************//**
  * Get touch points whenever a touch is detected on the screen.
  *****************************************************************************/
 sl_status_t touch_screen_read_touch(struct touch_screen *ts)
 {
-  int32_t samples[NUMSAMPLES];
   int32_t ts_data;
-  int i;
+
+  // Biasing the panel for sampling would trigger the touch interrupt
+  if (ts->aif->touch_irq_disable != NULL) {
+    ts->aif->touch_irq_disable();
+  }
+
+  // A touch connects the plates, without one Z1 stays near zero
+  if (ts->filter.z_threshold != 0) {
+    read_pressure(ts);
+    if (ts->t_z1 < ts->filter.z_threshold) {
+      return SL_STATUS_NOT_READY;
+    }
+  }
 
   // XM = 0, XP = 1, YM & YP as input
   ts->aif->set_output(TOUCH_SCREEN_CHANNEL_XM, 0);
@@ -111,14 +210,7 @@ sl_status_t touch_screen_read_touch(struct touch_screen *ts)
   // Fast ARM chips need to allow voltages to settle
   ts->aif->delay_10us(2);
 
-  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_YP);
-  for (i = 0; i < NUMSAMPLES; i++) {
-    samples[i] = ts->aif->adc_read_u12();
-  }
-  ts->aif->adc_stop();
-
-  insert_sort(samples, NUMSAMPLES);
-  ts_data = samples[NUMSAMPLES / 2];
+  ts_data = read_channel_median(ts, TOUCH_SCREEN_CHANNEL_YP);
   if (ts_data > 4095) {
     return SL_STATUS_INVALID_RANGE;
   }
@@ -134,33 +226,16 @@ sl_status_t touch_screen_read_touch(struct touch_screen *ts)
   // Fast ARM chips need to allow voltages to settle
   ts->aif->delay_10us(2);
 
-  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_XM);
-  for (i = 0; i < NUMSAMPLES; i++) {
-    samples[i] = ts->aif->adc_read_u12();
-  }
-  ts->aif->adc_stop();
-
-  insert_sort(samples, NUMSAMPLES);
-  ts_data = samples[NUMSAMPLES / 2];
+  ts_data = read_channel_median(ts, TOUCH_SCREEN_CHANNEL_XM);
   if (ts_data > 4095) {
     return SL_STATUS_INVALID_RANGE;
   }
 
   ts->t_y = (4096 - ts_data);
 
-  // XP = 0, YM = 1, XM = Hi-Z& YP as input
-  ts->aif->set_output(TOUCH_SCREEN_CHANNEL_XP, 0);
-  ts->aif->set_output(TOUCH_SCREEN_CHANNEL_YM, 1);
-  ts->aif->set_input(TOUCH_SCREEN_CHANNEL_XM);
-  ts->aif->set_input(TOUCH_SCREEN_CHANNEL_YP);
-
-  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_XM);
-  ts->t_z1 = ts->aif->adc_read_u12();
-  ts->aif->adc_stop();
-
-  ts->aif->adc_start_read(TOUCH_SCREEN_CHANNEL_YP);
-  ts->t_z2 = ts->aif->adc_read_u12();
-  ts->aif->adc_stop();
+  if (ts->filter.z_threshold == 0) {
+    read_pressure(ts);
+  }
 
   return SL_STATUS_OK;
 }
@@ -173,10 +248,24 @@ sl_status_t touch_screen_get_point(struct touch_screen *ts,
   sl_status_t status;
 
   status = touch_screen_read_touch(ts);
+  if (SL_STATUS_NOT_READY == status) {
+    // Not touched, keep the last coordinates
+    filter_reset(ts);
+    ts_point->r_touch = FLT_MAX;
+    return SL_STATUS_OK;
+  }
   if (SL_STATUS_OK != status) {
     return status;
   }
 
+  if (ts->debounce_count < ts->filter.debounce) {
+    ts->debounce_count++;
+    ts_point->r_touch = FLT_MAX;
+    return SL_STATUS_OK;
+  }
+  filter_position(ts);
+  ts->touched = true;
+
   if (ts->config->xy_swap) {
     x = ts->t_y;
     y = ts->t_x;
@@ -215,3 +304,34 @@ sl_status_t touch_screen_get_point(struct touch_screen *ts,
 
   return SL_STATUS_OK;
 }
+
+/**************************************************************************//**
+ * Check whether the last read detected a touch.
+ *****************************************************************************/
+bool touch_screen_is_touched(struct touch_screen *ts)
+{
+  return ts->touched;
+}
+
+/**************************************************************************//**
+ * Arm the touch interrupt.
+ *****************************************************************************/
+sl_status_t touch_screen_irq_enable(struct touch_screen *ts,
+                                    touch_screen_irq_callback_t callback,
+                                    void *arg)
+{
+  if (ts->aif->touch_irq_enable == NULL) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  return ts->aif->touch_irq_enable(callback, arg);
+}
+
+/**************************************************************************//**
+ * Disarm the touch interrupt.
+ *****************************************************************************/
+void touch_screen_irq_disable(struct touch_screen *ts)
+{
+  if (ts->aif->touch_irq_disable != NULL) {
+    ts->aif->touch_irq_disable();
+  }
+}
@@ -42,6 +42,8 @@
 #include "em_cmu.h"
 #include "em_gpio.h"
 #include "em_iadc.h"
+#include "dmadrv.h"
+#include "gpiointerrupt.h"
 #include "sl_udelay.h"
 #include "touch_screen.h"
 #include "touch_screen_config.h"
@@ -71,6 +73,10 @@ static void set_output(enum TOUCH_SCREEN_CHANNEL channel, uint8_t value);
 static sl_status_t adc_start_read(enum TOUCH_SCREEN_CHANNEL channel);
 static uint16_t adc_read_u12(void);
 static void adc_stop(void);
+static sl_status_t adc_read_burst_u12(uint16_t *buffer, uint8_t count);
+static sl_status_t touch_irq_enable(touch_screen_irq_callback_t callback,
+                                    void *arg);
+static void touch_irq_disable(void);
 
 // -----------------------------------------------------------------------------
 //                       Local Variables
@@ -96,9 +102,23 @@ static const struct touch_screen_analog_interface ts_analog_interface = {
   .set_output = set_output,
   .adc_start_read = adc_start_read,
   .adc_read_u12 = adc_read_u12,
-  .adc_stop = adc_stop
+  .adc_stop = adc_stop,
+  .adc_read_burst_u12 = adc_read_burst_u12,
+  .touch_irq_enable = touch_irq_enable,
+  .touch_irq_disable = touch_irq_disable
 };
 
+// Input of the last adc_start_read(), repeated in the burst scan table
+static IADC_PosInput_t adc_pos_input = iadcPosInputGnd;
+
+static unsigned int adc_dma_channel;
+static bool adc_dma_allocated = false;
+static uint32_t adc_burst_buffer[TOUCH_SCREEN_MAX_SAMPLES];
+static LDMA_Descriptor_t adc_dma_desc;
+
+static touch_screen_irq_callback_t touch_irq_callback = NULL;
+static void *touch_irq_arg = NULL;
+
 // -----------------------------------------------------------------------------
 //                       Local Functions
 // -----------------------------------------------------------------------------
@@ -219,6 +239,7 @@ static sl_status_t adc_init(GPIO_Port_TypeDef port,
     return SL_STATUS_FAIL;
   }
   singleInput.negInput = iadcNegInputGnd;
+  adc_pos_input = singleInput.posInput;
 
   // Allocate the analog bus for ADC inputs
   if (SL_STATUS_OK != allocate_analog_bus_even0(port)) {
@@ -342,6 +363,116 @@ static void adc_stop(void)
   adc_deinit();
 }
 
+/*******************************************************************************
+ * Convert the started channel count times with one scan sequence, the LDMA
+ * drains the 4 entry scan FIFO into adc_burst_buffer.
+ ******************************************************************************/
+static sl_status_t adc_read_burst_u12(uint16_t *buffer, uint8_t count)
+{
+  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
+  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+  LDMA_TransferCfg_t xfer =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SCAN);
+  bool done = false;
+  uint8_t i;
+
+  if ((count == 0) || (count > TOUCH_SCREEN_MAX_SAMPLES)
+      || (count > IADC0_ENTRIES) || (adc_pos_input == iadcPosInputGnd)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (!adc_dma_allocated) {
+    DMADRV_Init();
+    if (DMADRV_AllocateChannel(&adc_dma_channel, NULL)
+        != ECODE_EMDRV_DMADRV_OK) {
+      return SL_STATUS_FAIL;
+    }
+    adc_dma_allocated = true;
+  }
+
+  for (i = 0; i < count; i++) {
+    scanTable.entries[i].posInput = adc_pos_input;
+    scanTable.entries[i].negInput = iadcNegInputGnd;
+    scanTable.entries[i].includeInScan = true;
+  }
+  initScan.dataValidLevel = iadcFifoCfgDvl1;
+  initScan.fifoDmaWakeup = true;
+  IADC_initScan(IADC0, &initScan, &scanTable);
+
+  adc_dma_desc = (LDMA_Descriptor_t)
+                 LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&IADC0->SCANFIFODATA,
+                                                 adc_burst_buffer,
+                                                 count);
+  adc_dma_desc.xfer.size = ldmaCtrlSizeWord;
+  if (DMADRV_LdmaStartTransfer((int)adc_dma_channel,
+                               &xfer,
+                               &adc_dma_desc,
+                               NULL,
+                               NULL) != ECODE_EMDRV_DMADRV_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  IADC_command(IADC0, iadcCmdStartScan);
+
+  // A few microseconds at the IADC conversion rate
+  while (!done) {
+    DMADRV_TransferDone(adc_dma_channel, &done);
+  }
+
+  for (i = 0; i < count; i++) {
+    buffer[i] = (uint16_t)(adc_burst_buffer[i] & 0x0FFF);
+  }
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * GPIO interrupt on XP, one shot.
+ ******************************************************************************/
+static void touch_irq_handler(uint8_t int_no)
+{
+  (void)int_no;
+
+  touch_irq_disable();
+  if (touch_irq_callback != NULL) {
+    touch_irq_callback(touch_irq_arg);
+  }
+}
+
+/*******************************************************************************
+ * YM is driven low and XP is pulled up, a touch connects the plates and
+ * pulls XP low.
+ ******************************************************************************/
+static sl_status_t touch_irq_enable(touch_screen_irq_callback_t callback,
+                                    void *arg)
+{
+  touch_irq_callback = callback;
+  touch_irq_arg = arg;
+
+  set_input(TOUCH_SCREEN_CHANNEL_XM);
+  set_input(TOUCH_SCREEN_CHANNEL_YP);
+  set_output(TOUCH_SCREEN_CHANNEL_YM, 0);
+  GPIO_PinModeSet(TOUCHSCREEN_XP_PORT,
+                  TOUCHSCREEN_XP_PIN,
+                  gpioModeInputPullFilter,
+                  1);
+
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(TOUCHSCREEN_XP_PIN, touch_irq_handler);
+  GPIO_ExtIntConfig(TOUCHSCREEN_XP_PORT,
+                    TOUCHSCREEN_XP_PIN,
+                    TOUCHSCREEN_XP_PIN,
+                    false,
+                    true,
+                    true);
+  return SL_STATUS_OK;
+}
+
+static void touch_irq_disable(void)
+{
+  GPIO_IntDisable(1 << TOUCHSCREEN_XP_PIN);
+  GPIO_IntClear(1 << TOUCHSCREEN_XP_PIN);
+}
+
 // -----------------------------------------------------------------------------
 //                       Public Function
 // -----------------------------------------------------------------------------
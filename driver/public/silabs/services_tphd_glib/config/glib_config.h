@@ -0,0 +1,59 @@
+/***************************************************************************//**
+ * @file glib_config.h
+ * @brief Configuration of the Silicon Labs Graphics Library
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#ifndef GLIB_CONFIG_H
+#define GLIB_CONFIG_H
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+// <h> Text rendering
+// <o GLIB_GLYPH_CACHE_SIZE> Glyph cache entries <0-64>
+// <i> Glyphs are rasterized into rectangles before they are drawn, the
+// <i> rectangles of the most recently used glyphs are kept for any text
+// <i> size and color. 0 disables the cache, glyphs are then drawn pixel
+// <i> by pixel. Without the fill_rect hook of the display driver they are
+// <i> always drawn pixel by pixel.
+// <i> Default: 16
+#define GLIB_GLYPH_CACHE_SIZE         16
+
+// <o GLIB_GLYPH_CACHE_RECTS> Rectangles per cached glyph <8-128>
+// <i> Each rectangle takes 4 bytes, glyphs made of more rectangles are
+// <i> drawn without the cache.
+// <i> Default: 24
+#define GLIB_GLYPH_CACHE_RECTS        24
+// </h> end Text rendering
+
+// <<< end of configuration section >>>
+
+#endif // GLIB_CONFIG_H
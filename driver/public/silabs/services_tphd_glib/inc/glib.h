@@ -273,6 +273,8 @@ glib_status_t glib_draw_rect(glib_context_t *g_context,
  *    @brief    Fill a rectangle completely with one color. Update in subclasses
  *   if
  *    desired!
+ *    The rectangle is clipped and filled by the display driver in one go if
+ *    it provides a fill_rect function, otherwise it's drawn line by line.
  *     @param    x   Top left corner x coordinate
  *     @param    y   Top left corner y coordinate
  *     @param    w   Width in pixels
@@ -38,6 +38,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include "glib.h"
+#include "glib_config.h"
 #include "sl_sleeptimer.h"
 #include "oled_display.h"
 
@@ -48,10 +49,10 @@
     b = t;                 \
   }
 #define draw_vline(g, x, y, h, color) \
-  glib_draw_line(g, x, y, x, y + h - 1, color)
+  glib_fill_rect(g, x, y, 1, h, color)
 
 #define draw_hline(g, x, y, w, color) \
-  glib_draw_line(g, x, y, x + w - 1, y, color);
+  glib_fill_rect(g, x, y, w, 1, color)
 
 #define write_string(ptr)  { while (*ptr) {                                   \
                                glib_write_char(shift_data.context, *ptr++); } \
@@ -69,6 +70,64 @@ typedef struct {
   int16_t y;
 } glib_shift_string_data_t;
 
+#if GLIB_GLYPH_CACHE_SIZE > 0
+/// Most runs of a scanline merged with the next scanline while rasterizing
+#define GLIB_GLYPH_MAX_RUNS       16
+
+/// Flag of glib_glyph_rect_t.h for the foreground color
+#define GLIB_GLYPH_RECT_FG        0x80
+#define GLIB_GLYPH_RECT_HEIGHT    0x7F
+
+/// Run of equal pixels on a scanline of a glyph being rasterized
+typedef struct {
+  uint8_t x;
+  uint8_t y;
+  uint8_t w;
+  uint8_t h;
+  bool fg;
+  bool merged;  ///< Continued on the current scanline
+} glyph_run_t;
+
+/// Callback receiving the rectangles of a rasterized glyph
+typedef void (*glyph_rect_fn_t)(void *arg,
+                                int16_t x, int16_t y,
+                                uint8_t w, uint8_t h,
+                                bool fg);
+
+/// State of a glyph being drawn
+typedef struct {
+  glib_context_t *g_context;
+  int16_t x;
+  int16_t y;
+  uint8_t size_x;
+  uint8_t size_y;
+  uint16_t color;
+  uint16_t bg;
+  glib_status_t status;
+} glyph_draw_t;
+
+/// Rectangle of a cached glyph in font pixels
+typedef struct {
+  int8_t x;     ///< Relative to the cursor position
+  int8_t y;     ///< Relative to the cursor position
+  uint8_t w;
+  uint8_t h;    ///< Height, GLIB_GLYPH_RECT_FG is set for the foreground
+} glib_glyph_rect_t;
+
+/// Pre-rasterized glyph, independent of the text size and colors
+typedef struct {
+  const glib_gfx_font_t *font;  ///< NULL for the built-in font
+  uint32_t last_used;           ///< 0 if the entry is free
+  uint8_t c;
+  uint8_t count;
+  bool overflow;                ///< Doesn't fit, drawn without the cache
+  glib_glyph_rect_t rect[GLIB_GLYPH_CACHE_RECTS];
+} glib_glyph_cache_entry_t;
+
+static glib_glyph_cache_entry_t glyph_cache[GLIB_GLYPH_CACHE_SIZE];
+static uint32_t glyph_cache_clock;
+#endif
+
 const oled_display_t *oled_display = NULL;
 static glib_shift_string_data_t shift_data;
 
@@ -581,6 +640,72 @@ glib_status_t glib_draw_rect(glib_context_t *g_context,
   return status;
 }
 
+/***************************************************************************//**
+ *  @brief
+ *  Clip a rectangle to the display, clipped pixels are not reported, as for
+ *  lines.
+ *
+ *  @return
+ *  false if nothing of the rectangle is left.
+ ******************************************************************************/
+static bool clip_rect(const glib_context_t *g_context,
+                      int16_t *x, int16_t *y,
+                      int16_t *w, int16_t *h)
+{
+  if (*x < 0) {
+    *w += *x;
+    *x = 0;
+  }
+  if (*y < 0) {
+    *h += *y;
+    *y = 0;
+  }
+  if ((*x + *w) > g_context->width) {
+    *w = g_context->width - *x;
+  }
+  if ((*y + *h) > g_context->height) {
+    *h = g_context->height - *y;
+  }
+  return (*w > 0) && (*h > 0);
+}
+
+/***************************************************************************//**
+ *  @brief
+ *  Fill a clipped rectangle with the fill_rect function of the driver, the
+ *  driver fills whole spans at once.
+ ******************************************************************************/
+static glib_status_t fill_span(const glib_context_t *g_context,
+                               int16_t x, int16_t y,
+                               int16_t w, int16_t h,
+                               uint16_t color)
+{
+  int16_t t;
+
+  switch (g_context->rotation) {
+    case 1:
+      t = x;
+      x = oled_display->width - y - h;
+      y = t;
+      swap_int16_t(w, h);
+      break;
+    case 2:
+      x = oled_display->width - x - w;
+      y = oled_display->height - y - h;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = oled_display->height - t - w;
+      swap_int16_t(w, h);
+      break;
+  }
+
+  if (SL_STATUS_OK == oled_display->driver->fill_rect(x, y, w, h, color)) {
+    return GLIB_OK;
+  }
+  return GLIB_ERROR_IO;
+}
+
 /***************************************************************************//**
  *    @brief    Fill a rectangle completely with one color. Update in subclasses
  *   if
@@ -598,10 +723,32 @@ glib_status_t glib_fill_rect(glib_context_t *g_context,
 {
   glib_status_t status = GLIB_OK;
 
-  for (int16_t i = x; i < x + w; i++) {
-    status |= draw_vline(g_context, i, y, h, color);
+  // Check oled driver
+  if (oled_display == NULL) {
+    return GLIB_ERROR_DRIVER_NOT_INITIALIZED;
+  }
+
+  /* Check arguments */
+  if (g_context == NULL) {
+    return GLIB_ERROR_INVALID_ARGUMENT;
   }
-  return status;
+
+  if (!clip_rect(g_context, &x, &y, &w, &h)) {
+    return GLIB_OK;
+  }
+
+  if (oled_display->driver->fill_rect == NULL) {
+    // A horizontal line is drawn as one line, anything else column by column
+    if (h == 1) {
+      return glib_draw_line(g_context, x, y, x + w - 1, y, color);
+    }
+    for (int16_t i = x; i < x + w; i++) {
+      status |= glib_draw_line(g_context, i, y, i, y + h - 1, color);
+    }
+    return status;
+  }
+
+  return fill_span(g_context, x, y, w, h, color);
 }
 
 /***************************************************************************//**
@@ -1030,54 +1177,234 @@ static const unsigned char font_5x7[] = {
   0x3C, 0x00, 0x00, 0x00, 0x00, 0x00   // #255 NBSP
 };
 
+#if GLIB_GLYPH_CACHE_SIZE > 0
 /***************************************************************************//**
  *  @brief
- *  Draws a char using the font supplied with the library.
- *
- *  @param g_context
- *  Pointer to the glib_context_t
- *
- *  @param my_char
- *  Char to be drawn
+ *  Rasterize a glyph into rectangles.
  *
- *  @param x
- *  Start x-coordinate for the char (Upper left corner)
+ *  The runs of equal pixels on a scanline are merged with the same runs of
+ *  the following scanlines, each rectangle is passed to the callback once,
+ *  in font pixels relative to the cursor position. Background rectangles are
+ *  only produced for the built-in font, GFX fonts are transparent.
+ ******************************************************************************/
+static void rasterize_glyph(const glib_gfx_font_t *font,
+                            unsigned char c,
+                            glyph_rect_fn_t fn,
+                            void *arg)
+{
+  glyph_run_t open[GLIB_GLYPH_MAX_RUNS];
+  glyph_run_t next[GLIB_GLYPH_MAX_RUNS];
+  uint8_t open_count = 0;
+  const uint8_t *bitmap;
+  uint16_t bo = 0;
+  uint8_t w, h;
+  int8_t xo = 0, yo = 0;
+
+  if (font == NULL) {
+    bitmap = &font_5x7[c * 5];
+    w = 6; // The last column is the spacing
+    h = 8;
+  } else {
+    const glib_gfx_glyph_t *glyph = &font->glyph[c - font->first];
+
+    bitmap = font->bitmap;
+    bo = glyph->bitmap_offset;
+    w = glyph->width;
+    h = glyph->height;
+    xo = glyph->x_offset;
+    yo = glyph->y_offset;
+  }
+
+  for (uint8_t row = 0; row < h; row++) {
+    uint8_t next_count = 0;
+
+    for (uint8_t col = 0; col < w; ) {
+      uint8_t start = col;
+      bool fg = false;
+
+      // Find the end of the run
+      do {
+        bool bit;
+
+        if (font == NULL) {
+          bit = (col < 5) && ((bitmap[col] >> row) & 1);
+        } else {
+          uint16_t i = (uint16_t)row * w + col;
+          bit = (bitmap[bo + (i >> 3)] >> (7 - (i & 7))) & 1;
+        }
+        if (col == start) {
+          fg = bit;
+        } else if (bit != fg) {
+          break;
+        }
+      } while (++col < w);
+
+      if (!fg && (font != NULL)) {
+        continue;
+      }
+
+      // Extend the same run of the previous scanline
+      glyph_run_t *run = NULL;
+      for (uint8_t j = 0; j < open_count; j++) {
+        if (!open[j].merged && (open[j].x == start)
+            && (open[j].w == col - start) && (open[j].fg == fg)) {
+          open[j].merged = true;
+          run = &open[j];
+          break;
+        }
+      }
+
+      if (next_count < GLIB_GLYPH_MAX_RUNS) {
+        if (run != NULL) {
+          next[next_count] = *run;
+          next[next_count].h++;
+        } else {
+          next[next_count].x = start;
+          next[next_count].y = row;
+          next[next_count].w = col - start;
+          next[next_count].h = 1;
+          next[next_count].fg = fg;
+        }
+        next[next_count].merged = false;
+        next_count++;
+      } else {
+        // Too many runs on this scanline, the run is not merged further
+        if (run != NULL) {
+          fn(arg, xo + run->x, yo + run->y, run->w, run->h + 1, fg);
+        } else {
+          fn(arg, xo + start, yo + row, col - start, 1, fg);
+        }
+      }
+    }
+
+    // Runs not continued on this scanline are complete
+    for (uint8_t j = 0; j < open_count; j++) {
+      if (!open[j].merged) {
+        fn(arg, xo + open[j].x, yo + open[j].y,
+           open[j].w, open[j].h, open[j].fg);
+      }
+    }
+    memcpy(open, next, next_count * sizeof(glyph_run_t));
+    open_count = next_count;
+  }
+
+  for (uint8_t j = 0; j < open_count; j++) {
+    fn(arg, xo + open[j].x, yo + open[j].y,
+       open[j].w, open[j].h, open[j].fg);
+  }
+}
+
+/***************************************************************************//**
+ *  @brief
+ *  Draw a rectangle of a rasterized glyph, scaled to the text size.
+ ******************************************************************************/
+static void draw_glyph_rect(void *arg,
+                            int16_t x, int16_t y,
+                            uint8_t w, uint8_t h,
+                            bool fg)
+{
+  glyph_draw_t *draw = (glyph_draw_t *)arg;
+  uint16_t color = fg ? draw->color : draw->bg;
+  int16_t rx = draw->x + x * draw->size_x;
+  int16_t ry = draw->y + y * draw->size_y;
+  int16_t rw = w * draw->size_x;
+  int16_t rh = h * draw->size_y;
+
+  if (!fg && (draw->bg == draw->color)) {
+    return;
+  }
+  if (!clip_rect(draw->g_context, &rx, &ry, &rw, &rh)) {
+    return;
+  }
+  draw->status |= fill_span(draw->g_context, rx, ry, rw, rh, color);
+}
+
+/***************************************************************************//**
+ *  @brief
+ *  Store a rectangle of a rasterized glyph in a cache entry.
+ ******************************************************************************/
+static void store_glyph_rect(void *arg,
+                             int16_t x, int16_t y,
+                             uint8_t w, uint8_t h,
+                             bool fg)
+{
+  glib_glyph_cache_entry_t *entry = (glib_glyph_cache_entry_t *)arg;
+
+  if ((entry->count >= GLIB_GLYPH_CACHE_RECTS)
+      || (x < INT8_MIN) || (x > INT8_MAX)
+      || (y < INT8_MIN) || (y > INT8_MAX)
+      || (h > GLIB_GLYPH_RECT_HEIGHT)) {
+    // The glyph doesn't fit, it's drawn without the cache
+    entry->overflow = true;
+    return;
+  }
+
+  entry->rect[entry->count].x = (int8_t)x;
+  entry->rect[entry->count].y = (int8_t)y;
+  entry->rect[entry->count].w = w;
+  entry->rect[entry->count].h = h | (fg ? GLIB_GLYPH_RECT_FG : 0);
+  entry->count++;
+}
+
+/***************************************************************************//**
+ *  @brief
+ *  Look up a glyph in the cache, it's rasterized into the least recently
+ *  used entry on a miss.
  *
- *  @param y
- *  Start y-coordinate for the char (Upper left corner)
+ *  Glyphs without any rectangle, like spaces of GFX fonts, and glyphs that
+ *  don't fit into an entry are cached too, so they aren't rasterized again
+ *  on every draw. The latter have the overflow flag set and no rectangles.
  *
  *  @return
- *  Returns GLIB_OK on success, or else error code
+ *  The cache entry.
  ******************************************************************************/
-glib_status_t glib_draw_char(glib_context_t *g_context,
-                             int16_t x, int16_t y,
-                             unsigned char c,
-                             uint16_t color, uint16_t bg,
-                             uint8_t size_x, uint8_t size_y)
+static glib_glyph_cache_entry_t *glyph_cache_get(const glib_gfx_font_t *font,
+                                                 unsigned char c)
 {
-  glib_status_t status = GLIB_OK;
+  glib_glyph_cache_entry_t *victim = &glyph_cache[0];
 
-  // Check oled driver
-  if (oled_display == NULL) {
-    return GLIB_ERROR_DRIVER_NOT_INITIALIZED;
+  for (uint8_t i = 0; i < GLIB_GLYPH_CACHE_SIZE; i++) {
+    glib_glyph_cache_entry_t *entry = &glyph_cache[i];
+
+    if ((entry->last_used != 0) && (entry->font == font) && (entry->c == c)) {
+      entry->last_used = ++glyph_cache_clock;
+      return entry;
+    }
+    if (entry->last_used < victim->last_used) {
+      victim = entry;
+    }
   }
 
-  /* Check arguments */
-  if (g_context == NULL) {
-    return GLIB_ERROR_INVALID_ARGUMENT;
+  victim->font = font;
+  victim->c = c;
+  victim->count = 0;
+  victim->overflow = false;
+  rasterize_glyph(font, c, store_glyph_rect, victim);
+  if (victim->overflow) {
+    victim->count = 0;
   }
+  victim->last_used = ++glyph_cache_clock;
 
-  if (!g_context->font) { // 'Classic' built-in font
-    if ((x >= oled_display->width)                 // Clip right
-        || (y >= oled_display->height)             // Clip bottom
-        || ((x + 6 * size_x - 1) < 0) // Clip left
-        || ((y + 8 * size_y - 1) < 0)) { // Clip top
-      return GLIB_ERROR_INVALID_REGION;
-    }
+  return victim;
+}
+#endif
 
-    if (c >= 176) {
-      c++; // Handle 'classic' charset behavior
-    }
+/***************************************************************************//**
+ *  @brief
+ *  Draw a char pixel by pixel.
+ *
+ *  Used without the glyph cache or without the fill_rect hook of the driver,
+ *  the glyph rectangles are only faster if they are filled as spans.
+ ******************************************************************************/
+static glib_status_t draw_char_pixels(glib_context_t *g_context,
+                                      int16_t x, int16_t y,
+                                      unsigned char c,
+                                      uint16_t color, uint16_t bg,
+                                      uint8_t size_x, uint8_t size_y)
+{
+  glib_status_t status = GLIB_OK;
+
+  if (!g_context->font) { // 'Classic' built-in font
     for (int8_t i = 0; i < 5; i++) { // Char bitmap = 5 columns
       uint8_t line = font_5x7[c * 5 + i];
       for (int8_t j = 0; j < 8; j++, line >>= 1) {
@@ -1085,10 +1412,10 @@ glib_status_t glib_draw_char(glib_context_t *g_context,
           if ((size_x == 1) && (size_y == 1)) {
             status |= glib_draw_pixel(g_context, x + i, y + j, color);
           } else {
-            glib_fill_rect(g_context,
-                           x + i * size_x, y + j * size_y,
-                           size_x, size_y,
-                           color);
+            status |= glib_fill_rect(g_context,
+                                     x + i * size_x, y + j * size_y,
+                                     size_x, size_y,
+                                     color);
           }
         } else if (bg != color) {
           if ((size_x == 1) && (size_y == 1)) {
@@ -1147,7 +1474,7 @@ glib_status_t glib_draw_char(glib_context_t *g_context,
                                      y + (yo16 + yy) * size_y,
                                      size_x,
                                      size_y,
-                                     bg);
+                                     color);
           }
         }
         bits <<= 1;
@@ -1157,6 +1484,93 @@ glib_status_t glib_draw_char(glib_context_t *g_context,
   return status;
 }
 
+/***************************************************************************//**
+ *  @brief
+ *  Draws a char using the font supplied with the library.
+ *
+ *  @param g_context
+ *  Pointer to the glib_context_t
+ *
+ *  @param my_char
+ *  Char to be drawn
+ *
+ *  @param x
+ *  Start x-coordinate for the char (Upper left corner)
+ *
+ *  @param y
+ *  Start y-coordinate for the char (Upper left corner)
+ *
+ *  @return
+ *  Returns GLIB_OK on success, or else error code
+ ******************************************************************************/
+glib_status_t glib_draw_char(glib_context_t *g_context,
+                             int16_t x, int16_t y,
+                             unsigned char c,
+                             uint16_t color, uint16_t bg,
+                             uint8_t size_x, uint8_t size_y)
+{
+  // Check oled driver
+  if (oled_display == NULL) {
+    return GLIB_ERROR_DRIVER_NOT_INITIALIZED;
+  }
+
+  /* Check arguments */
+  if (g_context == NULL) {
+    return GLIB_ERROR_INVALID_ARGUMENT;
+  }
+
+  if (!g_context->font) { // 'Classic' built-in font
+    if ((x >= oled_display->width)                 // Clip right
+        || (y >= oled_display->height)             // Clip bottom
+        || ((x + 6 * size_x - 1) < 0) // Clip left
+        || ((y + 8 * size_y - 1) < 0)) { // Clip top
+      return GLIB_ERROR_INVALID_REGION;
+    }
+
+    if (c >= 176) {
+      c++; // Handle 'classic' charset behavior
+    }
+  } else if ((c < g_context->font->first) || (c > g_context->font->last)) {
+    return GLIB_ERROR_INVALID_CHAR;
+  }
+
+#if GLIB_GLYPH_CACHE_SIZE > 0
+  glyph_draw_t draw;
+
+  if (oled_display->driver->fill_rect == NULL) {
+    return draw_char_pixels(g_context, x, y, c, color, bg, size_x, size_y);
+  }
+
+  draw.g_context = g_context;
+  draw.x = x;
+  draw.y = y;
+  draw.size_x = size_x;
+  draw.size_y = size_y;
+  draw.color = color;
+  draw.bg = bg;
+  draw.status = GLIB_OK;
+
+  glib_glyph_cache_entry_t *entry = glyph_cache_get(g_context->font, c);
+
+  if (!entry->overflow) {
+    for (uint8_t i = 0; i < entry->count; i++) {
+      const glib_glyph_rect_t *rect = &entry->rect[i];
+
+      draw_glyph_rect(&draw,
+                      rect->x, rect->y,
+                      rect->w, rect->h & GLIB_GLYPH_RECT_HEIGHT,
+                      (rect->h & GLIB_GLYPH_RECT_FG) != 0);
+    }
+    return draw.status;
+  }
+
+  rasterize_glyph(g_context->font, c, draw_glyph_rect, &draw);
+  return draw.status;
+#else
+  return draw_char_pixels(g_context, x, y, c, color, bg, size_x, size_y);
+#endif
+}
+
 /***************************************************************************//**
  *  @brief
  *  Print one byte/character of data.
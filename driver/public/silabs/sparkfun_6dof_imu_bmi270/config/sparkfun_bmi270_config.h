@@ -65,6 +65,20 @@ extern "C" {
 // </h>
 // <<< end of configuration section >>>
 
+// <<< sl:start pin_tool >>>
+
+/*
+ * GPIO port/pin connected to the INT1 or INT2 pin of the sensor, used for the
+ * FIFO watermark interrupt.
+ */
+// <gpio optional=true> SPARKFUN_BMI270_INT
+// $[GPIO_SPARKFUN_BMI270_INT]
+// #define SPARKFUN_BMI270_INT_PORT                gpioPortB
+// #define SPARKFUN_BMI270_INT_PIN                 1
+// [GPIO_SPARKFUN_BMI270_INT]$
+
+// <<< sl:end pin_tool >>>
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,7 @@ extern "C" {
 //// Includes
 #include "sl_status.h"
 #include "drv_i2c_master.h"
+#include "sparkfun_bmi270_fifo.h"
 
 /******************************************************************************/
 
@@ -47,6 +48,9 @@ extern "C" {
 ///< Value of delay counter for milli seconds delay
 #define MS_DELAY_COUNTER        4600
 
+///< Value used to set BMI270_CMD_REG to clear the FIFO content
+#define FIFO_FLUSH_CMD          0xB0
+
 /*******************************************************************************
  ********************************   ENUMS   ************************************
  ******************************************************************************/
@@ -58,6 +62,15 @@ typedef enum bmi270_commands {
   ///< Register used to read the accelerator reading
   BMI270_ACC_X_LSB_ADDR          = 0x0C,
 
+  ///< Register used to read the FIFO interrupt status
+  BMI270_INT_STATUS_1_REG        = 0x1D,
+
+  ///< Register used to read the FIFO fill level LSB, MSB follows
+  BMI270_FIFO_LENGTH_0_REG       = 0x24,
+
+  ///< Register used to burst read the FIFO content
+  BMI270_FIFO_DATA_REG           = 0x26,
+
   ///< Register used to read the gyroscope reading
   BMI270_GYR_X_LSB_ADDR          = 0x12,
 
@@ -76,6 +89,24 @@ typedef enum bmi270_commands {
   ///< Register used to configure gyroscope range
   BMI270_GYRO_RANGE_REG          = 0x43,
 
+  ///< Register used to set the FIFO watermark LSB, MSB follows
+  BMI270_FIFO_WTM_0_REG          = 0x46,
+
+  ///< Register used to configure FIFO stop on full and sensor time frames
+  BMI270_FIFO_CONFIG_0_REG       = 0x48,
+
+  ///< Register used to configure FIFO header mode and enabled sensors
+  BMI270_FIFO_CONFIG_1_REG       = 0x49,
+
+  ///< Register used to configure the electrical behavior of INT1
+  BMI270_INT1_IO_CTRL_REG        = 0x53,
+
+  ///< Register used to configure the electrical behavior of INT2
+  BMI270_INT2_IO_CTRL_REG        = 0x54,
+
+  ///< Register used to map data interrupts to INT1 and INT2
+  BMI270_INT_MAP_DATA_REG        = 0x58,
+
   ///< Register used to make bmi270 sensor ready to load configuration file
   BMI270_INIT_CTRL_REG           = 0x59,
 
@@ -275,6 +306,18 @@ typedef enum {
   BMI270_GYRO_F_PERFO_OPT   = 0x01,
 }bmi270_gyro_filter_t;
 
+/// @brief Enum for bmi270 interrupt pins
+typedef enum {
+  ///< FIFO interrupts are not routed to a pin
+  BMI270_INT_PIN_NONE = 0x00,
+
+  ///< FIFO interrupts are routed to INT1
+  BMI270_INT_PIN_1    = 0x01,
+
+  ///< FIFO interrupts are routed to INT2
+  BMI270_INT_PIN_2    = 0x02,
+} bmi270_int_pin_t;
+
 /// @brief Accelerometer Configuration Structure
 typedef struct {
   ///< Used to set output data rate of accelerometer
@@ -332,6 +375,29 @@ typedef struct {
   uint8_t bmi270_slave_address;
 } bmi270_cfg_data_t;
 
+/// @brief FIFO Configuration Structure
+typedef struct {
+  ///< Used to enable frame headers, required for sensor time frames and
+  ///< for different accelerometer and gyroscope output data rates
+  bool header_mode;
+
+  ///< Used to store accelerometer data in the FIFO
+  bool acc_enable;
+
+  ///< Used to store gyroscope data in the FIFO
+  bool gyro_enable;
+
+  ///< Used to append a sensor time frame when the FIFO is drained
+  bool sensor_time_enable;
+
+  ///< Used to set the FIFO fill level in bytes raising the watermark
+  ///< interrupt
+  uint16_t watermark;
+
+  ///< Used to select the pin the watermark and full interrupts are routed to
+  bmi270_int_pin_t int_pin;
+} bmi270_fifo_config_t;
+
 // -----------------------------------------------------------------------------
 // Prototypes
 
@@ -434,6 +500,75 @@ sl_status_t sparkfun_bmi270_read_gyro_reading(bmi270_cfg_data_t *bmi_cfg_data,
 sl_status_t sparkfun_bmi270_read_temp_reading(bmi270_cfg_data_t *bmi_cfg_data,
                                               double *temperature_reading);
 
+/*******************************************************************************
+ * @brief Configure the FIFO of BMI270 sensor and the FIFO parser.
+ * @param[in] bmi_cfg_data : pointer to store the BMI270 sensor configuration
+ *   data.
+ * @param[in] fifo_config : pointer to the FIFO configuration.
+ * @param[in,out] fifo : FIFO parser state initialized with
+ *   'sparkfun_bmi270_fifo_init'.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_FAIL on failure.
+ * - \ref SL_STATUS_INVALID_PARAMETER on invalid parameter.
+ * @note
+ * 1. The FIFO content is flushed.
+ * 2. In headerless mode the accelerometer and gyroscope must run at the same
+ *   output data rate.
+ * 3. This API must be called after
+ *   'sparkfun_bmi270_enable_and_config_features'.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_configure(
+  bmi270_cfg_data_t *bmi_cfg_data,
+  const bmi270_fifo_config_t *fifo_config,
+  bmi270_fifo_t *fifo);
+
+/*******************************************************************************
+ * @brief Clear the FIFO content of BMI270 sensor.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_FAIL on failure.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_flush(void);
+
+/*******************************************************************************
+ * @brief Read the FIFO fill level of BMI270 sensor.
+ * @param[out] length : pointer to store the fill level in bytes.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_FAIL on failure.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_get_length(uint16_t *length);
+
+/*******************************************************************************
+ * @brief Drain the FIFO of BMI270 sensor in one burst read and decode the
+ *   frames into the sample ring of the FIFO parser.
+ * @param[in,out] fifo : FIFO parser state.
+ * @param[in] buffer : scratch buffer for the raw FIFO content.
+ * @param[in] buffer_size : size of buffer, up to BMI270_FIFO_SIZE
+ *   + BMI270_FIFO_SENSOR_TIME_LENGTH bytes are used.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_FAIL on failure.
+ * - \ref SL_STATUS_INVALID_PARAMETER on invalid parameter.
+ * @note Frames that do not fit in buffer stay in the FIFO for the next read.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_read_fifo(bmi270_fifo_t *fifo,
+                                      uint8_t *buffer,
+                                      uint16_t buffer_size);
+
+/*******************************************************************************
+ * @brief Register a callback for the FIFO interrupt pin of BMI270 sensor.
+ * @param[in] callback : function called from interrupt context when the
+ *   watermark or FIFO full interrupt is raised.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_NOT_SUPPORTED if SPARKFUN_BMI270_INT is not configured.
+ * @note The callback should only signal the application, the FIFO is then
+ *   drained with 'sparkfun_bmi270_read_fifo' outside interrupt context.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_register_fifo_int_callback(void (*callback)(void));
+
 #ifdef __cplusplus
 }
 #endif
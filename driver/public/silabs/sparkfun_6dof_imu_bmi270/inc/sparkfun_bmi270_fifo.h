@@ -0,0 +1,220 @@
+/***************************************************************************/ /**
+ * @file sparkfun_bmi270_fifo.h
+ * @brief sparkfun bmi270 FIFO frame parser
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef SPARKFUN_BMI270_FIFO_H_
+#define SPARKFUN_BMI270_FIFO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+/*******************************************************************************
+ ***************************  Defines / Macros  ********************************
+ ******************************************************************************/
+///< Size of the BMI270 FIFO in bytes
+#define BMI270_FIFO_SIZE                6144
+
+///< Sample flag set when the accelerometer fields are valid
+#define BMI270_FIFO_SAMPLE_ACC          0x01
+
+///< Sample flag set when the gyroscope fields are valid
+#define BMI270_FIFO_SAMPLE_GYRO         0x02
+
+///< Regular frame header, sensor bits of the header select the payload
+#define BMI270_FIFO_HEADER_REGULAR      0x80
+
+///< Regular frame header bit for auxiliary sensor data (8 bytes)
+#define BMI270_FIFO_HEADER_AUX          0x10
+
+///< Regular frame header bit for gyroscope data (6 bytes)
+#define BMI270_FIFO_HEADER_GYRO         0x08
+
+///< Regular frame header bit for accelerometer data (6 bytes)
+#define BMI270_FIFO_HEADER_ACC          0x04
+
+///< Control frame header, number of skipped frames follows (1 byte)
+#define BMI270_FIFO_HEADER_SKIP         0x40
+
+///< Control frame header, 24-bit sensor time follows (3 bytes)
+#define BMI270_FIFO_HEADER_SENSOR_TIME  0x44
+
+///< Control frame header, FIFO input configuration change (4 bytes)
+#define BMI270_FIFO_HEADER_INPUT_CFG    0x48
+
+///< Bytes appended after the last frame when the sensor time is enabled
+#define BMI270_FIFO_SENSOR_TIME_LENGTH  4
+
+/*******************************************************************************
+ ********************************   STRUCTS   **********************************
+ ******************************************************************************/
+/// @brief One decoded FIFO frame in fixed-point units
+typedef struct {
+  ///< Accelerometer X, Y, Z in milli-g
+  int32_t acc[3];
+
+  ///< Gyroscope X, Y, Z in milli-degree per second
+  int32_t gyro[3];
+
+  ///< BMI270_FIFO_SAMPLE_ACC and/or BMI270_FIFO_SAMPLE_GYRO
+  uint8_t flags;
+} bmi270_fifo_sample_t;
+
+/// @brief FIFO parser state and caller provided sample ring
+typedef struct {
+  ///< Frames carry a header byte
+  bool header_mode;
+
+  ///< Accelerometer data is stored in the FIFO
+  bool acc_enable;
+
+  ///< Gyroscope data is stored in the FIFO
+  bool gyro_enable;
+
+  ///< A sensor time frame is appended when the FIFO is drained
+  bool sensor_time_enable;
+
+  ///< Accelerometer full scale in milli-g
+  int32_t acc_scale;
+
+  ///< Gyroscope full scale in milli-degree per second
+  int32_t gyro_scale;
+
+  ///< Caller provided sample storage
+  bmi270_fifo_sample_t *buffer;
+
+  ///< Number of entries in buffer
+  uint16_t size;
+
+  ///< Index of the next sample to write
+  uint16_t head;
+
+  ///< Index of the next sample to read
+  uint16_t tail;
+
+  ///< Number of samples in the ring
+  uint16_t count;
+
+  ///< Last sensor time received, in 39.0625 us ticks
+  uint32_t sensor_time;
+
+  ///< A sensor time frame has been received
+  bool sensor_time_valid;
+
+  ///< Frames the sensor reported as skipped because the FIFO was full
+  uint32_t skipped;
+
+  ///< Samples dropped because the ring was full
+  uint32_t dropped;
+} bmi270_fifo_t;
+
+// -----------------------------------------------------------------------------
+// Prototypes
+
+/*******************************************************************************
+ * @brief Initialize the FIFO parser with a caller provided sample ring.
+ * @param[out] fifo : pointer to the FIFO parser state.
+ * @param[in] buffer : storage for decoded samples.
+ * @param[in] size : number of entries in buffer.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_INVALID_PARAMETER on invalid parameter.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_init(bmi270_fifo_t *fifo,
+                                      bmi270_fifo_sample_t *buffer,
+                                      uint16_t size);
+
+/*******************************************************************************
+ * @brief Set the frame format the parser expects.
+ * @param[in,out] fifo : pointer to the FIFO parser state.
+ * @param[in] header_mode : frames carry a header byte.
+ * @param[in] acc_enable : accelerometer data is stored in the FIFO.
+ * @param[in] gyro_enable : gyroscope data is stored in the FIFO.
+ * @param[in] acc_range : accelerometer range, bmi270_accel_range_t value.
+ * @param[in] gyro_range : gyroscope range, bmi270_gyro_range_t value.
+ * @note This is called by 'sparkfun_bmi270_fifo_configure'. It only needs to
+ *   be called directly to decode recorded FIFO dumps.
+ ******************************************************************************/
+void sparkfun_bmi270_fifo_set_format(bmi270_fifo_t *fifo,
+                                     bool header_mode,
+                                     bool acc_enable,
+                                     bool gyro_enable,
+                                     uint8_t acc_range,
+                                     uint8_t gyro_range);
+
+/*******************************************************************************
+ * @brief Decode raw FIFO data and append the samples to the ring.
+ * @param[in,out] fifo : pointer to the FIFO parser state.
+ * @param[in] data : raw bytes read from the FIFO_DATA register.
+ * @param[in] length : number of bytes in data.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success. A trailing partial frame is ignored.
+ * - \ref SL_STATUS_INVALID_PARAMETER on invalid parameter.
+ * - \ref SL_STATUS_FAIL on an unknown frame header, the frames before it are
+ *   still decoded.
+ * @note This function does not access the sensor.
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_parse(bmi270_fifo_t *fifo,
+                                       const uint8_t *data,
+                                       uint16_t length);
+
+/*******************************************************************************
+ * @brief Get the oldest decoded sample from the ring.
+ * @param[in,out] fifo : pointer to the FIFO parser state.
+ * @param[out] sample : pointer to store the sample.
+ * @return true if a sample was returned, false if the ring is empty.
+ ******************************************************************************/
+bool sparkfun_bmi270_fifo_pop(bmi270_fifo_t *fifo,
+                              bmi270_fifo_sample_t *sample);
+
+/*******************************************************************************
+ * @brief Get the number of decoded samples in the ring.
+ * @param[in] fifo : pointer to the FIFO parser state.
+ * @return number of samples.
+ ******************************************************************************/
+uint16_t sparkfun_bmi270_fifo_available(const bmi270_fifo_t *fifo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPARKFUN_BMI270_FIFO_H_ */
@@ -1,6 +1,17 @@
 #include "sparkfun_bmi270.h"
 #include "sparkfun_bmi270_config.h"
 
+#ifdef SPARKFUN_BMI270_INT_PIN
+#include "drv_digital_in.h"
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#define GPIO_M4_INTR              7 // M4 Pin interrupt number
+#define AVL_INTR_NO               0 // available interrupt number
+#else
+#include "gpiointerrupt.h"
+#endif
+#endif
+
 /*******************************************************************************
  * @brief BMI270 configuration file
  ******************************************************************************/
@@ -872,6 +883,11 @@ static const uint8_t bmi270_config_file[] = {
 
 static i2c_master_t bmi270;
 
+#ifdef SPARKFUN_BMI270_INT_PIN
+static digital_in_t bmi270_int_pin;
+static void (*bmi270_fifo_int_callback)(void) = NULL;
+#endif
+
 // -----------------------------------------------------------------------------
 // Prototypes
 // -----------------------------------------------------------------------------
@@ -907,6 +923,13 @@ static sl_status_t sparkfun_bmi270_config_gyro_range(
 static void sparkfun_bmi270_convert_raw_to_gyro_degree_per_sec(
   int16_t *raw_data,
   double *gyro_data);
+#ifdef SPARKFUN_BMI270_INT_PIN
+#if (defined(SLI_SI917))
+static void sparkfun_bmi270_int_handler(uint32_t int_no);
+#else
+static void sparkfun_bmi270_int_handler(uint8_t int_no);
+#endif
+#endif
 
 /*******************************************************************************
  * @brief  Gives delay in milliseconds
@@ -1423,6 +1446,26 @@ static void sparkfun_bmi270_convert_raw_to_gyro_degree_per_sec(
   gyro_data[2] = raw_data[2] * scaling_factor;
 }
 
+#ifdef SPARKFUN_BMI270_INT_PIN
+/*******************************************************************************
+ * @brief GPIO interrupt handler of the BMI270 FIFO interrupt pin.
+ * @param[in] int_no : interrupt number.
+ ******************************************************************************/
+#if (defined(SLI_SI917))
+static void sparkfun_bmi270_int_handler(uint32_t int_no)
+#else
+static void sparkfun_bmi270_int_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  if (bmi270_fifo_int_callback != NULL) {
+    bmi270_fifo_int_callback();
+  }
+}
+
+#endif
+
 // -----------------------------------------------------------------------------
 // Public Function
 // -----------------------------------------------------------------------------
@@ -1745,3 +1788,222 @@ sl_status_t sparkfun_bmi270_read_temp_reading(bmi270_cfg_data_t *bmi_cfg_data,
 
   return SL_STATUS_OK;
 }
+
+/*******************************************************************************
+ * Function to configure the FIFO
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_configure(
+  bmi270_cfg_data_t *bmi_cfg_data,
+  const bmi270_fifo_config_t *fifo_config,
+  bmi270_fifo_t *fifo)
+{
+  sl_status_t status;
+  uint8_t tx_buffer[3];
+  uint8_t int_map = 0;
+
+  if ((bmi270.handle == NULL) || (bmi_cfg_data == NULL)
+      || (fifo_config == NULL) || (fifo == NULL) || (fifo->buffer == NULL)
+      || (fifo_config->watermark > BMI270_FIFO_SIZE)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (!fifo_config->acc_enable && !fifo_config->gyro_enable) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  /// watermark in bytes, 13 bits
+  tx_buffer[0] = BMI270_FIFO_WTM_0_REG;
+  tx_buffer[1] = (uint8_t)(fifo_config->watermark & 0xFF);
+  tx_buffer[2] = (uint8_t)((fifo_config->watermark >> 8) & 0x1F);
+
+  status = sparkfun_bmi270_reg_write(tx_buffer, sizeof(tx_buffer));
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  /// FIFO_CONFIG_0: streaming mode, sensor time frame (bit 1)
+  /// FIFO_CONFIG_1: gyroscope (bit 7), accelerometer (bit 6), header (bit 4)
+  tx_buffer[0] = BMI270_FIFO_CONFIG_0_REG;
+  tx_buffer[1] = (fifo_config->sensor_time_enable
+                  && fifo_config->header_mode) ? 0x02 : 0x00;
+  tx_buffer[2] = (uint8_t)((fifo_config->gyro_enable ? 0x80 : 0x00)
+                           | (fifo_config->acc_enable ? 0x40 : 0x00)
+                           | (fifo_config->header_mode ? 0x10 : 0x00));
+
+  status = sparkfun_bmi270_reg_write(tx_buffer, sizeof(tx_buffer));
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  if (fifo_config->int_pin != BMI270_INT_PIN_NONE) {
+    /// push-pull, active high output
+    tx_buffer[0] = (fifo_config->int_pin == BMI270_INT_PIN_1)
+                   ? BMI270_INT1_IO_CTRL_REG : BMI270_INT2_IO_CTRL_REG;
+    tx_buffer[1] = 0x0A;
+
+    status = sparkfun_bmi270_reg_write(tx_buffer, 2);
+    if (SL_STATUS_OK != status) {
+      return SL_STATUS_FAIL;
+    }
+
+    /// FIFO watermark and full interrupts
+    int_map = (fifo_config->int_pin == BMI270_INT_PIN_1) ? 0x03 : 0x30;
+  }
+
+  tx_buffer[0] = BMI270_INT_MAP_DATA_REG;
+  tx_buffer[1] = int_map;
+
+  status = sparkfun_bmi270_reg_write(tx_buffer, 2);
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  fifo->sensor_time_enable = fifo_config->sensor_time_enable
+                             && fifo_config->header_mode;
+  sparkfun_bmi270_fifo_set_format(fifo,
+                                  fifo_config->header_mode,
+                                  fifo_config->acc_enable,
+                                  fifo_config->gyro_enable,
+                                  bmi_cfg_data->acc_config.range,
+                                  bmi_cfg_data->gyro_config.range);
+
+  return sparkfun_bmi270_fifo_flush();
+}
+
+/*******************************************************************************
+ * Function to clear the FIFO content
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_flush(void)
+{
+  sl_status_t status;
+  uint8_t tx_buffer[2] = { BMI270_CMD_REG, FIFO_FLUSH_CMD };
+
+  if (bmi270.handle == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = sparkfun_bmi270_reg_write(tx_buffer, sizeof(tx_buffer));
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function to read the FIFO fill level
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_get_length(uint16_t *length)
+{
+  sl_status_t status;
+  uint8_t rx_buffer[2];
+
+  if ((bmi270.handle == NULL) || (length == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = sparkfun_bmi270_reg_read(BMI270_FIFO_LENGTH_0_REG,
+                                    rx_buffer,
+                                    sizeof(rx_buffer));
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  *length = (uint16_t)(((rx_buffer[1] & 0x3F) << 8) | rx_buffer[0]);
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function to drain the FIFO
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_read_fifo(bmi270_fifo_t *fifo,
+                                      uint8_t *buffer,
+                                      uint16_t buffer_size)
+{
+  sl_status_t status;
+  uint16_t length;
+
+  if ((bmi270.handle == NULL) || (fifo == NULL) || (buffer == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = sparkfun_bmi270_fifo_get_length(&length);
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  if (length == 0) {
+    return SL_STATUS_OK;
+  }
+
+  /// the sensor time frame is only returned when reading past the last frame
+  if (fifo->sensor_time_enable) {
+    length += BMI270_FIFO_SENSOR_TIME_LENGTH;
+  }
+
+  if (length > buffer_size) {
+    length = buffer_size;
+  }
+
+  /// headerless frames cannot be resynchronized, read whole frames only
+  if (!fifo->header_mode) {
+    uint16_t frame_length = (fifo->acc_enable ? 6 : 0)
+                            + (fifo->gyro_enable ? 6 : 0);
+
+    if (frame_length == 0) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    length -= length % frame_length;
+    if (length == 0) {
+      return SL_STATUS_OK;
+    }
+  }
+
+  /// one burst, the FIFO_DATA address does not auto increment
+  status = sparkfun_bmi270_reg_read(BMI270_FIFO_DATA_REG, buffer, length);
+  if (SL_STATUS_OK != status) {
+    return SL_STATUS_FAIL;
+  }
+
+  return sparkfun_bmi270_fifo_parse(fifo, buffer, length);
+}
+
+/*******************************************************************************
+ * Function to register the FIFO interrupt callback
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_register_fifo_int_callback(void (*callback)(void))
+{
+#ifdef SPARKFUN_BMI270_INT_PIN
+  pin_name_t int_pin = hal_gpio_pin_name(SPARKFUN_BMI270_INT_PORT,
+                                         SPARKFUN_BMI270_INT_PIN);
+
+  bmi270_fifo_int_callback = callback;
+  digital_in_init(&bmi270_int_pin, int_pin);
+
+  /// INT is configured as push-pull, active high
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { SPARKFUN_BMI270_INT_PIN / 16,
+                              SPARKFUN_BMI270_INT_PIN % 16 };
+  sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                     GPIO_M4_INTR,
+                                     SL_GPIO_INTERRUPT_RISING_EDGE,
+                                     sparkfun_bmi270_int_handler,
+                                     AVL_INTR_NO);
+#else // None Si91x device
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(SPARKFUN_BMI270_INT_PIN,
+                           sparkfun_bmi270_int_handler);
+  GPIO_ExtIntConfig(SPARKFUN_BMI270_INT_PORT,
+                    SPARKFUN_BMI270_INT_PIN,
+                    SPARKFUN_BMI270_INT_PIN,
+                    true,
+                    false,
+                    true);
+#endif
+  return SL_STATUS_OK;
+#else
+  (void)callback;
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
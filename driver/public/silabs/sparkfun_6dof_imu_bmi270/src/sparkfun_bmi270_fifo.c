@@ -0,0 +1,337 @@
+/***************************************************************************/ /**
+ * @file sparkfun_bmi270_fifo.c
+ * @brief sparkfun bmi270 FIFO frame parser
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include "sparkfun_bmi270_fifo.h"
+
+// The parser has no dependency on the sensor or the I2C driver so recorded
+// FIFO dumps can be decoded off target.
+
+///< Length of one sensor payload in a frame
+#define BMI270_FIFO_AXES_LENGTH         6
+
+///< Length of the auxiliary sensor payload in a frame
+#define BMI270_FIFO_AUX_LENGTH          8
+
+///< Regular frame sensor bits, the two lowest bits carry interrupt tags
+#define BMI270_FIFO_HEADER_PARM_MASK    0x1C
+
+///< Frame type bits of the header
+#define BMI270_FIFO_HEADER_MODE_MASK    0xC0
+
+///< Header bits compared for control frames
+#define BMI270_FIFO_HEADER_CTRL_MASK    0xFC
+
+// -----------------------------------------------------------------------------
+// Prototypes
+// -----------------------------------------------------------------------------
+static void sparkfun_bmi270_fifo_decode_axes(const uint8_t *data,
+                                             int32_t scale,
+                                             int32_t *out);
+static void sparkfun_bmi270_fifo_push(bmi270_fifo_t *fifo,
+                                      const bmi270_fifo_sample_t *sample);
+static uint16_t sparkfun_bmi270_fifo_parse_headerless(bmi270_fifo_t *fifo,
+                                                      const uint8_t *data,
+                                                      uint16_t length);
+
+/*******************************************************************************
+ * @brief Convert three little endian raw axes to fixed-point.
+ * @param[in] data : pointer to the 6 byte payload.
+ * @param[in] scale : full scale of the sensor in output units.
+ * @param[out] out : converted X, Y, Z values.
+ ******************************************************************************/
+static void sparkfun_bmi270_fifo_decode_axes(const uint8_t *data,
+                                             int32_t scale,
+                                             int32_t *out)
+{
+  for (uint8_t i = 0; i < 3; i++) {
+    int16_t raw = (int16_t)((data[2 * i + 1] << 8) | data[2 * i]);
+
+    /// raw is a Q15 fraction of the full scale
+    out[i] = (int32_t)(((int64_t)raw * scale) >> 15);
+  }
+}
+
+/*******************************************************************************
+ * @brief Append a sample to the ring, the sample is dropped if it is full.
+ * @param[in,out] fifo : pointer to the FIFO parser state.
+ * @param[in] sample : sample to append.
+ ******************************************************************************/
+static void sparkfun_bmi270_fifo_push(bmi270_fifo_t *fifo,
+                                      const bmi270_fifo_sample_t *sample)
+{
+  if (fifo->count >= fifo->size) {
+    fifo->dropped++;
+    return;
+  }
+
+  fifo->buffer[fifo->head] = *sample;
+  fifo->head = (fifo->head + 1) % fifo->size;
+  fifo->count++;
+}
+
+/*******************************************************************************
+ * @brief Decode headerless frames, all enabled sensors are in every frame.
+ * @param[in,out] fifo : pointer to the FIFO parser state.
+ * @param[in] data : raw FIFO bytes.
+ * @param[in] length : number of bytes in data.
+ * @return number of bytes consumed.
+ ******************************************************************************/
+static uint16_t sparkfun_bmi270_fifo_parse_headerless(bmi270_fifo_t *fifo,
+                                                      const uint8_t *data,
+                                                      uint16_t length)
+{
+  bmi270_fifo_sample_t sample = { 0 };
+  uint16_t frame_length = 0;
+  uint16_t index = 0;
+
+  if (fifo->gyro_enable) {
+    frame_length += BMI270_FIFO_AXES_LENGTH;
+    sample.flags |= BMI270_FIFO_SAMPLE_GYRO;
+  }
+  if (fifo->acc_enable) {
+    frame_length += BMI270_FIFO_AXES_LENGTH;
+    sample.flags |= BMI270_FIFO_SAMPLE_ACC;
+  }
+
+  if (frame_length == 0) {
+    return 0;
+  }
+
+  while ((index + frame_length) <= length) {
+    const uint8_t *p = &data[index];
+
+    /// gyroscope data precedes accelerometer data
+    if (fifo->gyro_enable) {
+      sparkfun_bmi270_fifo_decode_axes(p, fifo->gyro_scale, sample.gyro);
+      p += BMI270_FIFO_AXES_LENGTH;
+    }
+    if (fifo->acc_enable) {
+      sparkfun_bmi270_fifo_decode_axes(p, fifo->acc_scale, sample.acc);
+    }
+
+    sparkfun_bmi270_fifo_push(fifo, &sample);
+    index += frame_length;
+  }
+
+  return index;
+}
+
+// -----------------------------------------------------------------------------
+// Public Function
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to initialize the FIFO parser
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_init(bmi270_fifo_t *fifo,
+                                      bmi270_fifo_sample_t *buffer,
+                                      uint16_t size)
+{
+  if ((fifo == NULL) || (buffer == NULL) || (size == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  fifo->buffer = buffer;
+  fifo->size = size;
+  fifo->head = 0;
+  fifo->tail = 0;
+  fifo->count = 0;
+  fifo->sensor_time = 0;
+  fifo->sensor_time_valid = false;
+  fifo->skipped = 0;
+  fifo->dropped = 0;
+
+  /// default to the register defaults of the sensor
+  fifo->sensor_time_enable = false;
+  sparkfun_bmi270_fifo_set_format(fifo, true, true, false, 0x02, 0x00);
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function to set the frame format of the FIFO parser
+ ******************************************************************************/
+void sparkfun_bmi270_fifo_set_format(bmi270_fifo_t *fifo,
+                                     bool header_mode,
+                                     bool acc_enable,
+                                     bool gyro_enable,
+                                     uint8_t acc_range,
+                                     uint8_t gyro_range)
+{
+  if (fifo == NULL) {
+    return;
+  }
+
+  fifo->header_mode = header_mode;
+  fifo->acc_enable = acc_enable;
+  fifo->gyro_enable = gyro_enable;
+
+  /// +/- 2g << range, in milli-g
+  fifo->acc_scale = (int32_t)2000 << (acc_range & 0x03);
+
+  /// +/- 2000dps >> range, in milli-degree per second
+  fifo->gyro_scale = (int32_t)2000000 >> ((gyro_range > 4) ? 4 : gyro_range);
+}
+
+/*******************************************************************************
+ * Function to decode raw FIFO data
+ ******************************************************************************/
+sl_status_t sparkfun_bmi270_fifo_parse(bmi270_fifo_t *fifo,
+                                       const uint8_t *data,
+                                       uint16_t length)
+{
+  uint16_t index = 0;
+
+  if ((fifo == NULL) || (fifo->buffer == NULL) || (data == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (!fifo->header_mode) {
+    sparkfun_bmi270_fifo_parse_headerless(fifo, data, length);
+    return SL_STATUS_OK;
+  }
+
+  while (index < length) {
+    uint8_t header = data[index];
+
+    if ((header & BMI270_FIFO_HEADER_MODE_MASK) == BMI270_FIFO_HEADER_REGULAR) {
+      uint8_t parm = header & BMI270_FIFO_HEADER_PARM_MASK;
+      uint16_t frame_length = 1;
+      bmi270_fifo_sample_t sample = { 0 };
+
+      /// a regular header without data marks the end of valid data
+      if (parm == 0) {
+        break;
+      }
+
+      if (parm & BMI270_FIFO_HEADER_AUX) {
+        frame_length += BMI270_FIFO_AUX_LENGTH;
+      }
+      if (parm & BMI270_FIFO_HEADER_GYRO) {
+        frame_length += BMI270_FIFO_AXES_LENGTH;
+      }
+      if (parm & BMI270_FIFO_HEADER_ACC) {
+        frame_length += BMI270_FIFO_AXES_LENGTH;
+      }
+
+      /// partial frame, it is read again on the next burst
+      if ((index + frame_length) > length) {
+        break;
+      }
+
+      /// payload order is auxiliary, gyroscope, accelerometer
+      const uint8_t *p = &data[index + 1];
+      if (parm & BMI270_FIFO_HEADER_AUX) {
+        p += BMI270_FIFO_AUX_LENGTH;
+      }
+      if (parm & BMI270_FIFO_HEADER_GYRO) {
+        sparkfun_bmi270_fifo_decode_axes(p, fifo->gyro_scale, sample.gyro);
+        sample.flags |= BMI270_FIFO_SAMPLE_GYRO;
+        p += BMI270_FIFO_AXES_LENGTH;
+      }
+      if (parm & BMI270_FIFO_HEADER_ACC) {
+        sparkfun_bmi270_fifo_decode_axes(p, fifo->acc_scale, sample.acc);
+        sample.flags |= BMI270_FIFO_SAMPLE_ACC;
+      }
+
+      if (sample.flags) {
+        sparkfun_bmi270_fifo_push(fifo, &sample);
+      }
+      index += frame_length;
+    } else {
+      switch (header & BMI270_FIFO_HEADER_CTRL_MASK) {
+        case BMI270_FIFO_HEADER_SKIP:
+          if ((index + 2) > length) {
+            return SL_STATUS_OK;
+          }
+          fifo->skipped += data[index + 1];
+          index += 2;
+          break;
+
+        case BMI270_FIFO_HEADER_SENSOR_TIME:
+          if ((index + BMI270_FIFO_SENSOR_TIME_LENGTH) > length) {
+            return SL_STATUS_OK;
+          }
+          fifo->sensor_time = (uint32_t)data[index + 1]
+                              | ((uint32_t)data[index + 2] << 8)
+                              | ((uint32_t)data[index + 3] << 16);
+          fifo->sensor_time_valid = true;
+          index += BMI270_FIFO_SENSOR_TIME_LENGTH;
+          break;
+
+        case BMI270_FIFO_HEADER_INPUT_CFG:
+          index += 5;
+          break;
+
+        default:
+          return SL_STATUS_FAIL;
+      }
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function to get the oldest decoded sample
+ ******************************************************************************/
+bool sparkfun_bmi270_fifo_pop(bmi270_fifo_t *fifo,
+                              bmi270_fifo_sample_t *sample)
+{
+  if ((fifo == NULL) || (sample == NULL) || (fifo->count == 0)) {
+    return false;
+  }
+
+  *sample = fifo->buffer[fifo->tail];
+  fifo->tail = (fifo->tail + 1) % fifo->size;
+  fifo->count--;
+
+  return true;
+}
+
+/*******************************************************************************
+ * Function to get the number of decoded samples
+ ******************************************************************************/
+uint16_t sparkfun_bmi270_fifo_available(const bmi270_fifo_t *fifo)
+{
+  if (fifo == NULL) {
+    return 0;
+  }
+
+  return fifo->count;
+}
@@ -57,6 +57,8 @@ typedef struct oled_display_driver_api {
   sl_status_t (*scroll_diag_left)(uint8_t, uint8_t);
   sl_status_t (*stop_scroll)(void);
   sl_status_t (*enable_display)(bool);
+  sl_status_t (*fill_rect)(int16_t x, int16_t y, int16_t w, int16_t h,
+                           uint16_t color);
 } oled_display_driver_api_t;
 
 /**
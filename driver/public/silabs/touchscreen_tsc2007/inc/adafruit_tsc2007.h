@@ -1,6 +1,7 @@
 #ifndef _ADAFRUIT_TSC2007_H
 #define _ADAFRUIT_TSC2007_H
 
+#include <stdbool.h>
 #include "sl_status.h"
 
 /*!
@@ -95,7 +96,25 @@ sl_status_t adafruit_tsc2007_get_touch_point(int32_t *pt_x,
                                              int32_t *pt_y,
                                              int32_t *rtouch);
 
-void adafruit_tsc2007_register_touch_detect_isr_callback(
+/***************************************************************************//**
+ *    @brief
+ *      Register a callback for the PENIRQ falling edge. The TSC2007 is left
+ *      in power-down with PENIRQ enabled after each reading.
+ *    @param[in] callback
+ *      Called from interrupt context when the panel is touched.
+ *    @return
+ *     Returns SL_STATUS_OK on success, SL_STATUS_NOT_SUPPORTED if the INT
+ *     pin is not configured.
+ ******************************************************************************/
+sl_status_t adafruit_tsc2007_register_touch_detect_isr_callback(
   void (*callback)(void));
 
+/***************************************************************************//**
+ *    @brief
+ *      Check the PENIRQ level, without any I2C transfer.
+ *    @return
+ *     Returns true while the panel is touched.
+ ******************************************************************************/
+bool adafruit_tsc2007_is_touched(void);
+
 #endif // _ADAFRUIT_TSC2007_H
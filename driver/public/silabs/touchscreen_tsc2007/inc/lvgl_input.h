@@ -43,11 +43,26 @@
 extern "C" {
 #endif
 
+// Touch sample of the interrupt driven mode
+typedef struct _lvgl_input_point {
+  int16_t x;
+  int16_t y;
+  bool pressed;
+  uint32_t timestamp; // sleeptimer ticks
+} lvgl_input_point_t;
+
 typedef struct _lvgl_input_driver_api {
   sl_status_t (*init)(void);
   sl_status_t (*read_data)(void);
   bool (*get_touch)(void);
   sl_status_t (*get_xy)(int16_t *x, int16_t *y);
+
+  // Interrupt driven mode: sample only while touched. wakeup is called from
+  // interrupt context when a sample is due, it shall only signal the task
+  // that calls sample. sample takes the due sample in task context and
+  // returns SL_STATUS_EMPTY if there is none.
+  sl_status_t (*irq_init)(void (*wakeup)(void));
+  sl_status_t (*sample)(lvgl_input_point_t *point);
 } lvgl_input_driver_api_t;
 
 typedef struct _lvgl_input{
@@ -6,6 +6,18 @@
 #include "adafruit_tsc2007_config.h"
 #include "adafruit_tsc2007.h"
 
+#if defined(ADAFRUIT_TSC2007_INT_PORT)
+#if (defined(SLI_SI917))
+#include "sl_driver_gpio.h"
+#include "drv_digital_in.h"
+#define ADAFRUIT_TSC2007_INTR_NO      6 // M4 Pin interrupt number
+#define ADAFRUIT_TSC2007_AVL_INTR_NO  0 // available interrupt number
+#else
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
+#endif
+#endif
+
 static sl_status_t tsc2007_command(adafruit_tsc2007_function_t func,
                                    adafruit_tsc2007_power_t pwr,
                                    adafruit_tsc2007_resolution_t res,
@@ -188,3 +200,83 @@ static sl_status_t tsc2007_command(adafruit_tsc2007_function_t func,
   }
   return SL_STATUS_OK;
 }
+
+#if defined(ADAFRUIT_TSC2007_INT_PORT)
+static void (*touch_detect_callback)(void) = NULL;
+#if (defined(SLI_SI917))
+static digital_in_t penirq_pin;
+#endif
+
+#if (defined(SLI_SI917))
+static void tsc2007_penirq_handler(uint32_t int_no)
+#else
+static void tsc2007_penirq_handler(uint8_t int_no)
+#endif
+{
+  (void)int_no;
+
+  if (touch_detect_callback) {
+    touch_detect_callback();
+  }
+}
+
+#endif
+
+sl_status_t adafruit_tsc2007_register_touch_detect_isr_callback(
+  void (*callback)(void))
+{
+#if defined(ADAFRUIT_TSC2007_INT_PORT)
+  touch_detect_callback = callback;
+
+  // PENIRQ is open drain, low while touched
+#if (defined(SLI_SI917))
+  sl_gpio_t gpio_port_pin = { ADAFRUIT_TSC2007_INT_PIN / 16,
+                              ADAFRUIT_TSC2007_INT_PIN % 16 };
+
+  if (digital_in_pullup_init(&penirq_pin,
+                             hal_gpio_pin_name(ADAFRUIT_TSC2007_INT_PORT,
+                                               ADAFRUIT_TSC2007_INT_PIN))
+      != DIGITAL_IN_SUCCESS) {
+    return SL_STATUS_INITIALIZATION;
+  }
+  if (sl_gpio_driver_configure_interrupt(&gpio_port_pin,
+                                         ADAFRUIT_TSC2007_INTR_NO,
+                                         SL_GPIO_INTERRUPT_FALLING_EDGE,
+                                         tsc2007_penirq_handler,
+                                         ADAFRUIT_TSC2007_AVL_INTR_NO)
+      != SL_STATUS_OK) {
+    return SL_STATUS_INITIALIZATION;
+  }
+#else // None Si91x device
+  GPIO_PinModeSet(ADAFRUIT_TSC2007_INT_PORT,
+                  ADAFRUIT_TSC2007_INT_PIN,
+                  gpioModeInputPullFilter,
+                  1);
+  GPIOINT_Init();
+  GPIOINT_CallbackRegister(ADAFRUIT_TSC2007_INT_PIN,
+                           tsc2007_penirq_handler);
+  GPIO_ExtIntConfig(ADAFRUIT_TSC2007_INT_PORT,
+                    ADAFRUIT_TSC2007_INT_PIN,
+                    ADAFRUIT_TSC2007_INT_PIN,
+                    false,
+                    true,
+                    true);
+#endif
+  return SL_STATUS_OK;
+#else
+  (void)callback;
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+bool adafruit_tsc2007_is_touched(void)
+{
+#if defined(ADAFRUIT_TSC2007_INT_PORT) && (defined(SLI_SI917))
+  return digital_in_read(&penirq_pin) == 0;
+#elif defined(ADAFRUIT_TSC2007_INT_PORT)
+  return GPIO_PinInGet(ADAFRUIT_TSC2007_INT_PORT,
+                       ADAFRUIT_TSC2007_INT_PIN) == 0;
+#else
+  return false;
+#endif
+}
@@ -33,6 +33,7 @@
  * at the sole discretion of Silicon Labs.
  ******************************************************************************/
 #include "sl_status.h"
+#include "sl_sleeptimer.h"
 #include "lvgl_input.h"
 // -----------------------------------------------------------------------------
 //                       Local Function
@@ -41,6 +42,8 @@ static sl_status_t lvgl_input_driver_init(void);
 static sl_status_t lvgl_input_driver_read_data (void);
 static sl_status_t lvgl_input_driver_get_xy(int16_t *x, int16_t *y);
 static bool lvgl_input_driver_get_touch(void);
+static sl_status_t lvgl_input_driver_irq_init(void (*wakeup)(void));
+static sl_status_t lvgl_input_driver_sample(lvgl_input_point_t *point);
 
 // -----------------------------------------------------------------------------
 //                       Local Variables
@@ -58,9 +61,21 @@ static const lvgl_input_driver_api_t lvgl_input_driver_api =
   .init = lvgl_input_driver_init,
   .read_data = lvgl_input_driver_read_data,
   .get_touch = lvgl_input_driver_get_touch,
-  .get_xy = lvgl_input_driver_get_xy
+  .get_xy = lvgl_input_driver_get_xy,
+  .irq_init = lvgl_input_driver_irq_init,
+  .sample = lvgl_input_driver_sample
 };
 
+// Interrupt driven mode
+#ifndef LVGL_INPUT_SAMPLE_PERIOD_MS
+#define LVGL_INPUT_SAMPLE_PERIOD_MS     (10)
+#endif
+
+static sl_sleeptimer_timer_handle_t sample_timer;
+static volatile bool sample_due = false;
+static volatile bool sampling = false;
+static void (*wakeup_callback)(void) = NULL;
+
 sl_status_t lvgl_input_init(void)
 {
   lvgl_input_instance.driver = &lvgl_input_driver_api;
@@ -119,3 +134,75 @@ static bool lvgl_input_driver_get_touch(void)
   }
   return retVal;
 }
+
+/***************************************************************************//**
+ * Periodic sample while PENIRQ reports a touch, the I2C transfers are left
+ * to the task calling lvgl_input_driver_sample().
+ ******************************************************************************/
+static void sample_timer_callback(sl_sleeptimer_timer_handle_t *handle,
+                                  void *data)
+{
+  (void)handle;
+  (void)data;
+
+  sample_due = true;
+  if (NULL != wakeup_callback) {
+    wakeup_callback();
+  }
+}
+
+static void pen_down_callback(void)
+{
+  // PENIRQ also toggles while a conversion is running
+  if (!sampling) {
+    sample_due = true;
+    if (NULL != wakeup_callback) {
+      wakeup_callback();
+    }
+  }
+}
+
+static sl_status_t lvgl_input_driver_sample(lvgl_input_point_t *point)
+{
+  if (NULL == point) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (!sample_due) {
+    return SL_STATUS_EMPTY;
+  }
+  sample_due = false;
+
+  if (!sampling) {
+    sampling = true;
+    sl_sleeptimer_start_periodic_timer_ms(&sample_timer,
+                                          LVGL_INPUT_SAMPLE_PERIOD_MS,
+                                          sample_timer_callback,
+                                          NULL,
+                                          0,
+                                          0);
+  }
+
+  if ((SL_STATUS_OK == lvgl_input_driver_read_data())
+      && lvgl_input_driver_get_touch()) {
+    point->pressed = true;
+  } else if (!adafruit_tsc2007_is_touched()) {
+    sl_sleeptimer_stop_timer(&sample_timer);
+    sampling = false;
+    point->pressed = false;
+  } else {
+    // Too light touch, wait for the next sample
+    return SL_STATUS_EMPTY;
+  }
+  point->x = _x;
+  point->y = _y;
+  point->timestamp = sl_sleeptimer_get_tick_count();
+
+  return SL_STATUS_OK;
+}
+
+static sl_status_t lvgl_input_driver_irq_init(void (*wakeup)(void))
+{
+  wakeup_callback = wakeup;
+  return adafruit_tsc2007_register_touch_detect_isr_callback(
+    pen_down_callback);
+}
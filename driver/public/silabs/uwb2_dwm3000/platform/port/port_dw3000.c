@@ -29,9 +29,18 @@
 #include "gpiointerrupt.h"
 #endif
 
+// With a GPIO driven chip select the header, body and CRC of a transaction
+// are sent as consecutive DMA transfers under one CS assertion instead of
+// being copied into one staging buffer.
+#if defined (DWM3000_CS_PORT) && !defined(SLI_SI917)
+#define DWM3000_SPI_SCATTER_GATHER
+#include "spidrv.h"
+#endif
+
 typedef struct port_dw3000
 {
   spi_master_t spi;
+  uint32_t bitrate;
 
 #if defined (DWM3000_RESET_PORT)
   digital_out_t gpio_reset;
@@ -87,6 +96,7 @@ int uwb2_dwm3000_spi_init(mikroe_spi_handle_t spidrv)
   if (spi_master_open(&uwb2_dwm3000.spi, &spi_cfg) == SPI_MASTER_ERROR) {
     return _ERR;
   }
+  uwb2_dwm3000.bitrate = spi_cfg.speed;
 
 #if defined (DWM3000_RESET_PORT)
   pin_name_t gpio_reset_pin = hal_gpio_pin_name(DWM3000_RESET_PORT,
@@ -151,7 +161,16 @@ int uwb2_dwm3000_spi_close(void)
 
 static void port_spi_set_bitrate(uint32_t goal_bitrate)
 {
-  spi_master_set_speed(&uwb2_dwm3000.spi, goal_bitrate);
+  // The decadriver selects the rate before every burst, only reprogram the
+  // SPI peripheral when it actually changes
+  if (uwb2_dwm3000.bitrate == goal_bitrate) {
+    return;
+  }
+
+  if (spi_master_set_speed(&uwb2_dwm3000.spi,
+                           goal_bitrate) == SPI_MASTER_SUCCESS) {
+    uwb2_dwm3000.bitrate = goal_bitrate;
+  }
 }
 
 void set_dw_spi_slow_rate(void)
@@ -196,18 +215,70 @@ int readfromspi(uint16_t headerLength,
   spi_transfer_open();
 
   if ((headerBuffer) && (headerLength) && (readBuffer) && (readLength)) {
+#if defined (DWM3000_SPI_SCATTER_GATHER)
+    // The header write also applies the bus speed and mode, the body is
+    // received straight into the caller buffer
+    if ((spi_master_write(&uwb2_dwm3000.spi, headerBuffer,
+                          headerLength) != SPI_MASTER_SUCCESS)
+        || (SPIDRV_MReceiveB((SPIDRV_Handle_t)uwb2_dwm3000.spi.handle,
+                             readBuffer,
+                             readLength) != ECODE_EMDRV_SPIDRV_OK)) {
+      sc = DWT_ERROR;
+    }
+#else
     if (spi_master_write_then_read(&uwb2_dwm3000.spi, headerBuffer,
                                    headerLength,
                                    readBuffer,
                                    readLength) != SPI_MASTER_SUCCESS) {
       sc = DWT_ERROR;
     }
+#endif
   }
   spi_transfer_close();
 
   return sc;
 }
 
+#if defined (DWM3000_SPI_SCATTER_GATHER)
+static int spi_write(uint16_t headerLength,
+                     const uint8_t *headerBuffer,
+                     uint16_t bodyLength,
+                     const uint8_t *bodyBuffer,
+                     uint8_t *crc8)
+{
+  dwt_error_e sc = DWT_SUCCESS;
+  const uint8_t *seg_buff[3] = { headerBuffer, bodyBuffer, crc8 };
+  uint16_t seg_len[3] = { headerLength, bodyLength, 1 };
+  bool bus_ready = false;
+
+  spi_transfer_open();
+
+  for (uint8_t i = 0; i < 3; i++) {
+    if ((seg_buff[i] == NULL) || (seg_len[i] == 0)) {
+      continue;
+    }
+
+    if (!bus_ready) {
+      // The first segment goes through the peripheral driver so the bus
+      // speed and mode are applied
+      if (spi_master_write(&uwb2_dwm3000.spi, (uint8_t *)seg_buff[i],
+                           seg_len[i]) != SPI_MASTER_SUCCESS) {
+        sc = DWT_ERROR;
+        break;
+      }
+      bus_ready = true;
+    } else if (SPIDRV_MTransmitB((SPIDRV_Handle_t)uwb2_dwm3000.spi.handle,
+                                 seg_buff[i],
+                                 seg_len[i]) != ECODE_EMDRV_SPIDRV_OK) {
+      sc = DWT_ERROR;
+      break;
+    }
+  }
+  spi_transfer_close();
+
+  return sc;
+}
+#else
 static int spi_write(uint16_t headerLength,
                      const uint8_t *headerBuffer,
                      uint16_t bodyLength,
@@ -262,6 +333,7 @@ static int spi_write(uint16_t headerLength,
 
   return sc;
 }
+#endif
 
 int writetospi(uint16_t headerLength,
                const uint8_t *headerBuffer,
@@ -0,0 +1,60 @@
+/***************************************************************************/ /**
+ * @file uwb2_dwm3000_twr_config.h
+ * @brief DWM3000 double-sided two-way ranging configuration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef UWB2_DWM3000_TWR_CONFIG_H_
+#define UWB2_DWM3000_TWR_CONFIG_H_
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+// <h> DS-TWR ranging engine
+
+// <o UWB2_DWM3000_TWR_MAX_RESPONDERS> Maximum number of responder slots <1-16>
+// <i> Responders answering one poll, each adds 6 bytes to the final message
+// <i> Default: 8
+#define UWB2_DWM3000_TWR_MAX_RESPONDERS      8
+
+// <o UWB2_DWM3000_TWR_RANGE_QUEUE_SIZE> Range queue size <2-64>
+// <i> Ranges buffered between the interrupt and uwb2_dwm3000_twr_get_range()
+// <i> Default: 16
+#define UWB2_DWM3000_TWR_RANGE_QUEUE_SIZE    16
+
+// </h>
+
+// <<< end of configuration section >>>
+
+#endif /* UWB2_DWM3000_TWR_CONFIG_H_ */
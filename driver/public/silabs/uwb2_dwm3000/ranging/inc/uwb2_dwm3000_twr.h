@@ -0,0 +1,241 @@
+/***************************************************************************/ /**
+ * @file uwb2_dwm3000_twr.h
+ * @brief DWM3000 double-sided two-way ranging engine
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef UWB2_DWM3000_TWR_H_
+#define UWB2_DWM3000_TWR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+/*******************************************************************************
+ * The engine runs asymmetric double-sided two-way ranging from the DW3000
+ * interrupt callbacks. One exchange serves several responders:
+ *
+ *   initiator   POLL --------------------------------------> FINAL
+ *   responder 0       RESP (slot 0)
+ *   responder 1                     RESP (slot 1)
+ *   ...
+ *
+ * Responses and the final message are sent with delayed TX at fixed offsets
+ * from the poll, so the timestamps they carry are known before transmission.
+ * Each responder computes its distance when the final message is received and
+ * pushes it to the range queue. Initiators range in their own TDMA slot of
+ * the ranging period, so several initiators can share the channel.
+ ******************************************************************************/
+
+/*******************************************************************************
+ ***************************  Defines / Macros  ********************************
+ ******************************************************************************/
+///< Default configuration, set role, address and slots before use
+#define UWB2_DWM3000_TWR_CONFIG_DEFAULT \
+  {                                     \
+    .role = UWB2_DWM3000_TWR_INITIATOR, \
+    .pan_id = 0xDECA,                   \
+    .address = 0x0001,                  \
+    .responder_slot = 0,                \
+    .responder_count = 1,               \
+    .initiator_slot = 0,                \
+    .period_ms = 100,                   \
+    .slot_ms = 10,                      \
+    .resp_delay_uus = 800,              \
+    .resp_slot_uus = 500,               \
+    .final_delay_uus = 500,             \
+    .rx_guard_uus = 300,                \
+    .tx_antenna_delay = 16385,          \
+    .rx_antenna_delay = 16385,          \
+  }
+
+/*******************************************************************************
+ ********************************   ENUMS   ************************************
+ ******************************************************************************/
+/// @brief Role of the device in the exchange
+typedef enum {
+  ///< Sends polls and final messages (tag)
+  UWB2_DWM3000_TWR_INITIATOR = 0,
+
+  ///< Answers polls in its slot and computes the distance (anchor)
+  UWB2_DWM3000_TWR_RESPONDER
+} uwb2_dwm3000_twr_role_t;
+
+/*******************************************************************************
+ ********************************   STRUCTS   **********************************
+ ******************************************************************************/
+/// @brief Ranging engine configuration
+typedef struct {
+  ///< Role of this device
+  uwb2_dwm3000_twr_role_t role;
+
+  ///< PAN identifier shared by all devices
+  uint16_t pan_id;
+
+  ///< Short address of this device
+  uint16_t address;
+
+  ///< Responder: response slot of this device, 0 .. responder_count - 1
+  uint8_t responder_slot;
+
+  ///< Number of response slots following each poll
+  uint8_t responder_count;
+
+  ///< Initiator: TDMA slot of this device within the ranging period
+  uint8_t initiator_slot;
+
+  ///< Initiator: ranging period in milliseconds
+  uint32_t period_ms;
+
+  ///< Initiator: width of one initiator TDMA slot in milliseconds
+  uint32_t slot_ms;
+
+  ///< Poll RX to slot 0 response TX, in UWB microseconds
+  uint32_t resp_delay_uus;
+
+  ///< Spacing of the response slots, in UWB microseconds
+  uint32_t resp_slot_uus;
+
+  ///< Last response slot to final TX, in UWB microseconds
+  uint32_t final_delay_uus;
+
+  ///< Receiver is enabled this long before a response is expected
+  uint32_t rx_guard_uus;
+
+  ///< TX antenna delay in device time units
+  uint16_t tx_antenna_delay;
+
+  ///< RX antenna delay in device time units
+  uint16_t rx_antenna_delay;
+} uwb2_dwm3000_twr_config_t;
+
+/// @brief One distance measurement
+typedef struct {
+  ///< Address of the initiator
+  uint16_t initiator;
+
+  ///< Address of the responder
+  uint16_t responder;
+
+  ///< Sequence number of the exchange
+  uint8_t seq;
+
+  ///< Distance in millimeters, may be slightly negative at very short range
+  int32_t distance_mm;
+
+  ///< Clock offset of the initiator relative to the responder, in units of
+  ///< 2^-26 (about 0.015 ppm), already applied to distance_mm
+  int16_t clock_offset;
+
+  ///< Sleeptimer tick count when the final message was received
+  uint32_t timestamp;
+} uwb2_dwm3000_twr_range_t;
+
+/// @brief Exchange counters
+typedef struct {
+  ///< Initiator: polls sent. Responder: polls answered
+  uint32_t polls;
+
+  ///< Responder: ranges computed
+  uint32_t ranges;
+
+  ///< Initiator: polls without any response
+  uint32_t no_response;
+
+  ///< Delayed transmissions that were started too late
+  uint32_t late_tx;
+
+  ///< Receive errors
+  uint32_t rx_errors;
+
+  ///< Initiator: periods skipped because an exchange was still running
+  uint32_t skipped;
+
+  ///< Ranges lost because the range queue was full
+  uint32_t dropped;
+} uwb2_dwm3000_twr_stats_t;
+
+// -----------------------------------------------------------------------------
+// Prototypes
+
+/*******************************************************************************
+ * @brief Start the ranging engine.
+ * @param[in] config : engine configuration, copied.
+ * @return The following values are returned:
+ * - \ref SL_STATUS_OK on success.
+ * - \ref SL_STATUS_NULL_POINTER if config is NULL.
+ * - \ref SL_STATUS_INVALID_PARAMETER on an invalid configuration.
+ * - \ref SL_STATUS_FAIL if the timer or the receiver could not be started.
+ * @note The DW3000 must be initialized and configured with dwt_configure()
+ *   beforehand. The engine installs the DW3000 event callbacks and enables
+ *   the host interrupt.
+ ******************************************************************************/
+sl_status_t uwb2_dwm3000_twr_init(const uwb2_dwm3000_twr_config_t *config);
+
+/*******************************************************************************
+ * @brief Stop ranging, the transceiver is turned off.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_stop(void);
+
+/*******************************************************************************
+ * @brief Start the poll of the initiator when its slot is due.
+ * @note Call this from the main loop. The rest of the exchange runs from the
+ *   DW3000 interrupt. It does nothing on a responder.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_process(void);
+
+/*******************************************************************************
+ * @brief Get the oldest measurement from the range queue.
+ * @param[out] range : pointer to store the measurement.
+ * @return true if a measurement was returned, false if the queue is empty.
+ ******************************************************************************/
+bool uwb2_dwm3000_twr_get_range(uwb2_dwm3000_twr_range_t *range);
+
+/*******************************************************************************
+ * @brief Get the exchange counters.
+ * @param[out] stats : pointer to store the counters.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_get_stats(uwb2_dwm3000_twr_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UWB2_DWM3000_TWR_H_ */
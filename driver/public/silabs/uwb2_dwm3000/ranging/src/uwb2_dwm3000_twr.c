@@ -0,0 +1,767 @@
+/***************************************************************************/ /**
+ * @file uwb2_dwm3000_twr.c
+ * @brief DWM3000 double-sided two-way ranging engine
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "sl_sleeptimer.h"
+#include "deca_device_api.h"
+#include "port_dw3000.h"
+#include "uwb2_dwm3000_twr.h"
+#include "uwb2_dwm3000_twr_config.h"
+
+// IEEE 802.15.4 data frame, PAN ID compression, short addresses
+#define TWR_FRAME_CTRL_0          0x41
+#define TWR_FRAME_CTRL_1          0x88
+#define TWR_SEQ_IDX               2
+#define TWR_PAN_IDX               3
+#define TWR_DST_IDX               5
+#define TWR_SRC_IDX               7
+#define TWR_FUNC_IDX              9
+#define TWR_PAYLOAD_IDX           10
+#define TWR_FCS_LEN               2
+#define TWR_BROADCAST             0xFFFF
+
+#define TWR_FUNC_POLL             0x21
+#define TWR_FUNC_RESP             0x10
+#define TWR_FUNC_FINAL            0x23
+
+// Poll: responder count. Response: responder slot.
+#define TWR_POLL_LEN              (TWR_PAYLOAD_IDX + 1)
+#define TWR_RESP_LEN              (TWR_PAYLOAD_IDX + 1)
+
+// Final: poll TX time, final TX time, entry count, then per responder its
+// address and the RX time of its response
+#define TWR_FINAL_POLL_TX_IDX     TWR_PAYLOAD_IDX
+#define TWR_FINAL_FINAL_TX_IDX    (TWR_PAYLOAD_IDX + 4)
+#define TWR_FINAL_COUNT_IDX       (TWR_PAYLOAD_IDX + 8)
+#define TWR_FINAL_ENTRY_IDX       (TWR_PAYLOAD_IDX + 9)
+#define TWR_FINAL_ENTRY_LEN       6
+#define TWR_FINAL_LEN(n)          (TWR_FINAL_ENTRY_IDX \
+                                   + ((n) * TWR_FINAL_ENTRY_LEN))
+
+#define TWR_FRAME_MAX \
+  (TWR_FINAL_LEN(UWB2_DWM3000_TWR_MAX_RESPONDERS) + TWR_FCS_LEN)
+
+// 1 uus = 512 / 499.2 us, 1 us = 499.2 * 128 device time units
+#define TWR_UUS_TO_DWT_TIME       63898
+
+// Speed of light in air, in millimeters per second
+#define TWR_SPEED_OF_LIGHT_MM     299702547000LL
+
+// Device time units per second, 499.2 MHz * 128
+#define TWR_DWT_TIME_PER_SECOND   63897600000LL
+
+typedef enum {
+  TWR_STATE_IDLE = 0,
+  TWR_STATE_POLL_TX,
+  TWR_STATE_COLLECT,
+  TWR_STATE_FINAL_TX,
+  TWR_STATE_LISTEN,
+  TWR_STATE_WAIT_FINAL
+} twr_state_t;
+
+typedef struct {
+  uwb2_dwm3000_twr_config_t config;
+  volatile twr_state_t state;
+  uint8_t seq;
+
+  // Initiator: exchange in progress
+  uint64_t poll_tx_ts;
+  uint32_t window_end;
+  uint8_t resp_count;
+  uint16_t resp_addr[UWB2_DWM3000_TWR_MAX_RESPONDERS];
+  uint32_t resp_rx_ts[UWB2_DWM3000_TWR_MAX_RESPONDERS];
+  sl_sleeptimer_timer_handle_t slot_timer;
+  sl_sleeptimer_timer_handle_t period_timer;
+  volatile bool poll_due;
+
+  // Responder: exchange in progress
+  uint16_t peer;
+  uint32_t poll_rx_ts;
+  uint32_t resp_tx_ts;
+
+  uwb2_dwm3000_twr_range_t queue[UWB2_DWM3000_TWR_RANGE_QUEUE_SIZE];
+  volatile uint8_t queue_head;
+  volatile uint8_t queue_tail;
+
+  uwb2_dwm3000_twr_stats_t stats;
+  uint8_t frame[TWR_FRAME_MAX];
+} twr_t;
+
+static twr_t twr;
+
+// -----------------------------------------------------------------------------
+// Prototypes
+// -----------------------------------------------------------------------------
+static void twr_tx_done_cb(const dwt_cb_data_t *cb_data);
+static void twr_rx_ok_cb(const dwt_cb_data_t *cb_data);
+static void twr_rx_to_cb(const dwt_cb_data_t *cb_data);
+static void twr_rx_err_cb(const dwt_cb_data_t *cb_data);
+static void twr_slot_timer_cb(sl_sleeptimer_timer_handle_t *handle,
+                              void *data);
+static void twr_period_timer_cb(sl_sleeptimer_timer_handle_t *handle,
+                                void *data);
+static void twr_send_poll(void);
+static void twr_send_final(void);
+static void twr_resume_collect(void);
+static void twr_close_window(void);
+static void twr_handle_poll(uint16_t src, uint8_t seq, uint8_t count);
+static void twr_handle_final(uint16_t src, uint8_t seq, uint16_t length);
+static void twr_listen(void);
+static void twr_push_range(const uwb2_dwm3000_twr_range_t *range);
+
+// -----------------------------------------------------------------------------
+// Frame helpers
+// -----------------------------------------------------------------------------
+static void twr_put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t twr_get_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void twr_put_u32(uint8_t *p, uint32_t v)
+{
+  for (uint8_t i = 0; i < 4; i++) {
+    p[i] = (uint8_t)(v >> (8 * i));
+  }
+}
+
+static uint32_t twr_get_u32(const uint8_t *p)
+{
+  return (uint32_t)p[0]
+         | ((uint32_t)p[1] << 8)
+         | ((uint32_t)p[2] << 16)
+         | ((uint32_t)p[3] << 24);
+}
+
+static void twr_write_header(uint8_t function, uint16_t dst)
+{
+  twr.frame[0] = TWR_FRAME_CTRL_0;
+  twr.frame[1] = TWR_FRAME_CTRL_1;
+  twr.frame[TWR_SEQ_IDX] = twr.seq;
+  twr_put_u16(&twr.frame[TWR_PAN_IDX], twr.config.pan_id);
+  twr_put_u16(&twr.frame[TWR_DST_IDX], dst);
+  twr_put_u16(&twr.frame[TWR_SRC_IDX], twr.config.address);
+  twr.frame[TWR_FUNC_IDX] = function;
+}
+
+/*******************************************************************************
+ * @brief Read a 40-bit TX or RX timestamp.
+ ******************************************************************************/
+static uint64_t twr_read_timestamp(void (*read)(uint8_t *))
+{
+  uint8_t ts[5];
+  uint64_t value = 0;
+
+  read(ts);
+  for (int8_t i = 4; i >= 0; i--) {
+    value = (value << 8) | ts[i];
+  }
+
+  return value;
+}
+
+/*******************************************************************************
+ * @brief Delayed TX start time for an offset from a 40-bit timestamp.
+ ******************************************************************************/
+static uint32_t twr_delayed_time(uint64_t base, uint32_t delay_uus)
+{
+  return (uint32_t)((base + (uint64_t)delay_uus * TWR_UUS_TO_DWT_TIME) >> 8);
+}
+
+/*******************************************************************************
+ * @brief Low 32 bits of the antenna adjusted timestamp of a delayed TX.
+ ******************************************************************************/
+static uint32_t twr_delayed_tx_timestamp(uint32_t delayed_time)
+{
+  // The transceiver ignores the lowest bit of the delayed start time
+  return (uint32_t)(((uint64_t)(delayed_time & 0xFFFFFFFEUL) << 8)
+                    + twr.config.tx_antenna_delay);
+}
+
+/*******************************************************************************
+ * @brief Asymmetric double-sided two-way ranging.
+ *
+ *  round1 and reply2 are measured by the initiator, reply1 and round2 by the
+ *  responder. The initiator intervals are scaled to the responder clock with
+ *  the carrier derived clock offset before they are combined.
+ ******************************************************************************/
+static int32_t twr_distance_mm(int64_t round1,
+                               int64_t reply1,
+                               int64_t round2,
+                               int64_t reply2,
+                               int16_t clock_offset)
+{
+  int64_t tof;
+  int64_t sum;
+
+  round1 -= (round1 * clock_offset) / (1 << 26);
+  reply2 -= (reply2 * clock_offset) / (1 << 26);
+
+  sum = round1 + reply1 + round2 + reply2;
+  if (sum == 0) {
+    return 0;
+  }
+
+  tof = ((round1 * round2) - (reply1 * reply2)) / sum;
+
+  return (int32_t)((tof * TWR_SPEED_OF_LIGHT_MM) / TWR_DWT_TIME_PER_SECOND);
+}
+
+// -----------------------------------------------------------------------------
+// Public Function
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Start the ranging engine.
+ ******************************************************************************/
+sl_status_t uwb2_dwm3000_twr_init(const uwb2_dwm3000_twr_config_t *config)
+{
+  if (config == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if ((config->responder_count == 0)
+      || (config->responder_count > UWB2_DWM3000_TWR_MAX_RESPONDERS)
+      || (config->resp_slot_uus == 0)
+      || (config->rx_guard_uus > config->resp_delay_uus)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((config->role == UWB2_DWM3000_TWR_RESPONDER)
+      && (config->responder_slot >= config->responder_count)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((config->role == UWB2_DWM3000_TWR_INITIATOR)
+      && ((config->period_ms == 0)
+          || ((uint32_t)config->initiator_slot * config->slot_ms
+              >= config->period_ms))) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  uwb2_dwm3000_twr_stop();
+
+  memset(&twr.stats, 0, sizeof(twr.stats));
+  twr.config = *config;
+  twr.queue_head = 0;
+  twr.queue_tail = 0;
+  twr.poll_due = false;
+
+  dwt_setrxantennadelay(config->rx_antenna_delay);
+  dwt_settxantennadelay(config->tx_antenna_delay);
+
+  dwt_setcallbacks(twr_tx_done_cb,
+                   twr_rx_ok_cb,
+                   twr_rx_to_cb,
+                   twr_rx_err_cb,
+                   NULL,
+                   NULL,
+                   NULL);
+  dwt_setinterrupt(DWT_INT_TXFRS_BIT_MASK | DWT_INT_RXFCG_BIT_MASK
+                   | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR,
+                   0,
+                   DWT_ENABLE_INT_ONLY);
+  dwt_writesysstatuslo(DWT_INT_TXFRS_BIT_MASK | SYS_STATUS_ALL_RX_GOOD
+                       | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+  enable_dw3000_irq();
+
+  if (config->role == UWB2_DWM3000_TWR_RESPONDER) {
+    // Responders listen continuously
+    dwt_setrxtimeout(0);
+    twr.state = TWR_STATE_LISTEN;
+    if (dwt_rxenable(DWT_START_RX_IMMEDIATE) != DWT_SUCCESS) {
+      return SL_STATUS_FAIL;
+    }
+    return SL_STATUS_OK;
+  }
+
+  twr.state = TWR_STATE_IDLE;
+
+  // Offset the ranging period by the TDMA slot of this initiator
+  uint32_t offset_ms = (uint32_t)config->initiator_slot * config->slot_ms;
+  if (offset_ms == 0) {
+    twr.poll_due = true;
+    if (sl_sleeptimer_start_periodic_timer_ms(&twr.period_timer,
+                                              config->period_ms,
+                                              twr_period_timer_cb,
+                                              NULL,
+                                              0,
+                                              0) != SL_STATUS_OK) {
+      return SL_STATUS_FAIL;
+    }
+  } else if (sl_sleeptimer_start_timer_ms(&twr.slot_timer,
+                                          offset_ms,
+                                          twr_slot_timer_cb,
+                                          NULL,
+                                          0,
+                                          0) != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Stop ranging.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_stop(void)
+{
+  sl_sleeptimer_stop_timer(&twr.slot_timer);
+  sl_sleeptimer_stop_timer(&twr.period_timer);
+  twr.poll_due = false;
+
+  decaIrqStatus_t s = decamutexon();
+  dwt_forcetrxoff();
+  twr.state = TWR_STATE_IDLE;
+  decamutexoff(s);
+}
+
+/*******************************************************************************
+ * Start the poll of the initiator when its slot is due.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_process(void)
+{
+  if ((twr.config.role != UWB2_DWM3000_TWR_INITIATOR) || !twr.poll_due) {
+    return;
+  }
+
+  twr.poll_due = false;
+
+  if (twr.state != TWR_STATE_IDLE) {
+    twr.stats.skipped++;
+    return;
+  }
+
+  decaIrqStatus_t s = decamutexon();
+  twr_send_poll();
+  decamutexoff(s);
+}
+
+/*******************************************************************************
+ * Get the oldest measurement from the range queue.
+ ******************************************************************************/
+bool uwb2_dwm3000_twr_get_range(uwb2_dwm3000_twr_range_t *range)
+{
+  uint8_t tail = twr.queue_tail;
+
+  if ((range == NULL) || (tail == twr.queue_head)) {
+    return false;
+  }
+
+  *range = twr.queue[tail];
+  twr.queue_tail = (tail + 1) % UWB2_DWM3000_TWR_RANGE_QUEUE_SIZE;
+
+  return true;
+}
+
+/*******************************************************************************
+ * Get the exchange counters.
+ ******************************************************************************/
+void uwb2_dwm3000_twr_get_stats(uwb2_dwm3000_twr_stats_t *stats)
+{
+  if (stats != NULL) {
+    *stats = twr.stats;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Initiator
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * @brief Broadcast a poll and open the response window.
+ ******************************************************************************/
+static void twr_send_poll(void)
+{
+  uint32_t window_uus = twr.config.rx_guard_uus
+                        + (uint32_t)twr.config.responder_count
+                        * twr.config.resp_slot_uus;
+
+  twr.seq++;
+  twr.resp_count = 0;
+  twr_write_header(TWR_FUNC_POLL, TWR_BROADCAST);
+  twr.frame[TWR_PAYLOAD_IDX] = twr.config.responder_count;
+
+  dwt_writetxdata(TWR_POLL_LEN, twr.frame, 0);
+  dwt_writetxfctrl(TWR_POLL_LEN + TWR_FCS_LEN, 0, 1);
+
+  // The receiver turns on shortly before the slot 0 response and stays on
+  // until the last slot has passed
+  dwt_setrxaftertxdelay(twr.config.resp_delay_uus - twr.config.rx_guard_uus);
+  dwt_setrxtimeout(window_uus);
+
+  twr.state = TWR_STATE_POLL_TX;
+  if (dwt_starttx(DWT_START_TX_IMMEDIATE
+                  | DWT_RESPONSE_EXPECTED) != DWT_SUCCESS) {
+    twr.state = TWR_STATE_IDLE;
+    return;
+  }
+
+  twr.stats.polls++;
+}
+
+/*******************************************************************************
+ * @brief Send the final message at a fixed offset from the poll.
+ ******************************************************************************/
+static void twr_send_final(void)
+{
+  uint32_t final_delay_uus = twr.config.resp_delay_uus
+                             + (uint32_t)twr.config.responder_count
+                             * twr.config.resp_slot_uus
+                             + twr.config.final_delay_uus;
+  uint32_t final_tx_time = twr_delayed_time(twr.poll_tx_ts, final_delay_uus);
+  uint16_t length = TWR_FINAL_LEN(twr.resp_count);
+
+  twr_write_header(TWR_FUNC_FINAL, TWR_BROADCAST);
+  twr_put_u32(&twr.frame[TWR_FINAL_POLL_TX_IDX], (uint32_t)twr.poll_tx_ts);
+  twr_put_u32(&twr.frame[TWR_FINAL_FINAL_TX_IDX],
+              twr_delayed_tx_timestamp(final_tx_time));
+  twr.frame[TWR_FINAL_COUNT_IDX] = twr.resp_count;
+
+  for (uint8_t i = 0; i < twr.resp_count; i++) {
+    uint8_t *entry = &twr.frame[TWR_FINAL_ENTRY_IDX
+                                + (i * TWR_FINAL_ENTRY_LEN)];
+
+    twr_put_u16(entry, twr.resp_addr[i]);
+    twr_put_u32(entry + 2, twr.resp_rx_ts[i]);
+  }
+
+  dwt_writetxdata(length, twr.frame, 0);
+  dwt_writetxfctrl(length + TWR_FCS_LEN, 0, 1);
+  dwt_setdelayedtrxtime(final_tx_time);
+
+  twr.state = TWR_STATE_FINAL_TX;
+  if (dwt_starttx(DWT_START_TX_DELAYED) != DWT_SUCCESS) {
+    twr.stats.late_tx++;
+    twr.state = TWR_STATE_IDLE;
+  }
+}
+
+/*******************************************************************************
+ * @brief Keep receiving until the last response slot has passed.
+ ******************************************************************************/
+static void twr_resume_collect(void)
+{
+  int32_t remaining = (int32_t)(twr.window_end - dwt_readsystimestamphi32());
+
+  if (remaining <= 0) {
+    twr_close_window();
+    return;
+  }
+
+  // System time high word counts 256 device time units
+  dwt_setrxtimeout(((uint32_t)remaining << 8) / TWR_UUS_TO_DWT_TIME + 1);
+  if (dwt_rxenable(DWT_START_RX_IMMEDIATE) != DWT_SUCCESS) {
+    twr_close_window();
+  }
+}
+
+/*******************************************************************************
+ * @brief End of the response window, send the final or give up.
+ ******************************************************************************/
+static void twr_close_window(void)
+{
+  if (twr.resp_count > 0) {
+    twr_send_final();
+  } else {
+    twr.stats.no_response++;
+    twr.state = TWR_STATE_IDLE;
+  }
+}
+
+static void twr_slot_timer_cb(sl_sleeptimer_timer_handle_t *handle,
+                              void *data)
+{
+  (void)handle;
+  (void)data;
+
+  twr.poll_due = true;
+  sl_sleeptimer_start_periodic_timer_ms(&twr.period_timer,
+                                        twr.config.period_ms,
+                                        twr_period_timer_cb,
+                                        NULL,
+                                        0,
+                                        0);
+}
+
+static void twr_period_timer_cb(sl_sleeptimer_timer_handle_t *handle,
+                                void *data)
+{
+  (void)handle;
+  (void)data;
+
+  twr.poll_due = true;
+}
+
+// -----------------------------------------------------------------------------
+// Responder
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * @brief Answer a poll in the response slot of this device.
+ ******************************************************************************/
+static void twr_handle_poll(uint16_t src, uint8_t seq, uint8_t count)
+{
+  uint64_t poll_rx_ts;
+  uint32_t resp_tx_time;
+
+  if (twr.config.responder_slot >= count) {
+    twr_listen();
+    return;
+  }
+
+  poll_rx_ts = twr_read_timestamp(dwt_readrxtimestamp);
+  resp_tx_time = twr_delayed_time(poll_rx_ts,
+                                  twr.config.resp_delay_uus
+                                  + (uint32_t)twr.config.responder_slot
+                                  * twr.config.resp_slot_uus);
+
+  twr.seq = seq;
+  twr_write_header(TWR_FUNC_RESP, src);
+  twr.frame[TWR_PAYLOAD_IDX] = twr.config.responder_slot;
+
+  dwt_writetxdata(TWR_RESP_LEN, twr.frame, 0);
+  dwt_writetxfctrl(TWR_RESP_LEN + TWR_FCS_LEN, 0, 1);
+  dwt_setdelayedtrxtime(resp_tx_time);
+  dwt_setrxaftertxdelay(0);
+
+  if (dwt_starttx(DWT_START_TX_DELAYED
+                  | DWT_RESPONSE_EXPECTED) != DWT_SUCCESS) {
+    twr.stats.late_tx++;
+    twr.state = TWR_STATE_LISTEN;
+    twr_listen();
+    return;
+  }
+
+  twr.peer = src;
+  twr.poll_rx_ts = (uint32_t)poll_rx_ts;
+  twr.resp_tx_ts = twr_delayed_tx_timestamp(resp_tx_time);
+  twr.state = TWR_STATE_WAIT_FINAL;
+  twr.stats.polls++;
+}
+
+/*******************************************************************************
+ * @brief Compute the distance from a final message.
+ ******************************************************************************/
+static void twr_handle_final(uint16_t src, uint8_t seq, uint16_t length)
+{
+  uint32_t final_rx_ts;
+  uint8_t count;
+
+  if ((twr.state != TWR_STATE_WAIT_FINAL)
+      || (src != twr.peer)
+      || (seq != twr.seq)
+      || (length < TWR_FINAL_ENTRY_IDX)) {
+    twr_listen();
+    return;
+  }
+
+  final_rx_ts = dwt_readrxtimestamplo32();
+  count = twr.frame[TWR_FINAL_COUNT_IDX];
+  if (length < TWR_FINAL_LEN(count)) {
+    count = (length - TWR_FINAL_ENTRY_IDX) / TWR_FINAL_ENTRY_LEN;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    const uint8_t *entry = &twr.frame[TWR_FINAL_ENTRY_IDX
+                                      + (i * TWR_FINAL_ENTRY_LEN)];
+
+    if (twr_get_u16(entry) != twr.config.address) {
+      continue;
+    }
+
+    uint32_t poll_tx_ts = twr_get_u32(&twr.frame[TWR_FINAL_POLL_TX_IDX]);
+    uint32_t final_tx_ts = twr_get_u32(&twr.frame[TWR_FINAL_FINAL_TX_IDX]);
+    uint32_t resp_rx_ts = twr_get_u32(entry + 2);
+    uwb2_dwm3000_twr_range_t range;
+
+    range.initiator = src;
+    range.responder = twr.config.address;
+    range.seq = seq;
+    range.clock_offset = dwt_readclockoffset();
+    range.timestamp = sl_sleeptimer_get_tick_count();
+    range.distance_mm = twr_distance_mm(
+      (uint32_t)(resp_rx_ts - poll_tx_ts),
+      (uint32_t)(twr.resp_tx_ts - twr.poll_rx_ts),
+      (uint32_t)(final_rx_ts - twr.resp_tx_ts),
+      (uint32_t)(final_tx_ts - resp_rx_ts),
+      range.clock_offset);
+
+    twr.stats.ranges++;
+    twr_push_range(&range);
+    break;
+  }
+
+  twr.state = TWR_STATE_LISTEN;
+  twr_listen();
+}
+
+static void twr_listen(void)
+{
+  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+}
+
+static void twr_push_range(const uwb2_dwm3000_twr_range_t *range)
+{
+  uint8_t head = twr.queue_head;
+  uint8_t next = (head + 1) % UWB2_DWM3000_TWR_RANGE_QUEUE_SIZE;
+
+  if (next == twr.queue_tail) {
+    twr.stats.dropped++;
+    return;
+  }
+
+  twr.queue[head] = *range;
+  twr.queue_head = next;
+}
+
+// -----------------------------------------------------------------------------
+// DW3000 event callbacks, called from dwt_isr()
+// -----------------------------------------------------------------------------
+static void twr_tx_done_cb(const dwt_cb_data_t *cb_data)
+{
+  (void)cb_data;
+
+  if (twr.state == TWR_STATE_POLL_TX) {
+    twr.poll_tx_ts = twr_read_timestamp(dwt_readtxtimestamp);
+    twr.window_end = twr_delayed_time(twr.poll_tx_ts,
+                                      twr.config.resp_delay_uus
+                                      + (uint32_t)twr.config.responder_count
+                                      * twr.config.resp_slot_uus);
+    twr.state = TWR_STATE_COLLECT;
+  } else if (twr.state == TWR_STATE_FINAL_TX) {
+    twr.state = TWR_STATE_IDLE;
+  }
+}
+
+static void twr_rx_ok_cb(const dwt_cb_data_t *cb_data)
+{
+  uint16_t length = cb_data->datalength;
+  uint16_t src;
+  uint16_t dst;
+  uint8_t seq;
+  uint8_t function;
+
+  if ((length < (TWR_PAYLOAD_IDX + 1 + TWR_FCS_LEN))
+      || (length > TWR_FRAME_MAX)) {
+    length = 0;
+  } else {
+    length -= TWR_FCS_LEN;
+    dwt_readrxdata(twr.frame, length, 0);
+  }
+
+  if ((length == 0)
+      || (twr.frame[0] != TWR_FRAME_CTRL_0)
+      || (twr.frame[1] != TWR_FRAME_CTRL_1)
+      || (twr_get_u16(&twr.frame[TWR_PAN_IDX]) != twr.config.pan_id)) {
+    if (twr.state == TWR_STATE_COLLECT) {
+      twr_resume_collect();
+    } else if (twr.config.role == UWB2_DWM3000_TWR_RESPONDER) {
+      twr_listen();
+    }
+    return;
+  }
+
+  seq = twr.frame[TWR_SEQ_IDX];
+  dst = twr_get_u16(&twr.frame[TWR_DST_IDX]);
+  src = twr_get_u16(&twr.frame[TWR_SRC_IDX]);
+  function = twr.frame[TWR_FUNC_IDX];
+
+  if (twr.state == TWR_STATE_COLLECT) {
+    if ((function == TWR_FUNC_RESP)
+        && (dst == twr.config.address)
+        && (seq == twr.seq)
+        && (twr.resp_count < UWB2_DWM3000_TWR_MAX_RESPONDERS)) {
+      uint8_t slot = twr.frame[TWR_PAYLOAD_IDX];
+
+      twr.resp_addr[twr.resp_count] = src;
+      twr.resp_rx_ts[twr.resp_count] = dwt_readrxtimestamplo32();
+      twr.resp_count++;
+
+      // Nothing is expected after the last slot
+      if (slot >= (twr.config.responder_count - 1)) {
+        twr_send_final();
+        return;
+      }
+    }
+    twr_resume_collect();
+    return;
+  }
+
+  if (twr.config.role != UWB2_DWM3000_TWR_RESPONDER) {
+    return;
+  }
+
+  if ((function == TWR_FUNC_POLL)
+      && ((dst == TWR_BROADCAST) || (dst == twr.config.address))) {
+    twr_handle_poll(src, seq, twr.frame[TWR_PAYLOAD_IDX]);
+  } else if (function == TWR_FUNC_FINAL) {
+    twr_handle_final(src, seq, length);
+  } else {
+    twr_listen();
+  }
+}
+
+static void twr_rx_to_cb(const dwt_cb_data_t *cb_data)
+{
+  (void)cb_data;
+
+  if (twr.state == TWR_STATE_COLLECT) {
+    twr_close_window();
+  } else if (twr.config.role == UWB2_DWM3000_TWR_RESPONDER) {
+    twr_listen();
+  }
+}
+
+static void twr_rx_err_cb(const dwt_cb_data_t *cb_data)
+{
+  (void)cb_data;
+
+  twr.stats.rx_errors++;
+
+  if (twr.state == TWR_STATE_COLLECT) {
+    twr_resume_collect();
+  } else if (twr.config.role == UWB2_DWM3000_TWR_RESPONDER) {
+    twr_listen();
+  }
+}
@@ -311,6 +311,12 @@ VL53L1X_ERROR VL53L1X_GetAmbientRate(uint16_t dev, uint16_t *ambRate);
  */
 VL53L1X_ERROR VL53L1X_GetRangeStatus(uint16_t dev, uint8_t *rangeStatus);
 
+/**
+ * @brief This function converts the RESULT__RANGE_STATUS register value into
+ *   the ranging status returned by VL53L1X_GetRangeStatus(), 255 if unknown
+ */
+uint8_t VL53L1X_DecodeRangeStatus(uint8_t rawStatus);
+
 /**
  * @brief This function returns measurements and the range status in a single
  *   read access
@@ -638,13 +638,19 @@ VL53L1X_ERROR VL53L1X_GetRangeStatus(uint16_t dev, uint8_t *rangeStatus)
   VL53L1X_ERROR status = 0;
   uint8_t RgSt;
 
-  *rangeStatus = 255;
   status |= VL53L1_RdByte(dev, VL53L1_RESULT__RANGE_STATUS, &RgSt);
-  RgSt = RgSt & 0x1F;
+  *rangeStatus = VL53L1X_DecodeRangeStatus(RgSt);
+  return status;
+}
+
+uint8_t VL53L1X_DecodeRangeStatus(uint8_t rawStatus)
+{
+  uint8_t RgSt = rawStatus & 0x1F;
+
   if (RgSt < 24) {
-    *rangeStatus = status_rtn[RgSt];
+    return status_rtn[RgSt];
   }
-  return status;
+  return 255;
 }
 
 VL53L1X_ERROR VL53L1X_GetResult(uint16_t dev, VL53L1X_Result_t *pResult)